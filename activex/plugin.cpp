@@ -1427,12 +1427,17 @@ void VLCPlugin::player_register_events()
     em.onEncounteredError([this] {
         fireOnMediaPlayerEncounteredErrorEvent();
     });
-    em.onTimeChanged([this] (int64_t time) {
+    // Scripts don't need more than a few time & position updates per second.
+    // The last value is still delivered before the player pauses or stops.
+    // While playing, a merged update waits for the next one, which libvlc
+    // raises a few times per second anyway.
+    const auto progressInterval = std::chrono::milliseconds( 100 );
+    em.onTimeChanged(VLC::coalesce( progressInterval, [this] (int64_t time) {
         fireOnMediaPlayerTimeChangedEvent( time );
-    });
-    em.onPositionChanged([this](float pos) {
+    }));
+    em.onPositionChanged(VLC::coalesce( progressInterval, [this](float pos) {
         fireOnMediaPlayerPositionChangedEvent( pos );
-    });
+    }));
     em.onSeekableChanged([this](bool b) {
         fireOnMediaPlayerSeekableChangedEvent( B( b ) );
     });
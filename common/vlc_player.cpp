@@ -25,8 +25,11 @@
 
 #if defined(_WIN32)
 #  include <windows.h>
+#  include <stdexcept>
 #else
-#  include <future>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
 #endif
 
 #include "vlc_player.h"
@@ -105,54 +108,514 @@ int vlc_player::preparse_item_sync(unsigned int idx, int options, unsigned int t
 {
     int retval = -1;
 
-    VLC::MediaList::Lock lock( _ml );
-    auto media = _ml.itemAtIndex( idx );
-    if ( !media )
-        return -1;
-    auto em = media->eventManager();
+    auto batch = preparse_items_async( std::vector<unsigned int>( 1, idx ), options, timeout, 1,
+        [&retval]( unsigned int, int status )
+    {
+        retval = status;
+    });
+    batch->wait();
 
-#  if defined(_WIN32)
-    HANDLE barrier = CreateEvent(nullptr, true,  false, nullptr);
-    if ( barrier == nullptr )
-        return -1;
+    return retval;
+}
 
-    auto event = em.onParsedChanged(
-        [&barrier, &retval](VLC::Media::ParsedStatus status )
+std::shared_ptr<vlc_preparse_batch>
+vlc_player::preparse_items_async(const std::vector<unsigned int>& idxs, int options,
+                                 unsigned int timeout, unsigned int concurrency,
+                                 vlc_preparse_batch::item_cb on_item)
+{
+    std::vector<vlc_preparse_batch::item> items;
+    items.reserve( idxs.size() );
     {
-        retval = int( status );
-        SetEvent( barrier );
-    });
+        // Only hold the playlist while taking references to the items
+        VLC::MediaList::Lock lock( _ml );
+        for( auto idx : idxs ) {
+            vlc_preparse_batch::item it;
+            it.idx = idx;
+            it.media = _ml.itemAtIndex( idx );
+            it.stopped = false;
+            it.parsed = false;
+            it.status = -1;
+            items.push_back( std::move( it ) );
+        }
+    }
+    return std::shared_ptr<vlc_preparse_batch>(
+        new vlc_preparse_batch( _libvlc_instance, std::move( items ), options, timeout,
+                                concurrency, std::move( on_item ) ) );
+}
+
+/*
+ * How long a stopped parsing has to report its status, before its item is
+ * reported as timed out anyway
+ */
+static const std::chrono::seconds preparse_stop_grace( 1 );
+
+namespace {
+
+typedef std::chrono::steady_clock preparse_clock;
+
+/*
+ * The batch thread, and the lock and conditions it and its users wait on.
+ * MinGW's win32 thread model lacks std::thread and its primitives, so the
+ * Win32 API is used on Windows, as available on XP.
+ */
+#if defined(_WIN32)
+class preparse_sync
+{
+public:
+    preparse_sync()
+        : _thread( nullptr )
+        , _thread_id( 0 )
+        , _entry( nullptr )
+        , _opaque( nullptr )
+    {
+        // Only the batch thread waits for a wakeup, and a wakeup happening
+        // while it doesn't wait is kept until it does. Once set, the done
+        // event is never reset.
+        _wakeup = CreateEvent( nullptr, FALSE, FALSE, nullptr );
+        _done = CreateEvent( nullptr, TRUE, FALSE, nullptr );
+        if( _wakeup == nullptr || _done == nullptr ) {
+            if( _wakeup != nullptr )
+                CloseHandle( _wakeup );
+            if( _done != nullptr )
+                CloseHandle( _done );
+            throw std::runtime_error( "Failed to create the preparse events" );
+        }
+        InitializeCriticalSection( &_cs );
+    }
 
-    media->parseRequest( _libvlc_instance, VLC::Media::ParseFlags( options ), timeout );
+    ~preparse_sync()
+    {
+        if( _thread != nullptr )
+            CloseHandle( _thread );
+        CloseHandle( _wakeup );
+        CloseHandle( _done );
+        DeleteCriticalSection( &_cs );
+    }
+
+    void lock()
+    {
+        EnterCriticalSection( &_cs );
+    }
 
-    DWORD waitResult = WaitForSingleObject( barrier, INFINITE );
-    switch ( waitResult ) {
-    case WAIT_OBJECT_0:
-        break;
-    default:
-        retval = -1;
-        break;
+    void unlock()
+    {
+        LeaveCriticalSection( &_cs );
+    }
+
+    // Wakes the batch thread up
+    void notify()
+    {
+        SetEvent( _wakeup );
+    }
+
+    // Called by the batch thread with the lock held, which is released while
+    // waiting
+    void wait_until( preparse_clock::time_point deadline )
+    {
+        DWORD timeout = INFINITE;
+        if( deadline != preparse_clock::time_point::max() ) {
+            auto now = preparse_clock::now();
+            auto ms = deadline > now ?
+                std::chrono::duration_cast<std::chrono::milliseconds>( deadline - now ).count() + 1 : 0;
+            timeout = ms < INFINITE ? DWORD( ms ) : INFINITE - 1;
+        }
+        LeaveCriticalSection( &_cs );
+        WaitForSingleObject( _wakeup, timeout );
+        EnterCriticalSection( &_cs );
+    }
+
+    void notify_finished()
+    {
+        SetEvent( _done );
+    }
+
+    // Called with the lock held, which is released while waiting
+    void wait_finished()
+    {
+        LeaveCriticalSection( &_cs );
+        WaitForSingleObject( _done, INFINITE );
+        EnterCriticalSection( &_cs );
+    }
+
+    void start( void (*entry)( void* ), void* opaque )
+    {
+        _entry = entry;
+        _opaque = opaque;
+        _thread = CreateThread( nullptr, 0, &preparse_sync::thread_main, this, 0, &_thread_id );
+        if( _thread == nullptr )
+            throw std::runtime_error( "Failed to start the preparse thread" );
+    }
+
+    void join()
+    {
+        WaitForSingleObject( _thread, INFINITE );
+    }
+
+    void detach()
+    {
+        CloseHandle( _thread );
+        _thread = nullptr;
+    }
+
+    bool is_current() const
+    {
+        return GetCurrentThreadId() == _thread_id;
+    }
+
+private:
+    static DWORD WINAPI thread_main( LPVOID data )
+    {
+        auto self = static_cast<preparse_sync*>( data );
+        // The entry point may destroy us
+        auto entry = self->_entry;
+        auto opaque = self->_opaque;
+        entry( opaque );
+        return 0;
+    }
+
+    preparse_sync(const preparse_sync&) = delete;
+    preparse_sync& operator=(const preparse_sync&) = delete;
+
+private:
+    CRITICAL_SECTION _cs;
+    HANDLE           _wakeup;
+    HANDLE           _done;
+    HANDLE           _thread;
+    DWORD            _thread_id;
+    void           (*_entry)( void* );
+    void*            _opaque;
+};
+#else
+class preparse_sync
+{
+public:
+    void lock()
+    {
+        _lock.lock();
+    }
+
+    void unlock()
+    {
+        _lock.unlock();
+    }
+
+    void notify()
+    {
+        _cond.notify_all();
+    }
+
+    void wait_until( preparse_clock::time_point deadline )
+    {
+        std::unique_lock<std::mutex> lock( _lock, std::adopt_lock );
+        if( deadline == preparse_clock::time_point::max() )
+            _cond.wait( lock );
+        else
+            _cond.wait_until( lock, deadline );
+        lock.release();
+    }
+
+    void notify_finished()
+    {
+        _cond.notify_all();
+    }
+
+    void wait_finished()
+    {
+        wait_until( preparse_clock::time_point::max() );
+    }
+
+    void start( void (*entry)( void* ), void* opaque )
+    {
+        _thread = std::thread( entry, opaque );
     }
-    CloseHandle( barrier );
-    event->unregister();
-#  else
-    std::promise<int> promise;
-    std::future<int> future = promise.get_future();
 
-    auto event = em.onParsedChanged(
-        [&promise]( VLC::Media::ParsedStatus status )
+    void join()
     {
-        promise.set_value( int( status ) );
+        _thread.join();
+    }
+
+    void detach()
+    {
+        _thread.detach();
+    }
+
+    bool is_current() const
+    {
+        return std::this_thread::get_id() == _thread.get_id();
+    }
+
+private:
+    std::mutex              _lock;
+    std::condition_variable _cond;
+    std::thread             _thread;
+};
+#endif
+
+class preparse_lock
+{
+public:
+    explicit preparse_lock( preparse_sync& sync )
+        : _sync( sync )
+        , _locked( true )
+    {
+        _sync.lock();
+    }
+
+    ~preparse_lock()
+    {
+        if( _locked )
+            _sync.unlock();
+    }
+
+    void lock()
+    {
+        _sync.lock();
+        _locked = true;
+    }
+
+    void unlock()
+    {
+        _locked = false;
+        _sync.unlock();
+    }
+
+    preparse_lock(const preparse_lock&) = delete;
+    preparse_lock& operator=(const preparse_lock&) = delete;
+
+private:
+    preparse_sync& _sync;
+    bool           _locked;
+};
+
+}
+
+/*
+ * The batch thread holds its own reference to the state, so that the batch
+ * can be destroyed while the thread winds down.
+ */
+struct vlc_preparse_batch::state : std::enable_shared_from_this<vlc_preparse_batch::state>
+{
+    state(const VLC::Instance& instance, std::vector<item> items, int options,
+          unsigned int timeout, unsigned int concurrency, item_cb on_item)
+        : _instance( instance )
+        , _items( std::move( items ) )
+        , _options( options )
+        , _timeout( timeout )
+        , _concurrency( concurrency > 0 ? concurrency : 1 )
+        , _on_item( std::move( on_item ) )
+        , _cancelled( false )
+        , _finished( false )
+        , _orphaned( false )
+    {
+    }
+
+    static void thread_main(void* opaque);
+
+    void run();
+    bool start(item& it);
+    void stop(item& it);
+
+    VLC::Instance           _instance;
+    std::vector<item>       _items;
+    const int               _options;
+    const unsigned int      _timeout;
+    const unsigned int      _concurrency;
+    const item_cb           _on_item;
+
+    preparse_sync           _sync;
+    bool                    _cancelled;
+    bool                    _finished;
+    // The batch was destroyed from the callback
+    bool                    _orphaned;
+};
+
+vlc_preparse_batch::vlc_preparse_batch(const VLC::Instance& instance, std::vector<item> items,
+                                       int options, unsigned int timeout,
+                                       unsigned int concurrency, item_cb on_item)
+    : _state( std::make_shared<state>( instance, std::move( items ), options, timeout,
+                                       concurrency, std::move( on_item ) ) )
+{
+    auto ref = new std::shared_ptr<state>( _state );
+    try {
+        _state->_sync.start( &state::thread_main, ref );
+    }
+    catch( ... ) {
+        delete ref;
+        throw;
+    }
+}
+
+vlc_preparse_batch::~vlc_preparse_batch()
+{
+    // The thread can't wait for itself: when destroyed from the callback,
+    // let the thread finish on its own, without reporting anything else
+    bool orphaned = _state->_sync.is_current();
+    {
+        preparse_lock lock( _state->_sync );
+        _state->_cancelled = true;
+        _state->_orphaned = orphaned;
+        _state->_sync.notify();
+    }
+    if( orphaned )
+        _state->_sync.detach();
+    else
+        _state->_sync.join();
+}
+
+void vlc_preparse_batch::cancel()
+{
+    preparse_lock lock( _state->_sync );
+    _state->_cancelled = true;
+    _state->_sync.notify();
+}
+
+void vlc_preparse_batch::wait()
+{
+    preparse_lock lock( _state->_sync );
+    while( !_state->_finished )
+        _state->_sync.wait_finished();
+}
+
+bool vlc_preparse_batch::finished()
+{
+    preparse_lock lock( _state->_sync );
+    return _state->_finished;
+}
+
+void vlc_preparse_batch::state::thread_main(void* opaque)
+{
+    auto ref = static_cast<std::shared_ptr<state>*>( opaque );
+    (*ref)->run();
+    delete ref;
+}
+
+bool vlc_preparse_batch::state::start(item& it)
+{
+    if( !it.media )
+        return false;
+
+    auto i = static_cast<size_t>( &it - _items.data() );
+    /*
+     * Unregistering waits for a running handler, but a late event must not
+     * reach a released state anyway: only hold it while handling the event
+     */
+    std::weak_ptr<state> weak = shared_from_this();
+    it.event = it.media->eventManager().onParsedChanged(
+        [weak, i]( VLC::Media::ParsedStatus status )
+    {
+        auto self = weak.lock();
+        if( !self )
+            return;
+        preparse_lock lock( self->_sync );
+        self->_items[i].parsed = true;
+        self->_items[i].status = int( status );
+        self->_sync.notify();
     });
 
-    media->parseWithOptions( VLC::Media::ParseFlags( options ), timeout );
+    if( _timeout > 0 )
+        it.deadline = clock::now() + std::chrono::milliseconds( _timeout );
+    else
+        it.deadline = clock::time_point::max();
 
-    future.wait();
-    retval = future.get();
-    event->unregister();
-#  endif
+    // The deadline is enforced with parseStop(), rather than by libvlc
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    bool started = it.media->parseRequest( _instance, VLC::Media::ParseFlags( _options ), 0 );
+#else
+    bool started = it.media->parseWithOptions( VLC::Media::ParseFlags( _options ), 0 );
+#endif
+    if( !started )
+        it.event->unregister();
+    return started;
+}
 
-    return retval;
+void vlc_preparse_batch::state::stop(item& it)
+{
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    it.media->parseStop( _instance );
+#else
+    it.media->parseStop();
+#endif
+}
+
+void vlc_preparse_batch::state::run()
+{
+    // The indexes of the items being parsed
+    std::vector<size_t> running;
+    size_t next = 0;
+    size_t reported = 0;
+
+    // Called with the lock held, which is released during the callback
+    auto report = [this, &reported]( preparse_lock& lock, item& it, int status )
+    {
+        bool orphaned = _orphaned;
+        lock.unlock();
+        if( it.media )
+            it.event->unregister();
+        if( _on_item && !orphaned )
+            _on_item( it.idx, status );
+        lock.lock();
+        ++reported;
+    };
+
+    preparse_lock lock( _sync );
+    while( reported < _items.size() ) {
+        bool progress = false;
+
+        if( _cancelled ) {
+            while( next < _items.size() ) {
+                report( lock, _items[next++], -1 );
+                progress = true;
+            }
+        }
+
+        while( running.size() < _concurrency && next < _items.size() ) {
+            auto& it = _items[next++];
+            lock.unlock();
+            bool started = start( it );
+            lock.lock();
+            if( started )
+                running.push_back( static_cast<size_t>( &it - _items.data() ) );
+            else
+                report( lock, it, -1 );
+            progress = true;
+        }
+
+        auto now = clock::now();
+        auto wake = clock::time_point::max();
+        for( auto r = running.begin(); r != running.end(); ) {
+            auto& it = _items[*r];
+            if( !it.parsed && !it.stopped && ( _cancelled || now >= it.deadline ) ) {
+                it.stopped = true;
+                it.deadline = now + preparse_stop_grace;
+                lock.unlock();
+                stop( it );
+                lock.lock();
+                progress = true;
+            }
+            else if( !it.parsed && it.stopped && now >= it.deadline ) {
+                // The parser didn't acknowledge the stop
+                it.parsed = true;
+                it.status = int( VLC::Media::ParsedStatus::Timeout );
+            }
+            if( it.parsed ) {
+                report( lock, it, it.status );
+                r = running.erase( r );
+                progress = true;
+                continue;
+            }
+            if( it.deadline < wake )
+                wake = it.deadline;
+            ++r;
+        }
+
+        // Only sleep if nothing changed while the lock was released
+        if( progress )
+            continue;
+        _sync.wait_until( wake );
+    }
+
+    _finished = true;
+    _sync.notify_finished();
 }
 
 std::shared_ptr<VLC::Media> vlc_player::get_media(unsigned int idx)
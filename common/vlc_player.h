@@ -23,6 +23,11 @@
 
 #include <vlcpp/vlc.hpp>
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
 enum vlc_player_action_e
 {
     pa_play,
@@ -32,6 +37,62 @@ enum vlc_player_action_e
     pa_prev
 };
 
+/*
+ * A batch of playlist items being preparsed, created by
+ * vlc_player::preparse_items_async().
+ *
+ * The items are parsed from a thread of the batch, a few at a time. Each one
+ * is reported once to the callback, from that thread, with its
+ * VLC::Media::ParsedStatus as an int, or -1 if the item doesn't exist, its
+ * parsing couldn't start, or the batch was cancelled before it started.
+ *
+ * Destroying the batch cancels it, and waits for it. When destroyed from the
+ * callback, it doesn't wait, and no other item is reported.
+ */
+class vlc_preparse_batch
+{
+public:
+    typedef std::function<void(unsigned int idx, int status)> item_cb;
+
+    ~vlc_preparse_batch();
+
+    vlc_preparse_batch(const vlc_preparse_batch&) = delete;
+    vlc_preparse_batch& operator=(const vlc_preparse_batch&) = delete;
+
+    // Stops the parsing items, and reports the others as failed
+    void cancel();
+    // Waits until all the items were reported
+    void wait();
+    bool finished();
+
+private:
+    friend class vlc_player;
+
+    typedef std::chrono::steady_clock clock;
+
+    struct item
+    {
+        unsigned int idx;
+        std::shared_ptr<VLC::Media> media;
+        VLC::EventManager::RegisteredEvent event;
+        clock::time_point deadline;
+        // Whether parseStop() was called
+        bool stopped;
+        // Set by the parsed event, under the batch lock
+        bool parsed;
+        int status;
+    };
+
+    // Shared with the batch thread
+    struct state;
+
+    vlc_preparse_batch(const VLC::Instance& instance, std::vector<item> items, int options,
+                       unsigned int timeout, unsigned int concurrency, item_cb on_item);
+
+private:
+    std::shared_ptr<state>  _state;
+};
+
 class vlc_player
 {
 public:
@@ -50,6 +111,17 @@ public:
 
     int preparse_item_sync(unsigned int idx, int options, unsigned int timeout);
 
+    /*
+     * Preparses the items at the given indexes, with at most concurrency of
+     * them at once. Each item gets timeout milliseconds, 0 meaning no limit,
+     * after which its parsing is stopped. The playlist is only locked while
+     * the items are looked up.
+     */
+    std::shared_ptr<vlc_preparse_batch> preparse_items_async(const std::vector<unsigned int>& idxs,
+                                                             int options, unsigned int timeout,
+                                                             unsigned int concurrency,
+                                                             vlc_preparse_batch::item_cb on_item);
+
     VLC::MediaPlayer& get_mp()
     {
         return _mp;
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * audioconverter.cpp: AudioConverter throughput benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/AudioConverter.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Converter = VLC::AudioConverter;
+using Format = Converter::SampleFormat;
+using Layout = Converter::Layout;
+using Clock = std::chrono::steady_clock;
+
+// The size of a block libvlc usually provides at 48kHz
+static const unsigned BlockFrames = 1024;
+static const unsigned NbBlocks = 20000;
+
+static std::string name( Layout l )
+{
+    std::string n = Converter::fourcc( l.format );
+    n += " " + std::to_string( l.channels ) + "ch";
+    if ( l.planar == true )
+        n += " planar";
+    return n;
+}
+
+// The benchmark runs on a single thread, so the throughput is per core.
+// Samples are counted on the input side.
+static void bench( Layout from, Layout to, Converter::Isa isa )
+{
+    Converter conv( from, to, Converter::Options(), isa );
+    std::vector<std::vector<uint8_t>> src( from.planar ? from.channels : 1 );
+    std::vector<std::vector<uint8_t>> dst( to.planar ? to.channels : 1 );
+    std::vector<const void*> srcPlanes;
+    std::vector<void*> dstPlanes;
+    for ( auto& s : src )
+    {
+        s.resize( BlockFrames * from.channels * Converter::sampleSize( from.format ) );
+        // Keep float samples within a sane range
+        for ( auto& b : s )
+            b = static_cast<uint8_t>( rand() & 0x3f );
+        srcPlanes.push_back( s.data() );
+    }
+    for ( auto& d : dst )
+    {
+        d.resize( BlockFrames * to.channels * Converter::sampleSize( to.format ) );
+        dstPlanes.push_back( d.data() );
+    }
+    // Warm up
+    conv.convert( srcPlanes.data(), dstPlanes.data(), BlockFrames );
+    auto start = Clock::now();
+    for ( auto i = 0u; i < NbBlocks; ++i )
+        conv.convert( srcPlanes.data(), dstPlanes.data(), BlockFrames );
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count();
+    auto msps = static_cast<double>( BlockFrames ) * from.channels * NbBlocks / static_cast<double>( us );
+    std::cout << "  " << std::setw( 16 ) << std::left << name( from ) << " -> " << std::setw( 16 )
+              << name( to ) << std::right << ": " << std::fixed << std::setprecision( 1 )
+              << std::setw( 8 ) << msps << " Msamples/s" << std::endl;
+}
+
+int main()
+{
+    const std::pair<Layout, Layout> conversions[] = {
+        { Layout( Format::S16, 2 ), Layout( Format::FL32, 2 ) },
+        { Layout( Format::FL32, 2 ), Layout( Format::S16, 2 ) },
+        { Layout( Format::S32, 2 ), Layout( Format::FL32, 2 ) },
+        { Layout( Format::FL32, 2 ), Layout( Format::S32, 2 ) },
+        { Layout( Format::S16, 2 ), Layout( Format::FL32, 2, true ) },
+        { Layout( Format::FL32, 2, true ), Layout( Format::S16, 2 ) },
+        { Layout( Format::FL32, 6 ), Layout( Format::FL32, 2 ) },
+        { Layout( Format::S16, 6 ), Layout( Format::S16, 2 ) },
+        { Layout( Format::S16, 2 ), Layout( Format::FL32, 6, true ) },
+    };
+    std::cout << NbBlocks << " blocks of " << BlockFrames << " frames, on a single core" << std::endl;
+    for ( auto isa : { Converter::Isa::Scalar, Converter::Isa::SSE2,
+                       Converter::Isa::AVX2, Converter::Isa::NEON } )
+    {
+        if ( Converter::isSupported( isa ) == false )
+            continue;
+        std::cout << Converter::isaName( isa ) << std::endl;
+        for ( const auto& c : conversions )
+            bench( c.first, c.second, isa );
+    }
+    return 0;
+}
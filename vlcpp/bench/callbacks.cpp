@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * callbacks.cpp: CallbackWrapper micro benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t NbCalls = 50000000;
+// Number of simulated players. With a single one, everything stays in the L1
+// cache, and the extra pointer hop is almost free. With many players, the
+// hop is likely to be a cache miss.
+static const size_t NbPlayers[] = { 1, 16384 };
+
+// Same prototype as libvlc_video_lock_cb
+using LockCb = void*(*)(void*, void**);
+
+// Mimics libvlc invoking a callback through a function pointer it can't inline
+static double run( LockCb cb, const std::vector<void*>& opaques )
+{
+    volatile LockCb fn = cb;
+    void* planes[1] = { nullptr };
+    auto nbOpaques = opaques.size();
+    auto start = Clock::now();
+    for ( auto i = 0u, o = 0u; i < NbCalls; ++i )
+    {
+        fn( opaques[o], planes );
+        if ( ++o == nbOpaques )
+            o = 0;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+    return static_cast<double>( ns ) / NbCalls;
+}
+
+// The previous storage: a heap allocated handler behind a virtual base, in an
+// array of unique_ptr
+namespace legacy
+{
+    struct CallbackHandlerBase
+    {
+        virtual ~CallbackHandlerBase() = default;
+    };
+
+    template <typename Func>
+    struct CallbackHandler : public CallbackHandlerBase
+    {
+        template <typename FuncFwd>
+        CallbackHandler(FuncFwd&& f) : func( std::forward<Func>( f ) ) {}
+        Func func;
+    };
+
+    template <size_t NbEvent>
+    using CallbackArray = std::array<std::unique_ptr<CallbackHandlerBase>, NbEvent>;
+
+    template <size_t Idx, size_t NbEvents, typename Func>
+    LockCb wrap( CallbackArray<NbEvents>& callbacks, Func&& func )
+    {
+        callbacks[Idx] = std::unique_ptr<CallbackHandler<Func>>( new CallbackHandler<Func>( std::forward<Func>( func ) ) );
+        return [](void* opaque, void** planes) -> void* {
+            auto& callbacks = *reinterpret_cast<CallbackArray<NbEvents>*>( opaque );
+            auto cbHandler = static_cast<CallbackHandler<Func>*>( callbacks[Idx].get() );
+            return cbHandler->func( planes );
+        };
+    }
+}
+
+struct RawContext
+{
+    uint8_t* buffer;
+    uint64_t nbCalls;
+};
+
+static void* rawLock( void* opaque, void** planes )
+{
+    auto ctx = static_cast<RawContext*>( opaque );
+    ++ctx->nbCalls;
+    *planes = ctx->buffer;
+    return nullptr;
+}
+
+int main()
+{
+    uint8_t buffer[16];
+    uint64_t nbCalls = 0;
+    auto lock = [&buffer, &nbCalls]( void** planes ) -> void* {
+        ++nbCalls;
+        *planes = buffer;
+        return nullptr;
+    };
+    using Lock = decltype(lock);
+    std::mt19937 rng( 42 );
+
+    std::cout << "Invoking a video lock callback " << NbCalls << " times (ns/call)" << std::endl;
+    std::cout << "players\traw C callback\tunique_ptr + virtual\tinline slot" << std::endl;
+    for ( auto nbPlayers : NbPlayers )
+    {
+        std::vector<RawContext> contexts( nbPlayers, RawContext{ buffer, 0 } );
+        std::vector<std::shared_ptr<legacy::CallbackArray<13>>> legacyArrays;
+        std::vector<std::shared_ptr<VLC::CallbackArray<13>>> arrays;
+        // Interleave unrelated allocations, as a real application would, so
+        // that the legacy handlers aren't packed next to their arrays.
+        std::vector<std::unique_ptr<char[]>> noise;
+        std::vector<void*> rawOpaques, legacyOpaques, opaques;
+        LockCb legacyCb = nullptr;
+        LockCb cb = nullptr;
+        for ( auto i = 0u; i < nbPlayers; ++i )
+        {
+            legacyArrays.push_back( std::make_shared<legacy::CallbackArray<13>>() );
+            noise.emplace_back( new char[64 + rng() % 512] );
+            legacyCb = legacy::wrap<11>( *legacyArrays.back(), Lock( lock ) );
+            arrays.push_back( std::make_shared<VLC::CallbackArray<13>>() );
+            cb = VLC::CallbackWrapper<11, LockCb>::wrap( *arrays.back(), Lock( lock ) );
+            rawOpaques.push_back( &contexts[i] );
+            legacyOpaques.push_back( legacyArrays.back().get() );
+            opaques.push_back( arrays.back().get() );
+        }
+        // Don't let the hardware prefetcher guess the next player
+        std::shuffle( begin( rawOpaques ), end( rawOpaques ), rng );
+        std::shuffle( begin( legacyOpaques ), end( legacyOpaques ), rng );
+        std::shuffle( begin( opaques ), end( opaques ), rng );
+
+        auto raw = run( &rawLock, rawOpaques );
+        auto legacyTime = run( legacyCb, legacyOpaques );
+        auto inlineTime = run( cb, opaques );
+        std::cout << nbPlayers << "\t" << raw << "\t\t" << legacyTime
+                  << "\t\t\t" << inlineTime << std::endl;
+    }
+    return nbCalls > 0 ? 0 : 1;
+}
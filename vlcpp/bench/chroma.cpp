@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * chroma.cpp: ChromaConverter throughput benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/ChromaConverter.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using Converter = VLC::ChromaConverter;
+using Format = Converter::Format;
+using Clock = std::chrono::steady_clock;
+
+static const unsigned Width = 1920;
+static const unsigned Height = 1080;
+static const unsigned NbFrames = 100;
+
+static const char* name( Format f )
+{
+    switch ( f )
+    {
+    case Format::I420:
+        return "I420";
+    case Format::NV12:
+        return "NV12";
+    case Format::P010:
+        return "P010";
+    case Format::RGBA:
+        return "RGBA";
+    case Format::BGRA:
+        return "BGRA";
+    default:
+        return "RGB24";
+    }
+}
+
+// A 1080p picture, with 64 bytes aligned lines
+struct Picture
+{
+    explicit Picture( Format f )
+    {
+        unsigned bytes[3] = { 0, 0, 0 };
+        unsigned lines[3] = { Height, Height / 2, Height / 2 };
+        switch ( f )
+        {
+        case Format::I420:
+            bytes[0] = Width;
+            bytes[1] = bytes[2] = Width / 2;
+            break;
+        case Format::NV12:
+            bytes[0] = bytes[1] = Width;
+            break;
+        case Format::P010:
+            bytes[0] = bytes[1] = Width * 2;
+            break;
+        case Format::RGB24:
+            bytes[0] = Width * 3;
+            break;
+        default:
+            bytes[0] = Width * 4;
+            break;
+        }
+        for ( auto i = 0u; i < 3; ++i )
+        {
+            img.pitches[i] = ( bytes[i] + 63 ) & ~63u;
+            buffers[i].resize( img.pitches[i] * lines[i] + 64 );
+            for ( auto& b : buffers[i] )
+                b = static_cast<uint8_t>( rand() & 0xc0 );
+            auto addr = reinterpret_cast<uintptr_t>( buffers[i].data() );
+            img.planes[i] = buffers[i].data() + ( ( 64 - addr % 64 ) % 64 );
+        }
+    }
+
+    std::vector<uint8_t> buffers[3];
+    Converter::Image img;
+};
+
+static void bench( Format from, Format to, Converter::Isa isa )
+{
+    Converter conv( from, to, Converter::Matrix::BT709, Converter::Range::Limited, isa );
+    Picture src( from );
+    Picture dst( to );
+    // Warm up
+    conv.convert( src.img, dst.img, Width, Height );
+    auto start = Clock::now();
+    for ( auto i = 0u; i < NbFrames; ++i )
+        conv.convert( src.img, dst.img, Width, Height );
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count();
+    auto mps = static_cast<double>( Width ) * Height * NbFrames / static_cast<double>( us );
+    std::cout << "  " << std::setw( 5 ) << name( from ) << " -> " << std::setw( 5 ) << std::left
+              << name( to ) << std::right << ": " << std::fixed << std::setprecision( 1 )
+              << std::setw( 8 ) << mps << " MP/s" << std::endl;
+}
+
+int main()
+{
+    const Format yuvFormats[] = { Format::I420, Format::NV12, Format::P010 };
+    const Format rgbFormats[] = { Format::RGBA, Format::BGRA, Format::RGB24 };
+    std::cout << Width << "x" << Height << ", " << NbFrames << " frames per conversion" << std::endl;
+    for ( auto isa : { Converter::Isa::Scalar, Converter::Isa::SSE2,
+                       Converter::Isa::AVX2, Converter::Isa::NEON } )
+    {
+        if ( Converter::isSupported( isa ) == false )
+            continue;
+        std::cout << Converter::isaName( isa ) << std::endl;
+        for ( auto yuv : yuvFormats )
+            for ( auto rgb : rgbFormats )
+                bench( yuv, rgb, isa );
+        for ( auto rgb : rgbFormats )
+            for ( auto yuv : yuvFormats )
+                bench( rgb, yuv, isa );
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*****************************************************************************
+ * events.cpp: EventManager micro benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Count every allocation going through the C++ runtime. libvlc's own
+// allocations (ie. the listener it creates when attaching an event) don't
+// go through operator new and aren't accounted for.
+static std::atomic<size_t> nbAllocs{ 0 };
+
+void* operator new( size_t size )
+{
+    ++nbAllocs;
+    auto ptr = malloc( size );
+    if ( ptr == nullptr )
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    free( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept
+{
+    free( ptr );
+}
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t NbCycles = 100000;
+// Number of handlers registered at the same time, to mimic a control layer
+// swapping its handlers when the played item changes
+static const size_t NbHandlers = 24;
+
+static void report( const char* name, size_t allocs, Clock::duration d )
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( d ).count();
+    std::cout << name << ": "
+              << static_cast<double>( allocs ) / ( NbCycles * NbHandlers ) << " allocations/cycle, "
+              << static_cast<double>( ns ) / ( NbCycles * NbHandlers ) << " ns/cycle" << std::endl;
+}
+
+// Mimics the previous storage: one heap allocated handler per registration,
+// and a linear search upon unregistration.
+struct LegacyHandlerBase
+{
+    virtual ~LegacyHandlerBase() = default;
+};
+
+template <typename Func>
+struct LegacyHandler : public LegacyHandlerBase
+{
+    LegacyHandler( libvlc_event_manager_t* em, Func f )
+        : func( std::move( f ) ), em( em )
+    {
+        libvlc_event_attach( em, libvlc_MediaPlayerTimeChanged, &LegacyHandler::callback, &func );
+    }
+    ~LegacyHandler()
+    {
+        libvlc_event_detach( em, libvlc_MediaPlayerTimeChanged, &LegacyHandler::callback, &func );
+    }
+    static void callback( const libvlc_event_t* e, void* data )
+    {
+        (*static_cast<Func*>( data ))( e->u.media_player_time_changed.new_time );
+    }
+    Func func;
+    libvlc_event_manager_t* em;
+};
+
+static void benchLegacy( libvlc_event_manager_t* em )
+{
+    std::vector<std::unique_ptr<LegacyHandlerBase>> handlers;
+    std::vector<LegacyHandlerBase*> registered;
+    handlers.reserve( NbHandlers );
+    registered.reserve( NbHandlers );
+    int64_t sink = 0;
+    auto f = [&sink]( int64_t t ) { sink += t; };
+
+    auto allocsBefore = nbAllocs.load();
+    auto start = Clock::now();
+    for ( auto c = 0u; c < NbCycles; ++c )
+    {
+        for ( auto i = 0u; i < NbHandlers; ++i )
+        {
+            handlers.emplace_back( new LegacyHandler<decltype(f)>( em, f ) );
+            registered.push_back( handlers.back().get() );
+        }
+        for ( auto h : registered )
+        {
+            auto it = std::find_if( begin( handlers ), end( handlers ),
+                                    [h]( const std::unique_ptr<LegacyHandlerBase>& p ) {
+                return p.get() == h;
+            });
+            handlers.erase( it );
+        }
+        registered.clear();
+    }
+    report( "legacy unique_ptr storage", nbAllocs.load() - allocsBefore, Clock::now() - start );
+}
+
+static void benchStore( VLC::MediaPlayerEventManager& em )
+{
+    std::vector<VLC::EventManager::RegisteredEvent> registered;
+    registered.reserve( NbHandlers );
+    int64_t sink = 0;
+    auto f = [&sink]( int64_t t ) { sink += t; };
+
+    // Warm up, so that the store reaches its working size
+    for ( auto i = 0u; i < NbHandlers; ++i )
+        registered.push_back( em.onTimeChanged( f ) );
+    for ( const auto& h : registered )
+        h.unregister();
+    registered.clear();
+
+    auto allocsBefore = nbAllocs.load();
+    auto start = Clock::now();
+    for ( auto c = 0u; c < NbCycles; ++c )
+    {
+        for ( auto i = 0u; i < NbHandlers; ++i )
+            registered.push_back( em.onTimeChanged( f ) );
+        for ( const auto& h : registered )
+            h.unregister();
+        registered.clear();
+    }
+    report( "slab storage", nbAllocs.load() - allocsBefore, Clock::now() - start );
+}
+
+// libvlc raises libvlc_MediaMetaChanged synchronously from
+// libvlc_media_set_meta, which lets us measure the dispatch cost without
+// having to play anything.
+static const size_t NbEvents = 20000;
+
+static double timeMetaChanges( VLC::Media& media )
+{
+    auto start = Clock::now();
+    for ( auto i = 0u; i < NbEvents; ++i )
+        media.setMeta( libvlc_meta_Title, "title" );
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+    return static_cast<double>( ns ) / NbEvents;
+}
+
+static void onMetaChangedRaw( const libvlc_event_t* e, void* data )
+{
+    *static_cast<int*>( data ) += e->u.media_meta_changed.meta_type;
+}
+
+static void benchDispatch( VLC::Media& media )
+{
+    auto rawEm = libvlc_media_event_manager( media );
+    auto baseline = timeMetaChanges( media );
+    std::vector<int> sinks( 64 );
+
+    std::cout << std::endl << "Dispatch cost per event, excluding libvlc_media_set_meta ("
+              << baseline << " ns)" << std::endl;
+    std::cout << "subscribers\tone attachment each (ns)\tfan-out (ns)" << std::endl;
+    for ( auto nbSubscribers = 1u; nbSubscribers <= sinks.size(); nbSubscribers *= 2 )
+    {
+        // Previous behavior: one libvlc listener per subscriber
+        for ( auto i = 0u; i < nbSubscribers; ++i )
+            libvlc_event_attach( rawEm, libvlc_MediaMetaChanged, &onMetaChangedRaw, &sinks[i] );
+        auto attached = timeMetaChanges( media ) - baseline;
+        for ( auto i = 0u; i < nbSubscribers; ++i )
+            libvlc_event_detach( rawEm, libvlc_MediaMetaChanged, &onMetaChangedRaw, &sinks[i] );
+
+        // A single libvlc listener, fanning out to our subscribers
+        auto em = media.eventManager();
+        for ( auto i = 0u; i < nbSubscribers; ++i )
+        {
+            auto sink = &sinks[i];
+            em.onMetaChanged( [sink]( libvlc_meta_t m ) { *sink += m; } );
+        }
+        auto fanOut = timeMetaChanges( media ) - baseline;
+
+        std::cout << nbSubscribers << "\t\t" << attached << "\t\t\t\t" << fanOut << std::endl;
+    }
+}
+
+int main()
+{
+    auto instance = VLC::Instance( 0, nullptr );
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    auto media = VLC::Media( "bench://events", VLC::Media::FromLocation );
+#else
+    auto media = VLC::Media( instance, "bench://events", VLC::Media::FromLocation );
+#endif
+    auto mp = VLC::MediaPlayer( instance );
+    auto& em = mp.eventManager();
+
+    std::cout << "Register/unregister cycles (" << NbHandlers << " handlers x "
+              << NbCycles << " rounds)" << std::endl;
+    benchLegacy( em );
+    benchStore( em );
+    benchDispatch( media );
+}
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * handles.cpp: Media & MediaPlayer handle micro benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+
+static std::atomic<size_t> nbAllocs{ 0 };
+
+void* operator new( size_t size )
+{
+    ++nbAllocs;
+    auto ptr = malloc( size );
+    if ( ptr == nullptr )
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    free( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept
+{
+    free( ptr );
+}
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t NbIterations = 10000000;
+
+template <typename Func>
+static void bench( const char* name, Func f )
+{
+    auto allocsBefore = nbAllocs.load();
+    auto start = Clock::now();
+    for ( auto i = 0u; i < NbIterations; ++i )
+        f();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+    std::cout << name << ": " << static_cast<double>( ns ) / NbIterations << " ns, "
+              << static_cast<double>( nbAllocs.load() - allocsBefore ) / NbIterations
+              << " allocations" << std::endl;
+}
+
+// The previous ownership model: a shared_ptr with the libvlc release function
+// as its deleter, on top of libvlc's own reference counter.
+template <typename T>
+static void benchSharedPtr( const char* name, T* raw, void (*retain)(T*), void (*release)(T*) )
+{
+    retain( raw );
+    std::shared_ptr<T> ptr( raw, release );
+    std::cout << name << " (std::shared_ptr emulation)" << std::endl;
+    bench( "  copy + destroy", [&ptr]() {
+        auto copy = ptr;
+        (void)copy;
+    });
+    bench( "  move + move back", [&ptr]() {
+        auto moved = std::move( ptr );
+        ptr = std::move( moved );
+    });
+    bench( "  wrap a raw pointer + destroy", [raw, retain, release]() {
+        retain( raw );
+        std::shared_ptr<T> p( raw, release );
+    });
+}
+
+template <typename T>
+static void benchHandle( const char* name, T& handle )
+{
+    std::cout << name << std::endl;
+    bench( "  copy + destroy", [&handle]() {
+        auto copy = handle;
+        (void)copy;
+    });
+    bench( "  move + move back", [&handle]() {
+        auto moved = std::move( handle );
+        handle = std::move( moved );
+    });
+}
+
+int main()
+{
+    auto instance = VLC::Instance( 0, nullptr );
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    auto media = VLC::Media( "bench://handles", VLC::Media::FromLocation );
+#else
+    auto media = VLC::Media( instance, "bench://handles", VLC::Media::FromLocation );
+#endif
+    auto mp = VLC::MediaPlayer( instance );
+
+    std::cout << NbIterations << " iterations, per iteration:" << std::endl;
+
+    benchHandle( "VLC::Media", media );
+    bench( "  wrap a raw pointer + destroy", [&media]() {
+        VLC::Media m( media.get(), true );
+    });
+    benchSharedPtr<libvlc_media_t>( "libvlc_media_t", media.get(),
+                                    []( libvlc_media_t* m ) { libvlc_media_retain( m ); },
+                                    &libvlc_media_release );
+
+    benchHandle( "VLC::MediaPlayer", mp );
+    benchSharedPtr<libvlc_media_player_t>( "libvlc_media_player_t", mp.get(),
+                                           &libvlc_media_player_retain,
+                                           &libvlc_media_player_release );
+    return 0;
+}
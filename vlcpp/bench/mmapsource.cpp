@@ -0,0 +1,131 @@
+/*****************************************************************************
+ * mmapsource.cpp: MmapSource throughput against the stdio imem path
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#if !defined(_WIN32)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/MmapSource.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Reads the file as the imem example does
+static size_t readStdio( const std::string& path, size_t chunkSize )
+{
+    auto f = fopen( path.c_str(), "rb" );
+    if ( f == nullptr )
+        abort();
+    std::vector<unsigned char> buf( chunkSize );
+    size_t total = 0;
+    size_t n;
+    while ( ( n = fread( buf.data(), 1, buf.size(), f ) ) > 0 )
+        total += n;
+    fclose( f );
+    return total;
+}
+
+static size_t readMmap( const VLC::MmapSource& source, size_t chunkSize )
+{
+    auto stream = source.open();
+    if ( stream == nullptr )
+        abort();
+    std::vector<unsigned char> buf( chunkSize );
+    size_t total = 0;
+    ptrdiff_t n;
+    while ( ( n = stream->read( buf.data(), buf.size() ) ) > 0 )
+        total += static_cast<size_t>( n );
+    return total;
+}
+
+// Each reader reads the whole file, from its own thread
+template <typename Read>
+static double bench( unsigned nbReaders, size_t fileSize, Read read )
+{
+    auto start = Clock::now();
+    std::vector<std::thread> readers;
+    for ( auto i = 0u; i < nbReaders; ++i )
+        readers.emplace_back( [&read, fileSize]() {
+            if ( read() != fileSize )
+                abort();
+        } );
+    for ( auto& t : readers )
+        t.join();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count();
+    return static_cast<double>( fileSize ) * nbReaders / static_cast<double>( us );
+}
+
+int main( int argc, char** argv )
+{
+    size_t sizeMb = argc > 1 ? strtoul( argv[1], nullptr, 10 ) : 256;
+    auto fileSize = sizeMb * 1024 * 1024;
+    char path[] = "/tmp/vlcpp-bench-mmap-XXXXXX";
+    auto fd = mkstemp( path );
+    if ( fd < 0 )
+        return 1;
+    std::vector<unsigned char> block( 1024 * 1024 );
+    for ( auto& b : block )
+        b = static_cast<unsigned char>( rand() );
+    for ( auto i = 0u; i < sizeMb; ++i )
+        if ( write( fd, block.data(), block.size() ) != static_cast<ssize_t>( block.size() ) )
+            return 1;
+    close( fd );
+
+    VLC::MmapSource source( path );
+    // Have the whole file in the page cache, to measure the read paths rather
+    // than the storage
+    readStdio( path, 1 << 20 );
+    std::cout << sizeMb << "MB file, from the page cache, MB/s summed over the readers" << std::endl;
+    std::cout << "readers   chunk     stdio      mmap" << std::endl;
+    for ( auto nbReaders : { 1u, 16u } )
+    {
+        for ( size_t chunk : { 4096u, 32768u, 262144u } )
+        {
+            auto stdio = bench( nbReaders, fileSize, [&path, chunk]() { return readStdio( path, chunk ); } );
+            auto mmap = bench( nbReaders, fileSize, [&source, chunk]() { return readMmap( source, chunk ); } );
+            std::cout << std::setw( 7 ) << nbReaders << std::setw( 8 ) << chunk
+                      << std::fixed << std::setprecision( 0 )
+                      << std::setw( 10 ) << stdio << std::setw( 10 ) << mmap << std::endl;
+        }
+    }
+    unlink( path );
+    return 0;
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+    std::cout << "The memory mapped file source is POSIX only" << std::endl;
+    return 0;
+}
+
+#endif
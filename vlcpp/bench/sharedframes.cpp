@@ -0,0 +1,288 @@
+/*****************************************************************************
+ * sharedframes.cpp: Cross process frame export benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#if defined(__linux__)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/SharedFramePublisher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Publisher = VLC::SharedFramePublisher;
+using Reader = VLC::SharedFrameReader;
+
+static const unsigned Width = 1920;
+static const unsigned Height = 1080;
+static const size_t FrameSize = Width * Height * 4;
+static const unsigned NbFrames = 300;
+// Keeps the readers' processing from being optimized out
+static volatile uint64_t Sink;
+
+// What each reader process reports to the parent
+struct Result
+{
+    uint64_t received;
+    uint64_t skipped;
+    int64_t p50;
+    int64_t p99;
+    int64_t max;
+};
+
+static Result summarize( std::vector<int64_t>& latencies, uint64_t skipped )
+{
+    Result r;
+    r.received = latencies.size();
+    r.skipped = skipped;
+    r.p50 = r.p99 = r.max = 0;
+    if ( latencies.empty() == false )
+    {
+        std::sort( begin( latencies ), end( latencies ) );
+        r.p50 = latencies[latencies.size() / 2];
+        r.p99 = latencies[latencies.size() * 99 / 100];
+        r.max = latencies.back();
+    }
+    return r;
+}
+
+static void report( const char* name, unsigned nbReaders, bool paced, int64_t us,
+                    const std::vector<Result>& results )
+{
+    std::cout << "  " << std::setw( 5 ) << std::left << name << std::right << " "
+              << nbReaders << " reader(s), " << ( paced ? "60 fps" : "burst " ) << ": "
+              << std::fixed << std::setprecision( 1 ) << std::setw( 7 )
+              << NbFrames * 1e6 / us << " frames/s" << std::endl;
+    for ( const auto& r : results )
+        std::cout << "      received " << std::setw( 4 ) << r.received << ", skipped "
+                  << std::setw( 4 ) << r.skipped << ", latency p50 " << std::setw( 6 ) << r.p50
+                  << " us, p99 " << std::setw( 6 ) << r.p99 << " us, max " << std::setw( 6 )
+                  << r.max << " us" << std::endl;
+}
+
+static void pace( bool paced, int64_t start, unsigned i )
+{
+    if ( paced == false )
+        return;
+    auto target = start + static_cast<int64_t>( i ) * 1000000 / 60;
+    auto now = Reader::now();
+    if ( target > now )
+        usleep( static_cast<useconds_t>( target - now ) );
+}
+
+// Writes a complete result to the parent, or fails the reader process
+static void sendResult( int fd, const Result& r )
+{
+    if ( write( fd, &r, sizeof( r ) ) != sizeof( r ) )
+        _exit( 1 );
+    _exit( 0 );
+}
+
+static std::vector<Result> collect( int fd, const std::vector<pid_t>& pids )
+{
+    std::vector<Result> results;
+    for ( auto i = 0u; i < pids.size(); ++i )
+    {
+        Result r;
+        if ( read( fd, &r, sizeof( r ) ) == sizeof( r ) )
+            results.push_back( r );
+    }
+    for ( auto pid : pids )
+        waitpid( pid, nullptr, 0 );
+    return results;
+}
+
+// libvlc decodes into the shared ring; readers access the frames in place
+static void benchShared( unsigned nbReaders, bool paced )
+{
+    Publisher::Configuration config;
+    config.chroma = "RV32";
+    config.width = Width;
+    config.height = Height;
+    std::unique_ptr<Publisher> pub( new Publisher( config ) );
+    char chroma[5] = "RV32";
+    uint32_t width = Width, height = Height;
+    uint32_t pitches[5], lines[5];
+    pub->setup( chroma, &width, &height, pitches, lines );
+
+    int results[2], ready[2];
+    if ( pipe( results ) != 0 || pipe( ready ) != 0 )
+        return;
+    std::vector<pid_t> pids;
+    for ( auto i = 0u; i < nbReaders; ++i )
+    {
+        auto pid = fork();
+        if ( pid != 0 )
+        {
+            pids.push_back( pid );
+            continue;
+        }
+        Reader reader( pub->fd() );
+        char c = 0;
+        if ( write( ready[1], &c, 1 ) != 1 )
+            _exit( 1 );
+        std::vector<int64_t> latencies;
+        latencies.reserve( NbFrames );
+        Reader::Frame f;
+        uint64_t sum = 0;
+        do
+        {
+            while ( reader.next( f ) == true )
+            {
+                latencies.push_back( Reader::now() - f.date );
+                // Stands for some lightweight processing of the frame
+                for ( auto x = 0u; x < f.pitch( 0 ); x += 64 )
+                    sum += f.plane( 0 )[x];
+                reader.valid( f );
+            }
+        } while ( reader.wait( std::chrono::seconds( 5 ) ) == true );
+        Sink = sum;
+        sendResult( results[1], summarize( latencies, reader.stats().skipped ) );
+    }
+    for ( auto i = 0u; i < nbReaders; ++i )
+    {
+        char c;
+        if ( read( ready[0], &c, 1 ) != 1 )
+            return;
+    }
+
+    auto start = Reader::now();
+    for ( auto i = 0u; i < NbFrames; ++i )
+    {
+        pace( paced, start, i );
+        void* planes[5];
+        auto pic = pub->lock( planes );
+        // Stands for the decoder writing the picture
+        memset( planes[0], static_cast<int>( i ), FrameSize );
+        pub->display( pic );
+    }
+    auto us = Reader::now() - start;
+    pub.reset();
+    report( "shm", nbReaders, paced, us, collect( results[0], pids ) );
+    for ( auto fd : { results[0], results[1], ready[0], ready[1] } )
+        close( fd );
+}
+
+// The copying approach: each frame is written to a pipe per reader
+static void benchPipe( unsigned nbReaders, bool paced )
+{
+    int results[2];
+    if ( pipe( results ) != 0 )
+        return;
+    std::vector<int> writers;
+    std::vector<pid_t> pids;
+    for ( auto i = 0u; i < nbReaders; ++i )
+    {
+        int fds[2];
+        if ( pipe( fds ) != 0 )
+            return;
+        auto pid = fork();
+        if ( pid != 0 )
+        {
+            close( fds[0] );
+            writers.push_back( fds[1] );
+            pids.push_back( pid );
+            continue;
+        }
+        close( fds[1] );
+        // Otherwise the previous readers wouldn't see the end of their pipe
+        for ( auto fd : writers )
+            close( fd );
+        std::vector<uint8_t> frame( FrameSize );
+        std::vector<int64_t> latencies;
+        latencies.reserve( NbFrames );
+        while ( true )
+        {
+            size_t done = 0;
+            while ( done < FrameSize )
+            {
+                auto n = read( fds[0], frame.data() + done, FrameSize - done );
+                if ( n <= 0 )
+                    break;
+                done += static_cast<size_t>( n );
+            }
+            if ( done < FrameSize )
+                break;
+            int64_t date;
+            memcpy( &date, frame.data(), sizeof( date ) );
+            latencies.push_back( Reader::now() - date );
+        }
+        sendResult( results[1], summarize( latencies, 0 ) );
+    }
+
+    std::vector<uint8_t> frame( FrameSize );
+    auto start = Reader::now();
+    for ( auto i = 0u; i < NbFrames; ++i )
+    {
+        pace( paced, start, i );
+        memset( frame.data(), static_cast<int>( i ), FrameSize );
+        auto date = Reader::now();
+        memcpy( frame.data(), &date, sizeof( date ) );
+        for ( auto fd : writers )
+        {
+            size_t done = 0;
+            while ( done < FrameSize )
+            {
+                auto n = write( fd, frame.data() + done, FrameSize - done );
+                if ( n <= 0 )
+                    return;
+                done += static_cast<size_t>( n );
+            }
+        }
+    }
+    auto us = Reader::now() - start;
+    for ( auto fd : writers )
+        close( fd );
+    report( "pipe", nbReaders, paced, us, collect( results[0], pids ) );
+    close( results[0] );
+    close( results[1] );
+}
+
+int main()
+{
+    std::cout << Width << "x" << Height << " RV32, " << NbFrames << " frames" << std::endl;
+    for ( auto paced : { false, true } )
+    {
+        for ( auto nbReaders : { 1u, 4u } )
+        {
+            benchShared( nbReaders, paced );
+            benchPipe( nbReaders, paced );
+        }
+    }
+    return 0;
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+    std::cout << "The shared memory frame ring is Linux only" << std::endl;
+    return 0;
+}
+
+#endif
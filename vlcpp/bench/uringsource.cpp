@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * uringsource.cpp: Compares the io_uring file source with the stdio reads
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#if defined(__linux__)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/UringSource.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// The size of the reads, as libvlc's demuxers typically request
+static const size_t ReadSize = 32768;
+
+// Reads the file as the imem example does
+static size_t readStdio( const std::string& path )
+{
+    auto f = fopen( path.c_str(), "rb" );
+    if ( f == nullptr )
+        abort();
+    std::vector<unsigned char> buf( ReadSize );
+    size_t total = 0;
+    size_t n;
+    while ( ( n = fread( buf.data(), 1, buf.size(), f ) ) > 0 )
+        total += n;
+    fclose( f );
+    return total;
+}
+
+static size_t readSource( const VLC::UringSource& source )
+{
+    auto stream = source.open();
+    if ( stream == nullptr )
+        abort();
+    std::vector<unsigned char> buf( ReadSize );
+    size_t total = 0;
+    ptrdiff_t n;
+    while ( ( n = stream->read( buf.data(), buf.size() ) ) > 0 )
+        total += static_cast<size_t>( n );
+    if ( n < 0 )
+        abort();
+    return total;
+}
+
+// Drops the pages of the file from the page cache
+static void evict( const std::string& path )
+{
+    auto fd = open( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        abort();
+    fdatasync( fd );
+    posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+    close( fd );
+}
+
+// Each player reads the whole file, from its own thread
+template <typename Read>
+static double bench( unsigned nbPlayers, size_t fileSize, const std::string& path, bool cold,
+                     Read read )
+{
+    if ( cold == true )
+        evict( path );
+    auto start = Clock::now();
+    std::vector<std::thread> players;
+    for ( auto i = 0u; i < nbPlayers; ++i )
+        players.emplace_back( [&read, fileSize]() {
+            if ( read() != fileSize )
+                abort();
+        } );
+    for ( auto& t : players )
+        t.join();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count();
+    return static_cast<double>( fileSize ) * nbPlayers / static_cast<double>( us );
+}
+
+int main( int argc, char** argv )
+{
+    size_t sizeMb = argc > 1 ? strtoul( argv[1], nullptr, 10 ) : 32;
+    auto fileSize = sizeMb * 1024 * 1024;
+    char path[] = "/var/tmp/vlcpp-bench-uring-XXXXXX";
+    auto fd = mkstemp( path );
+    if ( fd < 0 )
+        return 1;
+    std::vector<unsigned char> block( 1024 * 1024 );
+    for ( auto& b : block )
+        b = static_cast<unsigned char>( rand() );
+    for ( auto i = 0u; i < sizeMb; ++i )
+        if ( write( fd, block.data(), block.size() ) != static_cast<ssize_t>( block.size() ) )
+            return 1;
+    close( fd );
+
+    auto ring = VLC::IoUring::shared();
+    VLC::IoUring::Configuration fallbackConfig;
+    fallbackConfig.forcePread = true;
+    auto fallback = std::make_shared<VLC::IoUring>( fallbackConfig );
+    VLC::UringSource::Configuration directConfig;
+    directConfig.direct = true;
+    VLC::UringSource uring( path );
+    VLC::UringSource direct( path, directConfig );
+    VLC::UringSource pread( path, VLC::UringSource::Configuration(), fallback );
+
+    std::cout << sizeMb << "MB file, " << ReadSize / 1024 << "KB reads, MB/s summed over the players"
+              << std::endl;
+    std::cout << "io_uring: " << ( ring->available() ? "yes" : "no" )
+              << ", registered buffers: " << ( ring->fixedBuffers() ? "yes" : "no" ) << std::endl;
+    // From the page cache, then with the file evicted before each run
+    for ( auto cold : { false, true } )
+    {
+        if ( cold == false )
+            readStdio( path );
+        std::cout << ( cold ? "cold" : "warm" ) << " players     stdio     uring    direct     pread"
+                  << std::endl;
+        for ( auto nbPlayers : { 1u, 16u, 128u } )
+        {
+            auto s = bench( nbPlayers, fileSize, path, cold, [&path]() { return readStdio( path ); } );
+            auto u = bench( nbPlayers, fileSize, path, cold, [&uring]() { return readSource( uring ); } );
+            auto d = bench( nbPlayers, fileSize, path, cold, [&direct]() { return readSource( direct ); } );
+            auto p = bench( nbPlayers, fileSize, path, cold, [&pread]() { return readSource( pread ); } );
+            std::cout << std::setw( 12 ) << nbPlayers << std::fixed << std::setprecision( 0 )
+                      << std::setw( 10 ) << s << std::setw( 10 ) << u
+                      << std::setw( 10 ) << d << std::setw( 10 ) << p << std::endl;
+        }
+    }
+    auto stats = ring->stats();
+    std::cout << "io_uring: " << stats.requests << " reads in " << stats.submissions
+              << " submissions, " << stats.fixedReads << " in registered buffers" << std::endl;
+    unlink( path );
+    return 0;
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+    std::cout << "io_uring is only available on Linux" << std::endl;
+    return 0;
+}
+
+#endif
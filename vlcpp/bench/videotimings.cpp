@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * videotimings.cpp: VideoTimings overhead benchmarks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/VideoTimings.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static const unsigned NbFrames = 5000000;
+
+// Invokes the callbacks in libvlc's 4.x order, for each frame
+static double run( const std::function<void*(void**)>& lock,
+                   const std::function<void(void*, void* const*)>& unlock,
+                   const std::function<void(void*)>& display )
+{
+    void* planes[3];
+    auto start = Clock::now();
+    for ( auto i = 0u; i < NbFrames; ++i )
+    {
+        auto pic = lock( planes );
+        unlock( pic, planes );
+        display( pic );
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+    return static_cast<double>( ns ) / NbFrames;
+}
+
+static void benchHistogram()
+{
+    VLC::LatencyHistogram h;
+    for ( auto exclusive : { false, true } )
+    {
+        auto start = Clock::now();
+        for ( auto i = 0u; i < NbFrames; ++i )
+        {
+            if ( exclusive == true )
+                h.recordExclusive( i & 0xffff );
+            else
+                h.record( i & 0xffff );
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - start ).count();
+        std::cout << "  LatencyHistogram::" << ( exclusive ? "recordExclusive: " : "record:          " )
+                  << std::fixed << std::setprecision( 1 )
+                  << static_cast<double>( ns ) / NbFrames << " ns" << std::endl;
+    }
+}
+
+int main()
+{
+    int pictures[4];
+    unsigned next = 0;
+    auto lock = [&]( void** planes ) -> void* {
+        planes[0] = &pictures[next];
+        return &pictures[next++ & 3];
+    };
+    auto unlock = []( void*, void* const* ) {};
+    auto display = []( void* ) {};
+
+    auto base = run( lock, unlock, display );
+    VLC::VideoTimings timings;
+    auto c = timings.decorate( lock, unlock, display );
+    auto decorated = run( c.lock, c.unlock, c.display );
+    auto s = timings.snapshot();
+
+    std::cout << NbFrames << " frames" << std::endl
+              << std::fixed << std::setprecision( 1 )
+              << "  plain callbacks:     " << std::setw( 6 ) << base << " ns/frame" << std::endl
+              << "  decorated callbacks: " << std::setw( 6 ) << decorated << " ns/frame" << std::endl
+              << "  overhead:            " << std::setw( 6 ) << decorated - base << " ns/frame" << std::endl
+              << "  (recorded " << s.displayInterval.count << " intervals, p50 "
+              << s.displayInterval.p50 << " ns)" << std::endl;
+    benchHistogram();
+    return 0;
+}
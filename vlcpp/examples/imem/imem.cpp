@@ -1,4 +1,7 @@
 #include "vlcpp/vlc.hpp"
+#if !defined(_WIN32)
+# include "vlcpp/MmapSource.hpp"
+#endif
 #include <thread>
 #include <cstring>
 #include <cstdio>
@@ -19,6 +22,14 @@ int main(int ac, char**av)
         return 1;
     }
     auto instance = VLC::Instance(0, nullptr);
+#if !defined(_WIN32)
+    // Let the library map the file, rather than going through stdio
+# if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    auto imemMedia = VLC::mediaFromSource( VLC::MmapSource( av[1] ) );
+# else
+    auto imemMedia = VLC::mediaFromSource( instance, VLC::MmapSource( av[1] ) );
+# endif
+#else
     auto dummyOpaque = new ImemOpaque{};
     dummyOpaque->path = av[1];
 #if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
@@ -54,6 +65,8 @@ int main(int ac, char**av)
             fclose( context->file );
         });
 
+#endif
+
     auto opaque2 = new ImemOpaque{};
     opaque2->file = fopen( av[2], "rb" );
 
@@ -102,7 +115,9 @@ int main(int ac, char**av)
     mp2.stop();
 #endif
 
+#if defined(_WIN32)
     delete dummyOpaque;
+#endif
     fclose(opaque2->file);
     delete opaque2;
 }
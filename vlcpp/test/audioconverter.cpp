@@ -0,0 +1,351 @@
+/*****************************************************************************
+ * audioconverter.cpp: AudioConverter unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/AudioConverter.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using Converter = VLC::AudioConverter;
+using Format = Converter::SampleFormat;
+using Layout = Converter::Layout;
+using Isa = Converter::Isa;
+
+static const Isa isas[] = { Isa::SSE2, Isa::AVX2, Isa::NEON };
+
+// Samples of any format, with a buffer per plane
+struct Buffer
+{
+    Buffer( Layout l, size_t frames )
+        : layout( l )
+    {
+        auto nbPlanes = l.planar ? l.channels : 1u;
+        auto planeSize = Converter::sampleSize( l.format ) * frames * ( l.planar ? 1 : l.channels );
+        for ( auto p = 0u; p < nbPlanes; ++p )
+            data.emplace_back( planeSize );
+        for ( auto& d : data )
+        {
+            planes.push_back( d.data() );
+            cplanes.push_back( d.data() );
+        }
+    }
+
+    // Fills the buffer with noise, slightly exceeding full scale for floats
+    void randomize()
+    {
+        for ( auto& d : data )
+        {
+            if ( layout.format == Format::FL32 )
+            {
+                auto f = reinterpret_cast<float*>( d.data() );
+                for ( auto i = 0u; i < d.size() / sizeof( float ); ++i )
+                    f[i] = static_cast<float>( rand() % 2200001 - 1100000 ) / 1000000.f;
+            }
+            else
+            {
+                for ( auto& b : d )
+                    b = static_cast<uint8_t>( rand() );
+            }
+        }
+    }
+
+    Layout layout;
+    std::vector<std::vector<uint8_t>> data;
+    std::vector<void*> planes;
+    std::vector<const void*> cplanes;
+};
+
+static Converter::Options noDither()
+{
+    Converter::Options options;
+    options.dither = false;
+    return options;
+}
+
+// Every instruction set must produce the same output as the scalar kernels
+static void compareIsas( Layout from, Layout to, Converter::Options options = Converter::Options() )
+{
+    for ( auto frames : { 1u, 7u, 33u, 256u, 1000u } )
+    {
+        Buffer src( from, frames );
+        src.randomize();
+        Converter reference( from, to, options, Isa::Scalar );
+        Buffer expected( to, frames );
+        reference.convert( src.cplanes.data(), expected.planes.data(), frames );
+        for ( auto isa : isas )
+        {
+            if ( Converter::isSupported( isa ) == false )
+                continue;
+            Converter conv( from, to, options, isa );
+            assert( conv.isa() == isa );
+            Buffer out( to, frames );
+            conv.convert( src.cplanes.data(), out.planes.data(), frames );
+            for ( auto p = 0u; p < out.data.size(); ++p )
+            {
+                if ( out.data[p] != expected.data[p] )
+                {
+                    std::cerr << Converter::isaName( isa ) << " differs from the scalar output, "
+                              << frames << " frames" << std::endl;
+                    assert( false );
+                }
+            }
+        }
+    }
+}
+
+static void testIsas()
+{
+    const Format formats[] = { Format::S16, Format::S32, Format::FL32 };
+    for ( auto f : formats )
+    {
+        for ( auto t : formats )
+        {
+            compareIsas( Layout( f, 2 ), Layout( t, 2 ) );
+            compareIsas( Layout( f, 2 ), Layout( t, 2, true ) );
+            compareIsas( Layout( f, 2, true ), Layout( t, 2 ), noDither() );
+            compareIsas( Layout( f, 1 ), Layout( t, 2 ) );
+            compareIsas( Layout( f, 6 ), Layout( t, 2 ) );
+            compareIsas( Layout( f, 2 ), Layout( t, 6, true ) );
+        }
+    }
+    assert( Converter::isSupported( Isa::Scalar ) == true );
+    assert( Converter::isSupported( Converter::bestIsa() ) == true );
+}
+
+static void testRoundTrip()
+{
+    const size_t N = 65536;
+    std::vector<int16_t> s16( N );
+    for ( auto i = 0u; i < N; ++i )
+        s16[i] = static_cast<int16_t>( i );
+    std::vector<float> fl( N );
+    std::vector<int16_t> back( N );
+    Converter toFloat( Layout( Format::S16, 1 ), Layout( Format::FL32, 1 ) );
+    toFloat.convert( s16.data(), fl.data(), N );
+    assert( fl[0] == 0.f && fl[0x4000] == .5f && fl[0x8000] == -1.f );
+    // Reducing the precision back to 16 bits doesn't lose anything
+    Converter toS16( Layout( Format::FL32, 1 ), Layout( Format::S16, 1 ), noDither() );
+    toS16.convert( fl.data(), back.data(), N );
+    assert( back == s16 );
+
+    // S32 keeps the 24 bits a float can hold
+    std::vector<int32_t> s32( N );
+    for ( auto i = 0u; i < N; ++i )
+        s32[i] = static_cast<int32_t>( ( i * 2654435761u ) & 0xffffff00u );
+    Converter s32ToFloat( Layout( Format::S32, 2 ), Layout( Format::FL32, 2 ) );
+    Converter floatToS32( Layout( Format::FL32, 2 ), Layout( Format::S32, 2 ) );
+    std::vector<int32_t> back32( N );
+    s32ToFloat.convert( s32.data(), fl.data(), N / 2 );
+    floatToS32.convert( fl.data(), back32.data(), N / 2 );
+    for ( auto i = 0u; i < N; ++i )
+    {
+        // Except at full scale, which clips to the largest float below it
+        if ( s32[i] != static_cast<int32_t>( 0x7fffff00 ) )
+            assert( back32[i] == s32[i] );
+    }
+
+    // Identical layouts are copied as is
+    Converter copy( Layout( Format::S16, 1 ), Layout( Format::S16, 1 ) );
+    std::fill( back.begin(), back.end(), 0 );
+    copy.convert( s16.data(), back.data(), N );
+    assert( back == s16 );
+}
+
+static void testClipping()
+{
+    const float in[] = { 2.f, -2.f, 1.f, -1.f, NAN, 0.49f / 32768, 0.51f / 32768 };
+    int16_t s16[7];
+    int32_t s32[7];
+    for ( auto isa : { Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::NEON } )
+    {
+        if ( Converter::isSupported( isa ) == false )
+            continue;
+        Converter toS16( Layout( Format::FL32, 1 ), Layout( Format::S16, 1 ), noDither(), isa );
+        toS16.convert( in, s16, 7 );
+        assert( s16[0] == 32767 && s16[1] == -32768 );
+        assert( s16[2] == 32767 && s16[3] == -32768 );
+        assert( s16[4] == -32768 );
+        assert( s16[5] == 0 && s16[6] == 1 );
+        Converter toS32( Layout( Format::FL32, 1 ), Layout( Format::S32, 1 ), noDither(), isa );
+        toS32.convert( in, s32, 7 );
+        assert( s32[0] == 2147483520 && s32[1] == INT32_MIN );
+        assert( s32[2] == 2147483520 && s32[3] == INT32_MIN );
+    }
+}
+
+static void testDither()
+{
+    const size_t N = 100000;
+    // A quarter of a LSB can only be represented by dithering
+    std::vector<float> in( N, 0.25f / 32768 );
+    std::vector<int16_t> out( N );
+    Converter conv( Layout( Format::FL32, 1 ), Layout( Format::S16, 1 ) );
+    conv.convert( in.data(), out.data(), N );
+    double sum = 0;
+    for ( auto s : out )
+    {
+        assert( s >= -1 && s <= 1 );
+        sum += s;
+    }
+    assert( std::fabs( sum / N - 0.25 ) < 0.01 );
+
+    Converter plain( Layout( Format::FL32, 1 ), Layout( Format::S16, 1 ), noDither() );
+    plain.convert( in.data(), out.data(), N );
+    for ( auto s : out )
+        assert( s == 0 );
+
+    // The noise doesn't repeat from one call to the next
+    std::vector<int16_t> a( 64 ), b( 64 );
+    conv.convert( in.data(), a.data(), 64 );
+    conv.convert( in.data(), b.data(), 64 );
+    assert( a != b );
+}
+
+static void testMatrix()
+{
+    // 5.1 in libvlc's order: L R RL RR C LFE
+    const float surround[] = { .1f, .2f, .3f, .4f, .5f, 1.f };
+    float stereo[2];
+    Converter down( Layout( Format::FL32, 6 ), Layout( Format::FL32, 2 ) );
+    down.convert( surround, stereo, 1 );
+    const float h = 0.70710678f;
+    assert( std::fabs( stereo[0] - ( .1f + h * .5f + h * .3f ) ) < 1e-6f );
+    assert( std::fabs( stereo[1] - ( .2f + h * .5f + h * .4f ) ) < 1e-6f );
+
+    float mono;
+    Converter toMono( Layout( Format::FL32, 2 ), Layout( Format::FL32, 1 ) );
+    toMono.convert( stereo, &mono, 1 );
+    assert( std::fabs( mono - ( stereo[0] + stereo[1] ) / 2 ) < 1e-6f );
+
+    Converter up( Layout( Format::FL32, 2 ), Layout( Format::FL32, 6 ) );
+    float six[6];
+    up.convert( stereo, six, 1 );
+    assert( six[0] == stereo[0] && six[1] == stereo[1] );
+    for ( auto c = 2u; c < 6; ++c )
+        assert( six[c] == 0.f );
+
+    Converter centered( Layout( Format::FL32, 1 ), Layout( Format::FL32, 6 ) );
+    centered.convert( &mono, six, 1 );
+    assert( six[4] == mono && six[0] == 0.f );
+
+    // Custom matrix: swap the channels, and attenuate the left one
+    Converter::Options options;
+    options.matrix = { 0.f, 1.f, .5f, 0.f };
+    Converter swap( Layout( Format::FL32, 2 ), Layout( Format::FL32, 2, true ), options );
+    float l[1], r[1];
+    void* planes[] = { l, r };
+    const void* in[] = { stereo };
+    swap.convert( in, planes, 1 );
+    assert( l[0] == stereo[1] && r[0] == stereo[0] * .5f );
+
+    // Other layouts keep the first channels
+    auto m = Converter::standardMatrix( 3, 4 );
+    assert( m.size() == 12 && m[0] == 1.f && m[4] == 1.f && m[8] == 1.f && m[9] == 0.f );
+}
+
+static void testInvalid()
+{
+    Converter::Options options;
+    options.matrix = { 1.f, 1.f };
+    try
+    {
+        Converter conv( Layout( Format::FL32, 2 ), Layout( Format::FL32, 2 ), options );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    try
+    {
+        Converter conv( Layout( Format::FL32, 0 ), Layout( Format::FL32, 2 ) );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    for ( auto isa : isas )
+    {
+        if ( Converter::isSupported( isa ) == true )
+            continue;
+        try
+        {
+            Converter conv( Layout(), Layout(), Converter::Options(), isa );
+            assert( false );
+        }
+        catch ( const std::invalid_argument& )
+        {
+        }
+    }
+
+    Format f;
+    assert( Converter::fromFourcc( "S16N", f ) == true && f == Format::S16 );
+    assert( Converter::fromFourcc( "FL32", f ) == true && f == Format::FL32 );
+    assert( Converter::fromFourcc( "U8  ", f ) == false );
+    assert( strcmp( Converter::fourcc( Format::S32 ), "S32N" ) == 0 );
+}
+
+static void testDecorate()
+{
+    Converter conv( Layout( Format::S16, 2 ), Layout( Format::FL32, 2, true ) );
+    std::vector<float> left, right;
+    int64_t lastPts = 0;
+    auto play = conv.decorate( [&]( const void* const* planes, unsigned int count, int64_t pts ) {
+        auto l = static_cast<const float*>( planes[0] );
+        auto r = static_cast<const float*>( planes[1] );
+        left.insert( left.end(), l, l + count );
+        right.insert( right.end(), r, r + count );
+        lastPts = pts;
+    } );
+    const int16_t block[] = { 16384, -16384, 8192, -8192 };
+    play( block, 2, 42 );
+    play( block, 1, 43 );
+    assert( lastPts == 43 );
+    assert( left.size() == 3 && left[0] == .5f && left[1] == .25f && left[2] == .5f );
+    assert( right.size() == 3 && right[0] == -.5f && right[1] == -.25f );
+
+    try
+    {
+        Converter planar( Layout( Format::S16, 2, true ), Layout( Format::FL32, 2 ) );
+        planar.decorate( []( const void* const*, unsigned int, int64_t ) {} );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+int main()
+{
+    testIsas();
+    testRoundTrip();
+    testClipping();
+    testDither();
+    testMatrix();
+    testInvalid();
+    testDecorate();
+    std::cout << "All AudioConverter tests passed" << std::endl;
+    return 0;
+}
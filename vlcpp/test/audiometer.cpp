@@ -0,0 +1,313 @@
+/*****************************************************************************
+ * audiometer.cpp: AudioMeter unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/AudioMeter.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Meter = VLC::AudioMeter;
+using Isa = Meter::Isa;
+
+static void setup( Meter& meter, const char* fourcc, uint32_t rate, uint32_t channels )
+{
+    char format[5];
+    memcpy( format, fourcc, 5 );
+    assert( meter.setup( format, &rate, &channels ) == 0 );
+}
+
+// Interleaved float sines, one amplitude per channel
+static std::vector<float> sine( unsigned rate, unsigned channels, double seconds,
+                                const std::vector<double>& amplitudes, double frequency = 997 )
+{
+    const double pi = 3.14159265358979323846;
+    auto frames = static_cast<size_t>( rate * seconds );
+    std::vector<float> samples( frames * channels );
+    for ( size_t i = 0; i < frames; ++i )
+    {
+        auto v = std::sin( 2 * pi * frequency * static_cast<double>( i ) / rate );
+        for ( auto c = 0u; c < channels; ++c )
+            samples[i * channels + c] = static_cast<float>( amplitudes[c] * v );
+    }
+    return samples;
+}
+
+// Plays the samples in blocks of irregular sizes, as libvlc does
+static void play( Meter& meter, const std::vector<float>& samples, unsigned channels )
+{
+    auto frames = samples.size() / channels;
+    size_t done = 0;
+    unsigned block = 1;
+    while ( done < frames )
+    {
+        auto n = std::min<size_t>( block, frames - done );
+        meter.play( samples.data() + done * channels, static_cast<unsigned>( n ), 0 );
+        done += n;
+        block = block * 7 % 1500 + 1;
+    }
+}
+
+static void testLoudness()
+{
+    // EBU Tech 3341: a stereo 1kHz sine at -23dBFS measures -23 LUFS
+    for ( auto rate : { 44100u, 48000u, 96000u } )
+    {
+        Meter meter;
+        setup( meter, "FL32", rate, 2 );
+        auto a = std::pow( 10., -23. / 20 );
+        play( meter, sine( rate, 2, 3.05, { a, a } ), 2 );
+        auto l = meter.levels();
+        assert( l.channels == 2 );
+        assert( std::fabs( l.momentary + 23.f ) < 0.1f );
+        assert( std::fabs( l.shortTerm + 23.f ) < 0.1f );
+        for ( auto c = 0u; c < 2; ++c )
+        {
+            assert( std::fabs( l.peak[c] - a ) < 1e-3 );
+            assert( std::fabs( l.rms[c] - a / std::sqrt( 2. ) ) < 1e-3 );
+            assert( std::fabs( Meter::toDbfs( l.peak[c] ) + 23.f ) < 0.01f );
+        }
+        assert( meter.stats().blocks == 30 );
+    }
+
+    // The K-weighting attenuates low frequencies
+    Meter low;
+    setup( low, "FL32", 48000, 1 );
+    play( low, sine( 48000, 1, 0.5, { 0.5 }, 30 ), 1 );
+    Meter mid;
+    setup( mid, "FL32", 48000, 1 );
+    play( mid, sine( 48000, 1, 0.5, { 0.5 } ), 1 );
+    assert( low.levels().momentary < mid.levels().momentary - 3 );
+}
+
+static void testWindows()
+{
+    Meter meter;
+    setup( meter, "FL32", 48000, 1 );
+    auto l = meter.levels();
+    assert( std::isinf( l.momentary ) && std::isinf( l.shortTerm ) );
+    // Momentary loudness needs 400ms, short-term 3s
+    play( meter, sine( 48000, 1, 0.4, { 0.5 } ), 1 );
+    l = meter.levels();
+    assert( std::isinf( l.momentary ) == false && std::isinf( l.shortTerm ) );
+    assert( l.frames == 19200 );
+    auto loudness = l.momentary;
+
+    // The peak & RMS only cover the window
+    play( meter, std::vector<float>( 48000 / 10 * 3, 0.f ), 1 );
+    l = meter.levels();
+    assert( l.peak[0] == 0.f && l.rms[0] == 0.f );
+    // A quarter of the momentary window is still the sine
+    assert( std::fabs( l.momentary - ( loudness - 6.02f ) ) < 0.1f );
+
+    // Silence doesn't have any loudness, once the filters settled
+    play( meter, std::vector<float>( 48000 / 10 * 2, 0.f ), 1 );
+    assert( std::isinf( meter.levels().momentary ) );
+
+    // A flush restarts the measurement
+    play( meter, sine( 48000, 1, 1, { 0.5 } ), 1 );
+    assert( std::isinf( meter.levels().momentary ) == false );
+    meter.flush( 0 );
+    l = meter.levels();
+    assert( std::isinf( l.momentary ) && l.peak[0] == 0.f );
+}
+
+static void testWeights()
+{
+    // 5.1 in libvlc's order: L R RL RR C LFE
+    auto measure = []( unsigned channel, std::vector<float> weights ) {
+        Meter::Configuration config;
+        config.weights = std::move( weights );
+        Meter meter( config );
+        setup( meter, "FL32", 48000, 6 );
+        std::vector<double> amplitudes( 6, 0. );
+        amplitudes[channel] = 0.1;
+        play( meter, sine( 48000, 6, 0.4, amplitudes ), 6 );
+        return meter.levels().momentary;
+    };
+    auto front = measure( 0, {} );
+    auto surround = measure( 2, {} );
+    // 10 * log10( 1.41 )
+    assert( std::fabs( surround - front - 1.49f ) < 0.01f );
+    assert( std::isinf( measure( 5, {} ) ) );
+    assert( std::fabs( measure( 5, { 1, 1, 1, 1, 1, 1 } ) - front ) < 0.01f );
+}
+
+static void testClipping()
+{
+    Meter meter;
+    setup( meter, "S16N", 48000, 2 );
+    std::vector<int16_t> samples( 4800 * 2, 0 );
+    samples[10] = 32767;
+    samples[12] = -32768;
+    samples[15] = 32000;
+    samples[17] = -32767;
+    meter.play( samples.data(), 4800, 0 );
+    auto s = meter.stats();
+    assert( s.clipped[0] == 2 && s.clipped[1] == 1 );
+    assert( s.frames == 4800 && s.blocks == 1 );
+    auto l = meter.levels();
+    assert( l.peak[0] == 1.f );
+    assert( l.peak[1] == 32767.f / 32768 );
+}
+
+// Every instruction set must measure the same levels as the scalar kernels
+static void testIsas()
+{
+    for ( auto channels : { 1u, 2u, 5u, 6u, 9u, 16u } )
+    {
+        std::vector<float> samples( 48000 * channels / 2 );
+        for ( auto& s : samples )
+            s = static_cast<float>( rand() % 2000001 - 1000000 ) / 1000000.f;
+        Meter reference( Meter::Configuration(), Isa::Scalar );
+        setup( reference, "FL32", 48000, channels );
+        play( reference, samples, channels );
+        auto expected = reference.levels();
+        for ( auto isa : { Isa::SSE2, Isa::AVX2, Isa::NEON } )
+        {
+            if ( VLC::AudioConverter::isSupported( isa ) == false )
+                continue;
+            Meter meter( Meter::Configuration(), isa );
+            setup( meter, "FL32", 48000, channels );
+            play( meter, samples, channels );
+            auto l = meter.levels();
+            assert( l.momentary == expected.momentary );
+            for ( auto c = 0u; c < channels; ++c )
+                assert( l.peak[c] == expected.peak[c] && l.rms[c] == expected.rms[c] );
+            for ( auto c = 0u; c < channels; ++c )
+                assert( meter.stats().clipped[c] == reference.stats().clipped[c] );
+        }
+    }
+}
+
+static void testFormats()
+{
+    Meter meter;
+    char format[5] = "U8  ";
+    uint32_t rate = 48000, channels = 24;
+    assert( meter.setup( format, &rate, &channels ) == 0 );
+    assert( strcmp( format, "FL32" ) == 0 && channels == Meter::MaxChannels );
+
+    // A tapped setup callback keeps its format, even unsupported ones
+    Meter tapped;
+    auto forward = tapped.tapSetup( []( char* f, uint32_t*, uint32_t* ) -> int {
+        memcpy( f, "U8  ", 4 );
+        return 0;
+    } );
+    memcpy( format, "S16N", 5 );
+    channels = 2;
+    assert( forward( format, &rate, &channels ) == 0 );
+    assert( strcmp( format, "U8  " ) == 0 );
+    assert( tapped.stats().unsupported == 1 );
+    uint8_t silence[64] = {};
+    tapped.play( silence, 32, 0 );
+    assert( tapped.stats().frames == 0 );
+
+    try
+    {
+        Meter::Configuration config;
+        config.window = std::chrono::milliseconds( 0 );
+        Meter m( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+static void testTap()
+{
+    Meter meter;
+    auto setupCb = meter.tapSetup( []( char* f, uint32_t* r, uint32_t* c ) -> int {
+        memcpy( f, "S32N", 4 );
+        *r = 1000;
+        *c = 1;
+        return 0;
+    } );
+    std::vector<int32_t> received;
+    auto play = meter.tap( [&received]( const void* samples, unsigned int count, int64_t ) {
+        auto s = static_cast<const int32_t*>( samples );
+        received.insert( received.end(), s, s + count );
+    } );
+    char format[5] = "FL32";
+    uint32_t rate = 48000, channels = 2;
+    assert( setupCb( format, &rate, &channels ) == 0 );
+    std::vector<int32_t> samples( 100, 1 << 30 );
+    play( samples.data(), 100, 0 );
+    assert( received == samples );
+    auto l = meter.levels();
+    assert( l.channels == 1 && l.peak[0] == .5f );
+    assert( meter.stats().blocks == 1 );
+}
+
+// Snapshots must never mix the values of two publications
+static void testConcurrent()
+{
+    Meter meter;
+    setup( meter, "FL32", 1000, 2 );
+    std::atomic<bool> done( false );
+    std::thread monitor( [&meter, &done]() {
+        uint64_t snapshots = 0;
+        while ( done.load() == false )
+        {
+            auto l = meter.levels();
+            assert( l.peak[1] == 2 * l.peak[0] );
+            assert( l.rms[1] == 2 * l.rms[0] );
+            ++snapshots;
+        }
+        assert( snapshots > 0 );
+    } );
+    std::vector<float> block( 200 );
+    for ( auto i = 0u; i < 20000; ++i )
+    {
+        auto a = static_cast<float>( i % 100 ) / 256;
+        for ( auto f = 0u; f < 100; ++f )
+        {
+            block[2 * f] = a;
+            block[2 * f + 1] = 2 * a;
+        }
+        meter.play( block.data(), 100, 0 );
+    }
+    done = true;
+    monitor.join();
+    assert( meter.stats().blocks == 20000 );
+}
+
+int main()
+{
+    testLoudness();
+    testWindows();
+    testWeights();
+    testClipping();
+    testIsas();
+    testFormats();
+    testTap();
+    testConcurrent();
+    std::cout << "All AudioMeter tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,365 @@
+/*****************************************************************************
+ * audioring.cpp: AudioRing unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/AudioRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Ring = VLC::AudioRing;
+
+// A mono S16N ring at 1kHz, so that a frame lasts 1ms
+static Ring::Configuration mono( unsigned durationMs, unsigned nbBlocks = 256 )
+{
+    Ring::Configuration config;
+    config.format = "S16N";
+    config.rate = 1000;
+    config.channels = 1;
+    config.duration = std::chrono::milliseconds( durationMs );
+    config.nbBlocks = nbBlocks;
+    return config;
+}
+
+static void setup( Ring& ring, const char* fourcc = "S16N", uint32_t rate = 1000,
+                   uint32_t channels = 1 )
+{
+    char format[5];
+    memcpy( format, fourcc, 5 );
+    assert( ring.setup( format, &rate, &channels ) == 0 );
+}
+
+// Plays count frames, valued from first onward
+static void play( Ring& ring, int16_t first, unsigned count, int64_t pts )
+{
+    std::vector<int16_t> samples( count );
+    for ( auto i = 0u; i < count; ++i )
+        samples[i] = static_cast<int16_t>( first + i );
+    ring.play( samples.data(), count, pts );
+}
+
+static void testFormat()
+{
+    Ring ring;
+    Ring::Format f;
+    assert( ring.format( f ) == false );
+    char format[5] = "FL32";
+    uint32_t rate = 48000, channels = 2;
+    assert( ring.setup( format, &rate, &channels ) == 0 );
+    assert( strcmp( format, "FL32" ) == 0 && rate == 48000 && channels == 2 );
+    assert( ring.format( f ) == true );
+    assert( strcmp( f.fourcc, "FL32" ) == 0 && f.frameSize == 8 );
+    // 500ms at 48kHz, rounded up
+    assert( f.capacity == 32768 );
+
+    // Unsupported formats are replaced
+    memcpy( format, "A52 ", 5 );
+    assert( ring.setup( format, &rate, &channels ) == 0 );
+    assert( strcmp( format, "S16N" ) == 0 );
+
+    auto config = mono( 64 );
+    Ring forced( config );
+    memcpy( format, "FL32", 5 );
+    rate = 44100;
+    channels = 6;
+    assert( forced.setup( format, &rate, &channels ) == 0 );
+    assert( strcmp( format, "S16N" ) == 0 && rate == 1000 && channels == 1 );
+    assert( forced.format( f ) == true && f.capacity == 64 && f.frameSize == 2 );
+    forced.cleanup();
+    assert( forced.format( f ) == false );
+
+    config.format = "S24N";
+    try
+    {
+        Ring r( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+static void testPlayback()
+{
+    Ring ring( mono( 64 ) );
+    setup( ring );
+    play( ring, 0, 10, 1000000 );
+    play( ring, 10, 10, 1010000 );
+    assert( ring.available() == 20 );
+
+    int16_t samples[8];
+    int64_t pts = 0;
+    assert( ring.read( samples, 4, &pts ) == 4 );
+    assert( pts == 1000000 && samples[0] == 0 && samples[3] == 3 );
+    // The pts is interpolated within a block
+    assert( ring.read( samples, 4, &pts ) == 4 );
+    assert( pts == 1004000 && samples[0] == 4 );
+    assert( ring.read( samples, 4, &pts ) == 4 );
+    assert( pts == 1008000 && samples[2] == 10 );
+    assert( ring.read( samples, 6 ) == 6 );
+    assert( ring.read( samples, 4, &pts ) == 2 );
+    assert( pts == 1018000 && samples[1] == 19 );
+    // Running short fills the remainder with silence
+    assert( samples[2] == 0 && samples[3] == 0 );
+    auto s = ring.stats();
+    assert( s.written == 20 && s.read == 20 );
+    assert( s.underruns == 1 && s.missing == 2 && s.overruns == 0 );
+}
+
+static void testOverrun()
+{
+    Ring ring( mono( 64, 2 ) );
+    setup( ring );
+    play( ring, 0, 100, 0 );
+    auto s = ring.stats();
+    assert( s.written == 64 && s.overruns == 1 && s.dropped == 36 );
+
+    int16_t samples[64];
+    assert( ring.read( samples, 64 ) == 64 && samples[63] == 63 );
+    // Each block needs a pts slot as well
+    play( ring, 0, 1, 0 );
+    play( ring, 1, 1, 1000 );
+    play( ring, 2, 1, 2000 );
+    s = ring.stats();
+    assert( s.overruns == 2 && s.dropped == 37 );
+    int64_t pts;
+    assert( ring.read( samples, 1, &pts ) == 1 && pts == 0 && samples[0] == 0 );
+    assert( ring.read( samples, 4, &pts ) == 1 && pts == 1000 && samples[0] == 1 );
+    play( ring, 2, 1, 2000 );
+    assert( ring.read( samples, 4, &pts ) == 1 && pts == 2000 && samples[0] == 2 );
+}
+
+static void testPauseFlush()
+{
+    Ring ring( mono( 64 ) );
+    setup( ring );
+    play( ring, 0, 10, 0 );
+    ring.pause( 0 );
+    assert( ring.paused() == true );
+    int16_t samples[4] = { 1, 1, 1, 1 };
+    assert( ring.read( samples, 4 ) == 0 );
+    assert( samples[0] == 0 && samples[3] == 0 );
+    ring.resume( 0 );
+    assert( ring.read( samples, 4 ) == 4 );
+    assert( ring.stats().underruns == 0 );
+
+    ring.flush( 0 );
+    assert( ring.available() == 0 );
+    play( ring, 100, 4, 500000 );
+    int64_t pts;
+    assert( ring.read( samples, 4, &pts ) == 4 );
+    assert( samples[0] == 100 && pts == 500000 );
+    auto s = ring.stats();
+    assert( s.flushed == 6 && s.underruns == 0 );
+
+    // A format change discards the previous samples as well
+    Ring other;
+    setup( other );
+    play( other, 0, 10, 0 );
+    setup( other, "S32N", 1000, 2 );
+    assert( other.available() == 0 && other.stats().flushed == 10 );
+    int32_t stereo[4] = { 0, 1, 2, 3 };
+    other.play( stereo, 2, 42 );
+    int32_t out[4];
+    assert( other.read( out, 2, &pts ) == 2 && pts == 42 && out[3] == 3 );
+}
+
+static void testDrain()
+{
+    Ring ring( mono( 64 ) );
+    setup( ring );
+    play( ring, 0, 20, 0 );
+    assert( ring.drained() == false );
+    std::atomic<bool> done( false );
+    std::thread consumer( [&ring, &done]() {
+        int16_t samples[5];
+        while ( done.load() == false )
+        {
+            ring.read( samples, 5 );
+            std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+        }
+    } );
+    // Returns once the consumer read everything
+    ring.drain();
+    assert( ring.available() == 0 );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    done = true;
+    consumer.join();
+    assert( ring.drained() == true );
+    auto s = ring.stats();
+    assert( s.read == 20 && s.underruns == 0 );
+
+    // Playing again ends the drain
+    play( ring, 0, 1, 0 );
+    assert( ring.drained() == false );
+
+    // A consumer which doesn't read doesn't block libvlc forever
+    auto start = std::chrono::steady_clock::now();
+    ring.drain();
+    assert( std::chrono::steady_clock::now() - start < std::chrono::seconds( 1 ) );
+    assert( ring.drained() == false );
+}
+
+// Random sized blocks & reads, checking that the samples and pts remain
+// consistent with each other
+static void testConcurrent()
+{
+    const int32_t NbFrames = 1000000;
+    Ring::Configuration config;
+    config.format = "S32N";
+    // A frame per microsecond, so that each sample is its own pts
+    config.rate = 1000000;
+    config.channels = 1;
+    config.duration = std::chrono::milliseconds( 4 );
+    Ring ring( config );
+    setup( ring, "S32N", 1000000, 1 );
+
+    std::atomic<bool> done( false );
+    std::thread producer( [&ring, &done]() {
+        std::vector<int32_t> block( 1000 );
+        int32_t next = 0;
+        while ( next < NbFrames )
+        {
+            auto count = 1 + static_cast<unsigned>( next ) * 7919u % 1000;
+            count = std::min( count, static_cast<unsigned>( NbFrames - next ) );
+            for ( auto i = 0u; i < count; ++i )
+                block[i] = next + static_cast<int32_t>( i );
+            ring.play( block.data(), count, next );
+            next += static_cast<int32_t>( count );
+            if ( next % 16 == 0 )
+                std::this_thread::yield();
+        }
+        done = true;
+    } );
+    std::vector<int32_t> samples( 800 );
+    int32_t last = -1;
+    uint64_t total = 0;
+    unsigned size = 1;
+    while ( true )
+    {
+        auto finished = done.load();
+        int64_t pts;
+        auto n = ring.read( samples.data(), size, &pts );
+        if ( n > 0 )
+        {
+            assert( pts == samples[0] && samples[0] > last );
+            for ( auto i = 1u; i < n; ++i )
+            {
+                // Dropped samples can only make the sequence skip forward
+                // between blocks, and a read can straddle them
+                assert( samples[i] > samples[i - 1] );
+            }
+            last = samples[n - 1];
+            total += n;
+        }
+        else if ( finished == true )
+            break;
+        size = size % 700 + 37;
+    }
+    producer.join();
+    auto s = ring.stats();
+    assert( s.written == total && s.read == total );
+    assert( s.written + s.dropped == static_cast<uint64_t>( NbFrames ) );
+}
+
+// libvlc negotiates the format again on each track change: the ring
+// alternates between two buffers instead of piling them up, and never
+// reuses the one the consumer is reading from
+static void testRepeatedSetup()
+{
+    Ring ring;
+    const int16_t mono[4] = { 1, 2, 3, 4 };
+    const float stereo[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    int16_t in[4];
+    // The flushed blocks are released once the consumer skipped them, even
+    // though none of their samples were read
+    for ( auto i = 0; i < 1000; ++i )
+    {
+        setup( ring );
+        ring.read( in, 4 );
+        ring.play( mono, 4, i );
+        ring.cleanup();
+    }
+    assert( ring.stats().overruns == 0 );
+
+    std::atomic<bool> done( false );
+    std::thread consumer( [&ring, &done]() {
+        // Large enough for 16 frames in any of the formats
+        double samples[32];
+        Ring::Format f;
+        while ( done == false )
+        {
+            ring.read( samples, 16 );
+            if ( ring.format( f ) == true )
+                assert( f.rate == 1000 || f.rate == 48000 );
+        }
+    } );
+    for ( auto i = 0; i < 1000; ++i )
+    {
+        if ( i % 2 == 0 )
+        {
+            setup( ring );
+            ring.play( mono, 4, i );
+        }
+        else
+        {
+            setup( ring, "FL32", 48000, 2 );
+            ring.play( stereo, 4, i );
+        }
+        ring.cleanup();
+    }
+    done = true;
+    consumer.join();
+
+    // Both formats were set up again in buffers which held the other one.
+    // This thread is the consumer now, and skips what was flushed.
+    setup( ring, "FL32", 48000, 2 );
+    float out[8];
+    ring.read( out, 4 );
+    ring.play( stereo, 4, 0 );
+    assert( ring.read( out, 4 ) == 4 && out[0] == 1 && out[7] == 8 );
+    setup( ring );
+    ring.play( mono, 4, 0 );
+    assert( ring.read( in, 4 ) == 4 && in[0] == 1 && in[3] == 4 );
+    // A new format replaces the previous buffer
+    setup( ring, "S32N", 1000, 1 );
+    Ring::Format f;
+    assert( ring.format( f ) == true && strcmp( f.fourcc, "S32N" ) == 0 && f.frameSize == 4 );
+}
+
+int main()
+{
+    testFormat();
+    testPlayback();
+    testOverrun();
+    testPauseFlush();
+    testDrain();
+    testConcurrent();
+    testRepeatedSetup();
+    std::cout << "All AudioRing tests passed" << std::endl;
+    return 0;
+}
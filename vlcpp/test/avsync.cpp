@@ -0,0 +1,267 @@
+/*****************************************************************************
+ * avsync.cpp: AvSyncMonitor unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/AvSyncMonitor.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+using Monitor = VLC::AvSyncMonitor;
+
+static const int64_t Origin = 1000000000;
+
+///
+/// Simulates a playback from Origin, for the provided duration: an audio
+/// block each 20ms, a picture each 40ms, and an update each 100ms.
+/// audio( date ) returns the pts of the block played at date, given the
+/// current audio delay.
+///
+static int64_t simulate( Monitor& monitor, int64_t duration, int64_t delay,
+                         std::function<int64_t(int64_t, int64_t)> audio,
+                         std::function<int64_t(int64_t)> media = nullptr,
+                         std::function<void(int64_t)> video = nullptr )
+{
+    for ( int64_t t = 0; t <= duration; t += 20000 )
+    {
+        auto date = Origin + t;
+        monitor.recordAudio( audio( date, delay ), date );
+        if ( t % 40000 == 0 )
+        {
+            monitor.recordDisplay( date );
+            if ( video != nullptr )
+                video( date );
+        }
+        if ( t % 100000 == 0 && t > 0 )
+            delay = monitor.update( date, media != nullptr ? media( date ) : t, delay );
+    }
+    return delay;
+}
+
+static void testOffset()
+{
+    Monitor monitor;
+    auto s = monitor.stats();
+    assert( s.hasOffset == false && s.mediaTime == -1 );
+    monitor.setAudioLatency( std::chrono::milliseconds( 20 ) );
+    monitor.setVideoLatency( std::chrono::milliseconds( 10 ) );
+    // libvlc provides the audio 50ms ahead
+    simulate( monitor, 5000000, 0, []( int64_t date, int64_t ) { return date + 50000; } );
+    s = monitor.stats();
+    assert( s.hasOffset == true );
+    assert( s.audioBlocks == 251 && s.videoFrames == 126 );
+    // Heard 30ms early, shown 10ms late
+    assert( s.audioLateness == -30000 && s.videoLateness == 10000 );
+    assert( s.offset == -40000 );
+    assert( s.audioLead == 50000 );
+    assert( std::fabs( s.drift ) < 1e-6 && std::fabs( s.clockDrift ) < 1e-6 );
+    assert( s.mediaTime == 5000 );
+    assert( s.corrections == 0 && s.audioDelay == 0 );
+}
+
+static void testDrift()
+{
+    Monitor monitor;
+    // The audio clock falls behind by 100ppm
+    simulate( monitor, 20000000, 0, []( int64_t date, int64_t ) {
+        return date + 50000 - ( date - Origin ) / 10000;
+    } );
+    auto s = monitor.stats();
+    assert( std::fabs( s.drift - 100. ) < 1. );
+    // The audio lead lost 2ms over 20s
+    assert( std::llabs( s.offset + 48000 ) < 100 );
+
+    // The media time runs at 0.99x
+    Monitor slow;
+    simulate( slow, 5000000, 0, []( int64_t date, int64_t ) { return date; },
+              []( int64_t date ) { return ( date - Origin ) * 99 / 100; } );
+    assert( std::fabs( slow.stats().clockDrift - 10000. ) < 1. );
+}
+
+static void testPresentation()
+{
+    Monitor monitor;
+    monitor.setVideoLatency( std::chrono::milliseconds( 5 ) );
+    // Without a reported presentation, the video latency is used
+    simulate( monitor, 1000000, 0, []( int64_t date, int64_t ) { return date; } );
+    assert( monitor.stats().videoLateness == 5000 );
+    // A render thread presents the pictures 16ms after their display
+    simulate( monitor, 5000000, 0, []( int64_t date, int64_t ) { return date; }, nullptr,
+              [&monitor]( int64_t date ) { monitor.recordPresentation( date + 16000 ); } );
+    auto s = monitor.stats();
+    assert( std::llabs( s.videoLateness - 21000 ) < 10 );
+    assert( std::llabs( s.offset + 21000 ) < 10 );
+    // Presentations before the display are ignored
+    monitor.recordPresentation( 0 );
+    assert( monitor.stats().videoLateness == s.videoLateness );
+}
+
+static void testCorrection()
+{
+    // An audio output which schedules the samples by their pts, with a
+    // 60ms device latency. libvlc delivers them 50ms ahead, shifted by the
+    // audio delay.
+    auto run = []( Monitor& monitor ) {
+        return simulate( monitor, 10000000, 0, [&monitor]( int64_t date, int64_t delay ) {
+            auto pts = date + 50000 + delay;
+            monitor.setAudioLatency( std::chrono::microseconds( pts - date + 60000 ) );
+            return pts;
+        } );
+    };
+
+    Monitor passive;
+    assert( run( passive ) == 0 );
+    assert( passive.stats().offset == 60000 && passive.stats().corrections == 0 );
+
+    Monitor::Configuration config;
+    config.correct = true;
+    Monitor monitor( config );
+    auto delay = run( monitor );
+    auto s = monitor.stats();
+    // 10ms per second, until the offset is within the threshold
+    assert( delay == -40000 && s.audioDelay == -40000 );
+    assert( s.corrections == 4 );
+    assert( s.offset == 20000 );
+
+    config.maxDelay = std::chrono::milliseconds( 25 );
+    Monitor bounded( config );
+    assert( run( bounded ) == -25000 );
+    assert( bounded.stats().corrections == 3 && bounded.stats().offset == 35000 );
+}
+
+static void testDiscontinuities()
+{
+    Monitor monitor;
+    auto audio = []( int64_t date, int64_t ) { return date; };
+    simulate( monitor, 1000000, 0, audio );
+    assert( monitor.stats().hasOffset == true );
+    // A seek 30s forward
+    monitor.update( Origin + 1100000, 31100000, 0 );
+    auto s = monitor.stats();
+    assert( s.discontinuities == 1 && s.hasOffset == false );
+    // Until both streams flow again, nothing is measured
+    monitor.update( Origin + 1200000, 31200000, 0 );
+    assert( monitor.stats().hasOffset == false );
+    monitor.recordDisplay( Origin + 1210000 );
+    monitor.recordAudio( Origin + 1210000, Origin + 1210000 );
+    monitor.update( Origin + 1300000, 31300000, 0 );
+    s = monitor.stats();
+    assert( s.hasOffset == true && s.discontinuities == 1 && s.mediaTime == 31300 );
+
+    // A flush also restarts the measurements
+    monitor.flush( 0 );
+    assert( monitor.stats().hasOffset == false );
+
+    // A pause: the media time stops while the clock runs
+    Monitor paused;
+    simulate( paused, 1000000, 0, audio );
+    for ( int64_t t = 1100000; t < 3000000; t += 100000 )
+        paused.update( Origin + t, 1000000, 0 );
+    assert( paused.stats().discontinuities == 1 );
+}
+
+static void testCallbacks()
+{
+    Monitor monitor;
+    unsigned played = 0;
+    auto play = monitor.tap( [&played]( const void*, unsigned int count, int64_t ) {
+        played += count;
+    } );
+    auto display = monitor.tapDisplay( nullptr );
+    play( nullptr, 10, libvlc_clock() + 100000 );
+    play( nullptr, 10, libvlc_clock() + 100000 );
+    display( nullptr );
+    assert( played == 20 );
+    auto s = monitor.stats();
+    assert( s.audioBlocks == 2 && s.videoFrames == 1 );
+    assert( std::llabs( s.audioLead - 100000 ) < 50000 );
+    monitor.update( libvlc_clock(), 0, 0 );
+    assert( monitor.stats().hasOffset == true );
+
+    try
+    {
+        Monitor::Configuration config;
+        config.window = std::chrono::microseconds( 0 );
+        Monitor m( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+// The callbacks, the updates & the statistics each run on their own thread
+static void testConcurrent()
+{
+    Monitor::Configuration config;
+    config.correct = true;
+    Monitor monitor( config );
+    std::atomic<bool> done( false );
+    std::atomic<int64_t> delay( 0 );
+    std::thread audio( [&]() {
+        for ( int64_t t = 0; t < 200000; ++t )
+            monitor.recordAudio( Origin + t * 10 + 50000 + delay.load(), Origin + t * 10 );
+    } );
+    std::thread video( [&]() {
+        for ( int64_t t = 0; t < 100000; ++t )
+            monitor.recordDisplay( Origin + t * 20 );
+    } );
+    std::thread updater( [&]() {
+        int64_t t = 0;
+        while ( done.load() == false )
+        {
+            t += 1000;
+            delay = monitor.update( Origin + t, t, delay.load() );
+        }
+    } );
+    uint64_t snapshots = 0;
+    while ( done.load() == false )
+    {
+        auto s = monitor.stats();
+        assert( s.audioDelay >= -1000000 && s.audioDelay <= 1000000 );
+        if ( s.audioBlocks == 200000 && s.videoFrames == 100000 )
+            done = true;
+        ++snapshots;
+    }
+    audio.join();
+    video.join();
+    updater.join();
+    assert( snapshots > 0 );
+}
+
+int main()
+{
+    testOffset();
+    testDrift();
+    testPresentation();
+    testCorrection();
+    testDiscontinuities();
+    testCallbacks();
+    testConcurrent();
+    std::cout << "All AvSyncMonitor tests passed" << std::endl;
+    return 0;
+}
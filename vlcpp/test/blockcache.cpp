@@ -0,0 +1,431 @@
+/*****************************************************************************
+ * blockcache.cpp: BlockCache & CachedSource unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/BlockCache.hpp"
+#include "vlcpp/MemorySource.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+///
+/// A source wrapping a MemorySource, which counts the reads of its streams,
+/// and fails once a given offset is reached
+///
+struct CountingSource
+{
+    class Stream
+    {
+    public:
+        Stream( std::unique_ptr<VLC::MemorySource::Stream> inner, const CountingSource& source )
+            : m_inner( std::move( inner ) ), m_source( source )
+        {
+        }
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            ++*m_source.reads;
+            if ( m_inner->position() >= m_source.failAt )
+                return -1;
+            // Short reads, to check that the blocks are completed
+            return m_inner->read( buf, len > 1000 ? 1000 : len );
+        }
+
+        int seek( uint64_t offset )
+        {
+            return m_inner->seek( offset );
+        }
+
+        uint64_t size() const
+        {
+            return m_inner->size();
+        }
+
+    private:
+        std::unique_ptr<VLC::MemorySource::Stream> m_inner;
+        const CountingSource& m_source;
+    };
+
+    std::unique_ptr<Stream> open() const
+    {
+        return std::unique_ptr<Stream>( new Stream( memory.open(), *this ) );
+    }
+
+    VLC::MemorySource memory;
+    uint64_t failAt;
+    std::shared_ptr<std::atomic<unsigned>> reads;
+};
+
+using Cached = VLC::CachedSource<CountingSource>;
+
+static std::shared_ptr<const std::vector<uint8_t>> blob( size_t size )
+{
+    auto v = std::make_shared<std::vector<uint8_t>>( size );
+    for ( auto i = 0u; i < size; ++i )
+        (*v)[i] = static_cast<uint8_t>( i * 7 + ( i >> 12 ) );
+    return v;
+}
+
+static CountingSource counting( std::shared_ptr<const std::vector<uint8_t>> buffer,
+                                uint64_t failAt = UINT64_MAX )
+{
+    return CountingSource{ VLC::MemorySource( std::move( buffer ) ), failAt,
+                           std::make_shared<std::atomic<unsigned>>( 0 ) };
+}
+
+static std::shared_ptr<VLC::BlockCache> cache( size_t blockSize, size_t budget, size_t nbShards )
+{
+    VLC::BlockCache::Configuration config;
+    config.blockSize = blockSize;
+    config.budget = budget;
+    config.nbShards = nbShards;
+    return std::make_shared<VLC::BlockCache>( config );
+}
+
+static std::vector<uint8_t> readAll( Cached::Stream& stream, size_t chunk )
+{
+    std::vector<uint8_t> out;
+    std::vector<unsigned char> buf( chunk );
+    ptrdiff_t n;
+    while ( ( n = stream.read( buf.data(), buf.size() ) ) > 0 )
+        out.insert( end( out ), buf.data(), buf.data() + n );
+    assert( n == 0 );
+    return out;
+}
+
+static void testRead()
+{
+    auto buffer = blob( 100000 );
+    auto c = cache( 4096, 1024 * 1024, 4 );
+    auto inner = counting( buffer );
+    Cached source( inner, c );
+    auto stream = source.open();
+    assert( stream->size() == buffer->size() );
+    assert( readAll( *stream, 3000 ) == *buffer );
+    auto s = source.stats();
+    // 25 blocks, the last one being short
+    assert( s.misses == 25 && s.loaded == buffer->size() );
+    assert( c->stats().blocks == 25 && c->stats().memory == buffer->size() );
+
+    // A second stream only reads from the cache
+    auto reads = inner.reads->load();
+    auto second = source.open();
+    assert( readAll( *second, 10000 ) == *buffer );
+    assert( inner.reads->load() == reads );
+    s = source.stats();
+    assert( s.misses == 25 && s.hits > 0 && s.loaded == buffer->size() );
+    assert( c->stats().hits == s.hits && c->stats().misses == s.misses );
+}
+
+static void testSeek()
+{
+    auto buffer = blob( 100000 );
+    auto c = cache( 4096, 1024 * 1024, 4 );
+    Cached source( counting( buffer ), c );
+    auto stream = source.open();
+    std::mt19937 rng( 42 );
+    std::vector<unsigned char> buf( 5000 );
+    for ( auto i = 0; i < 1000; ++i )
+    {
+        auto offset = rng() % ( buffer->size() + 1 );
+        auto len = 1 + rng() % buf.size();
+        assert( stream->seek( offset ) == 0 );
+        auto n = stream->read( buf.data(), len );
+        auto expected = std::min<size_t>( len, buffer->size() - offset );
+        assert( n == static_cast<ptrdiff_t>( expected ) );
+        assert( memcmp( buf.data(), buffer->data() + offset, expected ) == 0 );
+        assert( stream->position() == offset + expected );
+    }
+    assert( stream->seek( buffer->size() + 1 ) == -1 );
+    // Each block was only read once
+    assert( source.stats().loaded == buffer->size() );
+}
+
+static void testSharing()
+{
+    auto buffer = blob( 50000 );
+    auto c = cache( 4096, 1024 * 1024, 4 );
+    auto inner = counting( buffer );
+    Cached first( inner, "file:///a.mkv", c );
+    Cached second( inner, "file:///a.mkv", c );
+    Cached other( inner, "file:///b.mkv", c );
+    Cached anonymous( inner, c );
+    assert( first.id() == second.id() && first.id() != other.id() );
+    assert( anonymous.id() != first.id() && anonymous.id() != other.id() );
+
+    assert( readAll( *first.open(), 8192 ) == *buffer );
+    auto reads = inner.reads->load();
+    assert( readAll( *second.open(), 8192 ) == *buffer );
+    assert( inner.reads->load() == reads );
+    assert( second.stats().misses == 0 && second.stats().hits == 13 );
+    assert( first.stats().misses == 13 );
+
+    // Other keys don't see these blocks
+    assert( readAll( *other.open(), 8192 ) == *buffer );
+    assert( readAll( *anonymous.open(), 8192 ) == *buffer );
+    assert( other.stats().hits == 0 && anonymous.stats().hits == 0 );
+    assert( inner.reads->load() > reads );
+
+    // Once invalidated, the blocks are read again
+    c->invalidate( first.id() );
+    assert( c->stats().blocks == 26 );
+    assert( readAll( *second.open(), 8192 ) == *buffer );
+    assert( second.stats().misses == 13 );
+    c->clear();
+    assert( c->stats().blocks == 0 && c->stats().memory == 0 );
+}
+
+static void testEviction()
+{
+    auto buffer = blob( 8 * 4096 );
+    // A single shard of 4 blocks
+    auto c = cache( 4096, 4 * 4096, 1 );
+    Cached source( counting( buffer ), c );
+    auto stream = source.open();
+    assert( readAll( *stream, 4096 ) == *buffer );
+    auto s = c->stats();
+    assert( s.blocks == 4 && s.memory == 4 * 4096 );
+    assert( s.insertions == 8 && s.evictions == 4 );
+
+    // The LRU order is now 7, 6, 5, 4
+    std::vector<unsigned char> buf( 10 );
+    auto touch = [&stream, &buf]( uint64_t block ) {
+        stream->seek( block * 4096 );
+        assert( stream->read( buf.data(), buf.size() ) == 10 );
+    };
+    assert( source.stats().misses == 8 );
+    touch( 7 );
+    touch( 4 );
+    assert( source.stats().misses == 8 );
+    // Block 0 was evicted, and evicts block 5
+    touch( 0 );
+    assert( source.stats().misses == 9 );
+    touch( 4 );
+    touch( 7 );
+    assert( source.stats().misses == 9 );
+    touch( 5 );
+    assert( source.stats().misses == 10 );
+    assert( c->stats().memory <= 4 * 4096 );
+
+    // The budget is split between the shards
+    auto sharded = cache( 4096, 64 * 4096, 8 );
+    Cached big( counting( blob( 1024 * 4096 ) ), sharded );
+    readAll( *big.open(), 65536 );
+    assert( sharded->stats().memory <= 64 * 4096 );
+    assert( sharded->stats().blocks > 32 );
+}
+
+static void testErrors()
+{
+    auto buffer = blob( 20000 );
+    auto c = cache( 4096, 1024 * 1024, 4 );
+    Cached source( counting( buffer, 10000 ), c );
+    auto stream = source.open();
+    std::vector<unsigned char> buf( 20000 );
+    // The first 2 blocks are served, then the read fails
+    assert( stream->read( buf.data(), buf.size() ) == 8192 );
+    assert( stream->read( buf.data(), buf.size() ) == -1 );
+    // Nothing partial was cached
+    assert( c->stats().blocks == 2 );
+    // The stream recovers after a seek
+    assert( stream->seek( 0 ) == 0 );
+    assert( stream->read( buf.data(), 100 ) == 100 );
+
+    auto invalid = []( size_t blockSize, size_t budget, size_t nbShards ) {
+        try
+        {
+            cache( blockSize, budget, nbShards );
+            return false;
+        }
+        catch ( const std::invalid_argument& )
+        {
+            return true;
+        }
+    };
+    assert( invalid( 0, 1024, 1 ) );
+    assert( invalid( 1024, 1024, 0 ) );
+    assert( invalid( 1024, 4096, 8 ) );
+    assert( invalid( 1024, 8192, 8 ) == false );
+    try
+    {
+        Cached s( counting( buffer ), std::shared_ptr<VLC::BlockCache>() );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+
+    // Sources use the process wide cache by default
+    Cached global( counting( buffer ) );
+    assert( global.cache() == VLC::BlockCache::global() );
+    assert( readAll( *global.open(), 1000 ) == *buffer );
+}
+
+// Concurrent readers of a block being loaded wait for it rather than loading it
+static void testSingleFlight()
+{
+    auto c = cache( 4096, 1024 * 1024, 4 );
+    std::atomic<bool> release( false );
+    std::atomic<unsigned> nbLoads( 0 );
+    auto slowLoader = [&release, &nbLoads]( std::vector<uint8_t>& data ) {
+        ++nbLoads;
+        while ( release == false )
+            std::this_thread::yield();
+        data.assign( 4096, 42 );
+        return true;
+    };
+    auto waitForCoalesced = [&c]( uint64_t n ) {
+        while ( c->stats().coalesced < n )
+            std::this_thread::yield();
+    };
+    std::vector<VLC::BlockCache::Block> blocks( 4 );
+    std::vector<std::thread> readers;
+    for ( auto i = 0u; i < blocks.size(); ++i )
+    {
+        readers.emplace_back( [&c, &blocks, &slowLoader, i]() {
+            blocks[i] = c->load( 1, 0, slowLoader );
+        } );
+        // The first reader loads the block, the others wait for it
+        while ( nbLoads == 0 )
+            std::this_thread::yield();
+        waitForCoalesced( i );
+    }
+    release = true;
+    for ( auto& t : readers )
+        t.join();
+    assert( nbLoads == 1 );
+    for ( const auto& b : blocks )
+        assert( b != nullptr && b == blocks[0] && b->size() == 4096 );
+    assert( c->find( 1, 0 ) == blocks[0] );
+
+    // When the load fails, a waiting reader loads the block again
+    release = false;
+    nbLoads = 0;
+    std::thread failing( [&c, &release, &nbLoads]() {
+        auto b = c->load( 1, 1, [&release, &nbLoads]( std::vector<uint8_t>& ) {
+            ++nbLoads;
+            while ( release == false )
+                std::this_thread::yield();
+            return false;
+        } );
+        assert( b == nullptr );
+    } );
+    while ( nbLoads == 0 )
+        std::this_thread::yield();
+    VLC::BlockCache::Block retried;
+    std::thread waiter( [&c, &retried, &nbLoads]() {
+        retried = c->load( 1, 1, [&nbLoads]( std::vector<uint8_t>& data ) {
+            ++nbLoads;
+            data.assign( 10, 1 );
+            return true;
+        } );
+    } );
+    waitForCoalesced( blocks.size() );
+    release = true;
+    failing.join();
+    waiter.join();
+    assert( nbLoads == 2 && retried != nullptr && retried->size() == 10 );
+
+    // Exceptions reach the loading reader, and nothing is left pending
+    try
+    {
+        c->load( 1, 2, []( std::vector<uint8_t>& ) -> bool { throw std::runtime_error( "" ); } );
+        assert( false );
+    }
+    catch ( const std::runtime_error& )
+    {
+    }
+    auto b = c->load( 1, 2, []( std::vector<uint8_t>& data ) {
+        data.assign( 1, 2 );
+        return true;
+    } );
+    assert( b != nullptr && b->size() == 1 );
+
+    // A block loaded while its source gets invalidated is served, not cached
+    release = false;
+    nbLoads = 0;
+    std::thread stale( [&c, &slowLoader]() {
+        assert( c->load( 2, 0, slowLoader ) != nullptr );
+    } );
+    while ( nbLoads == 0 )
+        std::this_thread::yield();
+    c->invalidate( 2 );
+    release = true;
+    stale.join();
+    assert( c->find( 2, 0 ) == nullptr );
+}
+
+// Many players of the same content, each on its own thread
+static void testConcurrent()
+{
+    auto buffer = blob( 4 * 1024 * 1024 );
+    auto c = cache( 16384, 3 * 1024 * 1024, 8 );
+    auto inner = counting( buffer );
+    Cached source( inner, "shared", c );
+    std::vector<std::thread> players;
+    for ( auto p = 0u; p < 8; ++p )
+    {
+        players.emplace_back( [&source, &buffer, p]() {
+            auto stream = source.open();
+            std::mt19937 rng( p );
+            std::vector<unsigned char> buf( 50000 );
+            for ( auto i = 0; i < 500; ++i )
+            {
+                // Mostly sequential, with some seeks
+                if ( rng() % 8 == 0 )
+                    stream->seek( rng() % buffer->size() );
+                auto offset = stream->position();
+                auto n = stream->read( buf.data(), 1 + rng() % buf.size() );
+                assert( n >= 0 );
+                assert( memcmp( buf.data(), buffer->data() + offset, n ) == 0 );
+                if ( n == 0 )
+                    stream->seek( 0 );
+            }
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+    auto s = source.stats();
+    auto cs = c->stats();
+    assert( s.hits == cs.hits && s.misses == cs.misses );
+    assert( s.hits > s.misses );
+    assert( cs.memory <= 3 * 1024 * 1024 );
+}
+
+int main()
+{
+    testRead();
+    testSeek();
+    testSharing();
+    testEviction();
+    testErrors();
+    testSingleFlight();
+    testConcurrent();
+    std::cout << "All BlockCache tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,350 @@
+/*****************************************************************************
+ * chroma.cpp: ChromaConverter unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/ChromaConverter.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using Converter = VLC::ChromaConverter;
+using Format = Converter::Format;
+using Matrix = Converter::Matrix;
+using Range = Converter::Range;
+using Isa = Converter::Isa;
+
+static const Format YuvFormats[] = { Format::I420, Format::NV12, Format::P010 };
+static const Format RgbFormats[] = { Format::RGBA, Format::BGRA, Format::RGB24 };
+static const uint8_t Guard = 0xa5;
+
+// A picture with padded lines, so that overflows are caught
+struct Picture
+{
+    Picture( Format f, unsigned w, unsigned h )
+        : format( f )
+        , width( w )
+        , height( h )
+        , nbPlanes( 1 )
+    {
+        unsigned cw = ( w + 1 ) / 2;
+        unsigned ch = ( h + 1 ) / 2;
+        switch ( f )
+        {
+        case Format::I420:
+            init( 0, w, h );
+            init( 1, cw, ch );
+            init( 2, cw, ch );
+            nbPlanes = 3;
+            break;
+        case Format::NV12:
+            init( 0, w, h );
+            init( 1, cw * 2, ch );
+            nbPlanes = 2;
+            break;
+        case Format::P010:
+            init( 0, w * 2, h );
+            init( 1, cw * 4, ch );
+            nbPlanes = 2;
+            break;
+        case Format::RGB24:
+            init( 0, w * 3, h );
+            break;
+        default:
+            init( 0, w * 4, h );
+            break;
+        }
+    }
+
+    void init( unsigned idx, unsigned bytesPerLine, unsigned lines )
+    {
+        pitches[idx] = bytesPerLine + 37;
+        planes[idx].assign( pitches[idx] * lines, Guard );
+    }
+
+    void randomize()
+    {
+        for ( auto i = 0u; i < nbPlanes; ++i )
+        {
+            for ( auto& b : planes[i] )
+                b = static_cast<uint8_t>( rand() );
+            if ( format == Format::P010 )
+            {
+                // Only keep valid 10 bits values, in the high bits
+                for ( auto j = 0u; j < planes[i].size(); j += 2 )
+                    planes[i][j] &= 0xc0;
+            }
+        }
+    }
+
+    Converter::Image image()
+    {
+        Converter::Image img;
+        for ( auto i = 0u; i < 3; ++i )
+        {
+            img.planes[i] = i < nbPlanes ? planes[i].data() : nullptr;
+            img.pitches[i] = i < nbPlanes ? pitches[i] : 0;
+        }
+        return img;
+    }
+
+    Format format;
+    unsigned width;
+    unsigned height;
+    unsigned nbPlanes;
+    std::vector<uint8_t> planes[3];
+    size_t pitches[3];
+};
+
+static std::vector<Isa> availableIsas()
+{
+    std::vector<Isa> isas;
+    for ( auto isa : { Isa::SSE2, Isa::AVX2, Isa::NEON } )
+    {
+        if ( Converter::isSupported( isa ) )
+            isas.push_back( isa );
+    }
+    return isas;
+}
+
+static bool samePlanes( const Picture& a, const Picture& b )
+{
+    for ( auto i = 0u; i < a.nbPlanes; ++i )
+    {
+        if ( a.planes[i] != b.planes[i] )
+            return false;
+    }
+    return true;
+}
+
+static void testUnsupported()
+{
+    try
+    {
+        Converter c( Format::I420, Format::NV12 );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    try
+    {
+        Converter c( Format::RGBA, Format::BGRA );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    assert( Converter::isSupported( Isa::Scalar ) == true );
+    assert( Converter::isSupported( Converter::bestIsa() ) == true );
+    Format f;
+    assert( Converter::fromFourcc( "NV12", f ) && f == Format::NV12 );
+    assert( Converter::fromFourcc( "J420", f ) && f == Format::I420 );
+    assert( Converter::fromFourcc( "YUY2", f ) == false );
+}
+
+// Every SIMD implementation must match the scalar one, bit for bit,
+// including the tails & odd dimensions.
+static void testMatchesScalar()
+{
+    const unsigned sizes[][2] = { { 1, 1 }, { 7, 3 }, { 16, 2 }, { 33, 5 }, { 67, 33 }, { 130, 4 } };
+    auto isas = availableIsas();
+    std::cout << "Testing against scalar:";
+    for ( auto isa : isas )
+        std::cout << " " << Converter::isaName( isa );
+    std::cout << std::endl;
+    for ( auto matrix : { Matrix::BT601, Matrix::BT709 } )
+    {
+        for ( auto range : { Range::Limited, Range::Full } )
+        {
+            for ( const auto& size : sizes )
+            {
+                for ( auto yuv : YuvFormats )
+                {
+                    for ( auto rgb : RgbFormats )
+                    {
+                        Picture srcYuv( yuv, size[0], size[1] );
+                        Picture srcRgb( rgb, size[0], size[1] );
+                        srcYuv.randomize();
+                        srcRgb.randomize();
+                        Picture refRgb( rgb, size[0], size[1] );
+                        Picture refYuv( yuv, size[0], size[1] );
+                        Converter( yuv, rgb, matrix, range, Isa::Scalar )
+                                .convert( srcYuv.image(), refRgb.image(), size[0], size[1] );
+                        Converter( rgb, yuv, matrix, range, Isa::Scalar )
+                                .convert( srcRgb.image(), refYuv.image(), size[0], size[1] );
+                        for ( auto isa : isas )
+                        {
+                            Picture outRgb( rgb, size[0], size[1] );
+                            Picture outYuv( yuv, size[0], size[1] );
+                            Converter( yuv, rgb, matrix, range, isa )
+                                    .convert( srcYuv.image(), outRgb.image(), size[0], size[1] );
+                            Converter( rgb, yuv, matrix, range, isa )
+                                    .convert( srcRgb.image(), outYuv.image(), size[0], size[1] );
+                            assert( samePlanes( outRgb, refRgb ) );
+                            assert( samePlanes( outYuv, refYuv ) );
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Checks the fixed point scalar code against a floating point reference
+static void testReference()
+{
+    const unsigned W = 64, H = 8;
+    for ( auto matrix : { Matrix::BT601, Matrix::BT709 } )
+    {
+        double kr = matrix == Matrix::BT601 ? 0.299 : 0.2126;
+        double kb = matrix == Matrix::BT601 ? 0.114 : 0.0722;
+        double kg = 1. - kr - kb;
+        for ( auto range : { Range::Limited, Range::Full } )
+        {
+            Picture yuv( Format::I420, W, H );
+            yuv.randomize();
+            Picture rgb( Format::RGB24, W, H );
+            Converter( Format::I420, Format::RGB24, matrix, range, Isa::Scalar )
+                    .convert( yuv.image(), rgb.image(), W, H );
+            for ( auto y = 0u; y < H; ++y )
+            {
+                for ( auto x = 0u; x < W; ++x )
+                {
+                    double Y = yuv.planes[0][y * yuv.pitches[0] + x];
+                    double U = yuv.planes[1][y / 2 * yuv.pitches[1] + x / 2] - 128.;
+                    double V = yuv.planes[2][y / 2 * yuv.pitches[2] + x / 2] - 128.;
+                    if ( range == Range::Limited )
+                    {
+                        Y = ( Y - 16. ) * 255. / 219.;
+                        U *= 255. / 224.;
+                        V *= 255. / 224.;
+                    }
+                    const double expected[3] = {
+                        Y + 2. * ( 1. - kr ) * V,
+                        Y - 2. * kb * ( 1. - kb ) / kg * U - 2. * kr * ( 1. - kr ) / kg * V,
+                        Y + 2. * ( 1. - kb ) * U,
+                    };
+                    for ( auto c = 0u; c < 3; ++c )
+                    {
+                        auto e = std::min( 255., std::max( 0., expected[c] ) );
+                        auto v = rgb.planes[0][y * rgb.pitches[0] + x * 3 + c];
+                        assert( std::fabs( v - e ) <= 1. );
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void testKnownValues()
+{
+    for ( auto yuv : YuvFormats )
+    {
+        for ( auto matrix : { Matrix::BT601, Matrix::BT709 } )
+        {
+            for ( auto range : { Range::Limited, Range::Full } )
+            {
+                // White, black & mid grey survive a round trip exactly
+                const uint8_t greys[] = { 255, 0, 128 };
+                for ( auto g : greys )
+                {
+                    Picture rgb( Format::RGBA, 20, 2 );
+                    for ( auto y = 0u; y < 2; ++y )
+                        for ( auto x = 0u; x < 20 * 4; ++x )
+                            rgb.planes[0][y * rgb.pitches[0] + x] = g;
+                    Picture out( yuv, 20, 2 );
+                    Converter( Format::RGBA, yuv, matrix, range ).convert( rgb.image(), out.image(), 20, 2 );
+                    unsigned expectedY = range == Range::Limited ? 16 + ( g * 219 + 127 ) / 255 : g;
+                    if ( yuv == Format::P010 )
+                    {
+                        unsigned y = VLC::detail::chroma::load16( out.planes[0].data() ) >> 6;
+                        unsigned u = VLC::detail::chroma::load16( out.planes[1].data() ) >> 6;
+                        assert( y >> 2 == expectedY || ( y + 2 ) >> 2 == expectedY );
+                        assert( u == 512 );
+                    }
+                    else
+                    {
+                        assert( out.planes[0][0] == expectedY );
+                        assert( out.planes[1][0] == 128 );
+                    }
+                    Picture back( Format::BGRA, 20, 2 );
+                    Converter( yuv, Format::BGRA, matrix, range ).convert( out.image(), back.image(), 20, 2 );
+                    for ( auto x = 0u; x < 20; ++x )
+                    {
+                        for ( auto c = 0u; c < 3; ++c )
+                            assert( back.planes[0][x * 4 + c] == g );
+                        assert( back.planes[0][x * 4 + 3] == 0xff );
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Smooth pictures survive a round trip with a small error
+static void testRoundTrip()
+{
+    const unsigned W = 48, H = 16;
+    Picture rgb( Format::RGB24, W, H );
+    for ( auto y = 0u; y < H; ++y )
+    {
+        for ( auto x = 0u; x < W; ++x )
+        {
+            auto p = rgb.planes[0].data() + y * rgb.pitches[0] + x * 3;
+            p[0] = static_cast<uint8_t>( 40 + x * 3 );
+            p[1] = static_cast<uint8_t>( 200 - y * 5 );
+            p[2] = static_cast<uint8_t>( 90 + ( x + y ) );
+        }
+    }
+    for ( auto yuv : YuvFormats )
+    {
+        Picture tmp( yuv, W, H );
+        Picture back( Format::RGB24, W, H );
+        Converter( Format::RGB24, yuv, Matrix::BT709, Range::Limited ).convert( rgb.image(), tmp.image(), W, H );
+        Converter( yuv, Format::RGB24, Matrix::BT709, Range::Limited ).convert( tmp.image(), back.image(), W, H );
+        for ( auto y = 0u; y < H; ++y )
+        {
+            for ( auto x = 0u; x < W * 3; ++x )
+            {
+                auto a = rgb.planes[0][y * rgb.pitches[0] + x];
+                auto b = back.planes[0][y * back.pitches[0] + x];
+                assert( std::abs( a - b ) <= 6 );
+            }
+            // The padding is left untouched
+            assert( back.planes[0][y * back.pitches[0] + W * 3] == Guard );
+        }
+    }
+}
+
+int main()
+{
+    srand( 42 );
+    testUnsupported();
+    testMatchesScalar();
+    testReference();
+    testKnownValues();
+    testRoundTrip();
+    std::cout << "All ChromaConverter tests passed" << std::endl;
+    return 0;
+}
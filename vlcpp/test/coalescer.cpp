@@ -0,0 +1,196 @@
+/*****************************************************************************
+ * coalescer.cpp: EventCoalescer unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/EventCoalescer.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// A clock which only moves when told so
+struct ManualClock
+{
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static const bool is_steady = true;
+
+    static time_point now()
+    {
+        return current;
+    }
+
+    static void advance( int64_t ms )
+    {
+        current += duration( ms );
+    }
+
+    static time_point current;
+};
+
+ManualClock::time_point ManualClock::current;
+
+using ms = std::chrono::milliseconds;
+
+static void testFirstEventIsDelivered()
+{
+    std::vector<int64_t> received;
+    auto c = VLC::coalesce<ManualClock>( ms( 100 ), [&received]( int64_t t ) {
+        received.push_back( t );
+    });
+    c( 1 );
+    assert( received.size() == 1 && received[0] == 1 );
+    assert( c.hasPending() == false );
+}
+
+static void testLatestValueWins()
+{
+    std::vector<int64_t> received;
+    auto c = VLC::coalesce<ManualClock>( ms( 100 ), [&received]( int64_t t ) {
+        received.push_back( t );
+    });
+    c( 1 );
+    for ( auto i = 2; i <= 10; ++i )
+    {
+        ManualClock::advance( 5 );
+        c( i );
+    }
+    assert( received.size() == 1 );
+    assert( c.hasPending() == true );
+    c.flush();
+    assert( received.size() == 2 && received[1] == 10 );
+    assert( c.hasPending() == false );
+    // Nothing left to flush
+    c.flush();
+    assert( received.size() == 2 );
+}
+
+static void testRateIsLimited()
+{
+    std::vector<int64_t> received;
+    auto c = VLC::coalesce<ManualClock>( ms( 100 ), [&received]( int64_t t ) {
+        received.push_back( t );
+    });
+    // 1 second worth of events, every 10ms
+    for ( auto i = 0; i < 100; ++i )
+    {
+        c( i );
+        ManualClock::advance( 10 );
+    }
+    assert( received.size() == 10 );
+    for ( auto i = 0u; i < received.size(); ++i )
+        assert( received[i] == static_cast<int64_t>( i * 10 ) );
+    // The last event is still pending, and superseded by the next one which
+    // occurs after the interval
+    assert( c.hasPending() == true );
+    ManualClock::advance( 100 );
+    c( 1000 );
+    assert( received.size() == 11 && received.back() == 1000 );
+    assert( c.hasPending() == false );
+}
+
+static void testFlushRestartsInterval()
+{
+    std::vector<int64_t> received;
+    auto c = VLC::coalesce<ManualClock>( ms( 100 ), [&received]( int64_t t ) {
+        received.push_back( t );
+    });
+    c( 1 );
+    ManualClock::advance( 50 );
+    c( 2 );
+    c.flush();
+    assert( received.size() == 2 );
+    ManualClock::advance( 60 );
+    // 110ms after the first delivery, but only 60ms after the flush
+    c( 3 );
+    assert( received.size() == 2 );
+    assert( c.hasPending() == true );
+}
+
+static void testMultipleArguments()
+{
+    std::string lastName;
+    int lastValue = 0;
+    auto nbCalls = 0;
+    auto c = VLC::coalesce<ManualClock>( ms( 10 ), [&]( const std::string& name, int value ) {
+        lastName = name;
+        lastValue = value;
+        ++nbCalls;
+    });
+    c( "a", 1 );
+    {
+        // The parameters must be copied, as they won't outlive the call
+        std::string tmp( "b" );
+        c( tmp, 2 );
+    }
+    c( "c", 3 );
+    assert( nbCalls == 1 && lastName == "a" && lastValue == 1 );
+    c.flush();
+    assert( nbCalls == 2 && lastName == "c" && lastValue == 3 );
+}
+
+static void testNoArgument()
+{
+    auto nbCalls = 0;
+    auto c = VLC::coalesce<ManualClock>( ms( 10 ), [&nbCalls]() { ++nbCalls; } );
+    c();
+    c();
+    c();
+    assert( nbCalls == 1 );
+    c.flush();
+    assert( nbCalls == 2 );
+}
+
+static int64_t lastFreeFunctionValue;
+
+static void freeFunction( int64_t t )
+{
+    lastFreeFunctionValue = t;
+}
+
+static void testFunctionPointer()
+{
+    auto c = VLC::coalesce<ManualClock>( ms( 10 ), &freeFunction );
+    c( 1 );
+    c( 2 );
+    assert( lastFreeFunctionValue == 1 );
+    ManualClock::advance( 10 );
+    c( 3 );
+    assert( lastFreeFunctionValue == 3 );
+}
+
+int main()
+{
+    testFirstEventIsDelivered();
+    testLatestValueWins();
+    testRateIsLimited();
+    testFlushRestartsInterval();
+    testMultipleArguments();
+    testNoArgument();
+    testFunctionPointer();
+    std::cout << "All EventCoalescer tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,334 @@
+/*****************************************************************************
+ * eventstore.cpp: EventHandlerStore dispatch unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Store = VLC::detail::EventHandlerStore;
+
+// The trampolines the store attached, in place of libvlc's event manager
+struct Attachment
+{
+    libvlc_event_e type;
+    libvlc_callback_t callback;
+    void* data;
+};
+
+static std::mutex attachLock;
+static std::vector<Attachment> attachments;
+// Run by libvlc_event_attach, to check what it can do while being called
+static std::function<void()> onAttach;
+
+extern "C" int libvlc_event_attach( libvlc_event_manager_t*, libvlc_event_e type,
+                                    libvlc_callback_t callback, void* data )
+{
+    if ( onAttach )
+        onAttach();
+    std::lock_guard<std::mutex> lock( attachLock );
+    attachments.push_back( Attachment{ type, callback, data } );
+    return 0;
+}
+
+extern "C" void libvlc_event_detach( libvlc_event_manager_t*, libvlc_event_e type,
+                                     libvlc_callback_t callback, void* data )
+{
+    std::lock_guard<std::mutex> lock( attachLock );
+    for ( auto it = begin( attachments ); it != end( attachments ); ++it )
+    {
+        if ( it->type == type && it->callback == callback && it->data == data )
+        {
+            attachments.erase( it );
+            return;
+        }
+    }
+    assert( false );
+}
+
+// Raises an event as libvlc would
+static void raise( const libvlc_event_t& e )
+{
+    Attachment a;
+    {
+        std::lock_guard<std::mutex> lock( attachLock );
+        auto it = begin( attachments );
+        while ( it != end( attachments ) && it->type != e.type )
+            ++it;
+        assert( it != end( attachments ) );
+        a = *it;
+    }
+    a.callback( &e, a.data );
+}
+
+static void raise( libvlc_event_e type )
+{
+    libvlc_event_t e;
+    e.type = type;
+    e.p_obj = nullptr;
+    raise( e );
+}
+
+static bool isAttached( libvlc_event_e type )
+{
+    std::lock_guard<std::mutex> lock( attachLock );
+    for ( const auto& a : attachments )
+    {
+        if ( a.type == type )
+            return true;
+    }
+    return false;
+}
+
+static libvlc_event_manager_t* const em = reinterpret_cast<libvlc_event_manager_t*>( 0x1000 );
+
+static Store::Handle add( Store& store, libvlc_event_e type, std::function<void()> f )
+{
+    return store.add( type, std::move( f ), []( const libvlc_event_t*, void* data ) {
+        ( *static_cast<std::function<void()>*>( data ) )();
+    });
+}
+
+// Waits for a condition with a timeout, so that a deadlock fails the test
+// instead of hanging it
+struct Latch
+{
+    void open()
+    {
+        std::lock_guard<std::mutex> lock( m );
+        opened = true;
+        cond.notify_all();
+    }
+
+    bool wait()
+    {
+        std::unique_lock<std::mutex> lock( m );
+        return cond.wait_for( lock, std::chrono::seconds( 5 ), [this]() { return opened; } );
+    }
+
+    std::mutex m;
+    std::condition_variable cond;
+    bool opened = false;
+};
+
+// A handler waiting for an event raised by another libvlc thread
+static void testConcurrentDispatch()
+{
+    Store store( em );
+    Latch second;
+    std::atomic<bool> waited{ false };
+    add( store, libvlc_MediaPlayerPlaying, [&second, &waited]() {
+        waited = second.wait();
+    });
+    add( store, libvlc_MediaPlayerTimeChanged, [&second]() {
+        second.open();
+    });
+    std::thread t( []() { raise( libvlc_MediaPlayerPlaying ); } );
+    raise( libvlc_MediaPlayerTimeChanged );
+    t.join();
+    assert( waited == true );
+}
+
+// Registering a handler for a new event from a handler attaches it to
+// libvlc, which must be able to raise events meanwhile
+static void testRegisterFromHandler()
+{
+    Store store( em );
+    std::atomic<int> nbRaised{ 0 };
+    add( store, libvlc_MediaPlayerTimeChanged, [&nbRaised]() { ++nbRaised; } );
+    onAttach = []() {
+        auto f = std::async( std::launch::async, []() {
+            raise( libvlc_MediaPlayerTimeChanged );
+        });
+        assert( f.wait_for( std::chrono::seconds( 5 ) ) == std::future_status::ready );
+    };
+    std::atomic<int> nbPaused{ 0 };
+    add( store, libvlc_MediaPlayerPlaying, [&store, &nbPaused]() {
+        add( store, libvlc_MediaPlayerPaused, [&nbPaused]() { ++nbPaused; } );
+    });
+    assert( nbRaised == 1 );
+    raise( libvlc_MediaPlayerPlaying );
+    onAttach = nullptr;
+    assert( nbRaised == 2 );
+    raise( libvlc_MediaPlayerPaused );
+    assert( nbPaused == 1 );
+}
+
+// Counts the destructions of its copies, to check when the store releases a
+// handler capturing it
+struct Tracked
+{
+    explicit Tracked( std::atomic<int>& d ) : destroyed( &d ), counts( false ) {}
+    Tracked( const Tracked& t ) : destroyed( t.destroyed ), counts( true ) {}
+    Tracked( Tracked&& t ) : destroyed( t.destroyed ), counts( t.counts ) { t.counts = false; }
+    ~Tracked()
+    {
+        if ( counts == true )
+            ++*destroyed;
+    }
+    std::atomic<int>* destroyed;
+    bool counts;
+};
+
+// A handler removed by another thread while a dispatch is in progress
+static void testRemoveDuringDispatch()
+{
+    Store store( em );
+    Latch running;
+    Latch released;
+    std::atomic<int> nbCalls{ 0 };
+    std::atomic<int> destroyed{ 0 };
+    std::atomic<bool> returned{ false };
+    // The delivery order is unspecified: both handlers block on their first
+    // call, so that whichever runs first blocks the dispatch
+    auto wait = [&running, &released, &returned]() {
+        running.open();
+        assert( released.wait() );
+        returned = true;
+    };
+    Store::Handle handles[2];
+    for ( auto i = 0; i < 2; ++i )
+    {
+        Tracked tracked( destroyed );
+        handles[i] = add( store, libvlc_MediaPlayerPlaying,
+                          [&wait, &nbCalls, tracked]() {
+            if ( nbCalls++ == 0 )
+                wait();
+        });
+    }
+    std::thread t( []() { raise( libvlc_MediaPlayerPlaying ); } );
+    assert( running.wait() );
+    // Remove both concurrently, as we don't know which one is running.
+    // Removing the running one waits for it to return.
+    std::atomic<int> nbReturnedFirst{ 0 };
+    auto removeAsync = [&store, &returned, &nbReturnedFirst]( Store::Handle h ) {
+        return std::async( std::launch::async, [&store, &returned, &nbReturnedFirst, h]() {
+            assert( store.remove( h ) );
+            if ( returned == true )
+                ++nbReturnedFirst;
+        });
+    };
+    auto first = removeAsync( handles[0] );
+    auto second = removeAsync( handles[1] );
+    for ( auto i = 0; i < 500 && ( store.isRegistered( handles[0] ) ||
+                                   store.isRegistered( handles[1] ) ); ++i )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    assert( store.isRegistered( handles[0] ) == false );
+    assert( store.isRegistered( handles[1] ) == false );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    // Only the removal of the running handler is still waiting
+    auto pending = ( first.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::timeout ) +
+                   ( second.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::timeout );
+    assert( pending == 1 );
+    // The running handler is still alive
+    assert( destroyed == 0 );
+    released.open();
+    first.get();
+    second.get();
+    assert( nbReturnedFirst >= 1 );
+    t.join();
+    // The other one was skipped, and both got destroyed after the dispatch
+    assert( nbCalls == 1 );
+    assert( destroyed == 2 );
+    assert( store.size() == 0 );
+}
+
+// A handler unregistering itself doesn't wait for its own return
+static void testRemoveFromHandler()
+{
+    Store store( em );
+    std::atomic<int> nbCalls{ 0 };
+    Store::Handle h;
+    h = add( store, libvlc_MediaPlayerStopped, [&store, &h, &nbCalls]() {
+        ++nbCalls;
+        assert( store.remove( h ) );
+    });
+    auto f = std::async( std::launch::async, []() { raise( libvlc_MediaPlayerStopped ); } );
+    assert( f.wait_for( std::chrono::seconds( 5 ) ) == std::future_status::ready );
+    raise( libvlc_MediaPlayerStopped );
+    assert( nbCalls == 1 );
+    assert( store.size() == 0 );
+}
+
+// A time update merged by a coalescer is delivered before the player's
+// state transitions
+static void testCoalescedFlush()
+{
+    struct PlayerEvents : VLC::MediaPlayerEventManager
+    {
+        PlayerEvents() : MediaPlayerEventManager( em, VLC::MediaPlayer() ) {}
+    };
+    PlayerEvents events;
+    std::vector<int64_t> received;
+    // Nothing is merged while the test runs, besides what follows the first
+    // delivery
+    events.onTimeChanged( VLC::coalesce( std::chrono::hours( 1 ), [&received]( libvlc_time_t t ) {
+        received.push_back( t );
+    }));
+    events.onPaused( [&received]() { received.push_back( -1 ); } );
+    events.onStopped( [&received]() { received.push_back( -2 ); } );
+    // The coalescer attached the flush events, even those without handlers
+    assert( isAttached( libvlc_MediaPlayerEncounteredError ) );
+    assert( isAttached( libvlc_MediaPlayerMediaChanged ) );
+
+    libvlc_event_t e;
+    e.type = libvlc_MediaPlayerTimeChanged;
+    e.p_obj = nullptr;
+    for ( auto t = 1; t <= 3; ++t )
+    {
+        e.u.media_player_time_changed.new_time = t * 1000;
+        raise( e );
+    }
+    // The first value went through, the last one is pending
+    assert( received.size() == 1 && received[0] == 1000 );
+    raise( libvlc_MediaPlayerPaused );
+    assert( ( received == std::vector<int64_t>{ 1000, 3000, -1 } ) );
+    // Nothing is pending anymore
+    raise( libvlc_MediaPlayerStopped );
+    assert( ( received == std::vector<int64_t>{ 1000, 3000, -1, -2 } ) );
+
+    // A flush event without a handler of its own flushes as well
+    e.u.media_player_time_changed.new_time = 4000;
+    raise( e );
+    assert( received.size() == 4 );
+    raise( libvlc_MediaPlayerEncounteredError );
+    assert( received.size() == 5 && received.back() == 4000 );
+}
+
+int main()
+{
+    testConcurrentDispatch();
+    testRegisterFromHandler();
+    testRemoveDuringDispatch();
+    testRemoveFromHandler();
+    testCoalescedFlush();
+    std::cout << "All EventHandlerStore tests passed" << std::endl;
+    return 0;
+}
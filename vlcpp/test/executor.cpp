@@ -0,0 +1,265 @@
+/*****************************************************************************
+ * executor.cpp: EventExecutor unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/EventExecutor.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void testCallerLoop()
+{
+    VLC::EventExecutor executor( 0 );
+    std::vector<int> received;
+    auto h = executor.wrap( [&received]( int i ) { received.push_back( i ); } );
+    for ( auto i = 0; i < 100; ++i )
+        h( i );
+    // Nothing runs until the caller drains the queue
+    assert( received.empty() == true );
+    assert( executor.depth() == 100 );
+    assert( executor.poll() == 100 );
+    assert( received.size() == 100 );
+    for ( auto i = 0; i < 100; ++i )
+        assert( received[i] == i );
+    auto stats = executor.stats();
+    assert( stats.depth == 0 && stats.processed == 100 && stats.dropped == 0 );
+}
+
+static void testParametersAreCopied()
+{
+    VLC::EventExecutor executor( 0 );
+    std::vector<std::string> received;
+    auto h = executor.wrap( [&received]( const std::string& s ) { received.push_back( s ); } );
+    {
+        std::string tmp( "a string which doesn't fit in the small string buffer" );
+        h( tmp );
+    }
+    executor.poll();
+    assert( received.size() == 1 );
+    assert( received[0] == "a string which doesn't fit in the small string buffer" );
+
+    // Objects & strings given by pointer only live as long as the event
+    struct Thumbnail
+    {
+        std::string name;
+    };
+    std::vector<std::string> names;
+    auto p = executor.wrap( [&names]( const Thumbnail* t ) {
+        names.push_back( t != nullptr ? t->name : "null" );
+    } );
+    {
+        Thumbnail tmp{ "a thumbnail name which doesn't fit in the small string buffer" };
+        p( &tmp );
+        tmp.name.clear();
+        p( nullptr );
+    }
+    executor.poll();
+    assert( names.size() == 2 );
+    assert( names[0] == "a thumbnail name which doesn't fit in the small string buffer" );
+    assert( names[1] == "null" );
+
+    std::vector<std::string> titles;
+    auto t = executor.wrap( [&titles]( const char* s ) {
+        titles.push_back( s != nullptr ? s : "null" );
+    } );
+    {
+        char tmp[] = "title";
+        t( tmp );
+        tmp[0] = 'T';
+        t( nullptr );
+    }
+    executor.poll();
+    assert( titles.size() == 2 && titles[0] == "title" && titles[1] == "null" );
+}
+
+static void testOverflowDrop()
+{
+    VLC::EventExecutor executor( 0, 4, VLC::EventExecutor::Overflow::Drop );
+    auto nbCalls = 0;
+    auto h = executor.wrap( [&nbCalls]() { ++nbCalls; } );
+    for ( auto i = 0; i < 10; ++i )
+        h();
+    auto stats = executor.stats();
+    assert( stats.depth == 4 );
+    assert( stats.dropped == 6 );
+    assert( executor.poll() == 4 );
+    assert( nbCalls == 4 );
+}
+
+static void testOverflowBlock()
+{
+    VLC::EventExecutor executor( 0, 2, VLC::EventExecutor::Overflow::Block );
+    auto nbCalls = 0;
+    auto h = executor.wrap( [&nbCalls]() { ++nbCalls; } );
+    h();
+    h();
+    // The producer sleeps until the consumer makes some room
+    std::atomic<bool> done( false );
+    std::thread producer( [&h, &done]() {
+        h();
+        done = true;
+    } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    assert( done == false );
+    auto nbPolled = executor.poll();
+    producer.join();
+    nbPolled += executor.poll();
+    assert( nbPolled == 3 && nbCalls == 3 );
+    assert( executor.dropped() == 0 );
+
+    // Stopping the executor drops the blocked event
+    h();
+    h();
+    producer = std::thread( [&h]() { h(); } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    executor.stop();
+    producer.join();
+    assert( executor.dropped() == 1 );
+}
+
+static void testUnregisteredHandlerIsSkipped()
+{
+    VLC::EventExecutor executor( 0 );
+    auto nbCalls = 0;
+    {
+        auto h = executor.wrap( [&nbCalls]() { ++nbCalls; } );
+        h();
+        h();
+    }
+    // The events are still consumed, but the handler isn't invoked
+    assert( executor.poll() == 2 );
+    assert( nbCalls == 0 );
+}
+
+static void testStop()
+{
+    VLC::EventExecutor executor( 0 );
+    auto nbCalls = 0;
+    auto h = executor.wrap( [&nbCalls]() { ++nbCalls; } );
+    h();
+    executor.stop();
+    h();
+    assert( executor.poll() == 0 );
+    assert( nbCalls == 0 );
+    assert( executor.dropped() == 1 );
+}
+
+static void testRunLoop()
+{
+    VLC::EventExecutor executor( 0 );
+    std::atomic<int> nbCalls{ 0 };
+    auto h = executor.wrap( [&nbCalls, &executor]( int i ) {
+        ++nbCalls;
+        if ( i == 999 )
+            executor.stop();
+    });
+    std::thread producer( [&h]() {
+        for ( auto i = 0; i < 1000; ++i )
+            h( i );
+    });
+    executor.run();
+    producer.join();
+    assert( nbCalls == 1000 );
+}
+
+// Multiple producers (ie. multiple players), multiple handlers, multiple
+// workers: every handler must see the events of a producer in order, and
+// must never run concurrently with itself.
+static void testWorkersOrdering()
+{
+    const auto NbProducers = 4u;
+    const auto NbHandlers = 8u;
+    const auto NbEvents = 20000;
+
+    struct Checker
+    {
+        std::array<int, NbProducers> last;
+        std::atomic<bool> running;
+        int nbCalls;
+    };
+    std::vector<Checker> checkers( NbHandlers );
+    std::atomic<bool> failed{ false };
+
+    std::unique_ptr<VLC::EventExecutor> executorPtr(
+                new VLC::EventExecutor( 3, 64, VLC::EventExecutor::Overflow::Block ) );
+    auto& executor = *executorPtr;
+    using Handler = decltype( executor.wrap( std::function<void(unsigned int, int)>{} ) );
+    std::vector<Handler> handlers;
+    for ( auto i = 0u; i < NbHandlers; ++i )
+    {
+        auto& c = checkers[i];
+        c.last.fill( -1 );
+        c.running = false;
+        c.nbCalls = 0;
+        handlers.push_back( executor.wrap( std::function<void(unsigned int, int)>(
+            [&c, &failed]( unsigned int producer, int seq ) {
+                if ( c.running.exchange( true ) == true )
+                    failed = true;
+                if ( c.last[producer] + 1 != seq )
+                    failed = true;
+                c.last[producer] = seq;
+                ++c.nbCalls;
+                c.running = false;
+            })));
+    }
+
+    std::vector<std::thread> producers;
+    for ( auto p = 0u; p < NbProducers; ++p )
+    {
+        producers.emplace_back( [p, &handlers]() {
+            for ( auto seq = 0; seq < NbEvents; ++seq )
+                for ( auto& h : handlers )
+                    h( p, seq );
+        });
+    }
+    for ( auto& t : producers )
+        t.join();
+    while ( executor.stats().processed < NbProducers * NbHandlers * NbEvents )
+        std::this_thread::yield();
+    assert( executor.dropped() == 0 );
+    // Join the workers before inspecting what the handlers did
+    executorPtr.reset();
+
+    assert( failed == false );
+    for ( const auto& c : checkers )
+        assert( c.nbCalls == static_cast<int>( NbProducers * NbEvents ) );
+}
+
+int main()
+{
+    testCallerLoop();
+    testParametersAreCopied();
+    testOverflowDrop();
+    testOverflowBlock();
+    testUnregisteredHandlerIsSkipped();
+    testStop();
+    testRunLoop();
+    testWorkersOrdering();
+    std::cout << "All EventExecutor tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*****************************************************************************
+ * fanout.cpp: FrameFanout unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/FrameFanout.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace vs = VLC::detail::scale;
+using Frame = VLC::FramePool::Frame;
+
+template <unsigned C>
+static void checkHalveRow( unsigned srcWidth )
+{
+    std::vector<uint8_t> r0( srcWidth * C ), r1( srcWidth * C );
+    for ( auto i = 0u; i < r0.size(); ++i )
+    {
+        r0[i] = static_cast<uint8_t>( rand() );
+        r1[i] = static_cast<uint8_t>( rand() );
+    }
+    auto dstWidth = ( srcWidth + 1 ) / 2;
+    std::vector<uint8_t> ref( dstWidth * C ), out( dstWidth * C );
+    vs::Scalar::halveRow<C>( r0.data(), r1.data(), ref.data(), dstWidth, srcWidth );
+    vs::Simd::halveRow<C>( r0.data(), r1.data(), out.data(), dstWidth, srcWidth );
+    assert( ref == out );
+}
+
+// The SIMD kernels must match the scalar ones exactly
+static void testKernels()
+{
+    for ( auto w = 1u; w < 80; ++w )
+    {
+        checkHalveRow<1>( w );
+        checkHalveRow<2>( w );
+        checkHalveRow<4>( w );
+    }
+    uint8_t r0[] = { 0, 10, 20, 30, 255 };
+    uint8_t r1[] = { 2, 12, 22, 32, 255 };
+    uint8_t out[3];
+    vs::Scalar::halveRow<1>( r0, r1, out, 3, 5 );
+    assert( out[0] == 6 && out[1] == 26 && out[2] == 255 );
+
+    for ( auto n = 1u; n < 70; ++n )
+    {
+        std::vector<uint8_t> a( n ), b( n ), ref( n ), res( n );
+        for ( auto i = 0u; i < n; ++i )
+        {
+            a[i] = static_cast<uint8_t>( rand() );
+            b[i] = static_cast<uint8_t>( rand() );
+        }
+        for ( auto w : { 0u, 1u, 64u, 127u } )
+        {
+            vs::Scalar::blendRows( a.data(), b.data(), ref.data(), n, w );
+            vs::Simd::blendRows( a.data(), b.data(), res.data(), n, w );
+            assert( ref == res );
+        }
+    }
+
+    auto taps = vs::computeTaps( 4, 2 );
+    assert( taps[0].i0 == 0 && taps[0].i1 == 1 && taps[0].w == 64 );
+    assert( taps[1].i0 == 2 && taps[1].i1 == 3 && taps[1].w == 64 );
+    taps = vs::computeTaps( 3, 3 );
+    for ( auto i = 0u; i < 3; ++i )
+        assert( taps[i].i0 == i && taps[i].w == 0 );
+}
+
+struct Collector
+{
+    std::vector<Frame> frames;
+    std::function<void(Frame)> callback()
+    {
+        return [this]( Frame f ) { frames.push_back( std::move( f ) ); };
+    }
+};
+
+// Hands a decoded picture to the vout, which displays then unlocks it with
+// libvlc 3.x, and unlocks then displays it with libvlc 4.x
+static void present( VLC::FrameFanout& fanout, void* pic, void** planes )
+{
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    fanout.unlock( pic, planes );
+    fanout.display( pic );
+#else
+    fanout.display( pic );
+    fanout.unlock( pic, planes );
+#endif
+}
+
+// Feeds a frame through the fan-out, as libvlc would
+static void decode( VLC::FrameFanout& fanout, const uint8_t* values, unsigned nbPlanes,
+                    const uint32_t* pitches, const uint32_t* lines )
+{
+    void* planes[5];
+    auto pic = fanout.lock( planes );
+    for ( auto p = 0u; p < nbPlanes; ++p )
+        memset( planes[p], values[p], pitches[p] * lines[p] );
+    present( fanout, pic, planes );
+}
+
+static void testPyramid()
+{
+    Collector full, half, analytics, preview;
+    VLC::FrameFanout::Configuration config;
+    config.source.chroma = "I420";
+    config.onFrame = full.callback();
+    const unsigned widths[] = { 160, 960, 640 };
+    Collector* collectors[] = { &preview, &half, &analytics };
+    for ( auto i = 0u; i < 3; ++i )
+    {
+        VLC::FrameFanout::Output o;
+        o.width = widths[i];
+        o.onFrame = collectors[i]->callback();
+        config.outputs.push_back( o );
+    }
+    VLC::FrameFanout fanout( config );
+    char chroma[5] = "NV12";
+    uint32_t width = 1920, height = 1080;
+    uint32_t pitches[5], lines[5];
+    assert( fanout.setup( chroma, &width, &height, pitches, lines ) == 4 );
+    assert( memcmp( chroma, "I420", 4 ) == 0 && width == 1920 && height == 1080 );
+
+    const uint8_t values[] = { 100, 50, 200 };
+    for ( auto i = 0; i < 3; ++i )
+        decode( fanout, values, 3, pitches, lines );
+    assert( full.frames.size() == 3 );
+    const unsigned heights[] = { 90, 540, 360 };
+    for ( auto i = 0u; i < 3; ++i )
+    {
+        auto& frames = collectors[i]->frames;
+        assert( frames.size() == 3 );
+        const auto& f = frames.back();
+        assert( f.width() == widths[i] && f.height() == heights[i] );
+        assert( strcmp( f.chroma(), "I420" ) == 0 );
+        assert( f.sequence() == 2 );
+        // A flat picture stays flat, up to the last line & column
+        for ( auto p = 0u; p < 3; ++p )
+        {
+            auto w = p == 0 ? f.width() : ( f.width() + 1 ) / 2;
+            auto h = p == 0 ? f.height() : ( f.height() + 1 ) / 2;
+            assert( f.plane( p )[0] == values[p] );
+            assert( f.plane( p )[( h - 1 ) * f.pitch( p ) + w - 1] == values[p] );
+        }
+        assert( fanout.outputStats( i ).delivered == 3 );
+    }
+    assert( fanout.sourceStats().delivered == 3 );
+}
+
+// Checks the actual filtering on a small grey picture
+static void testFiltering()
+{
+    Collector halved, scaled;
+    VLC::FrameFanout::Configuration config;
+    config.source.chroma = "GREY";
+    VLC::FrameFanout::Output o;
+    o.width = 4;
+    o.height = 1;
+    o.onFrame = halved.callback();
+    config.outputs.push_back( o );
+    o.width = 3;
+    o.onFrame = scaled.callback();
+    config.outputs.push_back( o );
+    VLC::FrameFanout fanout( config );
+    char chroma[5] = "GREY";
+    uint32_t width = 8, height = 2;
+    uint32_t pitches[5], lines[5];
+    fanout.setup( chroma, &width, &height, pitches, lines );
+
+    void* planes[5];
+    auto pic = fanout.lock( planes );
+    auto p = static_cast<uint8_t*>( planes[0] );
+    for ( auto y = 0u; y < 2; ++y )
+        for ( auto x = 0u; x < 8; ++x )
+            p[y * pitches[0] + x] = static_cast<uint8_t>( x * 16 + y * 2 );
+    present( fanout, pic, planes );
+
+    const auto& h = halved.frames.at( 0 );
+    assert( h.width() == 4 && h.height() == 1 );
+    for ( auto x = 0u; x < 4; ++x )
+        assert( h.plane( 0 )[x] == x * 32 + 9 );
+    // 4 -> 3 is computed from the halved output
+    const auto& s = scaled.frames.at( 0 );
+    assert( s.width() == 3 );
+    assert( s.plane( 0 )[0] == 14 && s.plane( 0 )[1] == 57 && s.plane( 0 )[2] == 100 );
+}
+
+static void testPackedAndSemiPlanar()
+{
+    for ( auto chroma : { "RV32", "NV12" } )
+    {
+        Collector out;
+        VLC::FrameFanout::Configuration config;
+        config.source.chroma = chroma;
+        VLC::FrameFanout::Output o;
+        o.height = 71;
+        o.onFrame = out.callback();
+        config.outputs.push_back( o );
+        VLC::FrameFanout fanout( config );
+        char c[5];
+        memcpy( c, chroma, 5 );
+        uint32_t width = 333, height = 211;
+        uint32_t pitches[5], lines[5];
+        fanout.setup( c, &width, &height, pitches, lines );
+        void* planes[5];
+        auto pic = fanout.lock( planes );
+        // Each component has its own value, so that mixing them up shows
+        auto nbComponents = memcmp( chroma, "RV32", 4 ) == 0 ? 4u : 2u;
+        auto plane = static_cast<uint8_t*>( planes[nbComponents == 4 ? 0 : 1] );
+        auto pitch = pitches[nbComponents == 4 ? 0 : 1];
+        auto nbLines = lines[nbComponents == 4 ? 0 : 1];
+        for ( auto y = 0u; y < nbLines; ++y )
+            for ( auto x = 0u; x < pitch; ++x )
+                plane[y * pitch + x] = static_cast<uint8_t>( 10 + 40 * ( x % nbComponents ) );
+        present( fanout, pic, planes );
+        const auto& f = out.frames.at( 0 );
+        assert( f.height() == 71 && f.width() == 112 );
+        auto idx = nbComponents == 4 ? 0 : 1;
+        auto w = nbComponents == 4 ? f.width() : ( f.width() + 1 ) / 2;
+        auto h = nbComponents == 4 ? f.height() : ( f.height() + 1 ) / 2;
+        for ( auto y = 0u; y < h; ++y )
+            for ( auto x = 0u; x < w * nbComponents; ++x )
+                assert( f.plane( idx )[y * f.pitch( idx ) + x] == 10 + 40 * ( x % nbComponents ) );
+    }
+}
+
+static void testInvalid()
+{
+    VLC::FrameFanout::Configuration config;
+    config.source.chroma = "P010";
+    config.outputs.resize( 1 );
+    config.outputs[0].width = 100;
+    try
+    {
+        VLC::FrameFanout f( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    config.source.chroma = "I420";
+    config.outputs[0].width = 0;
+    try
+    {
+        VLC::FrameFanout f( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+int main()
+{
+    srand( 42 );
+    testKernels();
+    testPyramid();
+    testFiltering();
+    testPackedAndSemiPlanar();
+    testInvalid();
+    std::cout << "All FrameFanout tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,483 @@
+/*****************************************************************************
+ * framepool.cpp: FramePool unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/FramePool.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Frame = VLC::FramePool::Frame;
+
+// Mimics what libvlc does with the format callback
+static uint32_t negotiate( VLC::FramePool& pool, unsigned srcWidth, unsigned srcHeight,
+                           uint32_t* pitches, uint32_t* lines )
+{
+    char chroma[5] = { 0 };
+    uint32_t width = srcWidth;
+    uint32_t height = srcHeight;
+    auto nb = pool.setup( chroma, &width, &height, pitches, lines );
+    assert( width == srcWidth && height == srcHeight );
+    return nb;
+}
+
+// Hands a decoded picture to the vout, which displays then unlocks it with
+// libvlc 3.x, and unlocks then displays it with libvlc 4.x
+static void present( VLC::FramePool& pool, void* pic, void** planes )
+{
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    pool.unlock( pic, planes );
+    pool.display( pic );
+#else
+    pool.display( pic );
+    pool.unlock( pic, planes );
+#endif
+}
+
+static VLC::FramePool::Configuration i420( unsigned nbBuffers )
+{
+    VLC::FramePool::Configuration config;
+    config.chroma = "I420";
+    config.nbBuffers = nbBuffers;
+    return config;
+}
+
+static void testLayout()
+{
+    VLC::PictureLayout l;
+    assert( l.compute( "ABCD", 16, 16 ) == false );
+    assert( l.compute( "RV32", 0, 16 ) == false );
+
+    assert( l.compute( "RV32", 100, 10 ) == true );
+    assert( l.nbPlanes == 1 );
+    assert( l.pitches[0] == 448 );
+    assert( l.lines[0] == 10 );
+    assert( l.size == 4480 );
+
+    assert( l.compute( "I420", 101, 51 ) == true );
+    assert( l.nbPlanes == 3 );
+    assert( l.pitches[0] == 128 && l.lines[0] == 51 );
+    assert( l.pitches[1] == 64 && l.lines[1] == 26 );
+    for ( auto i = 0u; i < l.nbPlanes; ++i )
+        assert( l.offsets[i] % 64 == 0 );
+    assert( l.offsets[2] == l.offsets[1] + 64 * 26 );
+
+    assert( l.compute( "P010", 1920, 1080 ) == true );
+    assert( l.nbPlanes == 2 );
+    assert( l.pitches[0] == 3840 && l.pitches[1] == 3840 );
+    assert( l.lines[1] == 540 );
+}
+
+static void testNegotiation()
+{
+    VLC::FramePool::Configuration config;
+    config.width = 640;
+    config.nbBuffers = 3;
+    VLC::FramePool pool( config );
+    char chroma[5] = { 0 };
+    uint32_t width = 1920, height = 1080;
+    uint32_t pitches[5], lines[5];
+    assert( pool.setup( chroma, &width, &height, pitches, lines ) == 3 );
+    assert( memcmp( chroma, "RV32", 4 ) == 0 );
+    // The source aspect ratio is preserved
+    assert( width == 640 && height == 360 );
+    assert( pitches[0] == 2560 && lines[0] == 360 );
+
+    config.nbBuffers = 65;
+    try
+    {
+        VLC::FramePool p( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+static void testPassthrough()
+{
+    VLC::FormatNegotiator negotiator( "RV32", { "NV12", "I420", "ABCD" }, 0, 0 );
+    VLC::FormatNegotiator::Result res;
+    char chroma[5] = "NV12";
+    uint32_t width = 1920, height = 1080;
+    uint32_t pitches[5], lines[5];
+    // The decoder's format is kept, with the planes strided for it
+    assert( negotiator.negotiate( chroma, &width, &height, pitches, lines, res ) == true );
+    assert( res.passthrough == true );
+    assert( memcmp( chroma, "NV12", 4 ) == 0 && width == 1920 && height == 1080 );
+    assert( res.layout.nbPlanes == 2 );
+    assert( pitches[0] == 1920 && lines[0] == 1080 );
+    assert( pitches[1] == 1920 && lines[1] == 540 );
+
+    // Unsupported chroma: libvlc has to convert to the fallback one
+    memcpy( chroma, "YUY2", 4 );
+    assert( negotiator.negotiate( chroma, &width, &height, pitches, lines, res ) == true );
+    assert( res.passthrough == false );
+    assert( memcmp( res.proposed, "YUY2", 5 ) == 0 );
+    assert( memcmp( chroma, "RV32", 4 ) == 0 && pitches[0] == 1920 * 4 );
+
+    // Declared, but without a known layout: no buffers can be allocated for it
+    memcpy( chroma, "ABCD", 4 );
+    assert( negotiator.negotiate( chroma, &width, &height, pitches, lines, res ) == true );
+    assert( res.passthrough == false && memcmp( chroma, "RV32", 4 ) == 0 );
+
+    // The chroma is kept, but a scaler is still needed
+    VLC::FormatNegotiator scaled( "RV32", { "I420" }, 640, 0 );
+    memcpy( chroma, "I420", 4 );
+    width = 1920;
+    height = 1080;
+    assert( scaled.negotiate( chroma, &width, &height, pitches, lines, res ) == true );
+    assert( res.passthrough == false && memcmp( chroma, "I420", 4 ) == 0 );
+    assert( width == 640 && height == 360 && res.sourceWidth == 1920 );
+
+    // Through the pool
+    VLC::FramePool::Configuration config;
+    config.nativeChromas = { "I420", "NV12" };
+    VLC::FramePool pool( config );
+    std::vector<Frame> frames;
+    pool.setFrameCallback( [&frames]( Frame f ) { frames.push_back( std::move( f ) ); } );
+    memcpy( chroma, "I420", 4 );
+    width = 101;
+    height = 51;
+    assert( pool.setup( chroma, &width, &height, pitches, lines ) == 4 );
+    assert( pool.stats().passthrough == true );
+    void* planes[5];
+    auto pic = pool.lock( planes );
+    assert( static_cast<uint8_t*>( planes[1] ) - static_cast<uint8_t*>( planes[0] ) ==
+            pitches[0] * lines[0] );
+    present( pool, pic, planes );
+    assert( frames.size() == 1 && strcmp( frames[0].chroma(), "I420" ) == 0 );
+    assert( frames[0].nbPlanes() == 3 && frames[0].pitch( 1 ) == pitches[1] );
+    memcpy( chroma, "P010", 4 );
+    pool.setup( chroma, &width, &height, pitches, lines );
+    assert( pool.stats().passthrough == false && memcmp( chroma, "RV32", 4 ) == 0 );
+
+    try
+    {
+        VLC::FormatNegotiator n( "RV32", { "NV1" }, 0, 0 );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+// libvlc 3.x invokes lock, display, then unlock. Frames can be unlocked
+// without being displayed when they are late.
+static void testDisplayBeforeUnlock()
+{
+    VLC::FramePool pool( i420( 2 ) );
+    uint32_t pitches[5], lines[5];
+    assert( negotiate( pool, 64, 32, pitches, lines ) == 2 );
+
+    void* planes[5];
+    auto p1 = pool.lock( planes );
+    for ( auto i = 0u; i < 3; ++i )
+        assert( reinterpret_cast<uintptr_t>( planes[i] ) % 64 == 0 );
+    memset( planes[0], 1, pitches[0] * lines[0] );
+    assert( pool.stats().inUse == 1 );
+    pool.display( p1 );
+    // Without a consumer, the frame is released right away, but libvlc
+    // keeps its picture until it unlocks it
+    assert( pool.stats().inUse == 1 );
+    pool.unlock( p1, planes );
+    assert( pool.stats().inUse == 0 );
+    auto p2 = pool.lock( planes );
+    assert( p2 != p1 );
+    pool.unlock( p2, planes );
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    // The picture may still be displayed
+    assert( pool.stats().inUse == 1 && pool.stats().dropped == 0 );
+#else
+    // The picture went back to libvlc's pool without being displayed
+    assert( pool.stats().inUse == 0 && pool.stats().dropped == 1 );
+#endif
+    pool.cleanup();
+    auto s = pool.stats();
+    assert( s.delivered == 1 && s.dropped == 1 && s.starved == 0 );
+    assert( s.inUse == 0 );
+}
+
+static void testDelivery()
+{
+    VLC::FramePool pool( i420( 2 ) );
+    std::vector<Frame> frames;
+    pool.setFrameCallback( [&frames]( Frame f ) { frames.push_back( std::move( f ) ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+
+    void* planes[5];
+    for ( auto i = 0u; i < 2; ++i )
+    {
+        auto pic = pool.lock( planes );
+        memset( planes[0], 10 + i, pitches[0] * lines[0] );
+        present( pool, pic, planes );
+    }
+    assert( frames.size() == 2 );
+    for ( auto i = 0u; i < 2; ++i )
+    {
+        assert( frames[i].sequence() == i );
+        assert( frames[i].width() == 64 && frames[i].height() == 32 );
+        assert( strcmp( frames[i].chroma(), "I420" ) == 0 );
+        assert( frames[i].nbPlanes() == 3 );
+        assert( frames[i].plane( 0 )[0] == 10 + i );
+        assert( frames[i].plane( 0 )[pitches[0] * lines[0] - 1] == 10 + i );
+    }
+    assert( frames[0].index() != frames[1].index() );
+    assert( pool.stats().inUse == 2 );
+    frames.clear();
+    assert( pool.stats().inUse == 0 );
+}
+
+static void testStarvation()
+{
+    auto config = i420( 2 );
+    auto nbStarvations = 0;
+    config.onStarvation = [&nbStarvations]() { ++nbStarvations; };
+    VLC::FramePool pool( config );
+    std::vector<Frame> frames;
+    pool.setFrameCallback( [&frames]( Frame f ) { frames.push_back( std::move( f ) ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+
+    void* planes[5];
+    for ( auto i = 0u; i < 2; ++i )
+    {
+        auto pic = pool.lock( planes );
+        present( pool, pic, planes );
+    }
+    // Both buffers are held by the consumer: the next frame is decoded to a
+    // scratch buffer, and never delivered. The held frames are left intact.
+    auto pic = pool.lock( planes );
+    memset( planes[0], 0xff, pitches[0] * lines[0] );
+    present( pool, pic, planes );
+    assert( nbStarvations == 1 );
+    assert( frames.size() == 2 );
+    assert( frames[0].plane( 0 )[0] != 0xff && frames[1].plane( 0 )[0] != 0xff );
+    auto s = pool.stats();
+    assert( s.starved == 1 && s.dropped == 1 && s.delivered == 2 );
+
+    // Once a frame is released, its buffer is reused
+    auto idx = frames[0].index();
+    frames.erase( begin( frames ) );
+    pic = pool.lock( planes );
+    present( pool, pic, planes );
+    assert( frames.size() == 2 );
+    assert( frames.back().index() == idx );
+}
+
+static void testStarvationTimeout()
+{
+    auto config = i420( 1 );
+    config.starvationTimeout = std::chrono::milliseconds( 5000 );
+    VLC::FramePool pool( config );
+    Frame held;
+    pool.setFrameCallback( [&held]( Frame f ) { held = std::move( f ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+
+    void* planes[5];
+    auto pic = pool.lock( planes );
+    present( pool, pic, planes );
+    assert( held );
+    std::thread consumer( [&held]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        held.release();
+    });
+    // Blocks until the consumer releases its frame
+    auto pic2 = pool.lock( planes );
+    consumer.join();
+    assert( pic2 == pic );
+    assert( pool.stats().starved == 0 );
+    pool.unlock( pic2, planes );
+}
+
+// Even without any buffer left, libvlc's thread is only blocked briefly
+static void testStarvationWithoutScratch()
+{
+    VLC::FramePool pool( i420( 1 ) );
+    Frame held;
+    pool.setFrameCallback( [&held]( Frame f ) { held = std::move( f ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+
+    void* planes[5];
+    auto pic = pool.lock( planes );
+    present( pool, pic, planes );
+    assert( held );
+    // More pictures than libvlc would hold at once, so that the scratch
+    // buffer is in use too
+    void* scratchPlanes[5];
+    auto scratch = pool.lock( scratchPlanes );
+    auto start = std::chrono::steady_clock::now();
+    void* sinkPlanes[5];
+    auto sink = pool.lock( sinkPlanes );
+    assert( std::chrono::steady_clock::now() - start < std::chrono::seconds( 5 ) );
+    assert( sink != pic && sink != scratch );
+    assert( sinkPlanes[0] != planes[0] && sinkPlanes[0] != scratchPlanes[0] );
+    memset( sinkPlanes[0], 0xff, pitches[0] * lines[0] );
+    // The sink can be handed out again while in use
+    void* sinkPlanes2[5];
+    assert( pool.lock( sinkPlanes2 ) == sink );
+    present( pool, sink, sinkPlanes );
+    present( pool, sink, sinkPlanes2 );
+    present( pool, scratch, scratchPlanes );
+    assert( held.plane( 0 )[0] != 0xff );
+    auto s = pool.stats();
+    assert( s.starved == 3 && s.dropped == 3 && s.delivered == 1 );
+
+    // The regular buffer is used again once released
+    held.release();
+    auto pic2 = pool.lock( planes );
+    assert( pic2 == pic );
+    present( pool, pic2, planes );
+    assert( pool.stats().delivered == 2 );
+}
+
+// The decoder holds several pictures at once, which the vout displays out
+// of decoding order
+static void testFramesInFlight()
+{
+    VLC::FramePool pool( i420( 3 ) );
+    std::vector<Frame> frames;
+    pool.setFrameCallback( [&frames]( Frame f ) { frames.push_back( std::move( f ) ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+    const auto size = pitches[0] * lines[0];
+
+    void* planes[5];
+    void* pics[3];
+    uint8_t* data[3];
+    for ( auto i = 0u; i < 3; ++i )
+    {
+        pics[i] = pool.lock( planes );
+        data[i] = static_cast<uint8_t*>( planes[0] );
+        memset( data[i], 20 + i, size );
+    }
+    auto intact = [&data, size]( unsigned i ) {
+        return data[i][0] == 20 + i && data[i][size - 1] == 20 + i;
+    };
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+    // Decoded, and queued for display
+    for ( auto i = 0u; i < 3; ++i )
+        pool.unlock( pics[i], planes );
+#endif
+    pool.display( pics[0] );
+    assert( pool.stats().inUse == 3 );
+    // No buffer is free: the next picture gets a scratch buffer of its own,
+    // which doesn't alias any of the pictures being decoded
+    auto scratch = pool.lock( planes );
+    auto scratchData = static_cast<uint8_t*>( planes[0] );
+    for ( auto i = 0u; i < 3; ++i )
+        assert( scratch != pics[i] && scratchData != data[i] );
+    // Neither does the next one, while the first scratch buffer is in use
+    auto scratch2 = pool.lock( planes );
+    assert( scratch2 != scratch && static_cast<uint8_t*>( planes[0] ) != scratchData );
+    memset( scratchData, 0xff, size );
+    memset( planes[0], 0xff, size );
+    for ( auto i = 0u; i < 3; ++i )
+        assert( intact( i ) );
+    assert( pool.stats().starved == 2 );
+
+    // B frames: the last decoded picture is displayed first
+    pool.display( pics[2] );
+    pool.display( pics[1] );
+    assert( frames.size() == 3 );
+    assert( frames[1].sequence() == 2 && frames[2].sequence() == 1 );
+    assert( frames[1].plane( 0 )[0] == 22 && frames[2].plane( 0 )[0] == 21 );
+#if LIBVLC_VERSION_INT < LIBVLC_VERSION(4, 0, 0, 0)
+    for ( auto i = 0u; i < 3; ++i )
+        pool.unlock( pics[i], planes );
+#endif
+    present( pool, scratch, planes );
+    present( pool, scratch2, planes );
+    auto s = pool.stats();
+    assert( s.inUse == 3 && s.delivered == 3 && s.dropped == 2 );
+    // The scratch buffers were never delivered, and the first frame is the
+    // only buffer the consumer gave back
+    frames.erase( begin( frames ) );
+    assert( pool.stats().inUse == 2 );
+    auto pic = pool.lock( planes );
+    assert( pic == pics[0] );
+    present( pool, pic, planes );
+    frames.clear();
+    assert( pool.stats().inUse == 0 );
+}
+
+static void testFormatChange()
+{
+    VLC::FramePool pool( i420( 2 ) );
+    Frame held;
+    pool.setFrameCallback( [&held]( Frame f ) { held = std::move( f ); } );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 64, 32, pitches, lines );
+    void* planes[5];
+    auto pic = pool.lock( planes );
+    memset( planes[0], 42, pitches[0] * lines[0] );
+    present( pool, pic, planes );
+    pool.cleanup();
+
+    // The frame outlives the buffers it came from
+    negotiate( pool, 128, 64, pitches, lines );
+    pic = pool.lock( planes );
+    assert( held.width() == 64 );
+    assert( held.plane( 0 )[pitches[0] / 2 * lines[0] / 2 - 1] == 42 );
+    held.release();
+    present( pool, pic, planes );
+    assert( held.width() == 128 );
+}
+
+static void testHugePages()
+{
+    auto config = i420( 4 );
+    config.hugePages = true;
+    VLC::FramePool pool( config );
+    uint32_t pitches[5], lines[5];
+    negotiate( pool, 1920, 1080, pitches, lines );
+    void* planes[5];
+    auto pic = pool.lock( planes );
+    memset( planes[0], 0, pitches[0] * lines[0] );
+    pool.unlock( pic, planes );
+    // Whether reserved huge pages are available depends on the system
+    std::cout << "Huge pages: " << ( pool.stats().hugePages ? "yes" : "no" ) << std::endl;
+}
+
+int main()
+{
+    testLayout();
+    testNegotiation();
+    testPassthrough();
+    testDisplayBeforeUnlock();
+    testDelivery();
+    testStarvation();
+    testStarvationTimeout();
+    testStarvationWithoutScratch();
+    testFramesInFlight();
+    testFormatChange();
+    testHugePages();
+    std::cout << "All FramePool tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * imempool.cpp: Checks that the imem callbacks don't allocate once warm
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Counts the allocations going through operator new
+static std::atomic<size_t> nbAllocs{ 0 };
+
+void* operator new( size_t size )
+{
+    ++nbAllocs;
+    auto ptr = malloc( size );
+    if ( ptr == nullptr )
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    free( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept
+{
+    free( ptr );
+}
+
+namespace imem = VLC::imem;
+
+static const size_t NbEvents = 4;
+using Array = VLC::CallbackArray<NbEvents>;
+using Pool = imem::OpaquePool<NbEvents>;
+
+// The user data each open callback creates
+struct Context
+{
+    int opens;
+    int reads;
+    int closes;
+};
+
+// The callbacks libvlc would receive from a Media created with an open
+// callback, as Media's constructor wraps them
+struct Callbacks
+{
+    explicit Callbacks( Context* context )
+    {
+        open = imem::CallbackWrapper<0, libvlc_media_open_cb>::wrap<imem::BoxingStrategy::Setup>(
+                    array, [context]( void*, void** datap, uint64_t* sizep ) {
+                        ++context->opens;
+                        *datap = context;
+                        *sizep = 1000;
+                        return 0;
+                    } );
+        read = imem::CallbackWrapper<1, libvlc_media_read_cb>::wrap<imem::BoxingStrategy::Unbox>(
+                    array, []( void* opaque, unsigned char* buf, size_t len ) -> ptrdiff_t {
+                        ++static_cast<Context*>( opaque )->reads;
+                        buf[0] = 42;
+                        return static_cast<ptrdiff_t>( len );
+                    } );
+        close = imem::CallbackWrapper<3, libvlc_media_close_cb>::wrap<imem::BoxingStrategy::Cleanup>(
+                    array, []( void* opaque ) {
+                        ++static_cast<Context*>( opaque )->closes;
+                    } );
+    }
+
+    // Opens, reads & closes the media once
+    void cycle()
+    {
+        void* data = nullptr;
+        uint64_t size = 0;
+        assert( open( &array, &data, &size ) == 0 );
+        assert( size == 1000 && data != nullptr );
+        unsigned char buf[16] = {};
+        assert( read( data, buf, sizeof( buf ) ) == sizeof( buf ) );
+        assert( buf[0] == 42 );
+        close( data );
+    }
+
+    Array array;
+    libvlc_media_open_cb open;
+    libvlc_media_read_cb read;
+    libvlc_media_close_cb close;
+};
+
+static void testCycles()
+{
+    Context context{ 0, 0, 0 };
+    Callbacks callbacks( &context );
+    // Warm the pool up
+    callbacks.cycle();
+    auto allocs = nbAllocs.load();
+    for ( auto i = 0; i < 10000; ++i )
+        callbacks.cycle();
+    assert( nbAllocs.load() == allocs );
+    assert( context.opens == 10001 && context.reads == 10001 && context.closes == 10001 );
+}
+
+static void testOverflow()
+{
+    Context context{ 0, 0, 0 };
+    Callbacks callbacks( &context );
+    // More media opened at once than the pool keeps
+    std::vector<void*> opened( Pool::Size * 2 );
+    uint64_t size;
+    for ( auto& data : opened )
+        assert( callbacks.open( &callbacks.array, &data, &size ) == 0 );
+    for ( auto i = 0u; i < opened.size(); ++i )
+        for ( auto j = i + 1; j < opened.size(); ++j )
+            assert( opened[i] != opened[j] );
+    for ( auto data : opened )
+        callbacks.close( data );
+    assert( context.closes == static_cast<int>( opened.size() ) );
+    // The pool is full, and serves the next opens without allocating
+    auto allocs = nbAllocs.load();
+    for ( auto i = 0u; i < Pool::Size; ++i )
+        assert( callbacks.open( &callbacks.array, &opened[i], &size ) == 0 );
+    assert( nbAllocs.load() == allocs );
+    for ( auto i = 0u; i < Pool::Size; ++i )
+        callbacks.close( opened[i] );
+}
+
+// Several players open & close their media concurrently
+static void testConcurrent()
+{
+    std::vector<std::thread> players;
+    for ( auto p = 0; p < 8; ++p )
+    {
+        players.emplace_back( []() {
+            Context context{ 0, 0, 0 };
+            Callbacks callbacks( &context );
+            for ( auto i = 0; i < 20000; ++i )
+                callbacks.cycle();
+            assert( context.opens == 20000 && context.closes == 20000 );
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+}
+
+int main()
+{
+    testCycles();
+    testOverflow();
+    testConcurrent();
+    std::cout << "All imem pool tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*****************************************************************************
+ * latestframe.cpp: LatestFrame unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/LatestFrame.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static void negotiate( VLC::LatestFrame& latest, uint32_t width, uint32_t height )
+{
+    char chroma[5] = { 0 };
+    uint32_t pitches[5], lines[5];
+    assert( latest.setup( chroma, &width, &height, pitches, lines ) == 1 );
+}
+
+// Mimics libvlc decoding & displaying a frame
+static void decode( VLC::LatestFrame& latest, uint8_t value )
+{
+    void* planes[5];
+    auto pic = latest.lock( planes );
+    memset( planes[0], value, 64 * 4 * 16 );
+    latest.display( pic );
+}
+
+static void testIndex()
+{
+    VLC::detail::TripleBufferIndex idx;
+    assert( idx.acquire() == false );
+    auto b = idx.back();
+    assert( idx.publish() == false );
+    assert( idx.back() != b );
+    assert( idx.acquire() == true );
+    assert( idx.front() == b );
+    assert( idx.acquire() == false );
+    // Publish twice without reading: the first one is overwritten
+    auto b1 = idx.back();
+    assert( idx.publish() == false );
+    auto b2 = idx.back();
+    assert( idx.publish() == true );
+    assert( idx.acquire() == true );
+    assert( idx.front() == b2 );
+    assert( b1 != b2 );
+    // The 3 indices are always distinct
+    assert( idx.back() != idx.front() );
+}
+
+static void testLatest()
+{
+    VLC::LatestFrame latest;
+    assert( latest.acquire() == nullptr );
+    negotiate( latest, 64, 16 );
+    decode( latest, 1 );
+    auto f = latest.acquire();
+    assert( f != nullptr );
+    assert( f->sequence == 0 && f->plane( 0 )[0] == 1 );
+    assert( f->width() == 64 && f->height() == 16 );
+    assert( strcmp( f->chroma(), "RV32" ) == 0 );
+    // Nothing new: same frame
+    f = latest.acquire();
+    assert( f->sequence == 0 );
+    for ( auto i = 2; i < 6; ++i )
+        decode( latest, i );
+    // The reader's frame is left intact while the decoder carries on
+    assert( f->plane( 0 )[0] == 1 );
+    f = latest.acquire();
+    assert( f->sequence == 4 && f->plane( 0 )[0] == 5 );
+    auto s = latest.stats();
+    assert( s.published == 5 && s.acquired == 2 && s.overwritten == 3 );
+}
+
+static void testFormatChange()
+{
+    VLC::LatestFrame latest;
+    negotiate( latest, 64, 16 );
+    decode( latest, 1 );
+    auto f = latest.acquire();
+    negotiate( latest, 128, 32 );
+    decode( latest, 2 );
+    // The previous frame's buffers are still alive
+    assert( f->width() == 64 && f->plane( 0 )[0] == 1 );
+    f = latest.acquire();
+    assert( f->width() == 128 && f->plane( 0 )[0] == 2 );
+}
+
+// A writer publishing as fast as it can, while the reader checks that it
+// never sees a torn or stale frame.
+static void testConcurrent()
+{
+    const auto NbFrames = 200000u;
+    VLC::LatestFrame latest;
+    negotiate( latest, 64, 16 );
+    std::atomic<bool> done{ false };
+    std::thread writer( [&latest, &done, NbFrames]() {
+        void* planes[5];
+        for ( auto i = 0u; i < NbFrames; ++i )
+        {
+            auto pic = latest.lock( planes );
+            auto p = static_cast<uint8_t*>( planes[0] );
+            memcpy( p, &i, sizeof( i ) );
+            memset( p + sizeof( i ), i & 0xff, 64 * 4 * 16 - 2 * sizeof( i ) );
+            memcpy( p + 64 * 4 * 16 - sizeof( i ), &i, sizeof( i ) );
+            latest.display( pic );
+        }
+        done = true;
+    });
+    auto nbRead = 0u;
+    uint64_t lastSeq = 0;
+    while ( done == false || nbRead == 0 )
+    {
+        auto f = latest.acquire();
+        if ( f == nullptr )
+            continue;
+        assert( f->sequence >= lastSeq );
+        lastSeq = f->sequence;
+        auto p = f->plane( 0 );
+        unsigned first, last;
+        memcpy( &first, p, sizeof( first ) );
+        memcpy( &last, p + 64 * 4 * 16 - sizeof( last ), sizeof( last ) );
+        assert( first == f->sequence && last == first );
+        assert( p[64 * 4 * 8] == ( first & 0xff ) );
+        ++nbRead;
+    }
+    writer.join();
+    auto f = latest.acquire();
+    assert( f->sequence == NbFrames - 1 );
+    auto s = latest.stats();
+    assert( s.published == NbFrames );
+    assert( s.acquired + s.overwritten == NbFrames );
+}
+
+int main()
+{
+    testIndex();
+    testLatest();
+    testFormatChange();
+    testConcurrent();
+    std::cout << "All LatestFrame tests passed" << std::endl;
+    return 0;
+}
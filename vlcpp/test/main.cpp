@@ -100,8 +100,10 @@ int main(int ac, char** av)
     });
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
     handler->unregister();
-    // handler must be considered a dangling reference from now on.
-    // We might want to fix this, but is it worth the cost of a shared/weak_pointer?
+    // handler is now stale. Unregistering it again is harmless, even if its
+    // slot gets reused by another handler in the meantime.
+    assert( handler.isRegistered() == false );
+    handler->unregister();
     expected = false;
 
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
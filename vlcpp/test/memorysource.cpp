@@ -0,0 +1,184 @@
+/*****************************************************************************
+ * memorysource.cpp: MemorySource unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/MemorySource.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Source = VLC::MemorySource;
+
+static std::shared_ptr<const std::vector<uint8_t>> blob( size_t size )
+{
+    auto v = std::make_shared<std::vector<uint8_t>>( size );
+    for ( auto i = 0u; i < size; ++i )
+        (*v)[i] = static_cast<uint8_t>( i * 31 + ( i >> 8 ) );
+    return v;
+}
+
+static void testRead()
+{
+    auto buffer = blob( 10000 );
+    Source source( buffer );
+    assert( source.size() == 10000 && source.data() == buffer->data() );
+    auto stream = source.open();
+    assert( stream->size() == 10000 );
+    std::vector<uint8_t> out;
+    unsigned char chunk[3000];
+    ptrdiff_t n;
+    while ( ( n = stream->read( chunk, sizeof( chunk ) ) ) > 0 )
+        out.insert( out.end(), chunk, chunk + n );
+    assert( n == 0 );
+    assert( out == *buffer );
+    assert( stream->position() == 10000 );
+
+    assert( stream->seek( 9990 ) == 0 );
+    assert( stream->read( chunk, sizeof( chunk ) ) == 10 );
+    assert( memcmp( chunk, buffer->data() + 9990, 10 ) == 0 );
+    assert( stream->seek( 10000 ) == 0 && stream->read( chunk, 1 ) == 0 );
+    assert( stream->seek( 10001 ) == -1 && stream->position() == 10000 );
+
+    // Any contiguous container, or a span with its owner
+    auto text = std::make_shared<std::string>( "hello" );
+    auto s = Source( text ).open();
+    assert( s->read( chunk, 100 ) == 5 && memcmp( chunk, "hello", 5 ) == 0 );
+    static const char data[] = "static";
+    auto span = Source( data, 6, nullptr ).open();
+    assert( span->read( chunk, 2 ) == 2 && memcmp( chunk, "st", 2 ) == 0 );
+    assert( Source( nullptr, 0, nullptr ).open()->read( chunk, 1 ) == 0 );
+    try
+    {
+        Source( std::shared_ptr<const std::vector<uint8_t>>() );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+// The last one of the source & its streams releases the buffer
+static void testOwnership()
+{
+    auto buffer = blob( 100 );
+    std::weak_ptr<const std::vector<uint8_t>> weak = buffer;
+    std::unique_ptr<Source::Stream> stream;
+    {
+        Source source( std::move( buffer ) );
+        stream = source.open();
+    }
+    assert( weak.expired() == false );
+    unsigned char c;
+    assert( stream->seek( 99 ) == 0 && stream->read( &c, 1 ) == 1 );
+    stream.reset();
+    assert( weak.expired() == true );
+}
+
+// The callbacks a media created by mediaFromSource gives to libvlc
+static void testCallbacks()
+{
+    using Callbacks = VLC::detail::source::Callbacks<Source>;
+    auto buffer = blob( 1000 );
+    Callbacks::Open open{ Source( buffer ) };
+    void* a = nullptr;
+    void* b = nullptr;
+    uint64_t size = 0;
+    assert( open( nullptr, &a, &size ) == 0 && size == 1000 );
+    assert( open( nullptr, &b, &size ) == 0 && a != b );
+    unsigned char chunk[600];
+    assert( Callbacks::read( a, chunk, 600 ) == 600 );
+    assert( Callbacks::read( b, chunk, 100 ) == 100 );
+    assert( memcmp( chunk, buffer->data(), 100 ) == 0 );
+    assert( Callbacks::read( a, chunk, 600 ) == 400 );
+    assert( Callbacks::seek( a, 10 ) == 0 );
+    assert( Callbacks::read( a, chunk, 1 ) == 1 && chunk[0] == (*buffer)[10] );
+    Callbacks::close( a );
+    Callbacks::close( b );
+
+    // A source failing to open a stream by throwing fails the opening
+    struct Throwing
+    {
+        using Stream = Source::Stream;
+        std::unique_ptr<Stream> open() const
+        {
+            throw std::bad_alloc();
+        }
+    };
+    VLC::detail::source::Callbacks<Throwing>::Open failing{ Throwing() };
+    a = nullptr;
+    assert( failing( nullptr, &a, &size ) == -1 && a == nullptr );
+
+    // Without a functional libvlc, only check that the media can be built
+    try
+    {
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+        auto media = VLC::mediaFromSource( Source( buffer ) );
+#else
+        auto media = VLC::mediaFromSource( VLC::Instance( 0, nullptr ), Source( buffer ) );
+#endif
+    }
+    catch ( const std::runtime_error& )
+    {
+    }
+}
+
+// Many players read the same buffer concurrently
+static void testConcurrent()
+{
+    auto buffer = blob( 1 << 20 );
+    Source source( buffer );
+    std::vector<std::thread> players;
+    for ( auto p = 0u; p < 8; ++p )
+    {
+        players.emplace_back( [&source, &buffer, p]() {
+            auto stream = source.open();
+            unsigned char chunk[4096];
+            uint32_t state = p + 1;
+            for ( auto i = 0u; i < 2000; ++i )
+            {
+                state = state * 1664525u + 1013904223u;
+                auto offset = state % buffer->size();
+                assert( stream->seek( offset ) == 0 );
+                auto n = stream->read( chunk, 1 + state % sizeof( chunk ) );
+                assert( n > 0 && memcmp( chunk, buffer->data() + offset, n ) == 0 );
+            }
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+}
+
+int main()
+{
+    testRead();
+    testOwnership();
+    testCallbacks();
+    testConcurrent();
+    std::cout << "All MemorySource tests passed" << std::endl;
+    return 0;
+}
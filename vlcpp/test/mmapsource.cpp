@@ -0,0 +1,184 @@
+/*****************************************************************************
+ * mmapsource.cpp: MmapSource unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#if !defined(_WIN32)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/MmapSource.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using Source = VLC::MmapSource;
+
+// A temporary file, removed on destruction
+struct TempFile
+{
+    explicit TempFile( size_t size )
+        : content( size )
+    {
+        char name[] = "/tmp/vlcpp-mmapsource-XXXXXX";
+        auto fd = mkstemp( name );
+        assert( fd >= 0 );
+        path = name;
+        for ( auto i = 0u; i < size; ++i )
+            content[i] = static_cast<uint8_t>( i * 7 + ( i >> 12 ) );
+        size_t done = 0;
+        while ( done < size )
+        {
+            auto n = write( fd, content.data() + done, size - done );
+            assert( n > 0 );
+            done += static_cast<size_t>( n );
+        }
+        close( fd );
+    }
+
+    ~TempFile()
+    {
+        unlink( path.c_str() );
+    }
+
+    std::string path;
+    std::vector<uint8_t> content;
+};
+
+static std::vector<uint8_t> readAll( Source::Stream& stream, size_t chunkSize )
+{
+    std::vector<uint8_t> out;
+    std::vector<unsigned char> chunk( chunkSize );
+    ptrdiff_t n;
+    while ( ( n = stream.read( chunk.data(), chunk.size() ) ) > 0 )
+        out.insert( out.end(), chunk.begin(), chunk.begin() + n );
+    assert( n == 0 );
+    return out;
+}
+
+static void testRead()
+{
+    TempFile file( 3 * 1024 * 1024 + 123 );
+    Source source( file.path );
+    auto stream = source.open();
+    assert( stream != nullptr && stream->size() == file.content.size() );
+    assert( readAll( *stream, 1000 ) == file.content );
+    assert( stream->position() == file.content.size() );
+
+    unsigned char chunk[100];
+    assert( stream->seek( 1000 ) == 0 );
+    assert( stream->read( chunk, 100 ) == 100 );
+    assert( memcmp( chunk, file.content.data() + 1000, 100 ) == 0 );
+    assert( stream->seek( file.content.size() + 1 ) == -1 );
+    assert( stream->seek( file.content.size() ) == 0 && stream->read( chunk, 1 ) == 0 );
+}
+
+// Releasing the pages behind the position doesn't lose their content
+static void testHints()
+{
+    TempFile file( 4 * 1024 * 1024 );
+    Source::Configuration config;
+    config.readahead = 64 * 1024;
+    config.keepBehind = 16 * 1024;
+    Source source( file.path, config );
+    auto stream = source.open();
+    assert( readAll( *stream, 4096 ) == file.content );
+    assert( stream->seek( 0 ) == 0 );
+    assert( readAll( *stream, 65536 * 3 + 17 ) == file.content );
+    // Backward seeks, in the released region & in the kept one
+    unsigned char chunk[5000];
+    for ( auto offset : { 4000000u, 10u, 2000000u, 1990000u, 1000u } )
+    {
+        assert( stream->seek( offset ) == 0 );
+        assert( stream->read( chunk, sizeof( chunk ) ) == sizeof( chunk ) );
+        assert( memcmp( chunk, file.content.data() + offset, sizeof( chunk ) ) == 0 );
+    }
+
+    config.dropBehind = false;
+    assert( readAll( *Source( file.path, config ).open(), 100000 ) == file.content );
+    try
+    {
+        config.readahead = 0;
+        Source s( file.path, config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+static void testErrors()
+{
+    assert( Source( "/nonexistent/vlcpp/file" ).open() == nullptr );
+    // Not a regular file
+    assert( Source( "/tmp" ).open() == nullptr );
+    TempFile empty( 0 );
+    auto stream = Source( empty.path ).open();
+    assert( stream != nullptr && stream->size() == 0 );
+    unsigned char c;
+    assert( stream->read( &c, 1 ) == 0 );
+}
+
+static void testConcurrent()
+{
+    TempFile file( 2 * 1024 * 1024 );
+    Source::Configuration config;
+    config.readahead = 128 * 1024;
+    config.keepBehind = 0;
+    Source source( file.path, config );
+    std::vector<std::thread> players;
+    for ( auto p = 0u; p < 8; ++p )
+    {
+        players.emplace_back( [&source, &file, p]() {
+            auto stream = source.open();
+            assert( stream != nullptr );
+            assert( readAll( *stream, 1024 * ( p + 1 ) ) == file.content );
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+}
+
+int main()
+{
+    testRead();
+    testHints();
+    testErrors();
+    testConcurrent();
+    std::cout << "All MmapSource tests passed" << std::endl;
+    return 0;
+}
+
+#else
+
+int main()
+{
+    // Skipped: the memory mapped file source is POSIX only
+    return 77;
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*****************************************************************************
+ * prefetchsource.cpp: PrefetchSource unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/MemorySource.hpp"
+#include "vlcpp/PrefetchSource.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+///
+/// A source wrapping a MemorySource, with a latency on each read, and an
+/// optional failure once a given offset is reached
+///
+struct SlowSource
+{
+    class Stream
+    {
+    public:
+        Stream( std::unique_ptr<VLC::MemorySource::Stream> inner, const SlowSource& source )
+            : m_inner( std::move( inner ) ), m_source( source )
+        {
+        }
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            std::this_thread::sleep_for( m_source.latency );
+            ++*m_source.reads;
+            if ( m_inner->position() >= m_source.failAt )
+                return -1;
+            return m_inner->read( buf, len );
+        }
+
+        int seek( uint64_t offset )
+        {
+            ++*m_source.seeks;
+            return m_inner->seek( offset );
+        }
+
+        uint64_t size() const
+        {
+            return m_inner->size();
+        }
+
+    private:
+        std::unique_ptr<VLC::MemorySource::Stream> m_inner;
+        const SlowSource& m_source;
+    };
+
+    std::unique_ptr<Stream> open() const
+    {
+        return std::unique_ptr<Stream>( new Stream( memory.open(), *this ) );
+    }
+
+    VLC::MemorySource memory;
+    std::chrono::microseconds latency;
+    uint64_t failAt;
+    std::shared_ptr<std::atomic<unsigned>> reads;
+    std::shared_ptr<std::atomic<unsigned>> seeks;
+};
+
+using Prefetch = VLC::PrefetchSource<SlowSource>;
+
+static std::shared_ptr<const std::vector<uint8_t>> blob( size_t size )
+{
+    auto v = std::make_shared<std::vector<uint8_t>>( size );
+    for ( auto i = 0u; i < size; ++i )
+        (*v)[i] = static_cast<uint8_t>( i * 13 + ( i >> 10 ) );
+    return v;
+}
+
+static SlowSource slow( std::shared_ptr<const std::vector<uint8_t>> buffer,
+                        std::chrono::microseconds latency, uint64_t failAt = UINT64_MAX )
+{
+    return SlowSource{ VLC::MemorySource( std::move( buffer ) ), latency, failAt,
+                       std::make_shared<std::atomic<unsigned>>( 0 ),
+                       std::make_shared<std::atomic<unsigned>>( 0 ) };
+}
+
+static VLC::PrefetchSource<SlowSource>::Configuration ring( size_t chunkSize, size_t nbChunks )
+{
+    Prefetch::Configuration config;
+    config.chunkSize = chunkSize;
+    config.nbChunks = nbChunks;
+    return config;
+}
+
+static void testRead()
+{
+    auto buffer = blob( 1000000 );
+    Prefetch source( slow( buffer, std::chrono::microseconds( 0 ) ), ring( 4096, 8 ) );
+    auto stream = source.open();
+    assert( stream->size() == buffer->size() );
+    std::vector<uint8_t> out;
+    std::vector<unsigned char> chunk( 10000 );
+    auto len = 1u;
+    ptrdiff_t n;
+    while ( ( n = stream->read( chunk.data(), len ) ) > 0 )
+    {
+        out.insert( out.end(), chunk.begin(), chunk.begin() + n );
+        len = len * 7 % 9999 + 1;
+    }
+    assert( n == 0 && out == *buffer );
+    assert( stream->read( chunk.data(), 1 ) == 0 );
+    auto s = source.stats();
+    assert( s.reads == s.hits + s.misses );
+    assert( s.prefetched == buffer->size() && s.discarded == 0 );
+}
+
+static void testSeek()
+{
+    auto buffer = blob( 1 << 20 );
+    auto inner = slow( buffer, std::chrono::microseconds( 0 ) );
+    Prefetch source( inner, ring( 1024, 16 ) );
+    auto stream = source.open();
+    unsigned char chunk[100];
+    assert( stream->read( chunk, 100 ) == 100 );
+    // Let the ring fill up
+    while ( source.stats().prefetched < 16 * 1024 )
+        std::this_thread::yield();
+    // Within the prefetched data, nothing is discarded
+    assert( stream->seek( 5000 ) == 0 );
+    assert( stream->read( chunk, 100 ) == 100 );
+    assert( memcmp( chunk, buffer->data() + 5000, 100 ) == 0 );
+    assert( stream->seek( 5100 ) == 0 );
+    auto s = source.stats();
+    assert( s.seeks == 2 && s.reprimes == 0 && s.discarded == 0 );
+    assert( inner.seeks->load() == 0 );
+
+    // Backward, and far forward seeks reprime the ring
+    for ( auto offset : { 0u, 500000u, 100u, 1048000u } )
+    {
+        assert( stream->seek( offset ) == 0 );
+        assert( stream->position() == offset );
+        assert( stream->read( chunk, 100 ) == 100 );
+        assert( memcmp( chunk, buffer->data() + offset, 100 ) == 0 );
+    }
+    s = source.stats();
+    assert( s.reprimes == 4 && s.discarded > 0 );
+    assert( stream->seek( buffer->size() + 1 ) == -1 );
+    assert( stream->seek( buffer->size() ) == 0 );
+    assert( stream->read( chunk, 100 ) == 0 );
+}
+
+static void testErrors()
+{
+    auto buffer = blob( 10000 );
+    Prefetch source( slow( buffer, std::chrono::microseconds( 0 ), 4096 ), ring( 1024, 4 ) );
+    auto stream = source.open();
+    std::vector<unsigned char> chunk( 10000 );
+    size_t total = 0;
+    ptrdiff_t n;
+    while ( ( n = stream->read( chunk.data(), chunk.size() ) ) > 0 )
+        total += static_cast<size_t>( n );
+    // The data read before the failure is served, then the error
+    assert( n == -1 && total == 4096 );
+    // A seek recovers
+    assert( stream->seek( 0 ) == 0 );
+    assert( stream->read( chunk.data(), 10 ) == 10 );
+
+    // Failing to open the wrapped source
+    struct Failing
+    {
+        using Stream = VLC::MemorySource::Stream;
+        std::unique_ptr<Stream> open() const { return nullptr; }
+    };
+    assert( VLC::prefetch( Failing() ).open() == nullptr );
+    try
+    {
+        Prefetch p( slow( buffer, std::chrono::microseconds( 0 ) ), ring( 0, 4 ) );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+}
+
+// The prefetching hides the latency of the wrapped source from a consumer
+// which reads at a slower pace
+static void testLatency()
+{
+    auto buffer = blob( 64 * 1024 );
+    Prefetch source( slow( buffer, std::chrono::milliseconds( 2 ) ), ring( 4096, 16 ) );
+    auto stream = source.open();
+    unsigned char chunk[4096];
+    // The first read waits for the wrapped source
+    assert( stream->read( chunk, sizeof( chunk ) ) == sizeof( chunk ) );
+    assert( source.stats().misses == 1 );
+    assert( source.stats().stallTime >= std::chrono::milliseconds( 1 ) );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    for ( auto i = 0u; i < 15; ++i )
+        assert( stream->read( chunk, sizeof( chunk ) ) == sizeof( chunk ) );
+    auto s = source.stats();
+    assert( s.hits == 15 && s.misses == 1 );
+}
+
+// Seeking & destroying the stream while the wrapped source is reading
+static void testCancel()
+{
+    auto buffer = blob( 1 << 20 );
+    auto inner = slow( buffer, std::chrono::milliseconds( 20 ) );
+    Prefetch source( inner, ring( 65536, 4 ) );
+    {
+        auto stream = source.open();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+        assert( stream->seek( 900000 ) == 0 );
+        unsigned char chunk[100];
+        assert( stream->read( chunk, 100 ) == 100 );
+        assert( memcmp( chunk, buffer->data() + 900000, 100 ) == 0 );
+        assert( inner.seeks->load() == 1 );
+    }
+    // Destroyed while reading
+    auto stream = source.open();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    stream.reset();
+}
+
+static void testConcurrent()
+{
+    auto buffer = blob( 1 << 20 );
+    auto source = VLC::prefetch( VLC::MemorySource( buffer ), ring( 8192, 8 ) );
+    std::vector<std::thread> players;
+    for ( auto p = 0u; p < 8; ++p )
+    {
+        players.emplace_back( [&source, &buffer, p]() {
+            auto stream = source.open();
+            unsigned char chunk[3000];
+            uint32_t state = p + 1;
+            for ( auto i = 0u; i < 300; ++i )
+            {
+                state = state * 1664525u + 1013904223u;
+                uint64_t offset = state % buffer->size();
+                if ( i % 4 == 0 )
+                    assert( stream->seek( offset ) == 0 );
+                else
+                    offset = stream->position();
+                auto n = stream->read( chunk, 1 + state % sizeof( chunk ) );
+                assert( n >= 0 );
+                assert( memcmp( chunk, buffer->data() + offset, static_cast<size_t>( n ) ) == 0 );
+            }
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+    auto s = source.stats();
+    assert( s.reads == 8 * 300 && s.seeks == 8 * 75 );
+}
+
+int main()
+{
+    testRead();
+    testSeek();
+    testErrors();
+    testLatency();
+    testCancel();
+    testConcurrent();
+    std::cout << "All PrefetchSource tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,273 @@
+/*****************************************************************************
+ * sharedframes.cpp: SharedFramePublisher & SharedFrameReader unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#if defined(__linux__)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/SharedFramePublisher.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Publisher = VLC::SharedFramePublisher;
+using Reader = VLC::SharedFrameReader;
+
+static Publisher::Configuration grey( unsigned nbSlots )
+{
+    Publisher::Configuration config;
+    config.chroma = "GREY";
+    config.width = 64;
+    config.height = 16;
+    config.nbSlots = nbSlots;
+    return config;
+}
+
+static void negotiate( Publisher& pub, const char* fourcc, unsigned w, unsigned h )
+{
+    char chroma[5];
+    memcpy( chroma, fourcc, 5 );
+    uint32_t width = w, height = h;
+    uint32_t pitches[5], lines[5];
+    assert( pub.setup( chroma, &width, &height, pitches, lines ) == 1 );
+}
+
+// Decodes a frame filled with the provided value, as libvlc would
+static void decode( Publisher& pub, uint8_t value, bool show = true )
+{
+    void* planes[5];
+    auto pic = pub.lock( planes );
+    memset( planes[0], value, 64 * 16 );
+    if ( show == true )
+        pub.display( pic );
+}
+
+static void testPublish()
+{
+    auto config = grey( 4 );
+    int64_t pts = 1000;
+    config.clock = [&pts]() { return pts; };
+    Publisher pub( config );
+    Reader reader( pub.fd() );
+    assert( reader.nbSlots() == 4 );
+    negotiate( pub, "I420", 64, 16 );
+    Reader::Frame f;
+    assert( reader.next( f ) == false );
+    assert( reader.wait( std::chrono::microseconds( 1000 ) ) == false );
+
+    decode( pub, 42 );
+    assert( reader.wait( std::chrono::microseconds( 0 ) ) == true );
+    assert( reader.next( f ) == true );
+    assert( f.sequence == 0 && f.pts == 1000 );
+    assert( f.width == 64 && f.height == 16 && strcmp( f.chroma, "GREY" ) == 0 );
+    assert( f.nbPlanes == 1 && f.pitch( 0 ) == 64 && f.nbLines( 0 ) == 16 );
+    assert( f.date > 0 && f.date <= Reader::now() );
+    for ( auto i = 0u; i < 64 * 16; ++i )
+        assert( f.plane( 0 )[i] == 42 );
+    assert( reader.valid( f ) == true );
+    assert( reader.next( f ) == false );
+
+    // A frame which wasn't displayed is never published
+    decode( pub, 1, false );
+    pts = 2000;
+    decode( pub, 43 );
+    assert( reader.next( f ) == true );
+    assert( f.sequence == 1 && f.pts == 2000 && f.plane( 0 )[0] == 43 );
+    auto stats = pub.stats();
+    assert( stats.published == 2 && stats.dropped == 1 && stats.passthrough == false );
+}
+
+static void testOverrun()
+{
+    Publisher pub( grey( 4 ) );
+    Reader reader( pub.fd() );
+    negotiate( pub, "GREY", 64, 16 );
+    decode( pub, 0 );
+    Reader::Frame first;
+    assert( reader.next( first ) == true );
+    assert( reader.valid( first ) == true );
+    // Going around the ring overwrites the frame being read
+    for ( auto i = 1u; i < 10; ++i )
+        decode( pub, static_cast<uint8_t>( i ) );
+    assert( reader.valid( first ) == false );
+    // Only the last 4 frames are left, the older ones are skipped
+    Reader::Frame f;
+    assert( reader.next( f ) == true );
+    assert( f.sequence == 6 && f.plane( 0 )[0] == 6 );
+    assert( reader.latest( f ) == true );
+    assert( f.sequence == 9 && f.plane( 0 )[0] == 9 );
+    assert( reader.latest( f ) == false );
+    auto stats = reader.stats();
+    assert( stats.received == 3 && stats.torn == 1 );
+    assert( stats.skipped == 7 );
+}
+
+static void testFormats()
+{
+    // Keep the source dimensions, within a fixed slot size
+    Publisher::Configuration config;
+    config.chroma = "GREY";
+    config.nativeChromas = { "I420" };
+    config.nbSlots = 2;
+    config.slotSize = 4096;
+    Publisher pub( config );
+    Reader reader( pub.fd() );
+    negotiate( pub, "I420", 64, 16 );
+    assert( pub.stats().passthrough == true );
+    void* planes[5];
+    pub.display( pub.lock( planes ) );
+    Reader::Frame f;
+    assert( reader.next( f ) == true );
+    assert( strcmp( f.chroma, "I420" ) == 0 && f.nbPlanes == 3 );
+    assert( f.offsets[1] == 64 * 16 && f.pitch( 1 ) == 64 && f.nbLines( 1 ) == 8 );
+
+    char chroma[5] = "I420";
+    uint32_t width = 1920, height = 1080;
+    uint32_t pitches[5], lines[5];
+    assert( pub.setup( chroma, &width, &height, pitches, lines ) == 0 );
+    assert( pub.stats().oversized == 1 );
+}
+
+static void testInvalid()
+{
+    auto config = grey( 1 );
+    try
+    {
+        Publisher p( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    config = grey( 4 );
+    config.width = 0;
+    try
+    {
+        Publisher p( config );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    try
+    {
+        Reader r( std::string( "/vlcpp-test-missing" ) );
+        assert( false );
+    }
+    catch ( const std::runtime_error& )
+    {
+    }
+    config = grey( 4 );
+    config.name = "/vlcpp-test-" + std::to_string( getpid() );
+    Publisher p( config );
+    // Names are exclusive
+    try
+    {
+        Publisher p2( config );
+        assert( false );
+    }
+    catch ( const std::runtime_error& )
+    {
+    }
+}
+
+// A child process reads the frames published by its parent
+static void testCrossProcess()
+{
+    const unsigned NbFrames = 200;
+    auto config = grey( 8 );
+    config.name = "/vlcpp-test-" + std::to_string( getpid() );
+    std::unique_ptr<Publisher> pub( new Publisher( config ) );
+    int ready[2];
+    assert( pipe( ready ) == 0 );
+    auto pid = fork();
+    assert( pid >= 0 );
+    if ( pid == 0 )
+    {
+        Reader reader( config.name );
+        char c = 0;
+        if ( write( ready[1], &c, 1 ) != 1 )
+            _exit( 1 );
+        Reader::Frame f;
+        uint64_t last = 0;
+        bool first = true;
+        do
+        {
+            while ( reader.next( f ) == true )
+            {
+                bool same = true;
+                for ( auto i = 0u; i < 64 * 16; ++i )
+                    same &= f.plane( 0 )[i] == static_cast<uint8_t>( f.sequence );
+                // A frame overwritten while being checked can be inconsistent
+                if ( reader.valid( f ) == true && same == false )
+                    _exit( 2 );
+                if ( first == false && f.sequence <= last )
+                    _exit( 3 );
+                last = f.sequence;
+                first = false;
+            }
+        } while ( reader.wait( std::chrono::seconds( 5 ) ) == true );
+        if ( reader.closed() == false || last != NbFrames - 1 )
+            _exit( 4 );
+        _exit( 0 );
+    }
+    char c;
+    assert( read( ready[0], &c, 1 ) == 1 );
+    close( ready[0] );
+    close( ready[1] );
+    negotiate( *pub, "GREY", 64, 16 );
+    for ( auto i = 0u; i < NbFrames; ++i )
+    {
+        decode( *pub, static_cast<uint8_t>( i ) );
+        if ( i % 16 == 0 )
+            usleep( 1000 );
+    }
+    pub.reset();
+    int status;
+    assert( waitpid( pid, &status, 0 ) == pid );
+    assert( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+}
+
+int main()
+{
+    testPublish();
+    testOverrun();
+    testFormats();
+    testInvalid();
+    testCrossProcess();
+    std::cout << "All SharedFrame tests passed" << std::endl;
+    return 0;
+}
+
+#else
+
+int main()
+{
+    // Skipped: the shared memory frame ring is Linux only
+    return 77;
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * tracer.cpp: EventTracer unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+#ifndef LIBVLCPP_EVENT_TRACING
+# define LIBVLCPP_EVENT_TRACING
+#endif
+
+#include "vlcpp/EventTracer.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static void testHistogramPrecision()
+{
+    using H = VLC::LatencyHistogram;
+    // Small values are exact
+    for ( auto v = 0u; v < H::SubBuckets; ++v )
+        assert( H::highestEquivalentValue( H::bucketIndex( v ) ) == v );
+    // Larger ones are within 1/16th
+    for ( uint64_t v = H::SubBuckets; v < ( uint64_t{ 1 } << 40 ); v = v * 3 / 2 + 1 )
+    {
+        auto idx = H::bucketIndex( v );
+        assert( idx < H::NbBuckets );
+        auto high = H::highestEquivalentValue( idx );
+        assert( high >= v );
+        assert( high - v <= v / H::SubBuckets );
+        // Buckets are contiguous
+        assert( H::bucketIndex( high ) == idx );
+        assert( H::bucketIndex( high + 1 ) == idx + 1 );
+    }
+    // Huge values are clamped
+    assert( H::bucketIndex( UINT64_MAX ) == H::NbBuckets - 1 );
+}
+
+static void testPercentiles()
+{
+    VLC::LatencyHistogram h;
+    assert( h.percentile( 50 ) == 0 );
+    for ( auto v = 1u; v <= 1000; ++v )
+        h.record( v * 1000 );
+    assert( h.count() == 1000 );
+    assert( h.max() == 1000000 );
+    assert( h.mean() == 500500. );
+    auto p50 = h.percentile( 50 );
+    assert( p50 >= 500000 && p50 <= 500000 + 500000 / 16 );
+    auto p99 = h.percentile( 99 );
+    assert( p99 >= 990000 && p99 <= 990000 + 990000 / 16 );
+    assert( h.percentile( 100 ) == 1000000 );
+    h.reset();
+    assert( h.count() == 0 && h.max() == 0 );
+}
+
+static void testTracer()
+{
+    auto& tracer = VLC::EventTracer::instance();
+    tracer.reset();
+    assert( tracer.eventStats( libvlc_MediaPlayerTimeChanged ) == nullptr );
+    for ( auto i = 0u; i < VLC::EventTracer::RingSize + 10; ++i )
+        tracer.record( libvlc_MediaPlayerTimeChanged, 100, 150, 400 );
+    tracer.record( libvlc_MediaPlayerPaused, 1000, 3000, 3010 );
+
+    auto s = tracer.eventStats( libvlc_MediaPlayerTimeChanged );
+    assert( s != nullptr );
+    assert( s->eventType == libvlc_MediaPlayerTimeChanged );
+    assert( s->overhead.count() == VLC::EventTracer::RingSize + 10 );
+    assert( s->overhead.max() == 50 );
+    assert( s->duration.max() == 250 );
+
+    auto records = tracer.recentEvents();
+    assert( records.size() == VLC::EventTracer::RingSize );
+    assert( records.back().eventType == libvlc_MediaPlayerPaused );
+    assert( records.back().timestamp == 3000 );
+    assert( records.back().overhead == 2000 );
+    assert( records.back().duration == 10 );
+
+    std::ostringstream json;
+    tracer.dump( json, VLC::EventTracer::Format::Json );
+    auto str = json.str();
+    assert( str.find( "{\"events\":[{\"type\":" ) == 0 );
+    assert( str.find( "\"overhead\":{\"count\":4106,\"mean\":50" ) != std::string::npos );
+    assert( str.find( "\"duration\":{\"count\":1,\"mean\":10" ) != std::string::npos );
+
+    std::ostringstream text;
+    tracer.dump( text );
+    assert( text.str().find( "overhead" ) != std::string::npos );
+    std::cout << text.str();
+}
+
+int main()
+{
+    testHistogramPrecision();
+    testPercentiles();
+    testTracer();
+    std::cout << "All EventTracer tests passed" << std::endl;
+    return 0;
+}
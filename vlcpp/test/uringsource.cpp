@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * uringsource.cpp: UringSource unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#if defined(__linux__)
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/UringSource.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// A temporary file, removed on destruction
+struct TempFile
+{
+    explicit TempFile( size_t size )
+        : content( size )
+    {
+        char name[] = "/tmp/vlcpp-uringsource-XXXXXX";
+        auto fd = mkstemp( name );
+        assert( fd >= 0 );
+        path = name;
+        for ( auto i = 0u; i < size; ++i )
+            content[i] = static_cast<uint8_t>( i * 7 + ( i >> 12 ) );
+        size_t done = 0;
+        while ( done < size )
+        {
+            auto n = write( fd, content.data() + done, size - done );
+            assert( n > 0 );
+            done += static_cast<size_t>( n );
+        }
+        close( fd );
+    }
+
+    ~TempFile()
+    {
+        unlink( path.c_str() );
+    }
+
+    std::string path;
+    std::vector<uint8_t> content;
+};
+
+static std::shared_ptr<VLC::IoUring> ring( size_t chunkSize, size_t nbBuffers,
+                                           bool forcePread = false )
+{
+    VLC::IoUring::Configuration config;
+    config.chunkSize = chunkSize;
+    config.nbBuffers = nbBuffers;
+    config.forcePread = forcePread;
+    return std::make_shared<VLC::IoUring>( config );
+}
+
+static VLC::UringSource::Configuration window( size_t nbChunks, bool direct = false )
+{
+    VLC::UringSource::Configuration config;
+    config.nbChunks = nbChunks;
+    config.direct = direct;
+    return config;
+}
+
+static std::vector<uint8_t> readAll( VLC::UringSource::Stream& stream, size_t chunk )
+{
+    std::vector<uint8_t> out;
+    std::vector<unsigned char> buf( chunk );
+    ptrdiff_t n;
+    while ( ( n = stream.read( buf.data(), buf.size() ) ) > 0 )
+        out.insert( end( out ), buf.data(), buf.data() + n );
+    assert( n == 0 );
+    return out;
+}
+
+static void testRead( const std::shared_ptr<VLC::IoUring>& r, bool direct )
+{
+    TempFile file( 1000000 );
+    VLC::UringSource source( file.path, window( 4, direct ), r );
+    auto stream = source.open();
+    assert( stream != nullptr );
+    assert( stream->size() == file.content.size() );
+    assert( readAll( *stream, 10000 ) == file.content );
+    // Reads larger than the chunks are short
+    assert( stream->seek( 0 ) == 0 );
+    assert( readAll( *stream, 100000 ) == file.content );
+
+    // Random seeks, within & out of the window
+    std::mt19937 rng( 7 );
+    std::vector<unsigned char> buf( 20000 );
+    for ( auto i = 0; i < 500; ++i )
+    {
+        auto offset = rng() % ( file.content.size() + 1 );
+        auto len = 1 + rng() % buf.size();
+        assert( stream->seek( offset ) == 0 );
+        auto n = stream->read( buf.data(), len );
+        assert( n >= 0 && static_cast<size_t>( n ) <= len );
+        assert( ( n == 0 ) == ( offset == file.content.size() ) );
+        assert( memcmp( buf.data(), file.content.data() + offset, n ) == 0 );
+        assert( stream->position() == offset + n );
+    }
+    assert( stream->seek( file.content.size() + 1 ) == -1 );
+}
+
+static void testRing()
+{
+    auto r = ring( 16384, 16 );
+    testRead( r, false );
+    auto s = r->stats();
+    if ( r->available() == true )
+    {
+        // The reads of each window were batched
+        assert( s.requests > 0 && s.submissions < s.requests );
+        assert( s.preads == 0 );
+        if ( r->fixedBuffers() == true )
+            assert( s.fixedReads > 0 );
+    }
+    else
+        assert( s.preads > 0 );
+
+    // O_DIRECT, or buffered reads where the file system can't
+    testRead( ring( 16384, 16 ), true );
+}
+
+static void testFallback()
+{
+    auto r = ring( 16384, 16, true );
+    assert( r->available() == false );
+    testRead( r, false );
+    auto s = r->stats();
+    assert( s.requests == 0 && s.preads > 0 );
+}
+
+static void testBuffers()
+{
+    // More chunks than the pool holds: the streams use their own buffers
+    auto r = ring( 8192, 4 );
+    TempFile file( 300000 );
+    VLC::UringSource source( file.path, window( 3 ), r );
+    auto a = source.open();
+    auto b = source.open();
+    auto c = source.open();
+    assert( readAll( *a, 5000 ) == file.content );
+    assert( readAll( *b, 5000 ) == file.content );
+    assert( readAll( *c, 5000 ) == file.content );
+    c.reset();
+    b.reset();
+    // The buffers went back to the pool
+    auto d = source.open();
+    assert( readAll( *d, 5000 ) == file.content );
+
+    // An empty file
+    TempFile empty( 0 );
+    VLC::UringSource none( empty.path, window( 3 ), r );
+    auto e = none.open();
+    unsigned char byte;
+    assert( e->size() == 0 && e->read( &byte, 1 ) == 0 );
+}
+
+static void testErrors()
+{
+    VLC::UringSource missing( "/nonexistent/file.mkv", window( 4 ), ring( 4096, 1 ) );
+    assert( missing.open() == nullptr );
+    VLC::UringSource directory( "/tmp", window( 4 ), ring( 4096, 1 ) );
+    assert( directory.open() == nullptr );
+
+    auto invalid = []( size_t chunkSize, size_t nbChunks ) {
+        try
+        {
+            VLC::UringSource( "/tmp/file", window( nbChunks ), ring( chunkSize, 1 ) );
+            return false;
+        }
+        catch ( const std::invalid_argument& )
+        {
+            return true;
+        }
+    };
+    assert( invalid( 0, 4 ) );
+    assert( invalid( 1000, 4 ) );
+    assert( invalid( 4096, 0 ) );
+    assert( invalid( 4096, 4 ) == false );
+    try
+    {
+        VLC::UringSource s( "/tmp/file", window( 4 ), nullptr );
+        assert( false );
+    }
+    catch ( const std::invalid_argument& )
+    {
+    }
+    // The sources share the process instance by default
+    assert( VLC::IoUring::shared() == VLC::IoUring::shared() );
+}
+
+// A read completing short of the end of the file isn't taken for it
+static void testShortRead( const std::shared_ptr<VLC::IoUring>& r )
+{
+    const size_t chunkSize = 16384;
+    TempFile file( 4 * chunkSize );
+    VLC::UringSource source( file.path, window( 4 ), r );
+    auto stream = source.open();
+    assert( stream != nullptr );
+    // The first read submits the whole window, while the file is truncated
+    // in the middle of the second chunk
+    assert( truncate( file.path.c_str(), chunkSize + chunkSize / 2 ) == 0 );
+    std::vector<unsigned char> buf( chunkSize );
+    assert( stream->read( buf.data(), 100 ) == 100 );
+    // Put the rest back before it's read
+    auto fd = open( file.path.c_str(), O_WRONLY );
+    assert( fd >= 0 );
+    auto rest = file.content.size() - ( chunkSize + chunkSize / 2 );
+    assert( pwrite( fd, file.content.data() + chunkSize + chunkSize / 2, rest,
+                    static_cast<off_t>( chunkSize + chunkSize / 2 ) ) ==
+            static_cast<ssize_t>( rest ) );
+    close( fd );
+    auto content = readAll( *stream, 1000 );
+    content.insert( begin( content ), file.content.data(), file.content.data() + 100 );
+    assert( content == file.content );
+
+    // A file which stays truncated ends early
+    stream = source.open();
+    assert( truncate( file.path.c_str(), chunkSize + chunkSize / 2 ) == 0 );
+    assert( stream->seek( 3 * chunkSize ) == 0 );
+    assert( stream->read( buf.data(), buf.size() ) == 0 );
+}
+
+// Many players, each on its own thread, share the ring
+static void testConcurrent()
+{
+    TempFile file( 2 * 1024 * 1024 );
+    auto r = ring( 32768, 32 );
+    VLC::UringSource source( file.path, window( 8 ), r );
+    std::vector<std::thread> players;
+    for ( auto p = 0u; p < 16; ++p )
+    {
+        players.emplace_back( [&source, &file, p]() {
+            auto stream = source.open();
+            assert( stream != nullptr );
+            std::mt19937 rng( p );
+            std::vector<unsigned char> buf( 40000 );
+            for ( auto i = 0; i < 300; ++i )
+            {
+                if ( rng() % 16 == 0 )
+                    stream->seek( rng() % file.content.size() );
+                auto offset = stream->position();
+                auto n = stream->read( buf.data(), 1 + rng() % buf.size() );
+                assert( n >= 0 );
+                assert( memcmp( buf.data(), file.content.data() + offset, n ) == 0 );
+                if ( n == 0 )
+                    stream->seek( 0 );
+            }
+        } );
+    }
+    for ( auto& t : players )
+        t.join();
+}
+
+int main()
+{
+    testRing();
+    testFallback();
+    testBuffers();
+    testErrors();
+    testShortRead( ring( 16384, 8 ) );
+    testShortRead( ring( 16384, 8, true ) );
+    testConcurrent();
+    std::cout << "All UringSource tests passed" << std::endl;
+    return 0;
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+    std::cout << "io_uring is only available on Linux" << std::endl;
+    return 77;
+}
+
+#endif
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * videotimings.cpp: VideoTimings unit tests
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#include "vlcpp/vlc.hpp"
+#include "vlcpp/VideoTimings.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Timings = VLC::VideoTimings;
+
+static void testExclusiveRecording()
+{
+    VLC::LatencyHistogram a, b;
+    for ( uint64_t v = 1; v < ( uint64_t{ 1 } << 36 ); v = v * 5 / 3 + 7 )
+    {
+        a.record( v );
+        b.recordExclusive( v );
+    }
+    assert( a.count() == b.count() && a.sum() == b.sum() && a.max() == b.max() );
+    for ( auto i = 0u; i < VLC::LatencyHistogram::NbBuckets; ++i )
+        assert( a.bucketCount( i ) == b.bucketCount( i ) );
+}
+
+static void testCallbacks()
+{
+    Timings timings;
+    int pictures[2];
+    unsigned nbLocks = 0, nbUnlocks = 0, nbDisplays = 0;
+    auto c = timings.decorate(
+        [&]( void** planes ) -> void* {
+            planes[0] = &pictures[1];
+            return &pictures[nbLocks++ % 2];
+        },
+        [&]( void* picture, void* const* planes ) {
+            assert( picture == &pictures[nbUnlocks++ % 2] );
+            assert( planes[0] == &pictures[1] );
+        },
+        [&]( void* picture ) {
+            assert( picture == &pictures[nbDisplays++ % 2] );
+        } );
+    void* planes[1];
+    for ( auto i = 0; i < 4; ++i )
+    {
+        auto pic = c.lock( planes );
+        c.unlock( pic, planes );
+        c.display( pic );
+    }
+    assert( nbLocks == 4 && nbUnlocks == 4 && nbDisplays == 4 );
+
+    // The unlock & display callbacks are optional
+    Timings other;
+    auto c2 = other.decorate( [&]( void** ) -> void* { return &pictures[0]; }, nullptr, nullptr );
+    auto pic = c2.lock( planes );
+    c2.unlock( pic, planes );
+    c2.display( pic );
+    auto s = other.snapshot();
+    assert( s.locked == 1 && s.displayed == 1 && s.hold.count == 1 );
+}
+
+static void testTimings()
+{
+    Timings timings;
+    int picture;
+    auto c = timings.decorate( [&]( void** ) -> void* { return &picture; }, nullptr, nullptr );
+    void* planes[1];
+    // Alternate between 2 & 4ms intervals, holding each picture for 1ms
+    for ( auto i = 0; i < 21; ++i )
+    {
+        auto pic = c.lock( planes );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        c.unlock( pic, planes );
+        c.display( pic );
+        std::this_thread::sleep_for( std::chrono::milliseconds( i % 2 == 0 ? 1 : 3 ) );
+    }
+    auto s = timings.snapshot();
+    assert( s.locked == 21 && s.displayed == 21 && s.untracked == 0 );
+    assert( s.hold.count == 21 );
+    assert( s.hold.p50 >= 1000000 && s.hold.mean >= 1000000. );
+    assert( s.hold.p50 <= s.hold.p90 && s.hold.p90 <= s.hold.p99 && s.hold.p99 <= s.hold.max );
+    assert( s.displayInterval.count == 20 );
+    assert( s.displayInterval.p50 >= 2000000 && s.displayInterval.max >= 4000000 );
+    assert( s.jitter.count == 19 );
+    // Consecutive intervals differ by at least 2ms
+    assert( s.jitter.p50 >= 1800000 );
+    assert( s.smoothedJitter > 1000000. );
+    assert( s.period.count() >= 60000000 );
+    assert( s.hasMediaStats == false );
+
+    // Each snapshot covers the period since the previous one
+    s = timings.snapshot();
+    assert( s.hold.count == 0 && s.displayInterval.count == 0 && s.hold.p99 == 0 );
+    assert( s.locked == 21 );
+    auto pic = c.lock( planes );
+    c.display( pic );
+    c.unlock( pic, planes );
+    s = timings.snapshot();
+    assert( s.hold.count == 1 && s.displayInterval.count == 1 && s.jitter.count == 1 );
+    assert( s.hold.max < 1000000 );
+}
+
+static void testUntracked()
+{
+    Timings timings;
+    char pictures[40];
+    unsigned next = 0;
+    auto c = timings.decorate( [&]( void** ) -> void* { return &pictures[next++]; },
+                               nullptr, nullptr );
+    void* planes[1];
+    void* locked[40];
+    for ( auto& l : locked )
+        l = c.lock( planes );
+    for ( auto l : locked )
+        c.unlock( l, planes );
+    auto s = timings.snapshot();
+    assert( s.locked == 40 );
+    assert( s.untracked == 40 - VLC::detail::timing::LockDates::Size );
+    assert( s.hold.count == VLC::detail::timing::LockDates::Size );
+}
+
+// libvlc 3.x can lock & unlock pictures from several threads at once
+static void testConcurrent()
+{
+    const unsigned NbThreads = 4, NbFrames = 20000;
+    Timings timings;
+    auto c = timings.decorate( []( void** planes ) -> void* { return planes; }, nullptr, nullptr );
+    std::vector<std::thread> threads;
+    for ( auto i = 0u; i < NbThreads; ++i )
+    {
+        threads.emplace_back( [&c]() {
+            void* planes[1];
+            for ( auto f = 0u; f < NbFrames; ++f )
+                c.unlock( c.lock( planes ), planes );
+        } );
+    }
+    for ( auto& t : threads )
+        t.join();
+    auto s = timings.snapshot();
+    assert( s.untracked == 0 );
+    assert( s.locked == NbThreads * NbFrames && s.hold.count == NbThreads * NbFrames );
+}
+
+int main()
+{
+    testExclusiveRecording();
+    testCallbacks();
+    testTimings();
+    testUntracked();
+    testConcurrent();
+    std::cout << "All VideoTimings tests passed" << std::endl;
+    return 0;
+}
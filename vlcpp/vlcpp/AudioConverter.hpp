@@ -0,0 +1,1159 @@
+/*****************************************************************************
+ * AudioConverter.hpp: SIMD audio sample conversion & channel remixing
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_AUDIOCONVERTER_H
+#define LIBVLC_CXX_AUDIOCONVERTER_H
+
+#include "ChromaConverter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The NEON kernels need the rounding conversions AArch64 provides
+#if defined(LIBVLCPP_CHROMA_NEON) && defined(__aarch64__)
+# define LIBVLCPP_AUDIO_NEON 1
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+namespace audioconv
+{
+
+///
+/// The dither noise of a sample is derived from its index, so that every
+/// kernel computes the same noise, whatever the number of samples it
+/// processes at once.
+///
+inline uint32_t ditherHash( uint32_t x )
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/// Samples are scaled to [-1, 1) floats
+static const float S16Scale = 32768.f;
+static const float S32Scale = 2147483648.f;
+/// The largest float which fits in an int32_t
+static const float S32Max = 2147483520.f;
+
+///
+/// Portable kernels. The SIMD ones perform the same floating point
+/// operations in the same order, and the conversions to integers round to
+/// the nearest, so that all of them produce the same output.
+///
+struct Scalar
+{
+    // Triangular noise, within ( -1, 1 ) LSB
+    static float dither( uint32_t index )
+    {
+        auto h = ditherHash( index );
+        return static_cast<float>( static_cast<int32_t>( h & 0xffff ) - static_cast<int32_t>( h >> 16 ) ) *
+                ( 1.f / 65536 );
+    }
+
+    // Same semantics as the SSE min/max instructions, including for NaNs
+    static float clamp( float v, float lo, float hi )
+    {
+        v = v > lo ? v : lo;
+        return v < hi ? v : hi;
+    }
+
+    static void s16ToFloatTail( const int16_t* src, float* dst, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+            dst[i] = static_cast<float>( src[i] ) * ( 1.f / S16Scale );
+    }
+
+    static void s32ToFloatTail( const int32_t* src, float* dst, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+            dst[i] = static_cast<float>( src[i] ) * ( 1.f / S32Scale );
+    }
+
+    static void floatToS16Tail( const float* src, int16_t* dst, size_t i, size_t n,
+                                bool dithered, uint32_t index )
+    {
+        for ( ; i < n; ++i )
+        {
+            auto v = src[i] * S16Scale;
+            if ( dithered == true )
+                v = v + dither( index + static_cast<uint32_t>( i ) );
+            dst[i] = static_cast<int16_t>( std::lrint( clamp( v, -32768.f, 32767.f ) ) );
+        }
+    }
+
+    static void floatToS32Tail( const float* src, int32_t* dst, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+            dst[i] = static_cast<int32_t>( std::lrint( clamp( src[i] * S32Scale, -S32Scale, S32Max ) ) );
+    }
+
+    static void mixTail( const float* const* in, const float* gains, unsigned nbIn,
+                         float* out, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+        {
+            auto acc = in[0][i] * gains[0];
+            for ( auto c = 1u; c < nbIn; ++c )
+                acc = acc + in[c][i] * gains[c];
+            out[i] = acc;
+        }
+    }
+
+    static void deinterleave2Tail( const float* src, float* l, float* r, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+        {
+            l[i] = src[2 * i];
+            r[i] = src[2 * i + 1];
+        }
+    }
+
+    static void interleave2Tail( const float* l, const float* r, float* dst, size_t i, size_t n )
+    {
+        for ( ; i < n; ++i )
+        {
+            dst[2 * i] = l[i];
+            dst[2 * i + 1] = r[i];
+        }
+    }
+
+    static void s16ToFloat( const int16_t* src, float* dst, size_t n )
+    {
+        s16ToFloatTail( src, dst, 0, n );
+    }
+
+    static void s32ToFloat( const int32_t* src, float* dst, size_t n )
+    {
+        s32ToFloatTail( src, dst, 0, n );
+    }
+
+    static void floatToS16( const float* src, int16_t* dst, size_t n, bool dithered, uint32_t index )
+    {
+        floatToS16Tail( src, dst, 0, n, dithered, index );
+    }
+
+    static void floatToS32( const float* src, int32_t* dst, size_t n )
+    {
+        floatToS32Tail( src, dst, 0, n );
+    }
+
+    static void mix( const float* const* in, const float* gains, unsigned nbIn, float* out, size_t n )
+    {
+        mixTail( in, gains, nbIn, out, 0, n );
+    }
+
+    static void deinterleave2( const float* src, float* l, float* r, size_t n )
+    {
+        deinterleave2Tail( src, l, r, 0, n );
+    }
+
+    static void interleave2( const float* l, const float* r, float* dst, size_t n )
+    {
+        interleave2Tail( l, r, dst, 0, n );
+    }
+};
+
+#if defined(LIBVLCPP_CHROMA_X86)
+
+///
+/// SSE2 kernels: 8 samples per iteration
+///
+struct Sse2
+{
+    // SSE2 has no 32 bits multiplication: multiply the even & odd lanes
+    // separately, and keep the low halves
+    LIBVLCPP_TARGET_SSE2 static __m128i mullo( __m128i a, __m128i b )
+    {
+        auto even = _mm_mul_epu32( a, b );
+        auto odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+        return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+                                   _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static __m128 dither( __m128i index )
+    {
+        auto h = _mm_xor_si128( index, _mm_srli_epi32( index, 16 ) );
+        h = mullo( h, _mm_set1_epi32( 0x7feb352d ) );
+        h = _mm_xor_si128( h, _mm_srli_epi32( h, 15 ) );
+        h = mullo( h, _mm_set1_epi32( static_cast<int>( 0x846ca68bu ) ) );
+        h = _mm_xor_si128( h, _mm_srli_epi32( h, 16 ) );
+        auto d = _mm_sub_epi32( _mm_and_si128( h, _mm_set1_epi32( 0xffff ) ), _mm_srli_epi32( h, 16 ) );
+        return _mm_mul_ps( _mm_cvtepi32_ps( d ), _mm_set1_ps( 1.f / 65536 ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static __m128 clamp( __m128 v, __m128 lo, __m128 hi )
+    {
+        return _mm_min_ps( _mm_max_ps( v, lo ), hi );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void s16ToFloat( const int16_t* src, float* dst, size_t n )
+    {
+        auto scale = _mm_set1_ps( 1.f / S16Scale );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+            auto lo = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+            auto hi = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+            _mm_storeu_ps( dst + i, _mm_mul_ps( _mm_cvtepi32_ps( lo ), scale ) );
+            _mm_storeu_ps( dst + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( hi ), scale ) );
+        }
+        Scalar::s16ToFloatTail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void s32ToFloat( const int32_t* src, float* dst, size_t n )
+    {
+        auto scale = _mm_set1_ps( 1.f / S32Scale );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+            auto b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i + 4 ) );
+            _mm_storeu_ps( dst + i, _mm_mul_ps( _mm_cvtepi32_ps( a ), scale ) );
+            _mm_storeu_ps( dst + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( b ), scale ) );
+        }
+        Scalar::s32ToFloatTail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void floatToS16( const float* src, int16_t* dst, size_t n,
+                                                 bool dithered, uint32_t index )
+    {
+        auto scale = _mm_set1_ps( S16Scale );
+        auto lo = _mm_set1_ps( -32768.f );
+        auto hi = _mm_set1_ps( 32767.f );
+        auto idx = _mm_add_epi32( _mm_set1_epi32( static_cast<int>( index ) ), _mm_setr_epi32( 0, 1, 2, 3 ) );
+        auto four = _mm_set1_epi32( 4 );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto a = _mm_mul_ps( _mm_loadu_ps( src + i ), scale );
+            auto b = _mm_mul_ps( _mm_loadu_ps( src + i + 4 ), scale );
+            if ( dithered == true )
+            {
+                a = _mm_add_ps( a, dither( idx ) );
+                idx = _mm_add_epi32( idx, four );
+                b = _mm_add_ps( b, dither( idx ) );
+                idx = _mm_add_epi32( idx, four );
+            }
+            auto ia = _mm_cvtps_epi32( clamp( a, lo, hi ) );
+            auto ib = _mm_cvtps_epi32( clamp( b, lo, hi ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packs_epi32( ia, ib ) );
+        }
+        Scalar::floatToS16Tail( src, dst, i, n, dithered, index );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void floatToS32( const float* src, int32_t* dst, size_t n )
+    {
+        auto scale = _mm_set1_ps( S32Scale );
+        auto lo = _mm_set1_ps( -S32Scale );
+        auto hi = _mm_set1_ps( S32Max );
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto v = clamp( _mm_mul_ps( _mm_loadu_ps( src + i ), scale ), lo, hi );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_cvtps_epi32( v ) );
+        }
+        Scalar::floatToS32Tail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void mix( const float* const* in, const float* gains, unsigned nbIn,
+                                          float* out, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto acc = _mm_mul_ps( _mm_loadu_ps( in[0] + i ), _mm_set1_ps( gains[0] ) );
+            for ( auto c = 1u; c < nbIn; ++c )
+                acc = _mm_add_ps( acc, _mm_mul_ps( _mm_loadu_ps( in[c] + i ), _mm_set1_ps( gains[c] ) ) );
+            _mm_storeu_ps( out + i, acc );
+        }
+        Scalar::mixTail( in, gains, nbIn, out, i, n );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void deinterleave2( const float* src, float* l, float* r, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto a = _mm_loadu_ps( src + 2 * i );
+            auto b = _mm_loadu_ps( src + 2 * i + 4 );
+            _mm_storeu_ps( l + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+            _mm_storeu_ps( r + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+        }
+        Scalar::deinterleave2Tail( src, l, r, i, n );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void interleave2( const float* l, const float* r, float* dst, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto a = _mm_loadu_ps( l + i );
+            auto b = _mm_loadu_ps( r + i );
+            _mm_storeu_ps( dst + 2 * i, _mm_unpacklo_ps( a, b ) );
+            _mm_storeu_ps( dst + 2 * i + 4, _mm_unpackhi_ps( a, b ) );
+        }
+        Scalar::interleave2Tail( l, r, dst, i, n );
+    }
+};
+
+///
+/// AVX2 kernels: 8 samples per iteration. The channel shuffles are memory
+/// bound, and keep using the SSE2 versions.
+///
+struct Avx2 : Sse2
+{
+    LIBVLCPP_TARGET_AVX2 static __m256 dither( __m256i index )
+    {
+        auto h = _mm256_xor_si256( index, _mm256_srli_epi32( index, 16 ) );
+        h = _mm256_mullo_epi32( h, _mm256_set1_epi32( 0x7feb352d ) );
+        h = _mm256_xor_si256( h, _mm256_srli_epi32( h, 15 ) );
+        h = _mm256_mullo_epi32( h, _mm256_set1_epi32( static_cast<int>( 0x846ca68bu ) ) );
+        h = _mm256_xor_si256( h, _mm256_srli_epi32( h, 16 ) );
+        auto d = _mm256_sub_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 0xffff ) ),
+                                   _mm256_srli_epi32( h, 16 ) );
+        return _mm256_mul_ps( _mm256_cvtepi32_ps( d ), _mm256_set1_ps( 1.f / 65536 ) );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static __m256 clamp( __m256 v, __m256 lo, __m256 hi )
+    {
+        return _mm256_min_ps( _mm256_max_ps( v, lo ), hi );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void s16ToFloat( const int16_t* src, float* dst, size_t n )
+    {
+        auto scale = _mm256_set1_ps( 1.f / S16Scale );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto v = _mm256_cvtepi16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) ) );
+            _mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_cvtepi32_ps( v ), scale ) );
+        }
+        Scalar::s16ToFloatTail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void s32ToFloat( const int32_t* src, float* dst, size_t n )
+    {
+        auto scale = _mm256_set1_ps( 1.f / S32Scale );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto v = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + i ) );
+            _mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_cvtepi32_ps( v ), scale ) );
+        }
+        Scalar::s32ToFloatTail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void floatToS16( const float* src, int16_t* dst, size_t n,
+                                                 bool dithered, uint32_t index )
+    {
+        auto scale = _mm256_set1_ps( S16Scale );
+        auto lo = _mm256_set1_ps( -32768.f );
+        auto hi = _mm256_set1_ps( 32767.f );
+        auto idx = _mm256_add_epi32( _mm256_set1_epi32( static_cast<int>( index ) ),
+                                     _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ) );
+        auto eight = _mm256_set1_epi32( 8 );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto v = _mm256_mul_ps( _mm256_loadu_ps( src + i ), scale );
+            if ( dithered == true )
+            {
+                v = _mm256_add_ps( v, dither( idx ) );
+                idx = _mm256_add_epi32( idx, eight );
+            }
+            auto iv = _mm256_cvtps_epi32( clamp( v, lo, hi ) );
+            auto packed = _mm_packs_epi32( _mm256_castsi256_si128( iv ), _mm256_extracti128_si256( iv, 1 ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), packed );
+        }
+        Scalar::floatToS16Tail( src, dst, i, n, dithered, index );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void floatToS32( const float* src, int32_t* dst, size_t n )
+    {
+        auto scale = _mm256_set1_ps( S32Scale );
+        auto lo = _mm256_set1_ps( -S32Scale );
+        auto hi = _mm256_set1_ps( S32Max );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto v = clamp( _mm256_mul_ps( _mm256_loadu_ps( src + i ), scale ), lo, hi );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), _mm256_cvtps_epi32( v ) );
+        }
+        Scalar::floatToS32Tail( src, dst, i, n );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void mix( const float* const* in, const float* gains, unsigned nbIn,
+                                          float* out, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 )
+        {
+            auto acc = _mm256_mul_ps( _mm256_loadu_ps( in[0] + i ), _mm256_set1_ps( gains[0] ) );
+            for ( auto c = 1u; c < nbIn; ++c )
+                acc = _mm256_add_ps( acc, _mm256_mul_ps( _mm256_loadu_ps( in[c] + i ),
+                                                         _mm256_set1_ps( gains[c] ) ) );
+            _mm256_storeu_ps( out + i, acc );
+        }
+        Scalar::mixTail( in, gains, nbIn, out, i, n );
+    }
+};
+
+#endif // LIBVLCPP_CHROMA_X86
+
+#if defined(LIBVLCPP_AUDIO_NEON)
+
+///
+/// NEON kernels: 4 samples per iteration. The clamping uses comparisons
+/// rather than vmin/vmax, which don't handle NaNs like the other kernels.
+///
+struct Neon
+{
+    static float32x4_t dither( uint32x4_t index )
+    {
+        auto h = veorq_u32( index, vshrq_n_u32( index, 16 ) );
+        h = vmulq_u32( h, vdupq_n_u32( 0x7feb352du ) );
+        h = veorq_u32( h, vshrq_n_u32( h, 15 ) );
+        h = vmulq_u32( h, vdupq_n_u32( 0x846ca68bu ) );
+        h = veorq_u32( h, vshrq_n_u32( h, 16 ) );
+        auto d = vsubq_s32( vreinterpretq_s32_u32( vandq_u32( h, vdupq_n_u32( 0xffff ) ) ),
+                            vreinterpretq_s32_u32( vshrq_n_u32( h, 16 ) ) );
+        return vmulq_f32( vcvtq_f32_s32( d ), vdupq_n_f32( 1.f / 65536 ) );
+    }
+
+    static float32x4_t clamp( float32x4_t v, float32x4_t lo, float32x4_t hi )
+    {
+        v = vbslq_f32( vcgtq_f32( v, lo ), v, lo );
+        return vbslq_f32( vcltq_f32( v, hi ), v, hi );
+    }
+
+    static void s16ToFloat( const int16_t* src, float* dst, size_t n )
+    {
+        auto scale = vdupq_n_f32( 1.f / S16Scale );
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+            vst1q_f32( dst + i, vmulq_f32( vcvtq_f32_s32( vmovl_s16( vld1_s16( src + i ) ) ), scale ) );
+        Scalar::s16ToFloatTail( src, dst, i, n );
+    }
+
+    static void s32ToFloat( const int32_t* src, float* dst, size_t n )
+    {
+        auto scale = vdupq_n_f32( 1.f / S32Scale );
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+            vst1q_f32( dst + i, vmulq_f32( vcvtq_f32_s32( vld1q_s32( src + i ) ), scale ) );
+        Scalar::s32ToFloatTail( src, dst, i, n );
+    }
+
+    static void floatToS16( const float* src, int16_t* dst, size_t n, bool dithered, uint32_t index )
+    {
+        auto scale = vdupq_n_f32( S16Scale );
+        auto lo = vdupq_n_f32( -32768.f );
+        auto hi = vdupq_n_f32( 32767.f );
+        static const uint32_t offsets[4] = { 0, 1, 2, 3 };
+        auto idx = vaddq_u32( vdupq_n_u32( index ), vld1q_u32( offsets ) );
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto v = vmulq_f32( vld1q_f32( src + i ), scale );
+            if ( dithered == true )
+            {
+                v = vaddq_f32( v, dither( idx ) );
+                idx = vaddq_u32( idx, vdupq_n_u32( 4 ) );
+            }
+            vst1_s16( dst + i, vqmovn_s32( vcvtnq_s32_f32( clamp( v, lo, hi ) ) ) );
+        }
+        Scalar::floatToS16Tail( src, dst, i, n, dithered, index );
+    }
+
+    static void floatToS32( const float* src, int32_t* dst, size_t n )
+    {
+        auto scale = vdupq_n_f32( S32Scale );
+        auto lo = vdupq_n_f32( -S32Scale );
+        auto hi = vdupq_n_f32( S32Max );
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+            vst1q_s32( dst + i, vcvtnq_s32_f32( clamp( vmulq_f32( vld1q_f32( src + i ), scale ), lo, hi ) ) );
+        Scalar::floatToS32Tail( src, dst, i, n );
+    }
+
+    static void mix( const float* const* in, const float* gains, unsigned nbIn, float* out, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto acc = vmulq_n_f32( vld1q_f32( in[0] + i ), gains[0] );
+            // Separate multiplications & additions: fused ones would round
+            // differently from the other kernels
+            for ( auto c = 1u; c < nbIn; ++c )
+                acc = vaddq_f32( acc, vmulq_n_f32( vld1q_f32( in[c] + i ), gains[c] ) );
+            vst1q_f32( out + i, acc );
+        }
+        Scalar::mixTail( in, gains, nbIn, out, i, n );
+    }
+
+    static void deinterleave2( const float* src, float* l, float* r, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            auto v = vld2q_f32( src + 2 * i );
+            vst1q_f32( l + i, v.val[0] );
+            vst1q_f32( r + i, v.val[1] );
+        }
+        Scalar::deinterleave2Tail( src, l, r, i, n );
+    }
+
+    static void interleave2( const float* l, const float* r, float* dst, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4 )
+        {
+            float32x4x2_t v;
+            v.val[0] = vld1q_f32( l + i );
+            v.val[1] = vld1q_f32( r + i );
+            vst2q_f32( dst + 2 * i, v );
+        }
+        Scalar::interleave2Tail( l, r, dst, i, n );
+    }
+};
+
+#endif // LIBVLCPP_AUDIO_NEON
+
+struct Kernels
+{
+    void (*s16ToFloat)( const int16_t*, float*, size_t );
+    void (*s32ToFloat)( const int32_t*, float*, size_t );
+    void (*floatToS16)( const float*, int16_t*, size_t, bool, uint32_t );
+    void (*floatToS32)( const float*, int32_t*, size_t );
+    void (*mix)( const float* const*, const float*, unsigned, float*, size_t );
+    void (*deinterleave2)( const float*, float*, float*, size_t );
+    void (*interleave2)( const float*, const float*, float*, size_t );
+};
+
+template <typename K>
+Kernels kernels()
+{
+    Kernels k;
+    k.s16ToFloat = &K::s16ToFloat;
+    k.s32ToFloat = &K::s32ToFloat;
+    k.floatToS16 = &K::floatToS16;
+    k.floatToS32 = &K::floatToS32;
+    k.mix = &K::mix;
+    k.deinterleave2 = &K::deinterleave2;
+    k.interleave2 = &K::interleave2;
+    return k;
+}
+
+// Converts the samples of a play callback before forwarding them
+template <typename Converter, typename PlayCb>
+struct Sink
+{
+    Sink( const Converter& c, PlayCb p )
+        : converter( c )
+        , callback( std::move( p ) )
+    {
+    }
+
+    void play( const void* samples, unsigned int count, int64_t pts )
+    {
+        const auto& to = converter.to();
+        auto planeSize = Converter::sampleSize( to.format ) * count * ( to.planar ? 1 : to.channels );
+        auto nbPlanes = to.planar ? to.channels : 1;
+        // Only allocates when libvlc provides a larger block than before
+        if ( buffer.size() < planeSize * nbPlanes )
+            buffer.resize( planeSize * nbPlanes );
+        void* planes[Converter::MaxChannels];
+        for ( auto p = 0u; p < nbPlanes; ++p )
+            planes[p] = buffer.data() + p * planeSize;
+        converter.convert( &samples, planes, count );
+        callback( const_cast<const void* const*>( planes ), count, pts );
+    }
+
+    Converter converter;
+    PlayCb callback;
+    std::vector<uint8_t> buffer;
+};
+
+} // namespace audioconv
+} // namespace detail
+
+///
+/// \brief The AudioConverter class converts the audio libvlc decodes when it
+///        can't provide the exact format a sink expects.
+///
+/// It converts between signed 16 & 32 bits and float samples, between
+/// interleaved & planar layouts, and remixes the channels with a gain
+/// matrix, for instance to downmix 5.1 to stereo. Reducing the precision to
+/// 16 bits adds triangular dither noise, unless disabled.
+///
+/// As for ChromaConverter, the kernels are selected at construction time
+/// from the best instruction set the CPU supports, and all of them produce
+/// the same output.
+///
+/// A converter keeps scratch buffers & the dither state, so it must only be
+/// used by one thread at a time.
+///
+class AudioConverter
+{
+public:
+    enum class SampleFormat
+    {
+        S16,
+        S32,
+        FL32,
+    };
+
+    enum class Isa
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    struct Layout
+    {
+        Layout( SampleFormat f = SampleFormat::FL32, unsigned c = 2, bool p = false )
+            : format( f )
+            , channels( c )
+            , planar( p )
+        {
+        }
+
+        SampleFormat format;
+        unsigned channels;
+        /// Planar audio has a buffer per channel, instead of interleaving
+        /// the samples of each frame
+        bool planar;
+    };
+
+    struct Options
+    {
+        Options()
+            : dither( true )
+        {
+        }
+
+        /// Add dither noise when reducing the precision to 16 bits
+        bool dither;
+        /// The gain of each input channel in each output one, as a
+        /// [output channels][input channels] row major matrix. When empty,
+        /// standardMatrix() is used.
+        std::vector<float> matrix;
+    };
+
+    /// The number of frames converted at once, through the scratch buffers
+    static constexpr size_t ChunkSize = 256;
+    static constexpr unsigned MaxChannels = 32;
+
+    ///
+    /// \brief AudioConverter Prepares a conversion, using the best available
+    ///        instruction set
+    /// \throws std::invalid_argument if the conversion isn't supported
+    ///
+    AudioConverter( Layout from, Layout to, Options options = Options() )
+        : AudioConverter( from, to, std::move( options ), bestIsa() )
+    {
+    }
+
+    ///
+    /// \brief AudioConverter Prepares a conversion, using the provided
+    ///        instruction set
+    /// \throws std::invalid_argument if the conversion or the instruction set
+    ///         isn't supported
+    ///
+    AudioConverter( Layout from, Layout to, Options options, Isa isa )
+        : m_from( from )
+        , m_to( to )
+        , m_isa( isa )
+        , m_identity( false )
+        , m_dither( false )
+        , m_ditherIndex( 0 )
+    {
+        if ( isSupported( isa ) == false )
+            throw std::invalid_argument( "Unsupported instruction set" );
+        if ( from.channels == 0 || from.channels > MaxChannels ||
+             to.channels == 0 || to.channels > MaxChannels )
+            throw std::invalid_argument( "Unsupported channel count" );
+        if ( options.matrix.empty() == true )
+            options.matrix = standardMatrix( from.channels, to.channels );
+        else if ( options.matrix.size() != from.channels * to.channels )
+            throw std::invalid_argument( "The matrix doesn't match the channel counts" );
+        m_identity = from.channels == to.channels;
+        for ( auto o = 0u; o < to.channels; ++o )
+        {
+            for ( auto c = 0u; c < from.channels; ++c )
+            {
+                auto g = options.matrix[o * from.channels + c];
+                if ( g != ( o == c ? 1.f : 0.f ) )
+                    m_identity = false;
+            }
+        }
+        // Dithering a conversion which doesn't lose anything would only add noise
+        m_dither = options.dither == true && to.format == SampleFormat::S16 &&
+                ( from.format != SampleFormat::S16 || m_identity == false );
+        // Silent inputs don't need to be mixed: only keep the others
+        m_rows.resize( to.channels );
+        for ( auto o = 0u; o < to.channels; ++o )
+        {
+            for ( auto c = 0u; c < from.channels; ++c )
+            {
+                auto g = options.matrix[o * from.channels + c];
+                if ( g != 0.f )
+                    m_rows[o].emplace_back( c, g );
+            }
+        }
+        m_matrix = std::move( options.matrix );
+        m_kernels = selectKernels( isa );
+        m_inputs.resize( from.channels * ChunkSize );
+        m_outputs.resize( to.channels * ChunkSize );
+        m_interleaved.resize( std::max( from.channels, to.channels ) * ChunkSize );
+    }
+
+    ///
+    /// \brief convert Converts frames of audio
+    ///
+    /// \param src  The input planes: a single one for interleaved audio, one
+    ///             per channel for planar audio
+    /// \param dst  The output planes, in the same fashion
+    /// \param frames The number of frames to convert
+    ///
+    void convert( const void* const* src, void* const* dst, size_t frames )
+    {
+        if ( m_identity == true && m_from.format == m_to.format && m_from.planar == m_to.planar &&
+             m_dither == false )
+        {
+            auto size = sampleSize( m_from.format ) * frames;
+            if ( m_from.planar == true )
+            {
+                for ( auto c = 0u; c < m_from.channels; ++c )
+                    memcpy( dst[c], src[c], size );
+            }
+            else
+                memcpy( dst[0], src[0], size * m_from.channels );
+            return;
+        }
+        for ( size_t done = 0; done < frames; done += ChunkSize )
+            convertChunk( src, dst, done, std::min( static_cast<size_t>( ChunkSize ), frames - done ) );
+    }
+
+    ///
+    /// \brief convert Converts interleaved frames of audio
+    ///
+    void convert( const void* src, void* dst, size_t frames )
+    {
+        if ( m_from.planar == true || m_to.planar == true )
+            throw std::logic_error( "Planar audio needs a buffer per channel" );
+        convert( &src, &dst, frames );
+    }
+
+    ///
+    /// \brief decorate Returns a callback matching the play prototype of
+    ///                 MediaPlayer::setAudioCallbacks, which converts the
+    ///                 samples before forwarding them to the provided one.
+    ///
+    /// \param play The sink, with a void(const void* const* planes,
+    ///             unsigned int frames, int64_t pts) prototype. Interleaved
+    ///             samples are provided through planes[0]. The planes are
+    ///             only valid during the call.
+    ///
+    /// The input layout must be interleaved, as libvlc provides it. The
+    /// converter is copied into the callback.
+    ///
+    template <typename PlayCb>
+    std::function<void(const void*, unsigned int, int64_t)> decorate( PlayCb&& play ) const
+    {
+        if ( m_from.planar == true )
+            throw std::invalid_argument( "libvlc provides interleaved audio" );
+        using Sink = detail::audioconv::Sink<AudioConverter, typename std::decay<PlayCb>::type>;
+        auto sink = std::make_shared<Sink>( *this, std::forward<PlayCb>( play ) );
+        return [sink]( const void* samples, unsigned int count, int64_t pts ) {
+            sink->play( samples, count, pts );
+        };
+    }
+
+    Isa isa() const
+    {
+        return m_isa;
+    }
+
+    const Layout& from() const
+    {
+        return m_from;
+    }
+
+    const Layout& to() const
+    {
+        return m_to;
+    }
+
+    const std::vector<float>& matrix() const
+    {
+        return m_matrix;
+    }
+
+    static size_t sampleSize( SampleFormat f )
+    {
+        return f == SampleFormat::S16 ? 2 : 4;
+    }
+
+    ///
+    /// \brief standardMatrix Returns the default gains to remix channels
+    ///
+    /// The channels are expected in libvlc's order: mono, stereo (L R), or
+    /// 5.1 (L R RL RR C LFE).
+    /// - Identical channel counts are left untouched.
+    /// - Stereo is downmixed to mono by averaging, and 5.1 to stereo with
+    ///   the ITU-R BS.775 coefficients, dropping the LFE. Loud sources can
+    ///   clip; scale the matrix down to prevent it.
+    /// - Mono is upmixed to both stereo channels, or the 5.1 center. Stereo
+    ///   is upmixed to the 5.1 front channels.
+    /// - Otherwise, the first channels are kept, and the others are silent.
+    ///
+    static std::vector<float> standardMatrix( unsigned in, unsigned out )
+    {
+        std::vector<float> m( in * out, 0.f );
+        auto set = [&m, in]( unsigned o, unsigned i, float g ) { m[o * in + i] = g; };
+        const float h = 0.70710678f;
+        if ( in == 6 && out == 2 )
+        {
+            set( 0, 0, 1.f );
+            set( 0, 4, h );
+            set( 0, 2, h );
+            set( 1, 1, 1.f );
+            set( 1, 4, h );
+            set( 1, 3, h );
+        }
+        else if ( in == 6 && out == 1 )
+        {
+            // The average of the stereo downmix
+            for ( auto i : { 0u, 1u } )
+                set( 0, i, .5f );
+            set( 0, 4, h );
+            for ( auto i : { 2u, 3u } )
+                set( 0, i, h / 2 );
+        }
+        else if ( in == 2 && out == 1 )
+        {
+            set( 0, 0, .5f );
+            set( 0, 1, .5f );
+        }
+        else if ( in == 1 && out == 2 )
+        {
+            set( 0, 0, 1.f );
+            set( 1, 0, 1.f );
+        }
+        else if ( in == 1 && out == 6 )
+            set( 4, 0, 1.f );
+        else
+        {
+            for ( auto c = 0u; c < std::min( in, out ); ++c )
+                set( c, c, 1.f );
+        }
+        return m;
+    }
+
+    ///
+    /// \brief fromFourcc Maps a libvlc audio fourcc to a sample format
+    /// \return false if the fourcc isn't supported
+    ///
+    static bool fromFourcc( const char* fourcc, SampleFormat& format )
+    {
+        static const struct
+        {
+            char fourcc[5];
+            SampleFormat format;
+        } formats[] = {
+            { "S16N", SampleFormat::S16 },
+            { "S32N", SampleFormat::S32 },
+            { "FL32", SampleFormat::FL32 },
+        };
+        for ( const auto& f : formats )
+        {
+            if ( memcmp( f.fourcc, fourcc, 4 ) == 0 )
+            {
+                format = f.format;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static const char* fourcc( SampleFormat format )
+    {
+        switch ( format )
+        {
+        case SampleFormat::S16:
+            return "S16N";
+        case SampleFormat::S32:
+            return "S32N";
+        default:
+            return "FL32";
+        }
+    }
+
+    ///
+    /// \brief isSupported Returns true if the CPU & the build support the
+    ///                    provided instruction set
+    ///
+    static bool isSupported( Isa isa )
+    {
+        switch ( isa )
+        {
+        case Isa::Scalar:
+            return true;
+#if defined(LIBVLCPP_CHROMA_X86)
+        case Isa::SSE2:
+            return true;
+        case Isa::AVX2:
+        {
+            static const bool avx2 = detail::chroma::cpuHasAvx2();
+            return avx2;
+        }
+#elif defined(LIBVLCPP_AUDIO_NEON)
+        case Isa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    static Isa bestIsa()
+    {
+        for ( auto isa : { Isa::AVX2, Isa::NEON, Isa::SSE2 } )
+        {
+            if ( isSupported( isa ) )
+                return isa;
+        }
+        return Isa::Scalar;
+    }
+
+    static const char* isaName( Isa isa )
+    {
+        switch ( isa )
+        {
+        case Isa::SSE2:
+            return "SSE2";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+        }
+    }
+
+private:
+    void convertChunk( const void* const* src, void* const* dst, size_t offset, size_t n )
+    {
+        const auto& k = m_kernels;
+        float* in[MaxChannels];
+        float* out[MaxChannels];
+        for ( auto c = 0u; c < m_from.channels; ++c )
+            in[c] = m_inputs.data() + c * ChunkSize;
+        // Interleaved audio which keeps its channels doesn't need to be
+        // split: the samples are converted as a single plane.
+        auto flat = m_identity == true && m_from.planar == false && m_to.planar == false;
+        if ( flat == true )
+        {
+            toFloat( m_from.format, src[0], offset * m_from.channels, m_interleaved.data(),
+                     n * m_from.channels );
+            fromFloat( m_interleaved.data(), dst[0], offset * m_to.channels, n * m_to.channels );
+            return;
+        }
+
+        // Load the input as planar floats
+        if ( m_from.planar == true )
+        {
+            for ( auto c = 0u; c < m_from.channels; ++c )
+                toFloat( m_from.format, src[c], offset, in[c], n );
+        }
+        else if ( m_from.channels == 1 )
+            toFloat( m_from.format, src[0], offset, in[0], n );
+        else
+        {
+            toFloat( m_from.format, src[0], offset * m_from.channels, m_interleaved.data(),
+                     n * m_from.channels );
+            deinterleave( m_interleaved.data(), in, m_from.channels, n );
+        }
+
+        // Remix
+        if ( m_identity == true )
+        {
+            for ( auto c = 0u; c < m_to.channels; ++c )
+                out[c] = in[c];
+        }
+        else
+        {
+            for ( auto o = 0u; o < m_to.channels; ++o )
+            {
+                out[o] = m_outputs.data() + o * ChunkSize;
+                const auto& row = m_rows[o];
+                if ( row.empty() == true )
+                {
+                    std::fill( out[o], out[o] + n, 0.f );
+                    continue;
+                }
+                const float* planes[MaxChannels];
+                float gains[MaxChannels];
+                for ( auto i = 0u; i < row.size(); ++i )
+                {
+                    planes[i] = in[row[i].first];
+                    gains[i] = row[i].second;
+                }
+                k.mix( planes, gains, static_cast<unsigned>( row.size() ), out[o], n );
+            }
+        }
+
+        // Store the output
+        if ( m_to.planar == true )
+        {
+            for ( auto c = 0u; c < m_to.channels; ++c )
+                fromFloat( out[c], dst[c], offset, n );
+        }
+        else if ( m_to.channels == 1 )
+            fromFloat( out[0], dst[0], offset, n );
+        else
+        {
+            interleave( out, m_interleaved.data(), m_to.channels, n );
+            fromFloat( m_interleaved.data(), dst[0], offset * m_to.channels, n * m_to.channels );
+        }
+    }
+
+    // Converts n samples, starting at the offset-th one of src
+    void toFloat( SampleFormat format, const void* src, size_t offset, float* dst, size_t n ) const
+    {
+        switch ( format )
+        {
+        case SampleFormat::S16:
+            m_kernels.s16ToFloat( static_cast<const int16_t*>( src ) + offset, dst, n );
+            break;
+        case SampleFormat::S32:
+            m_kernels.s32ToFloat( static_cast<const int32_t*>( src ) + offset, dst, n );
+            break;
+        default:
+            memcpy( dst, static_cast<const float*>( src ) + offset, n * sizeof( float ) );
+            break;
+        }
+    }
+
+    void fromFloat( const float* src, void* dst, size_t offset, size_t n )
+    {
+        switch ( m_to.format )
+        {
+        case SampleFormat::S16:
+            m_kernels.floatToS16( src, static_cast<int16_t*>( dst ) + offset, n, m_dither, m_ditherIndex );
+            m_ditherIndex += static_cast<uint32_t>( n );
+            break;
+        case SampleFormat::S32:
+            m_kernels.floatToS32( src, static_cast<int32_t*>( dst ) + offset, n );
+            break;
+        default:
+            memcpy( static_cast<float*>( dst ) + offset, src, n * sizeof( float ) );
+            break;
+        }
+    }
+
+    void deinterleave( const float* src, float* const* dst, unsigned channels, size_t n ) const
+    {
+        if ( channels == 2 )
+        {
+            m_kernels.deinterleave2( src, dst[0], dst[1], n );
+            return;
+        }
+        for ( size_t i = 0; i < n; ++i )
+        {
+            for ( auto c = 0u; c < channels; ++c )
+                dst[c][i] = src[i * channels + c];
+        }
+    }
+
+    void interleave( const float* const* src, float* dst, unsigned channels, size_t n ) const
+    {
+        if ( channels == 2 )
+        {
+            m_kernels.interleave2( src[0], src[1], dst, n );
+            return;
+        }
+        for ( size_t i = 0; i < n; ++i )
+        {
+            for ( auto c = 0u; c < channels; ++c )
+                dst[i * channels + c] = src[c][i];
+        }
+    }
+
+    static detail::audioconv::Kernels selectKernels( Isa isa )
+    {
+        namespace da = detail::audioconv;
+        switch ( isa )
+        {
+#if defined(LIBVLCPP_CHROMA_X86)
+        case Isa::AVX2:
+            return da::kernels<da::Avx2>();
+        case Isa::SSE2:
+            return da::kernels<da::Sse2>();
+#elif defined(LIBVLCPP_AUDIO_NEON)
+        case Isa::NEON:
+            return da::kernels<da::Neon>();
+#endif
+        default:
+            return da::kernels<da::Scalar>();
+        }
+    }
+
+private:
+    Layout m_from;
+    Layout m_to;
+    Isa m_isa;
+    bool m_identity;
+    bool m_dither;
+    uint32_t m_ditherIndex;
+    std::vector<float> m_matrix;
+    /// The non silent inputs of each output channel, with their gain
+    std::vector<std::vector<std::pair<unsigned, float>>> m_rows;
+    detail::audioconv::Kernels m_kernels;
+    std::vector<float> m_inputs;
+    std::vector<float> m_outputs;
+    std::vector<float> m_interleaved;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_AUDIOCONVERTER_H
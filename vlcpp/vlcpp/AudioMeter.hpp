@@ -0,0 +1,874 @@
+/*****************************************************************************
+ * AudioMeter.hpp: Audio levels & loudness metering
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_AUDIOMETER_H
+#define LIBVLC_CXX_AUDIOMETER_H
+
+#include "AudioConverter.hpp"
+#include "MediaPlayer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+namespace audiometer
+{
+
+static const unsigned MaxChannels = 16;
+/// The widest vector processes 8 channels at once, so the per channel
+/// state is padded to a multiple of 8.
+static const unsigned MaxLanes = ( MaxChannels + 7 ) / 8 * 8;
+
+///
+/// The K-weighting filter of ITU-R BS.1770: a high shelf followed by a high
+/// pass, as two cascaded biquads.
+///
+struct Filter
+{
+    /// b[stage][0..2], a[stage][1..2], normalized so that a0 is 1
+    float b[2][3];
+    float a[2][2];
+};
+
+inline Filter kWeighting( unsigned rate )
+{
+    const double pi = 3.14159265358979323846;
+    Filter f;
+    // The coefficients are given at 48kHz by the recommendation, and
+    // derived for other rates from the analog prototypes.
+    auto f0 = 1681.974450955533;
+    auto g = 3.999843853973347;
+    auto q = 0.7071752369554196;
+    auto k = std::tan( pi * f0 / rate );
+    auto vh = std::pow( 10., g / 20 );
+    auto vb = std::pow( vh, 0.4996667741545416 );
+    auto a0 = 1 + k / q + k * k;
+    f.b[0][0] = static_cast<float>( ( vh + vb * k / q + k * k ) / a0 );
+    f.b[0][1] = static_cast<float>( 2 * ( k * k - vh ) / a0 );
+    f.b[0][2] = static_cast<float>( ( vh - vb * k / q + k * k ) / a0 );
+    f.a[0][0] = static_cast<float>( 2 * ( k * k - 1 ) / a0 );
+    f.a[0][1] = static_cast<float>( ( 1 - k / q + k * k ) / a0 );
+
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = std::tan( pi * f0 / rate );
+    a0 = 1 + k / q + k * k;
+    f.b[1][0] = 1.f;
+    f.b[1][1] = -2.f;
+    f.b[1][2] = 1.f;
+    f.a[1][0] = static_cast<float>( 2 * ( k * k - 1 ) / a0 );
+    f.a[1][1] = static_cast<float>( ( 1 - k / q + k * k ) / a0 );
+    return f;
+}
+
+///
+/// The state of each channel: the filter memories, and what was measured
+/// since the last reset of the accumulators.
+///
+struct Lanes
+{
+    float z[4][MaxLanes];
+    float peak[MaxLanes];
+    /// Sums of the squared samples, before & after K-weighting
+    float sq[MaxLanes];
+    float ksq[MaxLanes];
+    int32_t clipped[MaxLanes];
+};
+
+///
+/// The kernels measure interleaved float frames. Each vector lane handles a
+/// channel, and the frames are processed in order, since the filters are
+/// recursive. The samples buffer must be readable for 8 floats past the
+/// last frame, as the vector loads may overlap the next frame.
+///
+/// All kernels perform the same operations in the same order on each
+/// channel, so that they produce the same results, unless the compiler is
+/// allowed to contract the scalar multiplications & additions into fused
+/// ones (-ffp-contract=fast on FMA capable targets).
+///
+struct Scalar
+{
+    static void analyze( const float* samples, unsigned channels, size_t frames, const Filter& f,
+                         float clipLevel, Lanes& l )
+    {
+        for ( auto c = 0u; c < channels; ++c )
+        {
+            auto z0 = l.z[0][c], z1 = l.z[1][c], z2 = l.z[2][c], z3 = l.z[3][c];
+            auto peak = l.peak[c], sq = l.sq[c], ksq = l.ksq[c];
+            auto clipped = l.clipped[c];
+            for ( size_t i = 0; i < frames; ++i )
+            {
+                auto x = samples[i * channels + c];
+                auto ax = std::fabs( x );
+                peak = ax > peak ? ax : peak;
+                clipped += ax >= clipLevel ? 1 : 0;
+                sq = sq + x * x;
+                auto y = f.b[0][0] * x + z0;
+                z0 = f.b[0][1] * x - f.a[0][0] * y + z1;
+                z1 = f.b[0][2] * x - f.a[0][1] * y;
+                auto w = f.b[1][0] * y + z2;
+                z2 = f.b[1][1] * y - f.a[1][0] * w + z3;
+                z3 = f.b[1][2] * y - f.a[1][1] * w;
+                ksq = ksq + w * w;
+            }
+            l.z[0][c] = z0;
+            l.z[1][c] = z1;
+            l.z[2][c] = z2;
+            l.z[3][c] = z3;
+            l.peak[c] = peak;
+            l.sq[c] = sq;
+            l.ksq[c] = ksq;
+            l.clipped[c] = clipped;
+        }
+    }
+};
+
+#if defined(LIBVLCPP_CHROMA_X86)
+
+struct Sse2
+{
+    LIBVLCPP_TARGET_SSE2 static void analyze( const float* samples, unsigned channels, size_t frames,
+                                              const Filter& f, float clipLevel, Lanes& l )
+    {
+        auto absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+        auto clip = _mm_set1_ps( clipLevel );
+        __m128 b[2][3], a[2][2];
+        for ( auto s = 0; s < 2; ++s )
+        {
+            for ( auto i = 0; i < 3; ++i )
+                b[s][i] = _mm_set1_ps( f.b[s][i] );
+            for ( auto i = 0; i < 2; ++i )
+                a[s][i] = _mm_set1_ps( f.a[s][i] );
+        }
+        for ( auto c = 0u; c < channels; c += 4 )
+        {
+            auto z0 = _mm_loadu_ps( l.z[0] + c ), z1 = _mm_loadu_ps( l.z[1] + c );
+            auto z2 = _mm_loadu_ps( l.z[2] + c ), z3 = _mm_loadu_ps( l.z[3] + c );
+            auto peak = _mm_loadu_ps( l.peak + c );
+            auto sq = _mm_loadu_ps( l.sq + c );
+            auto ksq = _mm_loadu_ps( l.ksq + c );
+            auto clipped = _mm_loadu_si128( reinterpret_cast<const __m128i*>( l.clipped + c ) );
+            for ( size_t i = 0; i < frames; ++i )
+            {
+                auto x = _mm_loadu_ps( samples + i * channels + c );
+                auto ax = _mm_and_ps( x, absMask );
+                peak = _mm_max_ps( ax, peak );
+                // Comparisons yield -1 in the matching lanes
+                clipped = _mm_sub_epi32( clipped, _mm_castps_si128( _mm_cmpge_ps( ax, clip ) ) );
+                sq = _mm_add_ps( sq, _mm_mul_ps( x, x ) );
+                auto y = _mm_add_ps( _mm_mul_ps( b[0][0], x ), z0 );
+                z0 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( b[0][1], x ), _mm_mul_ps( a[0][0], y ) ), z1 );
+                z1 = _mm_sub_ps( _mm_mul_ps( b[0][2], x ), _mm_mul_ps( a[0][1], y ) );
+                auto w = _mm_add_ps( _mm_mul_ps( b[1][0], y ), z2 );
+                z2 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( b[1][1], y ), _mm_mul_ps( a[1][0], w ) ), z3 );
+                z3 = _mm_sub_ps( _mm_mul_ps( b[1][2], y ), _mm_mul_ps( a[1][1], w ) );
+                ksq = _mm_add_ps( ksq, _mm_mul_ps( w, w ) );
+            }
+            _mm_storeu_ps( l.z[0] + c, z0 );
+            _mm_storeu_ps( l.z[1] + c, z1 );
+            _mm_storeu_ps( l.z[2] + c, z2 );
+            _mm_storeu_ps( l.z[3] + c, z3 );
+            _mm_storeu_ps( l.peak + c, peak );
+            _mm_storeu_ps( l.sq + c, sq );
+            _mm_storeu_ps( l.ksq + c, ksq );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( l.clipped + c ), clipped );
+        }
+    }
+};
+
+struct Avx2
+{
+    LIBVLCPP_TARGET_AVX2 static void analyze( const float* samples, unsigned channels, size_t frames,
+                                              const Filter& f, float clipLevel, Lanes& l )
+    {
+        // Mono & stereo only fill half of a SSE vector already
+        if ( channels <= 4 )
+        {
+            Sse2::analyze( samples, channels, frames, f, clipLevel, l );
+            return;
+        }
+        auto absMask = _mm256_castsi256_ps( _mm256_set1_epi32( 0x7fffffff ) );
+        auto clip = _mm256_set1_ps( clipLevel );
+        __m256 b[2][3], a[2][2];
+        for ( auto s = 0; s < 2; ++s )
+        {
+            for ( auto i = 0; i < 3; ++i )
+                b[s][i] = _mm256_set1_ps( f.b[s][i] );
+            for ( auto i = 0; i < 2; ++i )
+                a[s][i] = _mm256_set1_ps( f.a[s][i] );
+        }
+        for ( auto c = 0u; c < channels; c += 8 )
+        {
+            auto z0 = _mm256_loadu_ps( l.z[0] + c ), z1 = _mm256_loadu_ps( l.z[1] + c );
+            auto z2 = _mm256_loadu_ps( l.z[2] + c ), z3 = _mm256_loadu_ps( l.z[3] + c );
+            auto peak = _mm256_loadu_ps( l.peak + c );
+            auto sq = _mm256_loadu_ps( l.sq + c );
+            auto ksq = _mm256_loadu_ps( l.ksq + c );
+            auto clipped = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( l.clipped + c ) );
+            for ( size_t i = 0; i < frames; ++i )
+            {
+                auto x = _mm256_loadu_ps( samples + i * channels + c );
+                auto ax = _mm256_and_ps( x, absMask );
+                peak = _mm256_max_ps( ax, peak );
+                clipped = _mm256_sub_epi32( clipped, _mm256_castps_si256( _mm256_cmp_ps( ax, clip, _CMP_GE_OQ ) ) );
+                sq = _mm256_add_ps( sq, _mm256_mul_ps( x, x ) );
+                auto y = _mm256_add_ps( _mm256_mul_ps( b[0][0], x ), z0 );
+                z0 = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps( b[0][1], x ), _mm256_mul_ps( a[0][0], y ) ), z1 );
+                z1 = _mm256_sub_ps( _mm256_mul_ps( b[0][2], x ), _mm256_mul_ps( a[0][1], y ) );
+                auto w = _mm256_add_ps( _mm256_mul_ps( b[1][0], y ), z2 );
+                z2 = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps( b[1][1], y ), _mm256_mul_ps( a[1][0], w ) ), z3 );
+                z3 = _mm256_sub_ps( _mm256_mul_ps( b[1][2], y ), _mm256_mul_ps( a[1][1], w ) );
+                ksq = _mm256_add_ps( ksq, _mm256_mul_ps( w, w ) );
+            }
+            _mm256_storeu_ps( l.z[0] + c, z0 );
+            _mm256_storeu_ps( l.z[1] + c, z1 );
+            _mm256_storeu_ps( l.z[2] + c, z2 );
+            _mm256_storeu_ps( l.z[3] + c, z3 );
+            _mm256_storeu_ps( l.peak + c, peak );
+            _mm256_storeu_ps( l.sq + c, sq );
+            _mm256_storeu_ps( l.ksq + c, ksq );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( l.clipped + c ), clipped );
+        }
+    }
+};
+
+#endif // LIBVLCPP_CHROMA_X86
+
+#if defined(LIBVLCPP_AUDIO_NEON)
+
+struct Neon
+{
+    static void analyze( const float* samples, unsigned channels, size_t frames, const Filter& f,
+                         float clipLevel, Lanes& l )
+    {
+        auto clip = vdupq_n_f32( clipLevel );
+        for ( auto c = 0u; c < channels; c += 4 )
+        {
+            auto z0 = vld1q_f32( l.z[0] + c ), z1 = vld1q_f32( l.z[1] + c );
+            auto z2 = vld1q_f32( l.z[2] + c ), z3 = vld1q_f32( l.z[3] + c );
+            auto peak = vld1q_f32( l.peak + c );
+            auto sq = vld1q_f32( l.sq + c );
+            auto ksq = vld1q_f32( l.ksq + c );
+            auto clipped = vld1q_s32( l.clipped + c );
+            // Separate multiplications & additions: fused ones would round
+            // differently from the other kernels
+            for ( size_t i = 0; i < frames; ++i )
+            {
+                auto x = vld1q_f32( samples + i * channels + c );
+                auto ax = vabsq_f32( x );
+                peak = vbslq_f32( vcgtq_f32( ax, peak ), ax, peak );
+                clipped = vsubq_s32( clipped, vreinterpretq_s32_u32( vcgeq_f32( ax, clip ) ) );
+                sq = vaddq_f32( sq, vmulq_f32( x, x ) );
+                auto y = vaddq_f32( vmulq_n_f32( x, f.b[0][0] ), z0 );
+                z0 = vaddq_f32( vsubq_f32( vmulq_n_f32( x, f.b[0][1] ), vmulq_n_f32( y, f.a[0][0] ) ), z1 );
+                z1 = vsubq_f32( vmulq_n_f32( x, f.b[0][2] ), vmulq_n_f32( y, f.a[0][1] ) );
+                auto w = vaddq_f32( vmulq_n_f32( y, f.b[1][0] ), z2 );
+                z2 = vaddq_f32( vsubq_f32( vmulq_n_f32( y, f.b[1][1] ), vmulq_n_f32( w, f.a[1][0] ) ), z3 );
+                z3 = vsubq_f32( vmulq_n_f32( y, f.b[1][2] ), vmulq_n_f32( w, f.a[1][1] ) );
+                ksq = vaddq_f32( ksq, vmulq_f32( w, w ) );
+            }
+            vst1q_f32( l.z[0] + c, z0 );
+            vst1q_f32( l.z[1] + c, z1 );
+            vst1q_f32( l.z[2] + c, z2 );
+            vst1q_f32( l.z[3] + c, z3 );
+            vst1q_f32( l.peak + c, peak );
+            vst1q_f32( l.sq + c, sq );
+            vst1q_f32( l.ksq + c, ksq );
+            vst1q_s32( l.clipped + c, clipped );
+        }
+    }
+};
+
+#endif // LIBVLCPP_AUDIO_NEON
+
+} // namespace audiometer
+} // namespace detail
+
+///
+/// \brief The AudioMeter class measures the levels & loudness of the audio
+///        a media player decodes.
+///
+/// For each channel, it measures the peak & RMS levels over a sliding
+/// window, and counts the clipped samples. It also measures the EBU R128
+/// momentary (400ms) and short-term (3s) loudness, from the K-weighted
+/// signal of ITU-R BS.1770.
+///
+/// The measurement runs on libvlc's audio thread, either as the only
+/// consumer of the audio (see attach()), or as a tap in front of another
+/// play callback (see tap()). Each 100ms of audio, the results are
+/// published to a seqlock, from which any thread can read a consistent
+/// snapshot with levels(), without ever blocking the audio thread.
+///
+/// The filters run in single precision, with one channel per vector lane.
+/// The loudness remains within 0.1 LU of the double precision reference at
+/// common sample rates.
+///
+class AudioMeter
+{
+public:
+    using Isa = AudioConverter::Isa;
+
+    static constexpr unsigned MaxChannels = detail::audiometer::MaxChannels;
+
+    struct Configuration
+    {
+        Configuration()
+            : window( std::chrono::milliseconds( 300 ) )
+            , clipLevel( 0.999f )
+        {
+        }
+
+        /// The duration over which the peak & RMS levels are computed,
+        /// rounded up to a multiple of 100ms.
+        std::chrono::milliseconds window;
+        /// The level from which a sample is considered clipped, 1 being the
+        /// full scale.
+        float clipLevel;
+        /// The loudness weight of each channel. Channels without a weight
+        /// use the BS.1770 ones for libvlc's channel order: 1.41 for the
+        /// surround channels of 4.0, 5.x & 7.x layouts, 0 for the LFE, and
+        /// 1 for the others.
+        std::vector<float> weights;
+    };
+
+    ///
+    /// \brief The Levels struct is a snapshot of the measurements
+    ///
+    struct Levels
+    {
+        unsigned channels;
+        /// The peak & RMS levels of each channel over the window, 1 being
+        /// the full scale.
+        float peak[MaxChannels];
+        float rms[MaxChannels];
+        /// Loudness, in LUFS. -infinity until enough audio was measured, or
+        /// when the audio is quieter than the -70 LUFS absolute gate.
+        float momentary;
+        float shortTerm;
+        /// The number of frames measured when the snapshot was published
+        uint64_t frames;
+    };
+
+    struct Stats
+    {
+        /// Number of frames & of 100ms blocks measured
+        uint64_t frames;
+        uint64_t blocks;
+        /// Number of clipped samples, per channel
+        uint64_t clipped[MaxChannels];
+        /// Number of streams which couldn't be measured, due to their
+        /// format or channel count
+        uint64_t unsupported;
+    };
+
+    ///
+    /// \brief toDbfs Converts a level to dBFS
+    ///
+    static float toDbfs( float level )
+    {
+        if ( level <= 0.f )
+            return -std::numeric_limits<float>::infinity();
+        return 20.f * std::log10( level );
+    }
+
+private:
+    static const unsigned BlocksPerSecond = 10;
+    static const unsigned MomentaryBlocks = 4;
+    static const unsigned ShortTermBlocks = 30;
+    static constexpr double AbsoluteGate = -70.;
+
+    // What was measured during a 100ms block
+    struct Block
+    {
+        unsigned frames;
+        float peak[MaxChannels];
+        double sq[MaxChannels];
+        double ksq[MaxChannels];
+    };
+
+    using Kernel = void (*)( const float*, unsigned, size_t, const detail::audiometer::Filter&,
+                             float, detail::audiometer::Lanes& );
+
+    // Updates a counter which only has a single writer, without paying for
+    // an atomic read-modify-write.
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.store( counter.load( std::memory_order_relaxed ) + v, std::memory_order_relaxed );
+    }
+
+    class State
+    {
+    public:
+        State( Configuration config, Isa isa )
+            : m_config( std::move( config ) )
+            , m_isa( isa )
+            , m_kernel( selectKernel( isa ) )
+            , m_format( AudioConverter::SampleFormat::FL32 )
+            , m_channels( 0 )
+            , m_blockFrames( 0 )
+            , m_blockPos( 0 )
+            , m_nbBlocks( 0 )
+            , m_sequence( 0 )
+            , m_frames( 0 )
+            , m_blocks( 0 )
+            , m_unsupported( 0 )
+        {
+            auto windowBlocks = ( m_config.window.count() + 99 ) / 100;
+            m_windowBlocks = static_cast<unsigned>( std::max<int64_t>( windowBlocks, 1 ) );
+            m_history.resize( std::max<unsigned>( m_windowBlocks, +ShortTermBlocks ) );
+            for ( auto& c : m_clipped )
+                c.store( 0, std::memory_order_relaxed );
+            publish();
+        }
+
+        // Audio thread
+
+        int setup( char* format, uint32_t* rate, uint32_t* channels )
+        {
+            AudioConverter::SampleFormat f;
+            if ( AudioConverter::fromFourcc( format, f ) == false )
+                memcpy( format, "FL32", 4 );
+            if ( *channels > MaxChannels )
+                *channels = MaxChannels;
+            return configure( format, *rate, *channels ) == true ? 0 : -1;
+        }
+
+        bool configure( const char* format, unsigned rate, unsigned channels )
+        {
+            m_converter.reset();
+            m_channels = 0;
+            AudioConverter::SampleFormat f;
+            if ( AudioConverter::fromFourcc( format, f ) == false || channels == 0 ||
+                 channels > MaxChannels || rate < BlocksPerSecond )
+            {
+                add( m_unsupported, 1 );
+                reset();
+                return false;
+            }
+            try
+            {
+                AudioConverter::Options options;
+                options.dither = false;
+                m_converter.reset( new AudioConverter(
+                        AudioConverter::Layout( f, channels ),
+                        AudioConverter::Layout( AudioConverter::SampleFormat::FL32, channels ),
+                        options, m_isa ) );
+                // The kernels may read a vector past the last frame
+                m_scratch.assign( AudioConverter::ChunkSize * channels + 8, 0.f );
+            }
+            catch ( const std::bad_alloc& )
+            {
+                m_converter.reset();
+                return false;
+            }
+            m_format = f;
+            m_channels = channels;
+            m_filter = detail::audiometer::kWeighting( rate );
+            m_blockFrames = rate / BlocksPerSecond;
+            for ( auto c = 0u; c < MaxChannels; ++c )
+                m_weights[c] = weight( c, channels );
+            reset();
+            return true;
+        }
+
+        void cleanup()
+        {
+            m_converter.reset();
+            m_channels = 0;
+        }
+
+        void play( const void* samples, unsigned int count )
+        {
+            if ( m_converter == nullptr )
+                return;
+            auto src = static_cast<const uint8_t*>( samples );
+            auto frameSize = AudioConverter::sampleSize( m_format ) * m_channels;
+            while ( count > 0 )
+            {
+                auto n = std::min<size_t>( { count, AudioConverter::ChunkSize,
+                                             m_blockFrames - m_blockPos } );
+                m_converter->convert( src, m_scratch.data(), n );
+                m_kernel( m_scratch.data(), m_channels, n, m_filter, m_config.clipLevel, m_lanes );
+                src += n * frameSize;
+                count -= static_cast<unsigned int>( n );
+                m_blockPos += static_cast<unsigned>( n );
+                add( m_frames, n );
+                if ( m_blockPos == m_blockFrames )
+                    completeBlock();
+            }
+        }
+
+        // A discontinuity: the filters & windows restart from scratch
+        void reset()
+        {
+            memset( &m_lanes, 0, sizeof( m_lanes ) );
+            m_blockPos = 0;
+            m_nbBlocks = 0;
+            publish();
+        }
+
+        // Any thread
+
+        Levels levels() const
+        {
+            Levels l;
+            while ( true )
+            {
+                auto seq = m_sequence.load( std::memory_order_acquire );
+                if ( ( seq & 1 ) == 0 )
+                {
+                    l.channels = m_published.channels.load( std::memory_order_relaxed );
+                    for ( auto c = 0u; c < MaxChannels; ++c )
+                    {
+                        l.peak[c] = m_published.peak[c].load( std::memory_order_relaxed );
+                        l.rms[c] = m_published.rms[c].load( std::memory_order_relaxed );
+                    }
+                    l.momentary = m_published.momentary.load( std::memory_order_relaxed );
+                    l.shortTerm = m_published.shortTerm.load( std::memory_order_relaxed );
+                    l.frames = m_published.frames.load( std::memory_order_relaxed );
+                    std::atomic_thread_fence( std::memory_order_acquire );
+                    if ( m_sequence.load( std::memory_order_relaxed ) == seq )
+                        return l;
+                }
+                // The audio thread is publishing: this only takes a few
+                // stores, but it may have been preempted meanwhile
+                std::this_thread::yield();
+            }
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            s.frames = m_frames.load( std::memory_order_relaxed );
+            s.blocks = m_blocks.load( std::memory_order_relaxed );
+            for ( auto c = 0u; c < MaxChannels; ++c )
+                s.clipped[c] = m_clipped[c].load( std::memory_order_relaxed );
+            s.unsupported = m_unsupported.load( std::memory_order_relaxed );
+            return s;
+        }
+
+    private:
+        float weight( unsigned c, unsigned channels ) const
+        {
+            if ( c < m_config.weights.size() )
+                return m_config.weights[c];
+            if ( c >= channels )
+                return 0.f;
+            // libvlc orders channels as L R [ML MR] [RL RR] [C] [LFE]
+            switch ( channels )
+            {
+            case 4:
+            case 5:
+                return c == 2 || c == 3 ? 1.41f : 1.f;
+            case 6:
+                return c == 5 ? 0.f : ( c == 2 || c == 3 ? 1.41f : 1.f );
+            case 8:
+                return c == 7 ? 0.f : ( c >= 2 && c < 6 ? 1.41f : 1.f );
+            default:
+                return 1.f;
+            }
+        }
+
+        void completeBlock()
+        {
+            auto& b = m_history[m_nbBlocks % m_history.size()];
+            b.frames = m_blockPos;
+            for ( auto c = 0u; c < m_channels; ++c )
+            {
+                b.peak[c] = m_lanes.peak[c];
+                b.sq[c] = m_lanes.sq[c];
+                b.ksq[c] = m_lanes.ksq[c];
+                if ( m_lanes.clipped[c] != 0 )
+                    add( m_clipped[c], static_cast<uint64_t>( m_lanes.clipped[c] ) );
+            }
+            for ( auto lane = 0u; lane < detail::audiometer::MaxLanes; ++lane )
+            {
+                m_lanes.peak[lane] = 0.f;
+                m_lanes.sq[lane] = 0.f;
+                m_lanes.ksq[lane] = 0.f;
+                m_lanes.clipped[lane] = 0;
+                // Decaying filters would end up on denormals during silences
+                for ( auto& z : m_lanes.z )
+                {
+                    if ( std::fabs( z[lane] ) < 1e-15f )
+                        z[lane] = 0.f;
+                }
+            }
+            m_blockPos = 0;
+            ++m_nbBlocks;
+            add( m_blocks, 1 );
+            publish();
+        }
+
+        // The loudness of the last nbBlocks blocks
+        float loudness( unsigned nbBlocks ) const
+        {
+            if ( m_nbBlocks < nbBlocks )
+                return -std::numeric_limits<float>::infinity();
+            double sum = 0;
+            for ( auto c = 0u; c < m_channels; ++c )
+            {
+                double ksq = 0;
+                uint64_t frames = 0;
+                for ( auto i = 0u; i < nbBlocks; ++i )
+                {
+                    const auto& b = m_history[( m_nbBlocks - 1 - i ) % m_history.size()];
+                    ksq += b.ksq[c];
+                    frames += b.frames;
+                }
+                sum += m_weights[c] * ksq / static_cast<double>( frames );
+            }
+            // Below the absolute gate of R128, the audio is considered silent
+            auto lufs = sum > 0 ? -0.691 + 10 * std::log10( sum ) : -HUGE_VAL;
+            if ( lufs < AbsoluteGate )
+                return -std::numeric_limits<float>::infinity();
+            return static_cast<float>( lufs );
+        }
+
+        void publish()
+        {
+            auto seq = m_sequence.load( std::memory_order_relaxed );
+            m_sequence.store( seq + 1, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            auto nbBlocks = static_cast<unsigned>( std::min<uint64_t>( m_nbBlocks, m_windowBlocks ) );
+            m_published.channels.store( m_channels, std::memory_order_relaxed );
+            for ( auto c = 0u; c < MaxChannels; ++c )
+            {
+                float peak = 0.f;
+                double sq = 0;
+                uint64_t frames = 0;
+                for ( auto i = 0u; i < nbBlocks && c < m_channels; ++i )
+                {
+                    const auto& b = m_history[( m_nbBlocks - 1 - i ) % m_history.size()];
+                    peak = std::max( peak, b.peak[c] );
+                    sq += b.sq[c];
+                    frames += b.frames;
+                }
+                auto rms = frames > 0 ? std::sqrt( sq / static_cast<double>( frames ) ) : 0.;
+                m_published.peak[c].store( peak, std::memory_order_relaxed );
+                m_published.rms[c].store( static_cast<float>( rms ), std::memory_order_relaxed );
+            }
+            m_published.momentary.store( loudness( MomentaryBlocks ), std::memory_order_relaxed );
+            m_published.shortTerm.store( loudness( ShortTermBlocks ), std::memory_order_relaxed );
+            m_published.frames.store( m_frames.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+            m_sequence.store( seq + 2, std::memory_order_release );
+        }
+
+        static Kernel selectKernel( Isa isa )
+        {
+            namespace dm = detail::audiometer;
+            switch ( isa )
+            {
+#if defined(LIBVLCPP_CHROMA_X86)
+            case Isa::AVX2:
+                return &dm::Avx2::analyze;
+            case Isa::SSE2:
+                return &dm::Sse2::analyze;
+#elif defined(LIBVLCPP_AUDIO_NEON)
+            case Isa::NEON:
+                return &dm::Neon::analyze;
+#endif
+            default:
+                return &dm::Scalar::analyze;
+            }
+        }
+
+    private:
+        const Configuration m_config;
+        const Isa m_isa;
+        const Kernel m_kernel;
+        unsigned m_windowBlocks;
+
+        // Audio thread
+        std::unique_ptr<AudioConverter> m_converter;
+        AudioConverter::SampleFormat m_format;
+        unsigned m_channels;
+        std::vector<float> m_scratch;
+        detail::audiometer::Filter m_filter;
+        detail::audiometer::Lanes m_lanes;
+        float m_weights[MaxChannels];
+        unsigned m_blockFrames;
+        unsigned m_blockPos;
+        uint64_t m_nbBlocks;
+        std::vector<Block> m_history;
+
+        // Published by the audio thread, read by any thread
+        std::atomic<uint64_t> m_sequence;
+        struct
+        {
+            std::atomic<unsigned> channels;
+            std::atomic<float> peak[MaxChannels];
+            std::atomic<float> rms[MaxChannels];
+            std::atomic<float> momentary;
+            std::atomic<float> shortTerm;
+            std::atomic<uint64_t> frames;
+        } m_published;
+        std::atomic<uint64_t> m_frames;
+        std::atomic<uint64_t> m_blocks;
+        std::atomic<uint64_t> m_clipped[MaxChannels];
+        std::atomic<uint64_t> m_unsupported;
+    };
+
+public:
+    ///
+    /// \brief AudioMeter Creates a meter, using the best instruction set the
+    ///                   CPU supports
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit AudioMeter( Configuration config = Configuration() )
+        : AudioMeter( std::move( config ), AudioConverter::bestIsa() )
+    {
+    }
+
+    AudioMeter( Configuration config, Isa isa )
+    {
+        if ( AudioConverter::isSupported( isa ) == false )
+            throw std::invalid_argument( "Unsupported instruction set" );
+        if ( config.window.count() <= 0 )
+            throw std::invalid_argument( "The metering window can't be empty" );
+        if ( config.clipLevel <= 0.f )
+            throw std::invalid_argument( "Invalid clip level" );
+        m_state = std::make_shared<State>( std::move( config ), isa );
+    }
+
+    ///
+    /// \brief attach Sets the audio format & audio callbacks of the provided
+    ///               player, so that its audio is only measured.
+    ///
+    /// The player keeps libvlc's format when supported, otherwise it decodes
+    /// to float samples. This must be called before the playback starts.
+    ///
+    void attach( MediaPlayer& mp )
+    {
+        auto state = m_state;
+        mp.setAudioFormatCallbacks(
+            [state]( char* format, uint32_t* rate, uint32_t* channels ) -> int {
+                return state->setup( format, rate, channels );
+            },
+            [state]() { state->cleanup(); } );
+        mp.setAudioCallbacks(
+            [state]( const void* samples, unsigned int count, int64_t ) {
+                state->play( samples, count );
+            },
+            nullptr, nullptr,
+            [state]( int64_t ) { state->reset(); },
+            nullptr );
+    }
+
+    ///
+    /// \brief tap Returns a play callback which measures the samples before
+    ///            forwarding them to the provided one.
+    ///
+    /// The meter must learn the format of the samples: wrap the setup
+    /// callback with tapSetup(), or call setup() from it.
+    ///
+    template <typename PlayCb>
+    std::function<void(const void*, unsigned int, int64_t)> tap( PlayCb&& play )
+    {
+        auto state = m_state;
+        typename std::decay<PlayCb>::type cb( std::forward<PlayCb>( play ) );
+        return [state, cb]( const void* samples, unsigned int count, int64_t pts ) mutable {
+            state->play( samples, count );
+            cb( samples, count, pts );
+        };
+    }
+
+    ///
+    /// \brief tapSetup Returns a setup callback which records the format the
+    ///                 provided one negotiates.
+    ///
+    /// The format isn't altered: streams the meter doesn't support are
+    /// played, but not measured.
+    ///
+    template <typename SetupCb>
+    std::function<int(char*, uint32_t*, uint32_t*)> tapSetup( SetupCb&& setup )
+    {
+        auto state = m_state;
+        typename std::decay<SetupCb>::type cb( std::forward<SetupCb>( setup ) );
+        return [state, cb]( char* format, uint32_t* rate, uint32_t* channels ) mutable -> int {
+            auto res = cb( format, rate, channels );
+            if ( res == 0 )
+                state->configure( format, *rate, *channels );
+            return res;
+        };
+    }
+
+    ///
+    /// \brief levels Returns the last measurements
+    ///
+    /// This can be called from any thread, and never blocks the audio one.
+    ///
+    Levels levels() const
+    {
+        return m_state->levels();
+    }
+
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setAudioFormatCallbacks
+    /// and MediaPlayer::setAudioCallbacks prototypes, for callers which need
+    /// to wrap them. setup() replaces the formats which can't be measured.
+    ///
+    int setup( char* format, uint32_t* rate, uint32_t* channels )
+    {
+        return m_state->setup( format, rate, channels );
+    }
+
+    void cleanup()
+    {
+        m_state->cleanup();
+    }
+
+    void play( const void* samples, unsigned int count, int64_t )
+    {
+        m_state->play( samples, count );
+    }
+
+    void flush( int64_t )
+    {
+        m_state->reset();
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_AUDIOMETER_H
@@ -0,0 +1,735 @@
+/*****************************************************************************
+ * AudioRing.hpp: Single producer, single consumer ring for decoded audio
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_AUDIORING_H
+#define LIBVLC_CXX_AUDIORING_H
+
+#include "MediaPlayer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace audio
+{
+
+///
+/// \return The size of a sample in the provided libvlc audio format, or 0
+///         if the format isn't supported.
+///
+inline unsigned sampleSize( const char* fourcc )
+{
+    static const struct
+    {
+        char fourcc[5];
+        unsigned size;
+    } formats[] = {
+        { "U8  ", 1 }, { "S16N", 2 }, { "S32N", 4 }, { "FL32", 4 }, { "FL64", 8 },
+    };
+    for ( const auto& f : formats )
+    {
+        if ( strncmp( fourcc, f.fourcc, 4 ) == 0 )
+            return f.size;
+    }
+    return 0;
+}
+
+///
+/// \return The value of a silent byte in the provided format
+///
+inline int silence( const char* fourcc )
+{
+    // Unsigned samples are centered around 0x80, the others around 0
+    return strncmp( fourcc, "U8  ", 4 ) == 0 ? 0x80 : 0;
+}
+
+inline uint64_t nextPowerOfTwo( uint64_t v )
+{
+    uint64_t p = 1;
+    while ( p < v )
+        p <<= 1;
+    return p;
+}
+
+} // namespace audio
+
+} // namespace detail
+
+///
+/// \brief The AudioRing class hands the audio decoded by libvlc over to a
+///        consumer thread, typically an audio device's real-time callback.
+///
+/// libvlc's play callback copies its samples into a ring sized from the
+/// negotiated format, and the consumer reads them back at its own pace.
+/// Each block keeps the pts libvlc provided, so that the consumer knows the
+/// presentation time of the samples it reads.
+/// Neither side ever blocks nor allocates memory: positions are exchanged
+/// through atomic counters, so reading and writing are wait free.
+///
+/// libvlc's pause, resume, flush & drain requests are forwarded to the
+/// consumer: it outputs silence while paused, skips the flushed samples,
+/// and doesn't report the end of a drained stream as an underrun.
+/// When the ring is full, the samples which don't fit are dropped and an
+/// overrun is counted. When the consumer asks for more samples than are
+/// available, the missing ones are replaced by silence and an underrun is
+/// counted.
+///
+/// There must be a single consumer thread. libvlc calls all the audio
+/// callbacks from the same thread.
+///
+class AudioRing
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : rate( 0 )
+            , channels( 0 )
+            , duration( std::chrono::milliseconds( 500 ) )
+            , nbBlocks( 256 )
+        {
+        }
+
+        /// The sample format to decode to: "U8  ", "S16N", "S32N", "FL32" or
+        /// "FL64". If empty, the format libvlc proposes is used when
+        /// supported, otherwise "S16N".
+        std::string format;
+        /// The sample rate & channel count, or 0 to keep libvlc's ones
+        unsigned rate;
+        unsigned channels;
+        /// How much audio the ring can hold. The capacity is computed from
+        /// the negotiated format, and rounded up to a power of two frames.
+        std::chrono::milliseconds duration;
+        /// The maximum number of blocks of samples the ring can hold, each
+        /// with its own pts. This is rounded up to a power of two.
+        unsigned nbBlocks;
+    };
+
+    ///
+    /// \brief The Format struct describes the audio the ring currently holds
+    ///
+    struct Format
+    {
+        char fourcc[5];
+        unsigned rate;
+        unsigned channels;
+        /// The size of a frame, ie. of a sample for each channel
+        unsigned frameSize;
+        /// The ring capacity, in frames
+        uint64_t capacity;
+    };
+
+    struct Stats
+    {
+        /// Number of frames written to, and read from, the ring
+        uint64_t written;
+        uint64_t read;
+        /// Number of blocks which didn't fit, and of frames they lost
+        uint64_t overruns;
+        uint64_t dropped;
+        /// Number of reads which came short, and of frames they missed
+        uint64_t underruns;
+        uint64_t missing;
+        /// Number of frames discarded by flushes & format changes
+        uint64_t flushed;
+    };
+
+private:
+    // A negotiated format, along with the ring memory for it. The ring
+    // alternates between two of them, since the consumer may still be
+    // reading from the previous one after a format change.
+    struct Buffer
+    {
+        Buffer( const char* fourcc, unsigned r, unsigned c, std::chrono::milliseconds duration )
+        {
+            memcpy( format.fourcc, fourcc, 4 );
+            format.fourcc[4] = 0;
+            format.rate = r;
+            format.channels = c;
+            format.frameSize = detail::audio::sampleSize( fourcc ) * c;
+            format.capacity = detail::audio::nextPowerOfTwo(
+                        std::max<uint64_t>( r * static_cast<uint64_t>( duration.count() ) / 1000, 1 ) );
+            data.reset( new uint8_t[format.capacity * format.frameSize] );
+            silence = detail::audio::silence( fourcc );
+        }
+
+        bool matches( const char* fourcc, unsigned r, unsigned c ) const
+        {
+            return memcmp( format.fourcc, fourcc, 4 ) == 0 && format.rate == r &&
+                    format.channels == c;
+        }
+
+        Format format;
+        std::unique_ptr<uint8_t[]> data;
+        int silence;
+    };
+
+    struct Block
+    {
+        /// The position of the block first frame
+        uint64_t start;
+        int64_t pts;
+    };
+
+    // Updates a counter which only has a single writer, without paying for
+    // an atomic read-modify-write.
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.store( counter.load( std::memory_order_relaxed ) + v, std::memory_order_relaxed );
+    }
+
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_blocks( detail::audio::nextPowerOfTwo( m_config.nbBlocks ) )
+            , m_buffer( nullptr )
+            , m_paused( false )
+            , m_draining( false )
+            , m_write( 0 )
+            , m_flushTo( 0 )
+            , m_drainTo( 0 )
+            , m_blockWrite( 0 )
+            , m_current( nullptr )
+            , m_last( 1 )
+            , m_start( 0 )
+            , m_written( 0 )
+            , m_overruns( 0 )
+            , m_dropped( 0 )
+            , m_flushed( 0 )
+            , m_read( 0 )
+            , m_blockRead( 0 )
+            , m_readCount( 0 )
+            , m_underruns( 0 )
+            , m_missing( 0 )
+            , m_reading( nullptr )
+        {
+        }
+
+        // Producer side: libvlc's audio thread
+
+        int setup( char* format, uint32_t* rate, uint32_t* channels )
+        {
+            if ( m_config.format.empty() == false )
+                strncpy( format, m_config.format.c_str(), 4 );
+            else if ( detail::audio::sampleSize( format ) == 0 )
+                memcpy( format, "S16N", 4 );
+            if ( m_config.rate != 0 )
+                *rate = m_config.rate;
+            if ( m_config.channels != 0 )
+                *channels = m_config.channels;
+            if ( detail::audio::sampleSize( format ) == 0 || *rate == 0 || *channels == 0 )
+                return -1;
+            // The buffer which isn't published anymore can only be in use by
+            // a read which started before the previous setup. Reads never
+            // block, so wait for it to complete.
+            auto idx = 1 - m_last;
+            auto& buffer = m_buffers[idx];
+            while ( buffer != nullptr && m_reading.load( std::memory_order_seq_cst ) == buffer.get() )
+                std::this_thread::yield();
+            if ( buffer == nullptr || buffer->matches( format, *rate, *channels ) == false )
+            {
+                try
+                {
+                    buffer.reset( new Buffer( format, *rate, *channels, m_config.duration ) );
+                }
+                catch ( const std::bad_alloc& )
+                {
+                    return -1;
+                }
+            }
+            // Samples in the previous format must not be played anymore.
+            // The positions of the new ring start where the previous one
+            // stopped, so that the consumer can tell them apart.
+            discard();
+            m_last = idx;
+            m_current = buffer.get();
+            m_start = m_write.load( std::memory_order_relaxed );
+            m_paused.store( false, std::memory_order_relaxed );
+            m_buffer.store( m_current, std::memory_order_seq_cst );
+            return 0;
+        }
+
+        void cleanup()
+        {
+            discard();
+            m_current = nullptr;
+            m_buffer.store( nullptr, std::memory_order_seq_cst );
+        }
+
+        void play( const void* samples, unsigned count, int64_t pts )
+        {
+            if ( m_current == nullptr || count == 0 )
+                return;
+            const auto& format = m_current->format;
+            auto write = m_write.load( std::memory_order_relaxed );
+            // The flushed samples are only freed once the consumer skipped
+            // them, but the ones in the previous format are never read from
+            // this buffer.
+            auto read = std::max( m_read.load( std::memory_order_acquire ), m_start );
+            auto room = format.capacity - ( write - read );
+            auto blockWrite = m_blockWrite.load( std::memory_order_relaxed );
+            auto blockRead = m_blockRead.load( std::memory_order_acquire );
+            uint64_t n = count;
+            if ( blockWrite - blockRead == m_blocks.size() )
+                n = 0;
+            else if ( n > room )
+                n = room;
+            m_draining.store( false, std::memory_order_relaxed );
+            if ( n < count )
+            {
+                add( m_overruns, 1 );
+                add( m_dropped, count - n );
+            }
+            if ( n == 0 )
+                return;
+
+            auto& block = m_blocks[blockWrite & ( m_blocks.size() - 1 )];
+            block.start = write;
+            block.pts = pts;
+            store( m_current->data.get(), format, write, static_cast<const uint8_t*>( samples ), n );
+            m_blockWrite.store( blockWrite + 1, std::memory_order_release );
+            m_write.store( write + n, std::memory_order_release );
+            add( m_written, n );
+        }
+
+        void pause()
+        {
+            m_paused.store( true, std::memory_order_relaxed );
+        }
+
+        void resume()
+        {
+            m_paused.store( false, std::memory_order_relaxed );
+        }
+
+        void flush()
+        {
+            discard();
+        }
+
+        // libvlc expects the drain callback to return once the queued
+        // samples were played, which only the consumer can tell. Since all
+        // the callbacks come from the same thread, nothing else can happen
+        // to the ring meanwhile.
+        void drain()
+        {
+            if ( m_current == nullptr )
+                return;
+            auto write = m_write.load( std::memory_order_relaxed );
+            m_drainTo.store( write, std::memory_order_relaxed );
+            m_draining.store( true, std::memory_order_release );
+            auto read = m_read.load( std::memory_order_acquire );
+            if ( read >= write )
+                return;
+            // Don't wait forever for a consumer which stopped reading
+            auto timeout = std::chrono::microseconds( ( write - read ) * 1000000 / m_current->format.rate ) +
+                           std::chrono::milliseconds( 200 );
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while ( m_read.load( std::memory_order_acquire ) < write &&
+                    std::chrono::steady_clock::now() < deadline )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+
+        // Consumer side
+
+        uint64_t read( void* samples, uint64_t count, int64_t* pts )
+        {
+            BufferGuard guard( *this );
+            auto buffer = guard.get();
+            if ( buffer == nullptr )
+                return 0;
+            const auto& format = buffer->format;
+            auto dst = static_cast<uint8_t*>( samples );
+            auto read = m_read.load( std::memory_order_relaxed );
+            auto flushTo = m_flushTo.load( std::memory_order_acquire );
+            if ( read < flushTo )
+            {
+                read = flushTo;
+                // Release the flushed blocks now, as they could otherwise
+                // fill up the blocks ring when nothing follows them
+                releaseBlocks( flushTo );
+            }
+            auto write = m_write.load( std::memory_order_acquire );
+            uint64_t n = 0;
+            if ( m_paused.load( std::memory_order_relaxed ) == false )
+                n = std::min( count, write - read );
+            if ( n > 0 )
+            {
+                load( dst, format, read, buffer->data.get(), n );
+                // These samples were written after a format change: read
+                // them with the new format next time.
+                if ( m_buffer.load( std::memory_order_acquire ) != buffer )
+                {
+                    memset( dst, buffer->silence, count * format.frameSize );
+                    return 0;
+                }
+                auto t = timestamp( read, read + n, write, format.rate );
+                if ( pts != nullptr )
+                    *pts = t;
+            }
+            m_read.store( read + n, std::memory_order_release );
+            add( m_readCount, n );
+            if ( n < count )
+            {
+                memset( dst + n * format.frameSize, buffer->silence, ( count - n ) * format.frameSize );
+                // Running out of samples is expected while paused, or once
+                // a drained stream ended
+                auto drained = m_draining.load( std::memory_order_acquire ) == true &&
+                        read + n >= m_drainTo.load( std::memory_order_relaxed );
+                if ( m_paused.load( std::memory_order_relaxed ) == false && drained == false )
+                {
+                    add( m_underruns, 1 );
+                    add( m_missing, count - n );
+                }
+            }
+            return n;
+        }
+
+        uint64_t available() const
+        {
+            auto read = std::max( m_read.load( std::memory_order_relaxed ),
+                                  m_flushTo.load( std::memory_order_acquire ) );
+            return m_write.load( std::memory_order_acquire ) - read;
+        }
+
+        bool format( Format& f ) const
+        {
+            BufferGuard guard( *this );
+            auto buffer = guard.get();
+            if ( buffer == nullptr )
+                return false;
+            f = buffer->format;
+            return true;
+        }
+
+        bool paused() const
+        {
+            return m_paused.load( std::memory_order_relaxed );
+        }
+
+        bool drained() const
+        {
+            return m_draining.load( std::memory_order_acquire ) == true &&
+                    m_read.load( std::memory_order_relaxed ) >= m_drainTo.load( std::memory_order_relaxed );
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            s.written = m_written.load( std::memory_order_relaxed );
+            s.read = m_readCount.load( std::memory_order_relaxed );
+            s.overruns = m_overruns.load( std::memory_order_relaxed );
+            s.dropped = m_dropped.load( std::memory_order_relaxed );
+            s.underruns = m_underruns.load( std::memory_order_relaxed );
+            s.missing = m_missing.load( std::memory_order_relaxed );
+            s.flushed = m_flushed.load( std::memory_order_relaxed );
+            return s;
+        }
+
+    private:
+        // Publishes the buffer the consumer uses, so that setup() doesn't
+        // reuse it meanwhile
+        class BufferGuard
+        {
+        public:
+            explicit BufferGuard( const State& state )
+                : m_state( state )
+                , m_buffer( state.m_buffer.load( std::memory_order_acquire ) )
+            {
+                // setup() may have replaced the buffer before seeing ours:
+                // only use it if it's still published afterwards
+                while ( true )
+                {
+                    m_state.m_reading.store( m_buffer, std::memory_order_seq_cst );
+                    auto current = m_state.m_buffer.load( std::memory_order_seq_cst );
+                    if ( current == m_buffer )
+                        break;
+                    m_buffer = current;
+                }
+            }
+
+            ~BufferGuard()
+            {
+                m_state.m_reading.store( nullptr, std::memory_order_release );
+            }
+
+            Buffer* get() const
+            {
+                return m_buffer;
+            }
+
+            BufferGuard( const BufferGuard& ) = delete;
+            BufferGuard& operator=( const BufferGuard& ) = delete;
+
+        private:
+            const State& m_state;
+            Buffer* m_buffer;
+        };
+
+        // Copies count frames between the ring & a linear buffer, starting
+        // at the provided position, wrapping around the end of the ring.
+        static void store( uint8_t* ring, const Format& format, uint64_t position,
+                           const uint8_t* src, uint64_t count )
+        {
+            auto offset = position & ( format.capacity - 1 );
+            auto first = std::min( count, format.capacity - offset );
+            memcpy( ring + offset * format.frameSize, src, first * format.frameSize );
+            memcpy( ring, src + first * format.frameSize, ( count - first ) * format.frameSize );
+        }
+
+        static void load( uint8_t* dst, const Format& format, uint64_t position,
+                          const uint8_t* ring, uint64_t count )
+        {
+            auto offset = position & ( format.capacity - 1 );
+            auto first = std::min( count, format.capacity - offset );
+            memcpy( dst, ring + offset * format.frameSize, first * format.frameSize );
+            memcpy( dst + first * format.frameSize, ring, ( count - first ) * format.frameSize );
+        }
+
+        void discard()
+        {
+            auto write = m_write.load( std::memory_order_relaxed );
+            auto flushTo = m_flushTo.load( std::memory_order_relaxed );
+            auto read = std::max( m_read.load( std::memory_order_acquire ), flushTo );
+            add( m_flushed, write - read );
+            m_flushTo.store( write, std::memory_order_release );
+            m_draining.store( false, std::memory_order_relaxed );
+        }
+
+        // Releases the blocks starting before the provided position. Blocks
+        // are written at once, so they also end before it.
+        void releaseBlocks( uint64_t position )
+        {
+            auto blockRead = m_blockRead.load( std::memory_order_relaxed );
+            auto blockWrite = m_blockWrite.load( std::memory_order_acquire );
+            auto mask = m_blocks.size() - 1;
+            while ( blockRead != blockWrite && m_blocks[blockRead & mask].start < position )
+                ++blockRead;
+            m_blockRead.store( blockRead, std::memory_order_release );
+        }
+
+        // Returns the pts of the frame at the provided position, from the
+        // block it belongs to, and releases the blocks which were entirely
+        // read, up to the provided end position.
+        int64_t timestamp( uint64_t position, uint64_t end, uint64_t write, unsigned rate )
+        {
+            auto blockRead = m_blockRead.load( std::memory_order_relaxed );
+            auto blockWrite = m_blockWrite.load( std::memory_order_acquire );
+            auto mask = m_blocks.size() - 1;
+            while ( blockWrite - blockRead > 1 && m_blocks[( blockRead + 1 ) & mask].start <= position )
+                ++blockRead;
+            const auto& block = m_blocks[blockRead & mask];
+            auto pts = block.pts + static_cast<int64_t>( ( position - block.start ) * 1000000 / rate );
+            while ( blockWrite - blockRead > 1 && m_blocks[( blockRead + 1 ) & mask].start < end )
+                ++blockRead;
+            // Blocks are published before their samples, so the last block
+            // read is over when all the samples were read.
+            if ( end == write )
+                ++blockRead;
+            m_blockRead.store( blockRead, std::memory_order_release );
+            return pts;
+        }
+
+        const Configuration m_config;
+        std::vector<Block> m_blocks;
+        std::atomic<Buffer*> m_buffer;
+        std::atomic<bool> m_paused;
+        std::atomic<bool> m_draining;
+        // Producer side. Positions count frames since the ring creation.
+        std::atomic<uint64_t> m_write;
+        std::atomic<uint64_t> m_flushTo;
+        std::atomic<uint64_t> m_drainTo;
+        std::atomic<uint64_t> m_blockWrite;
+        std::unique_ptr<Buffer> m_buffers[2];
+        Buffer* m_current;
+        // The index of the buffer the last setup used
+        unsigned m_last;
+        uint64_t m_start;
+        std::atomic<uint64_t> m_written;
+        std::atomic<uint64_t> m_overruns;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_flushed;
+        // Consumer side
+        std::atomic<uint64_t> m_read;
+        std::atomic<uint64_t> m_blockRead;
+        std::atomic<uint64_t> m_readCount;
+        std::atomic<uint64_t> m_underruns;
+        std::atomic<uint64_t> m_missing;
+        mutable std::atomic<Buffer*> m_reading;
+    };
+
+public:
+    explicit AudioRing( Configuration config = Configuration() )
+    {
+        if ( config.format.empty() == false && detail::audio::sampleSize( config.format.c_str() ) == 0 )
+            throw std::invalid_argument( "Unsupported audio format: " + config.format );
+        if ( config.duration.count() <= 0 || config.nbBlocks == 0 )
+            throw std::invalid_argument( "The audio ring can't be empty" );
+        m_state = std::make_shared<State>( std::move( config ) );
+    }
+
+    ///
+    /// \brief attach Sets the audio format & audio callbacks of the provided
+    ///               player, so that it plays to this ring.
+    ///
+    /// This must be called before the playback starts.
+    ///
+    void attach( MediaPlayer& mp )
+    {
+        auto state = m_state;
+        mp.setAudioFormatCallbacks(
+            [state]( char* format, uint32_t* rate, uint32_t* channels ) -> int {
+                return state->setup( format, rate, channels );
+            },
+            [state]() { state->cleanup(); } );
+        mp.setAudioCallbacks(
+            [state]( const void* samples, unsigned int count, int64_t pts ) {
+                state->play( samples, count, pts );
+            },
+            [state]( int64_t ) { state->pause(); },
+            [state]( int64_t ) { state->resume(); },
+            [state]( int64_t ) { state->flush(); },
+            [state]() { state->drain(); } );
+    }
+
+    ///
+    /// \brief read Reads audio frames from the ring
+    ///
+    /// This never blocks. If fewer frames than requested are available, the
+    /// remainder of the buffer is filled with silence.
+    /// This must only be called from the consumer thread.
+    ///
+    /// \param samples  The buffer to read to. It must be large enough for
+    ///                 count frames in the current format.
+    /// \param count    The number of frames to read
+    /// \param pts      If not nullptr, receives the pts of the first frame
+    ///                 read, when any.
+    /// \return The number of frames read from the ring. Nothing is written
+    ///         to the buffer when no format was negotiated yet.
+    ///
+    uint64_t read( void* samples, uint64_t count, int64_t* pts = nullptr )
+    {
+        return m_state->read( samples, count, pts );
+    }
+
+    ///
+    /// \brief available Returns the number of frames which can be read
+    ///
+    uint64_t available() const
+    {
+        return m_state->available();
+    }
+
+    ///
+    /// \brief format Returns the format of the audio being played
+    ///
+    /// This must only be called from the consumer thread.
+    ///
+    /// \return false if no format was negotiated yet
+    ///
+    bool format( Format& f ) const
+    {
+        return m_state->format( f );
+    }
+
+    ///
+    /// \brief paused Returns true if libvlc paused the playback
+    ///
+    bool paused() const
+    {
+        return m_state->paused();
+    }
+
+    ///
+    /// \brief drained Returns true if libvlc drained the stream, and all
+    ///                its samples were read.
+    ///
+    bool drained() const
+    {
+        return m_state->drained();
+    }
+
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setAudioFormatCallbacks
+    /// and MediaPlayer::setAudioCallbacks prototypes, for callers which need
+    /// to wrap them.
+    ///
+    int setup( char* format, uint32_t* rate, uint32_t* channels )
+    {
+        return m_state->setup( format, rate, channels );
+    }
+
+    void cleanup()
+    {
+        m_state->cleanup();
+    }
+
+    void play( const void* samples, unsigned int count, int64_t pts )
+    {
+        m_state->play( samples, count, pts );
+    }
+
+    void pause( int64_t )
+    {
+        m_state->pause();
+    }
+
+    void resume( int64_t )
+    {
+        m_state->resume();
+    }
+
+    void flush( int64_t )
+    {
+        m_state->flush();
+    }
+
+    void drain()
+    {
+        m_state->drain();
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_AUDIORING_H
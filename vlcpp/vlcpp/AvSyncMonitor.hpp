@@ -0,0 +1,597 @@
+/*****************************************************************************
+ * AvSyncMonitor.hpp: Audio/video synchronization monitor for callback players
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_AVSYNCMONITOR_H
+#define LIBVLC_CXX_AVSYNCMONITOR_H
+
+#include "MediaPlayer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace avsync
+{
+
+// Invokes an optional user callback
+template <typename Cb, typename... Args>
+void call( Cb& cb, Args... args )
+{
+    cb( args... );
+}
+
+template <typename... Args>
+void call( std::nullptr_t&, Args... )
+{
+}
+
+struct Point
+{
+    int64_t date;
+    int64_t value;
+};
+
+///
+/// Returns the least squares slope of the values over their dates, in
+/// microseconds per second, or 0 with less than 3 points.
+///
+inline double slope( const std::deque<Point>& points )
+{
+    if ( points.size() < 3 )
+        return 0.;
+    // Relative to the first point, to keep the precision of the sums
+    const auto& origin = points.front();
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for ( const auto& p : points )
+    {
+        auto x = static_cast<double>( p.date - origin.date ) / 1000000.;
+        auto y = static_cast<double>( p.value - origin.value );
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    auto n = static_cast<double>( points.size() );
+    auto d = n * sxx - sx * sx;
+    if ( d <= 0. )
+        return 0.;
+    return ( n * sxy - sx * sy ) / d;
+}
+
+// Drops the points older than the window
+inline void trim( std::deque<Point>& points, int64_t date, int64_t window )
+{
+    while ( points.empty() == false && date - points.front().date > window )
+        points.pop_front();
+}
+
+} // namespace avsync
+
+} // namespace detail
+
+///
+/// \brief The AvSyncMonitor class measures whether the audio & video a
+///        callback player outputs line up.
+///
+/// When a player renders through both MediaPlayer::setVideoCallbacks and
+/// MediaPlayer::setAudioCallbacks, libvlc schedules the output, but it can't
+/// know when the application actually makes the samples audible and the
+/// pictures visible. The monitor compares both against libvlc's schedule, on
+/// the libvlc_clock() time base:
+/// - the audio lateness is the date at which the first sample of a block is
+///   heard, i.e. the play callback date plus the audio latency the
+///   application reports, minus the block pts. The current audio delay is
+///   added back, so that the lateness is relative to the video schedule.
+/// - the video lateness is the delay between the display callback, which
+///   libvlc invokes when a picture is due, and its presentation: either the
+///   one the application reports with presented(), or the configured video
+///   latency.
+///
+/// The A/V offset is the audio lateness minus the video one: a positive
+/// offset means the audio is heard after the matching picture is shown.
+/// update() samples the offset, along with MediaPlayer::time() to detect
+/// seeks & pauses, and tracks the drift of the offset with a least squares
+/// fit over a sliding window. When enabled, it also corrects the offset
+/// with MediaPlayer::setAudioDelay. A correction only takes effect if the
+/// audio output schedules the samples by their pts (see libvlc_delay()):
+/// an output which plays the samples as they come will keep its offset.
+///
+/// The callbacks only cost a clock read and a few relaxed atomic operations.
+///
+class AvSyncMonitor
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : window( std::chrono::seconds( 10 ) )
+            , correct( false )
+            , threshold( std::chrono::milliseconds( 20 ) )
+            , maxStep( std::chrono::milliseconds( 10 ) )
+            , interval( std::chrono::seconds( 1 ) )
+            , maxDelay( std::chrono::seconds( 1 ) )
+            , discontinuity( std::chrono::seconds( 1 ) )
+        {
+        }
+
+        /// The duration over which the drift is computed
+        std::chrono::microseconds window;
+        /// Whether update() corrects the offset with the audio delay
+        bool correct;
+        /// Offsets within this threshold aren't corrected
+        std::chrono::microseconds threshold;
+        /// The largest change of the audio delay per correction
+        std::chrono::microseconds maxStep;
+        /// The minimum time between two corrections, during which the
+        /// previous one settles
+        std::chrono::microseconds interval;
+        /// Corrections never set an audio delay beyond this bound
+        std::chrono::microseconds maxDelay;
+        /// A change of the difference between libvlc_clock() and the media
+        /// time larger than this is considered a seek or a pause, after
+        /// which the measurements restart.
+        std::chrono::microseconds discontinuity;
+    };
+
+    struct Stats
+    {
+        /// Number of audio blocks & video pictures measured
+        uint64_t audioBlocks;
+        uint64_t videoFrames;
+        /// True once the offset was measured, since the last discontinuity
+        bool hasOffset;
+        /// The smoothed lateness of each stream, and the A/V offset, in
+        /// microseconds
+        int64_t audioLateness;
+        int64_t videoLateness;
+        int64_t offset;
+        /// The drift of the A/V offset, in microseconds per second (ppm)
+        double drift;
+        /// The smoothed time between the audio play callbacks and the pts of
+        /// their blocks, in microseconds
+        int64_t audioLead;
+        /// The last MediaPlayer::time() update() read, in milliseconds, or -1
+        int64_t mediaTime;
+        /// The drift of libvlc_clock() against the media time, in
+        /// microseconds per second: 0 when playing at the normal rate
+        double clockDrift;
+        /// The last known audio delay, in microseconds
+        int64_t audioDelay;
+        /// Number of corrections applied, and of discontinuities
+        uint64_t corrections;
+        uint64_t discontinuities;
+    };
+
+private:
+    static const int64_t NoValue = INT64_MIN;
+
+    // Updates a counter which only has a single writer, without paying for
+    // an atomic read-modify-write.
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.store( counter.load( std::memory_order_relaxed ) + v, std::memory_order_relaxed );
+    }
+
+    // Exponentially weighted moving average, with a weight of 1/16
+    static int64_t smooth( int64_t average, int64_t v )
+    {
+        if ( average == NoValue )
+            return v;
+        return average + ( v - average ) / 16;
+    }
+
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_audioLatency( 0 )
+            , m_videoLatency( 0 )
+            , m_audioDelay( 0 )
+            , m_audioReset( false )
+            , m_audioBlocks( 0 )
+            , m_audioLateness( NoValue )
+            , m_audioLead( NoValue )
+            , m_videoFrames( 0 )
+            , m_lastDisplay( NoValue )
+            , m_presentationDelay( NoValue )
+            , m_lastAudioBlocks( 0 )
+            , m_lastVideoFrames( 0 )
+            , m_hasClockOffset( false )
+            , m_clockOffset( 0 )
+            , m_lastCorrection( NoValue )
+        {
+            m_stats = Stats();
+            m_stats.mediaTime = -1;
+        }
+
+        void setAudioLatency( int64_t latency )
+        {
+            m_audioLatency.store( latency, std::memory_order_relaxed );
+        }
+
+        void setVideoLatency( int64_t latency )
+        {
+            m_videoLatency.store( latency, std::memory_order_relaxed );
+        }
+
+        // libvlc plays the audio from a single thread
+        void audio( int64_t pts, int64_t date )
+        {
+            auto lateness = m_audioLateness.load( std::memory_order_relaxed );
+            auto lead = m_audioLead.load( std::memory_order_relaxed );
+            if ( m_audioReset.exchange( false, std::memory_order_relaxed ) == true )
+                lateness = lead = NoValue;
+            auto heard = date + m_audioLatency.load( std::memory_order_relaxed );
+            auto delay = m_audioDelay.load( std::memory_order_relaxed );
+            m_audioLateness.store( smooth( lateness, heard - pts + delay ), std::memory_order_relaxed );
+            m_audioLead.store( smooth( lead, pts - date ), std::memory_order_relaxed );
+            add( m_audioBlocks, 1 );
+        }
+
+        // libvlc displays from the video output thread
+        void video( int64_t date )
+        {
+            m_lastDisplay.store( date, std::memory_order_relaxed );
+            add( m_videoFrames, 1 );
+        }
+
+        // Called by the application's render thread. Relaxed ordering is
+        // enough: reading the display date of the previous picture only
+        // skews a single sample of the average.
+        void presented( int64_t date )
+        {
+            auto display = m_lastDisplay.load( std::memory_order_relaxed );
+            if ( display == NoValue || date < display )
+                return;
+            auto d = m_presentationDelay.load( std::memory_order_relaxed );
+            m_presentationDelay.store( smooth( d, date - display ), std::memory_order_relaxed );
+        }
+
+        void flush()
+        {
+            m_audioReset.store( true, std::memory_order_relaxed );
+            std::lock_guard<std::mutex> lock( m_lock );
+            restart();
+        }
+
+        // Returns the audio delay to apply
+        int64_t update( int64_t date, int64_t mediaTime, int64_t delay )
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            m_audioDelay.store( delay, std::memory_order_relaxed );
+            m_stats.audioDelay = delay;
+            m_stats.mediaTime = mediaTime >= 0 ? mediaTime / 1000 : -1;
+            // Only sample while both streams are flowing
+            auto audioBlocks = m_audioBlocks.load( std::memory_order_relaxed );
+            auto videoFrames = m_videoFrames.load( std::memory_order_relaxed );
+            bool flowing = audioBlocks != m_lastAudioBlocks && videoFrames != m_lastVideoFrames;
+            m_lastAudioBlocks = audioBlocks;
+            m_lastVideoFrames = videoFrames;
+            if ( mediaTime >= 0 )
+            {
+                // The reference only moves during the playback, so that a
+                // pause is detected once long enough, like a seek.
+                auto offset = date - mediaTime;
+                if ( m_hasClockOffset == true &&
+                     std::llabs( offset - m_clockOffset ) > m_config.discontinuity.count() )
+                {
+                    ++m_stats.discontinuities;
+                    m_audioReset.store( true, std::memory_order_relaxed );
+                    restart();
+                }
+                if ( m_hasClockOffset == false || flowing == true )
+                {
+                    m_hasClockOffset = true;
+                    m_clockOffset = offset;
+                }
+                if ( flowing == true )
+                {
+                    m_clockPoints.push_back( detail::avsync::Point{ date, offset } );
+                    detail::avsync::trim( m_clockPoints, date, m_config.window.count() );
+                    m_stats.clockDrift = detail::avsync::slope( m_clockPoints );
+                }
+            }
+
+            // The audio average restarts after a reset
+            auto audioLateness = m_audioLateness.load( std::memory_order_relaxed );
+            if ( flowing == false || audioLateness == NoValue ||
+                 m_audioReset.load( std::memory_order_relaxed ) == true )
+                return delay;
+
+            auto presentation = m_presentationDelay.load( std::memory_order_relaxed );
+            auto videoLateness = m_videoLatency.load( std::memory_order_relaxed ) +
+                    ( presentation != NoValue ? presentation : 0 );
+            auto offset = audioLateness - videoLateness;
+            m_stats.hasOffset = true;
+            m_stats.audioLateness = audioLateness;
+            m_stats.videoLateness = videoLateness;
+            m_stats.offset = offset;
+            m_offsetPoints.push_back( detail::avsync::Point{ date, offset } );
+            detail::avsync::trim( m_offsetPoints, date, m_config.window.count() );
+            m_stats.drift = detail::avsync::slope( m_offsetPoints );
+
+            if ( m_config.correct == false || std::llabs( offset ) <= m_config.threshold.count() ||
+                 ( m_lastCorrection != NoValue &&
+                   date - m_lastCorrection < m_config.interval.count() ) )
+                return delay;
+            auto step = offset;
+            auto maxStep = m_config.maxStep.count();
+            step = step > maxStep ? maxStep : ( step < -maxStep ? -maxStep : step );
+            auto maxDelay = m_config.maxDelay.count();
+            auto target = delay - step;
+            target = target > maxDelay ? maxDelay : ( target < -maxDelay ? -maxDelay : target );
+            if ( target == delay )
+                return delay;
+            // The offset jumps by the correction, which would skew the drift
+            ++m_stats.corrections;
+            m_lastCorrection = date;
+            m_audioDelay.store( target, std::memory_order_relaxed );
+            m_stats.audioDelay = target;
+            m_audioReset.store( true, std::memory_order_relaxed );
+            m_offsetPoints.clear();
+            return target;
+        }
+
+        // Reverts an audio delay the player refused
+        void rejected( int64_t delay )
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            --m_stats.corrections;
+            m_audioDelay.store( delay, std::memory_order_relaxed );
+            m_stats.audioDelay = delay;
+        }
+
+        Stats stats()
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            auto s = m_stats;
+            s.audioBlocks = m_audioBlocks.load( std::memory_order_relaxed );
+            s.videoFrames = m_videoFrames.load( std::memory_order_relaxed );
+            auto lead = m_audioLead.load( std::memory_order_relaxed );
+            s.audioLead = lead != NoValue ? lead : 0;
+            return s;
+        }
+
+    private:
+        // Forgets what was measured before a seek, a pause or a flush.
+        // Called with m_lock held.
+        void restart()
+        {
+            m_hasClockOffset = false;
+            m_clockPoints.clear();
+            m_offsetPoints.clear();
+            m_lastCorrection = NoValue;
+            m_stats.hasOffset = false;
+            m_stats.audioLateness = m_stats.videoLateness = m_stats.offset = 0;
+            m_stats.drift = m_stats.clockDrift = 0.;
+        }
+
+    private:
+        const Configuration m_config;
+        std::atomic<int64_t> m_audioLatency;
+        std::atomic<int64_t> m_videoLatency;
+        std::atomic<int64_t> m_audioDelay;
+        std::atomic<bool> m_audioReset;
+        // Audio thread
+        std::atomic<uint64_t> m_audioBlocks;
+        std::atomic<int64_t> m_audioLateness;
+        std::atomic<int64_t> m_audioLead;
+        // Video thread
+        std::atomic<uint64_t> m_videoFrames;
+        std::atomic<int64_t> m_lastDisplay;
+        // Render thread
+        std::atomic<int64_t> m_presentationDelay;
+        // update() side
+        std::mutex m_lock;
+        uint64_t m_lastAudioBlocks;
+        uint64_t m_lastVideoFrames;
+        bool m_hasClockOffset;
+        int64_t m_clockOffset;
+        std::deque<detail::avsync::Point> m_clockPoints;
+        std::deque<detail::avsync::Point> m_offsetPoints;
+        int64_t m_lastCorrection;
+        Stats m_stats;
+    };
+
+public:
+    ///
+    /// \brief AvSyncMonitor Creates a monitor
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit AvSyncMonitor( Configuration config = Configuration() )
+    {
+        if ( config.window.count() <= 0 )
+            throw std::invalid_argument( "The drift window can't be empty" );
+        if ( config.threshold.count() < 0 || config.maxStep.count() <= 0 ||
+             config.interval.count() < 0 || config.maxDelay.count() < 0 )
+            throw std::invalid_argument( "Invalid correction parameters" );
+        if ( config.discontinuity.count() <= 0 )
+            throw std::invalid_argument( "Invalid discontinuity threshold" );
+        m_state = std::make_shared<State>( std::move( config ) );
+    }
+
+    ///
+    /// \brief tap Returns a play callback which measures the audio lateness
+    ///            before forwarding the samples to the provided one.
+    ///
+    template <typename PlayCb>
+    std::function<void(const void*, unsigned int, int64_t)> tap( PlayCb&& play )
+    {
+        static_assert(signature_match<PlayCb, void(const void*, unsigned int, int64_t)>::value, "Mismatched play callback signature");
+        auto state = m_state;
+        typename std::decay<PlayCb>::type cb( std::forward<PlayCb>( play ) );
+        return [state, cb]( const void* samples, unsigned int count, int64_t pts ) mutable {
+            state->audio( pts, libvlc_clock() );
+            cb( samples, count, pts );
+        };
+    }
+
+    ///
+    /// \brief tapDisplay Returns a display callback which records when each
+    ///                   picture is due, before forwarding it to the
+    ///                   provided one, which can be nullptr.
+    ///
+    template <typename DisplayCb>
+    std::function<void(void*)> tapDisplay( DisplayCb&& display )
+    {
+        static_assert(signature_match_or_nullptr<DisplayCb, void(void*)>::value, "Mismatched display callback signature");
+        auto state = m_state;
+        typename std::decay<DisplayCb>::type cb( std::forward<DisplayCb>( display ) );
+        return [state, cb]( void* picture ) mutable {
+            state->video( libvlc_clock() );
+            detail::avsync::call( cb, picture );
+        };
+    }
+
+    ///
+    /// \brief setAudioLatency Sets the time between a play callback and the
+    ///                        moment its first sample is heard
+    ///
+    /// This includes what the application buffers, and the latency of the
+    /// audio device. It can be updated at any time, from any thread, for
+    /// instance from the fill level of an AudioRing.
+    ///
+    void setAudioLatency( std::chrono::microseconds latency )
+    {
+        m_state->setAudioLatency( latency.count() );
+    }
+
+    ///
+    /// \brief setVideoLatency Sets the time between the presentation of a
+    ///                        picture and the moment it is visible, such as
+    ///                        the compositor & display latency.
+    ///
+    void setVideoLatency( std::chrono::microseconds latency )
+    {
+        m_state->setVideoLatency( latency.count() );
+    }
+
+    ///
+    /// \brief update Samples the offset & the media time, and corrects the
+    ///               offset if the configuration enables it
+    ///
+    /// Call this periodically, for instance 10 times per second, from a
+    /// thread which may call libvlc: never from the player callbacks.
+    ///
+    void update( MediaPlayer& mp )
+    {
+        auto delay = mp.audioDelay();
+        auto time = mp.time();
+        auto target = m_state->update( libvlc_clock(), time >= 0 ? time * 1000 : -1, delay );
+        if ( target != delay && mp.setAudioDelay( target ) == false )
+            m_state->rejected( delay );
+    }
+
+    ///
+    /// \brief update Samples the offset, for callers which don't use a
+    ///               MediaPlayer, or which provide their own dates
+    /// \param date The current libvlc_clock() date
+    /// \param mediaTime The media time, in microseconds, or -1 if unknown
+    /// \param audioDelay The current audio delay, in microseconds
+    /// \return The audio delay to apply, which the caller is responsible for
+    ///
+    int64_t update( int64_t date, int64_t mediaTime, int64_t audioDelay )
+    {
+        return m_state->update( date, mediaTime, audioDelay );
+    }
+
+    ///
+    /// \brief stats Returns the measurements, as of the last update()
+    ///
+    /// This can be called from any thread.
+    ///
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setAudioCallbacks and
+    /// MediaPlayer::setVideoCallbacks prototypes, for callers which need to
+    /// wrap them. flush() should be called from the audio flush callback.
+    ///
+    void play( const void*, unsigned int, int64_t pts )
+    {
+        m_state->audio( pts, libvlc_clock() );
+    }
+
+    void display( void* )
+    {
+        m_state->video( libvlc_clock() );
+    }
+
+    void flush( int64_t )
+    {
+        m_state->flush();
+    }
+
+    ///
+    /// \brief presented Reports that the last displayed picture became
+    ///                  visible, for applications which present the
+    ///                  pictures after the display callback, from a render
+    ///                  thread.
+    ///
+    void presented()
+    {
+        m_state->presented( libvlc_clock() );
+    }
+
+    ///
+    /// The same, with dates provided by the caller, on the libvlc_clock()
+    /// time base.
+    ///
+    void recordAudio( int64_t pts, int64_t date )
+    {
+        m_state->audio( pts, date );
+    }
+
+    void recordDisplay( int64_t date )
+    {
+        m_state->video( date );
+    }
+
+    void recordPresentation( int64_t date )
+    {
+        m_state->presented( date );
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_AVSYNCMONITOR_H
@@ -0,0 +1,684 @@
+/*****************************************************************************
+ * BlockCache.hpp: Block cache shared by the Media sources
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_BLOCKCACHE_H
+#define LIBVLC_CXX_BLOCKCACHE_H
+
+#include "MediaSource.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The BlockCache class holds fixed size blocks of media sources,
+///        keyed by a source id and a block index, and evicts the least
+///        recently used ones once its memory budget is exceeded.
+///
+/// The blocks are spread over shards, each with its own lock, LRU list and
+/// share of the budget, so that concurrent players mostly take different
+/// locks. A block is handed out as a reference counted buffer, which remains
+/// valid after its eviction, so the copies happen outside of the locks.
+///
+/// The cache is meant to be shared by the sources of a process, through
+/// CachedSource: a thumbnailer, a preview and the main player of the same
+/// file then only read each block once. This holds for concurrent readers as
+/// well: while a block is being loaded, the other readers of this block wait
+/// for it rather than loading it again. See load().
+///
+class BlockCache
+{
+public:
+    using Block = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Configuration
+    {
+        Configuration()
+            : blockSize( 64 * 1024 )
+            , budget( 64 * 1024 * 1024 )
+            , nbShards( 16 )
+        {
+        }
+
+        /// The size of the blocks read from the sources
+        size_t blockSize;
+        /// The memory the cached blocks may use, evenly split between the
+        /// shards. Each shard must be able to hold a block.
+        size_t budget;
+        size_t nbShards;
+    };
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t insertions;
+        uint64_t evictions;
+        /// The reads which waited for another reader to load their block
+        uint64_t coalesced;
+        /// The size of the cached blocks, and their number
+        uint64_t memory;
+        uint64_t blocks;
+    };
+
+private:
+    struct Key
+    {
+        uint64_t source;
+        uint64_t block;
+
+        bool operator==( const Key& k ) const
+        {
+            return source == k.source && block == k.block;
+        }
+    };
+
+    struct Hash
+    {
+        size_t operator()( const Key& k ) const
+        {
+            // Consecutive blocks of a source must land on different shards
+            auto h = ( k.source * 0x9e3779b97f4a7c15ull ) ^ k.block;
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return static_cast<size_t>( h );
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        Block block;
+    };
+
+    // A block being loaded, shared by the loading reader and the waiting ones
+    struct Loading
+    {
+        Loading() : done( false ), detached( false ) {}
+
+        bool done;
+        // The loaded block, or nullptr if the load failed
+        Block block;
+        // Set when the source was invalidated meanwhile: the block is still
+        // given to the waiting readers, but not cached
+        bool detached;
+    };
+
+    struct Shard
+    {
+        Shard()
+            : memory( 0 ), hits( 0 ), misses( 0 ), insertions( 0 ), evictions( 0 )
+            , coalesced( 0 )
+        {
+        }
+
+        std::mutex lock;
+        // The most recently used blocks first
+        std::list<Entry> lru;
+        std::unordered_map<Key, std::list<Entry>::iterator, Hash> index;
+        std::unordered_map<Key, std::shared_ptr<Loading>, Hash> loading;
+        // Signaled when a load of this shard completes
+        std::condition_variable loaded;
+        uint64_t memory;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t insertions;
+        uint64_t evictions;
+        uint64_t coalesced;
+    };
+
+public:
+    ///
+    /// \brief BlockCache Creates an empty cache
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit BlockCache( Configuration config = Configuration() )
+        : m_config( std::move( config ) )
+        , m_nextId( 1 )
+    {
+        if ( m_config.blockSize == 0 || m_config.nbShards == 0 )
+            throw std::invalid_argument( "The block size & the number of shards can't be 0" );
+        if ( m_config.budget / m_config.nbShards < m_config.blockSize )
+            throw std::invalid_argument( "Each shard must be able to hold a block" );
+        m_shardBudget = m_config.budget / m_config.nbShards;
+        m_shards.reset( new Shard[m_config.nbShards] );
+    }
+
+    BlockCache( const BlockCache& ) = delete;
+    BlockCache& operator=( const BlockCache& ) = delete;
+
+    ///
+    /// \brief global Returns the cache shared by the whole process, with the
+    ///               default configuration
+    ///
+    static std::shared_ptr<BlockCache> global()
+    {
+        static std::shared_ptr<BlockCache> cache = std::make_shared<BlockCache>();
+        return cache;
+    }
+
+    size_t blockSize() const
+    {
+        return m_config.blockSize;
+    }
+
+    ///
+    /// \brief sourceId Returns the id of the source identified by key, such
+    ///                 as a path or an URL. Sources with the same key share
+    ///                 their blocks, so they must serve the same bytes.
+    ///
+    /// The keys are remembered for the lifetime of the cache.
+    ///
+    uint64_t sourceId( const std::string& key )
+    {
+        std::lock_guard<std::mutex> lock( m_keysLock );
+        auto it = m_keys.find( key );
+        if ( it != end( m_keys ) )
+            return it->second;
+        auto id = m_nextId.fetch_add( 1, std::memory_order_relaxed );
+        m_keys.emplace( key, id );
+        return id;
+    }
+
+    ///
+    /// \brief sourceId Returns a new id, which no other source shares
+    ///
+    uint64_t sourceId()
+    {
+        return m_nextId.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    ///
+    /// \brief find Returns the requested block, or nullptr if it isn't cached
+    ///
+    Block find( uint64_t source, uint64_t block )
+    {
+        Key key{ source, block };
+        auto& shard = shardOf( key );
+        std::lock_guard<std::mutex> lock( shard.lock );
+        auto it = shard.index.find( key );
+        if ( it == end( shard.index ) )
+        {
+            ++shard.misses;
+            return nullptr;
+        }
+        ++shard.hits;
+        shard.lru.splice( begin( shard.lru ), shard.lru, it->second );
+        return it->second->block;
+    }
+
+    ///
+    /// \brief insert Caches a block, and evicts the least recently used ones
+    ///               of its shard if needed
+    ///
+    /// \return The cached block, which is the one another thread inserted
+    ///         first, if any
+    ///
+    Block insert( uint64_t source, uint64_t block, std::vector<uint8_t> data )
+    {
+        Key key{ source, block };
+        auto& shard = shardOf( key );
+        Block b = std::make_shared<const std::vector<uint8_t>>( std::move( data ) );
+        std::lock_guard<std::mutex> lock( shard.lock );
+        return insertLocked( shard, key, std::move( b ) );
+    }
+
+    ///
+    /// \brief load Returns the requested block, loading it if it isn't cached
+    ///
+    /// Only one reader loads a given block at a time: the ones requesting it
+    /// meanwhile wait for this load to complete, and share its result. If it
+    /// fails, one of them tries again.
+    ///
+    /// \param loader Called without any lock held as `bool loader( std::vector<uint8_t>& data )`
+    ///               to fill the block. It returns false upon failure. An
+    ///               empty block, read at the end of the source, is returned
+    ///               but not cached. Exceptions are forwarded to the caller.
+    /// \return The block, or nullptr if the loader failed
+    ///
+    template <typename Loader>
+    Block load( uint64_t source, uint64_t block, Loader&& loader )
+    {
+        Key key{ source, block };
+        auto& shard = shardOf( key );
+        std::unique_lock<std::mutex> lock( shard.lock );
+        std::shared_ptr<Loading> pending;
+        while ( true )
+        {
+            auto it = shard.index.find( key );
+            if ( it != end( shard.index ) )
+            {
+                shard.lru.splice( begin( shard.lru ), shard.lru, it->second );
+                return it->second->block;
+            }
+            auto l = shard.loading.find( key );
+            if ( l == end( shard.loading ) )
+                break;
+            auto other = l->second;
+            ++shard.coalesced;
+            shard.loaded.wait( lock, [&other]() { return other->done; } );
+            if ( other->block != nullptr )
+                return other->block;
+        }
+        pending = std::make_shared<Loading>();
+        shard.loading.emplace( key, pending );
+        lock.unlock();
+
+        Block b;
+        try
+        {
+            std::vector<uint8_t> data;
+            if ( loader( data ) == true )
+                b = std::make_shared<const std::vector<uint8_t>>( std::move( data ) );
+        }
+        catch ( ... )
+        {
+            lock.lock();
+            completeLoad( shard, key, *pending, nullptr );
+            throw;
+        }
+        lock.lock();
+        return completeLoad( shard, key, *pending, std::move( b ) );
+    }
+
+    ///
+    /// \brief invalidate Drops the blocks of a source, for instance when its
+    ///                   content changed
+    ///
+    void invalidate( uint64_t source )
+    {
+        for ( auto i = 0u; i < m_config.nbShards; ++i )
+        {
+            auto& shard = m_shards[i];
+            std::lock_guard<std::mutex> lock( shard.lock );
+            for ( auto it = begin( shard.loading ); it != end( shard.loading ); )
+            {
+                if ( it->first.source != source )
+                {
+                    ++it;
+                    continue;
+                }
+                it->second->detached = true;
+                it = shard.loading.erase( it );
+            }
+            for ( auto it = begin( shard.lru ); it != end( shard.lru ); )
+            {
+                if ( it->key.source != source )
+                {
+                    ++it;
+                    continue;
+                }
+                shard.memory -= it->block->size();
+                shard.index.erase( it->key );
+                it = shard.lru.erase( it );
+            }
+        }
+    }
+
+    ///
+    /// \brief clear Drops all the blocks
+    ///
+    void clear()
+    {
+        for ( auto i = 0u; i < m_config.nbShards; ++i )
+        {
+            auto& shard = m_shards[i];
+            std::lock_guard<std::mutex> lock( shard.lock );
+            for ( auto& l : shard.loading )
+                l.second->detached = true;
+            shard.loading.clear();
+            shard.index.clear();
+            shard.lru.clear();
+            shard.memory = 0;
+        }
+    }
+
+    Stats stats() const
+    {
+        Stats s{};
+        for ( auto i = 0u; i < m_config.nbShards; ++i )
+        {
+            auto& shard = m_shards[i];
+            std::lock_guard<std::mutex> lock( shard.lock );
+            s.hits += shard.hits;
+            s.misses += shard.misses;
+            s.insertions += shard.insertions;
+            s.evictions += shard.evictions;
+            s.coalesced += shard.coalesced;
+            s.memory += shard.memory;
+            s.blocks += shard.lru.size();
+        }
+        return s;
+    }
+
+private:
+    Shard& shardOf( const Key& key ) const
+    {
+        return m_shards[Hash()( key ) % m_config.nbShards];
+    }
+
+    // Called with the shard's lock held
+    Block insertLocked( Shard& shard, const Key& key, Block b )
+    {
+        auto it = shard.index.find( key );
+        if ( it != end( shard.index ) )
+        {
+            shard.lru.splice( begin( shard.lru ), shard.lru, it->second );
+            return it->second->block;
+        }
+        shard.lru.push_front( Entry{ key, b } );
+        shard.index.emplace( key, begin( shard.lru ) );
+        shard.memory += b->size();
+        ++shard.insertions;
+        while ( shard.memory > m_shardBudget && shard.lru.size() > 1 )
+        {
+            auto& victim = shard.lru.back();
+            shard.memory -= victim.block->size();
+            shard.index.erase( victim.key );
+            shard.lru.pop_back();
+            ++shard.evictions;
+        }
+        return b;
+    }
+
+    // Called with the shard's lock held, by the reader which loaded the block
+    Block completeLoad( Shard& shard, const Key& key, Loading& loading, Block b )
+    {
+        if ( loading.detached == false )
+        {
+            shard.loading.erase( key );
+            if ( b != nullptr && b->empty() == false )
+                b = insertLocked( shard, key, std::move( b ) );
+        }
+        loading.block = b;
+        loading.done = true;
+        shard.loaded.notify_all();
+        return b;
+    }
+
+private:
+    const Configuration m_config;
+    size_t m_shardBudget;
+    std::unique_ptr<Shard[]> m_shards;
+    std::mutex m_keysLock;
+    std::unordered_map<std::string, uint64_t> m_keys;
+    std::atomic<uint64_t> m_nextId;
+};
+
+///
+/// \brief The CachedSource class serves another source through a BlockCache,
+///        for use with mediaFromSource().
+///
+/// Reads are served from the cached blocks, and a missing block is read from
+/// the wrapped stream, with a single seek and read of the whole block, before
+/// being cached. Streams missing the same block at the same time only read
+/// it once, see BlockCache::load(). Seeks are only recorded, and don't reach the wrapped stream
+/// until a block is missing, so seeking within cached data costs nothing.
+///
+/// The copies of a CachedSource share its id & statistics. Sources created
+/// with the same key share the blocks of the cache.
+///
+/// \code
+/// auto media = VLC::mediaFromSource( instance,
+///         VLC::CachedSource<VLC::MmapSource>( VLC::MmapSource( path ), path ) );
+/// \endcode
+///
+template <typename Source>
+class CachedSource
+{
+public:
+    struct Stats
+    {
+        /// The block lookups of this source's streams
+        uint64_t hits;
+        uint64_t misses;
+        /// The bytes read from the wrapped streams
+        uint64_t loaded;
+    };
+
+private:
+    struct Counters
+    {
+        Counters()
+            : hits( 0 ), misses( 0 ), loaded( 0 )
+        {
+        }
+
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> loaded;
+    };
+
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.fetch_add( v, std::memory_order_relaxed );
+    }
+
+public:
+    class Stream
+    {
+    public:
+        Stream( std::unique_ptr<typename Source::Stream> inner, std::shared_ptr<BlockCache> cache,
+                uint64_t id, std::shared_ptr<Counters> counters )
+            : m_inner( std::move( inner ) )
+            , m_cache( std::move( cache ) )
+            , m_id( id )
+            , m_counters( std::move( counters ) )
+            , m_size( m_inner->size() )
+            , m_blockSize( m_cache->blockSize() )
+            , m_position( 0 )
+            , m_innerPosition( 0 )
+        {
+        }
+
+        Stream( const Stream& ) = delete;
+        Stream& operator=( const Stream& ) = delete;
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            size_t done = 0;
+            while ( done < len )
+            {
+                if ( m_size != 0 && m_position >= m_size )
+                    break;
+                auto index = m_position / m_blockSize;
+                auto offset = static_cast<size_t>( m_position % m_blockSize );
+                auto block = m_cache->find( m_id, index );
+                if ( block != nullptr )
+                    add( m_counters->hits, 1 );
+                else
+                {
+                    add( m_counters->misses, 1 );
+                    block = load( index );
+                    if ( block == nullptr )
+                        return done > 0 ? static_cast<ptrdiff_t>( done ) : -1;
+                }
+                if ( offset >= block->size() )
+                    break;
+                auto n = block->size() - offset;
+                if ( len - done < n )
+                    n = len - done;
+                memcpy( buf + done, block->data() + offset, n );
+                done += n;
+                m_position += n;
+                // A short block is the last one
+                if ( block->size() < m_blockSize )
+                    break;
+            }
+            return static_cast<ptrdiff_t>( done );
+        }
+
+        int seek( uint64_t offset )
+        {
+            if ( m_size != 0 && offset > m_size )
+                return -1;
+            m_position = offset;
+            return 0;
+        }
+
+        uint64_t size() const
+        {
+            return m_size;
+        }
+
+        uint64_t position() const
+        {
+            return m_position;
+        }
+
+    private:
+        BlockCache::Block load( uint64_t index )
+        {
+            return m_cache->load( m_id, index, [this, index]( std::vector<uint8_t>& data ) {
+                return readBlock( index, data );
+            } );
+        }
+
+        bool readBlock( uint64_t index, std::vector<uint8_t>& data )
+        {
+            auto start = index * m_blockSize;
+            if ( m_innerPosition != start )
+            {
+                if ( m_inner->seek( start ) != 0 )
+                {
+                    m_innerPosition = UINT64_MAX;
+                    return false;
+                }
+                m_innerPosition = start;
+            }
+            data.resize( m_blockSize );
+            size_t filled = 0;
+            while ( filled < m_blockSize )
+            {
+                auto n = m_inner->read( data.data() + filled, m_blockSize - filled );
+                if ( n < 0 )
+                {
+                    m_innerPosition = UINT64_MAX;
+                    return false;
+                }
+                if ( n == 0 )
+                    break;
+                filled += static_cast<size_t>( n );
+            }
+            m_innerPosition = start + filled;
+            add( m_counters->loaded, filled );
+            // The end of the stream is returned empty, and isn't cached
+            data.resize( filled );
+            return true;
+        }
+
+    private:
+        const std::unique_ptr<typename Source::Stream> m_inner;
+        const std::shared_ptr<BlockCache> m_cache;
+        const uint64_t m_id;
+        const std::shared_ptr<Counters> m_counters;
+        const uint64_t m_size;
+        const size_t m_blockSize;
+        uint64_t m_position;
+        // The position of the wrapped stream, or UINT64_MAX after a failure
+        uint64_t m_innerPosition;
+    };
+
+    ///
+    /// \brief CachedSource Wraps a source, whose blocks are shared with the
+    ///                     other sources created with the same key
+    /// \throws std::invalid_argument if the cache is null
+    ///
+    CachedSource( Source source, const std::string& key,
+                  std::shared_ptr<BlockCache> cache = BlockCache::global() )
+        : m_source( std::move( source ) )
+        , m_cache( std::move( cache ) )
+        , m_counters( std::make_shared<Counters>() )
+    {
+        if ( m_cache == nullptr )
+            throw std::invalid_argument( "The cache can't be null" );
+        m_id = m_cache->sourceId( key );
+    }
+
+    ///
+    /// \brief CachedSource Wraps a source, whose blocks are only shared with
+    ///                     the copies of this CachedSource
+    /// \throws std::invalid_argument if the cache is null
+    ///
+    explicit CachedSource( Source source, std::shared_ptr<BlockCache> cache = BlockCache::global() )
+        : m_source( std::move( source ) )
+        , m_cache( std::move( cache ) )
+        , m_counters( std::make_shared<Counters>() )
+    {
+        if ( m_cache == nullptr )
+            throw std::invalid_argument( "The cache can't be null" );
+        m_id = m_cache->sourceId();
+    }
+
+    std::unique_ptr<Stream> open() const
+    {
+        auto inner = m_source.open();
+        if ( inner == nullptr )
+            return nullptr;
+        return std::unique_ptr<Stream>( new Stream( std::move( inner ), m_cache, m_id, m_counters ) );
+    }
+
+    uint64_t id() const
+    {
+        return m_id;
+    }
+
+    const std::shared_ptr<BlockCache>& cache() const
+    {
+        return m_cache;
+    }
+
+    ///
+    /// \brief stats Returns the statistics of all the streams of this source,
+    ///              and of its copies
+    ///
+    Stats stats() const
+    {
+        Stats s;
+        s.hits = m_counters->hits.load( std::memory_order_relaxed );
+        s.misses = m_counters->misses.load( std::memory_order_relaxed );
+        s.loaded = m_counters->loaded.load( std::memory_order_relaxed );
+        return s;
+    }
+
+private:
+    Source m_source;
+    std::shared_ptr<BlockCache> m_cache;
+    uint64_t m_id;
+    std::shared_ptr<Counters> m_counters;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_BLOCKCACHE_H
@@ -0,0 +1,1362 @@
+/*****************************************************************************
+ * ChromaConverter.hpp: SIMD YUV <-> RGB conversion for video callbacks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_CHROMACONVERTER_H
+#define LIBVLC_CXX_CHROMACONVERTER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+# define LIBVLCPP_CHROMA_X86 1
+# define LIBVLCPP_TARGET_SSE2 __attribute__((target("sse2")))
+# define LIBVLCPP_TARGET_AVX2 __attribute__((target("avx2")))
+# include <immintrin.h>
+#elif defined(_MSC_VER) && ( defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+# define LIBVLCPP_CHROMA_X86 1
+# define LIBVLCPP_TARGET_SSE2
+# define LIBVLCPP_TARGET_AVX2
+# include <immintrin.h>
+# include <intrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define LIBVLCPP_CHROMA_NEON 1
+# include <arm_neon.h>
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+namespace chroma
+{
+
+///
+/// Fixed point coefficients. Every kernel evaluates the exact same integer
+/// expressions, so all of them produce the same output, bit for bit.
+///
+/// YUV -> RGB: channel = clamp( ( (Y - yOff) * yMul + (C - cOff) * k + round ) >> shift )
+///
+struct YuvToRgbCoefs
+{
+    int16_t yOff;
+    int16_t cOff;
+    int16_t yMul;
+    int16_t vr;
+    int16_t ug;
+    int16_t vg;
+    int16_t ub;
+    int shift;
+    int32_t round;
+};
+
+///
+/// RGB -> YUV: Y = clamp( ( ( R * yr + G * yg + B * yb + yRound ) >> yShift ) + yOff )
+/// The chroma is computed from the sum of each 2x2 block of pixels.
+///
+struct RgbToYuvCoefs
+{
+    int16_t yr, yg, yb;
+    int16_t ur, ug, ub;
+    int16_t vr, vg, vb;
+    int yShift;
+    int cShift;
+    int16_t yRound;
+    int16_t cRound;
+    int16_t yOff;
+    int16_t cOff;
+    int16_t maxValue;
+};
+
+using YuvToRgbRow = void (*)( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                              uint8_t* dst, unsigned width, const YuvToRgbCoefs& c );
+using RgbToYuvRows = void (*)( const uint8_t* rgb0, const uint8_t* rgb1, uint8_t* y0,
+                               uint8_t* y1, uint8_t* u, uint8_t* v, unsigned width,
+                               const RgbToYuvCoefs& c );
+
+inline int clamp( int v, int max )
+{
+    return v < 0 ? 0 : ( v > max ? max : v );
+}
+
+inline unsigned load16( const uint8_t* p )
+{
+    uint16_t v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+inline void store16( uint8_t* p, unsigned v )
+{
+    auto s = static_cast<uint16_t>( v );
+    memcpy( p, &s, sizeof( s ) );
+}
+
+// Formats descriptions, used by the scalar code, and as tags by the SIMD code
+
+/// Planar 4:2:0, 8 bits
+struct I420
+{
+    static constexpr unsigned Depth = 8;
+    static void load( const uint8_t* y, const uint8_t* u, const uint8_t* v, unsigned x,
+                      int& Y, int& U, int& V )
+    {
+        Y = y[x];
+        U = u[x / 2];
+        V = v[x / 2];
+    }
+    static void storeY( uint8_t* y, unsigned x, int Y )
+    {
+        y[x] = static_cast<uint8_t>( Y );
+    }
+    static void storeC( uint8_t* u, uint8_t* v, unsigned cx, int U, int V )
+    {
+        u[cx] = static_cast<uint8_t>( U );
+        v[cx] = static_cast<uint8_t>( V );
+    }
+};
+
+/// Semi planar 4:2:0, 8 bits, interleaved U & V
+struct NV12
+{
+    static constexpr unsigned Depth = 8;
+    static void load( const uint8_t* y, const uint8_t* uv, const uint8_t*, unsigned x,
+                      int& Y, int& U, int& V )
+    {
+        Y = y[x];
+        U = uv[x & ~1u];
+        V = uv[( x & ~1u ) + 1];
+    }
+    static void storeY( uint8_t* y, unsigned x, int Y )
+    {
+        y[x] = static_cast<uint8_t>( Y );
+    }
+    static void storeC( uint8_t* uv, uint8_t*, unsigned cx, int U, int V )
+    {
+        uv[cx * 2] = static_cast<uint8_t>( U );
+        uv[cx * 2 + 1] = static_cast<uint8_t>( V );
+    }
+};
+
+/// Semi planar 4:2:0, 10 bits stored in the high bits of 16 bits words
+struct P010
+{
+    static constexpr unsigned Depth = 10;
+    static void load( const uint8_t* y, const uint8_t* uv, const uint8_t*, unsigned x,
+                      int& Y, int& U, int& V )
+    {
+        Y = static_cast<int>( load16( y + x * 2 ) >> 6 );
+        U = static_cast<int>( load16( uv + ( x & ~1u ) * 2 ) >> 6 );
+        V = static_cast<int>( load16( uv + ( x & ~1u ) * 2 + 2 ) >> 6 );
+    }
+    static void storeY( uint8_t* y, unsigned x, int Y )
+    {
+        store16( y + x * 2, static_cast<unsigned>( Y ) << 6 );
+    }
+    static void storeC( uint8_t* uv, uint8_t*, unsigned cx, int U, int V )
+    {
+        store16( uv + cx * 4, static_cast<unsigned>( U ) << 6 );
+        store16( uv + cx * 4 + 2, static_cast<unsigned>( V ) << 6 );
+    }
+};
+
+/// Packed RGB, described by the offset of each component in a pixel
+template <unsigned ROff, unsigned GOff, unsigned BOff, unsigned PixelSize>
+struct PackedRgb
+{
+    static constexpr unsigned R = ROff;
+    static constexpr unsigned G = GOff;
+    static constexpr unsigned B = BOff;
+    static constexpr unsigned Bpp = PixelSize;
+    static void load( const uint8_t* p, unsigned x, int& r, int& g, int& b )
+    {
+        p += x * Bpp;
+        r = p[R];
+        g = p[G];
+        b = p[B];
+    }
+    static void store( uint8_t* p, unsigned x, int r, int g, int b )
+    {
+        p += x * Bpp;
+        p[R] = static_cast<uint8_t>( r );
+        p[G] = static_cast<uint8_t>( g );
+        p[B] = static_cast<uint8_t>( b );
+        if ( Bpp == 4 )
+            p[3] = 0xff;
+    }
+};
+
+using RGBA = PackedRgb<0, 1, 2, 4>;
+using BGRA = PackedRgb<2, 1, 0, 4>;
+using RGB24 = PackedRgb<0, 1, 2, 3>;
+
+struct Scalar
+{
+    template <typename In, typename Out>
+    static void yuvToRgbTail( const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+                              unsigned start, unsigned width, const YuvToRgbCoefs& c )
+    {
+        for ( auto x = start; x < width; ++x )
+        {
+            int Y, U, V;
+            In::load( y, u, v, x, Y, U, V );
+            Y -= c.yOff;
+            U -= c.cOff;
+            V -= c.cOff;
+            auto ys = Y * c.yMul + c.round;
+            auto r = ( ys + V * c.vr ) >> c.shift;
+            auto g = ( ys - U * c.ug - V * c.vg ) >> c.shift;
+            auto b = ( ys + U * c.ub ) >> c.shift;
+            Out::store( dst, x, clamp( r, 255 ), clamp( g, 255 ), clamp( b, 255 ) );
+        }
+    }
+
+    template <typename In, typename Out>
+    static void yuvToRgb( const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+                          unsigned width, const YuvToRgbCoefs& c )
+    {
+        yuvToRgbTail<In, Out>( y, u, v, dst, 0, width, c );
+    }
+
+    template <typename In, typename Out>
+    static void rgbToYuvTail( const uint8_t* rgb0, const uint8_t* rgb1, uint8_t* y0, uint8_t* y1,
+                              uint8_t* u, uint8_t* v, unsigned start, unsigned width,
+                              const RgbToYuvCoefs& c )
+    {
+        for ( auto x = start; x < width; x += 2 )
+        {
+            // Odd widths: the last column is used twice for the chroma
+            auto x1 = x + 1 < width ? x + 1 : x;
+            int r[4], g[4], b[4];
+            In::load( rgb0, x, r[0], g[0], b[0] );
+            In::load( rgb0, x1, r[1], g[1], b[1] );
+            In::load( rgb1, x, r[2], g[2], b[2] );
+            In::load( rgb1, x1, r[3], g[3], b[3] );
+            for ( auto i = 0u; i < 4; ++i )
+            {
+                auto dst = i < 2 ? y0 : y1;
+                auto dx = i % 2 == 0 ? x : x1;
+                if ( dst == nullptr || ( i % 2 == 1 && x1 == x ) )
+                    continue;
+                auto Y = ( ( r[i] * c.yr + g[i] * c.yg + b[i] * c.yb + c.yRound ) >> c.yShift ) + c.yOff;
+                Out::storeY( dst, dx, clamp( Y, c.maxValue ) );
+            }
+            auto rs = r[0] + r[1] + r[2] + r[3];
+            auto gs = g[0] + g[1] + g[2] + g[3];
+            auto bs = b[0] + b[1] + b[2] + b[3];
+            auto U = ( ( rs * c.ur + gs * c.ug + bs * c.ub + c.cRound ) >> c.cShift ) + c.cOff;
+            auto V = ( ( rs * c.vr + gs * c.vg + bs * c.vb + c.cRound ) >> c.cShift ) + c.cOff;
+            Out::storeC( u, v, x / 2, clamp( U, c.maxValue ), clamp( V, c.maxValue ) );
+        }
+    }
+
+    template <typename In, typename Out>
+    static void rgbToYuv( const uint8_t* rgb0, const uint8_t* rgb1, uint8_t* y0, uint8_t* y1,
+                          uint8_t* u, uint8_t* v, unsigned width, const RgbToYuvCoefs& c )
+    {
+        rgbToYuvTail<In, Out>( rgb0, rgb1, y0, y1, u, v, 0, width, c );
+    }
+};
+
+#if defined(LIBVLCPP_CHROMA_X86)
+
+///
+/// SSE2 kernels: 8 pixels per iteration.
+/// _mm_madd_epi16 multiplies pairs of 16 bits values and sums each pair
+/// into 32 bits, which matches the scalar expressions exactly.
+///
+struct Sse2
+{
+    // Two 16 bits coefficients, applied to the low and high values of a pair
+    LIBVLCPP_TARGET_SSE2 static __m128i pair( int a, int b )
+    {
+        return _mm_set1_epi32( static_cast<int32_t>( static_cast<uint16_t>( a ) |
+                                                     ( static_cast<uint32_t>( static_cast<uint16_t>( b ) ) << 16 ) ) );
+    }
+
+    // ( a * ka + b * kb + c * kc + round ) >> shift, for 8 lanes, saturated to 16 bits.
+    // The rounding is folded in the last pair, with c being 1.
+    LIBVLCPP_TARGET_SSE2 static __m128i dot( __m128i a, __m128i b, __m128i kab,
+                                             __m128i c, __m128i kc1, __m128i shift )
+    {
+        auto one = _mm_set1_epi16( 1 );
+        auto lo = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), kab ),
+                                 _mm_madd_epi16( _mm_unpacklo_epi16( c, one ), kc1 ) );
+        auto hi = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( a, b ), kab ),
+                                 _mm_madd_epi16( _mm_unpackhi_epi16( c, one ), kc1 ) );
+        return _mm_packs_epi32( _mm_sra_epi32( lo, shift ), _mm_sra_epi32( hi, shift ) );
+    }
+
+    // Duplicates the low 16 bits of each 32 bits lane: ( u, x ) -> ( u, u )
+    LIBVLCPP_TARGET_SSE2 static void splitChroma( __m128i uv, __m128i& u, __m128i& v )
+    {
+        auto mask = _mm_set1_epi32( 0xffff );
+        u = _mm_and_si128( uv, mask );
+        u = _mm_or_si128( u, _mm_slli_epi32( u, 16 ) );
+        v = _mm_srli_epi32( uv, 16 );
+        v = _mm_or_si128( v, _mm_slli_epi32( v, 16 ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void loadYuv( I420, const uint8_t* y, const uint8_t* u,
+                                              const uint8_t* v, unsigned x,
+                                              __m128i& Y, __m128i& U, __m128i& V )
+    {
+        auto zero = _mm_setzero_si128();
+        Y = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( y + x ) ), zero );
+        int32_t u4, v4;
+        memcpy( &u4, u + x / 2, 4 );
+        memcpy( &v4, v + x / 2, 4 );
+        U = _mm_unpacklo_epi8( _mm_cvtsi32_si128( u4 ), zero );
+        U = _mm_unpacklo_epi16( U, U );
+        V = _mm_unpacklo_epi8( _mm_cvtsi32_si128( v4 ), zero );
+        V = _mm_unpacklo_epi16( V, V );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void loadYuv( NV12, const uint8_t* y, const uint8_t* uv,
+                                              const uint8_t*, unsigned x,
+                                              __m128i& Y, __m128i& U, __m128i& V )
+    {
+        auto zero = _mm_setzero_si128();
+        Y = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( y + x ) ), zero );
+        auto c = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( uv + x ) ), zero );
+        splitChroma( c, U, V );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void loadYuv( P010, const uint8_t* y, const uint8_t* uv,
+                                              const uint8_t*, unsigned x,
+                                              __m128i& Y, __m128i& U, __m128i& V )
+    {
+        Y = _mm_srli_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + x * 2 ) ), 6 );
+        auto c = _mm_srli_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( uv + x * 2 ) ), 6 );
+        splitChroma( c, U, V );
+    }
+
+    // Stores 8 pixels from the low 8 bytes of r, g & b
+    template <typename Out>
+    LIBVLCPP_TARGET_SSE2 static void storeRgb( Out, uint8_t* dst, unsigned x,
+                                               __m128i r, __m128i g, __m128i b )
+    {
+        auto alpha = _mm_set1_epi8( -1 );
+        auto c0 = Out::R == 0 ? r : b;
+        auto c2 = Out::R == 0 ? b : r;
+        auto lo = _mm_unpacklo_epi8( c0, g );
+        auto hi = _mm_unpacklo_epi8( c2, alpha );
+        auto p0 = _mm_unpacklo_epi16( lo, hi );
+        auto p1 = _mm_unpackhi_epi16( lo, hi );
+        if ( Out::Bpp == 4 )
+        {
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 4 ), p0 );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * 4 + 16 ), p1 );
+            return;
+        }
+        alignas(16) uint8_t tmp[32];
+        _mm_store_si128( reinterpret_cast<__m128i*>( tmp ), p0 );
+        _mm_store_si128( reinterpret_cast<__m128i*>( tmp + 16 ), p1 );
+        auto p = dst + x * 3;
+        for ( auto i = 0u; i < 8; ++i )
+            memcpy( p + i * 3, tmp + i * 4, 3 );
+    }
+
+    struct YuvToRgbConstants
+    {
+        LIBVLCPP_TARGET_SSE2 explicit YuvToRgbConstants( const YuvToRgbCoefs& c )
+            : yOff( _mm_set1_epi16( c.yOff ) )
+            , cOff( _mm_set1_epi16( c.cOff ) )
+            , yv( pair( c.yMul, c.vr ) )
+            , yu( pair( c.yMul, c.ub ) )
+            , yug( pair( c.yMul, -c.ug ) )
+            , vg( pair( -c.vg, 0 ) )
+            , round( pair( 0, c.round ) )
+            , shift( _mm_cvtsi32_si128( c.shift ) )
+        {
+        }
+        __m128i yOff, cOff, yv, yu, yug, vg, round, shift;
+    };
+
+    // Computes 8 pixels, as 8 bits values in the low half of r, g & b
+    LIBVLCPP_TARGET_SSE2 static void yuvToRgb8( __m128i Y, __m128i U, __m128i V,
+                                                const YuvToRgbConstants& k,
+                                                __m128i& r, __m128i& g, __m128i& b )
+    {
+        Y = _mm_sub_epi16( Y, k.yOff );
+        U = _mm_sub_epi16( U, k.cOff );
+        V = _mm_sub_epi16( V, k.cOff );
+        auto zero = _mm_setzero_si128();
+        auto r16 = dot( Y, V, k.yv, zero, k.round, k.shift );
+        auto g16 = dot( Y, U, k.yug, V, _mm_add_epi32( k.vg, k.round ), k.shift );
+        auto b16 = dot( Y, U, k.yu, zero, k.round, k.shift );
+        r = _mm_packus_epi16( r16, r16 );
+        g = _mm_packus_epi16( g16, g16 );
+        b = _mm_packus_epi16( b16, b16 );
+    }
+
+    template <typename In, typename Out>
+    LIBVLCPP_TARGET_SSE2 static void yuvToRgb( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                               uint8_t* dst, unsigned width, const YuvToRgbCoefs& c )
+    {
+        YuvToRgbConstants k( c );
+        auto x = 0u;
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            __m128i Y, U, V, r, g, b;
+            loadYuv( In{}, y, u, v, x, Y, U, V );
+            yuvToRgb8( Y, U, V, k, r, g, b );
+            storeRgb( Out{}, dst, x, r, g, b );
+        }
+        Scalar::yuvToRgbTail<In, Out>( y, u, v, dst, x, width, c );
+    }
+
+    // Loads 8 pixels as 16 bits components
+    template <typename In>
+    LIBVLCPP_TARGET_SSE2 static void loadRgb( In, const uint8_t* p, unsigned x,
+                                              __m128i& r, __m128i& g, __m128i& b )
+    {
+        __m128i p0, p1;
+        if ( In::Bpp == 4 )
+        {
+            p0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p + x * 4 ) );
+            p1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p + x * 4 + 16 ) );
+        }
+        else
+        {
+            alignas(16) uint8_t tmp[32];
+            for ( auto i = 0u; i < 8; ++i )
+            {
+                memcpy( tmp + i * 4, p + ( x + i ) * 3, 3 );
+                tmp[i * 4 + 3] = 0;
+            }
+            p0 = _mm_load_si128( reinterpret_cast<const __m128i*>( tmp ) );
+            p1 = _mm_load_si128( reinterpret_cast<const __m128i*>( tmp + 16 ) );
+        }
+        r = component( p0, p1, In::R );
+        g = component( p0, p1, In::G );
+        b = component( p0, p1, In::B );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static __m128i component( __m128i p0, __m128i p1, unsigned idx )
+    {
+        auto mask = _mm_set1_epi32( 0xff );
+        auto shift = _mm_cvtsi32_si128( static_cast<int>( idx * 8 ) );
+        return _mm_packs_epi32( _mm_and_si128( _mm_srl_epi32( p0, shift ), mask ),
+                                _mm_and_si128( _mm_srl_epi32( p1, shift ), mask ) );
+    }
+
+    struct RgbToYuvConstants
+    {
+        LIBVLCPP_TARGET_SSE2 explicit RgbToYuvConstants( const RgbToYuvCoefs& c )
+            : yrg( pair( c.yr, c.yg ) )
+            , yb( pair( c.yb, c.yRound ) )
+            , urg( pair( c.ur, c.ug ) )
+            , ub( pair( c.ub, c.cRound ) )
+            , vrg( pair( c.vr, c.vg ) )
+            , vb( pair( c.vb, c.cRound ) )
+            , yShift( _mm_cvtsi32_si128( c.yShift ) )
+            , cShift( _mm_cvtsi32_si128( c.cShift ) )
+            , yOff( _mm_set1_epi16( c.yOff ) )
+            , cOff( _mm_set1_epi16( c.cOff ) )
+            , maxValue( _mm_set1_epi16( c.maxValue ) )
+        {
+        }
+        __m128i yrg, yb, urg, ub, vrg, vb, yShift, cShift, yOff, cOff, maxValue;
+    };
+
+    LIBVLCPP_TARGET_SSE2 static __m128i clamp16( __m128i v, __m128i max )
+    {
+        return _mm_min_epi16( _mm_max_epi16( v, _mm_setzero_si128() ), max );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void storeY( I420, uint8_t* y, unsigned x, __m128i Y, __m128i )
+    {
+        _mm_storel_epi64( reinterpret_cast<__m128i*>( y + x ), _mm_packus_epi16( Y, Y ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void storeY( NV12, uint8_t* y, unsigned x, __m128i Y, __m128i max )
+    {
+        storeY( I420{}, y, x, Y, max );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void storeY( P010, uint8_t* y, unsigned x, __m128i Y, __m128i max )
+    {
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( y + x * 2 ),
+                          _mm_slli_epi16( clamp16( Y, max ), 6 ) );
+    }
+
+    // Stores 4 chroma samples, from the low 4 lanes of U & V
+    LIBVLCPP_TARGET_SSE2 static void storeC( I420, uint8_t* u, uint8_t* v, unsigned cx,
+                                             __m128i U, __m128i V, __m128i )
+    {
+        auto u4 = _mm_cvtsi128_si32( _mm_packus_epi16( U, U ) );
+        auto v4 = _mm_cvtsi128_si32( _mm_packus_epi16( V, V ) );
+        memcpy( u + cx, &u4, 4 );
+        memcpy( v + cx, &v4, 4 );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void storeC( NV12, uint8_t* uv, uint8_t*, unsigned cx,
+                                             __m128i U, __m128i V, __m128i )
+    {
+        auto c = _mm_unpacklo_epi16( U, V );
+        _mm_storel_epi64( reinterpret_cast<__m128i*>( uv + cx * 2 ), _mm_packus_epi16( c, c ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void storeC( P010, uint8_t* uv, uint8_t*, unsigned cx,
+                                             __m128i U, __m128i V, __m128i max )
+    {
+        auto c = _mm_unpacklo_epi16( clamp16( U, max ), clamp16( V, max ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( uv + cx * 4 ), _mm_slli_epi16( c, 6 ) );
+    }
+
+    // Sums each horizontal pair of 16 bits values: 8 lanes -> 4 lanes
+    LIBVLCPP_TARGET_SSE2 static __m128i pairSums( __m128i v )
+    {
+        auto s = _mm_madd_epi16( v, _mm_set1_epi16( 1 ) );
+        return _mm_packs_epi32( s, s );
+    }
+
+    template <typename In, typename Out>
+    LIBVLCPP_TARGET_SSE2 static void rgbToYuv( const uint8_t* rgb0, const uint8_t* rgb1,
+                                               uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v,
+                                               unsigned width, const RgbToYuvCoefs& c )
+    {
+        RgbToYuvConstants k( c );
+        auto x = 0u;
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            __m128i r0, g0, b0, r1, g1, b1;
+            loadRgb( In{}, rgb0, x, r0, g0, b0 );
+            loadRgb( In{}, rgb1, x, r1, g1, b1 );
+            storeY( Out{}, y0, x, _mm_add_epi16( dot( r0, g0, k.yrg, b0, k.yb, k.yShift ), k.yOff ), k.maxValue );
+            if ( y1 != nullptr )
+                storeY( Out{}, y1, x, _mm_add_epi16( dot( r1, g1, k.yrg, b1, k.yb, k.yShift ), k.yOff ), k.maxValue );
+            auto rs = pairSums( _mm_add_epi16( r0, r1 ) );
+            auto gs = pairSums( _mm_add_epi16( g0, g1 ) );
+            auto bs = pairSums( _mm_add_epi16( b0, b1 ) );
+            auto U = _mm_add_epi16( dot( rs, gs, k.urg, bs, k.ub, k.cShift ), k.cOff );
+            auto V = _mm_add_epi16( dot( rs, gs, k.vrg, bs, k.vb, k.cShift ), k.cOff );
+            storeC( Out{}, u, v, x / 2, U, V, k.maxValue );
+        }
+        Scalar::rgbToYuvTail<In, Out>( rgb0, rgb1, y0, y1, u, v, x, width, c );
+    }
+};
+
+///
+/// AVX2 kernels: 16 pixels per iteration for YUV -> RGB. The RGB -> YUV
+/// direction reuses the SSE2 kernels.
+///
+struct Avx2
+{
+    LIBVLCPP_TARGET_AVX2 static __m256i dot( __m256i a, __m256i b, __m256i kab,
+                                             __m256i c, __m256i kc1, __m128i shift )
+    {
+        auto one = _mm256_set1_epi16( 1 );
+        auto lo = _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), kab ),
+                                    _mm256_madd_epi16( _mm256_unpacklo_epi16( c, one ), kc1 ) );
+        auto hi = _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), kab ),
+                                    _mm256_madd_epi16( _mm256_unpackhi_epi16( c, one ), kc1 ) );
+        // unpack & pack both work within 128 bits lanes, so the pixels end
+        // up back in order
+        return _mm256_packs_epi32( _mm256_sra_epi32( lo, shift ), _mm256_sra_epi32( hi, shift ) );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void splitChroma( __m256i uv, __m256i& u, __m256i& v )
+    {
+        auto mask = _mm256_set1_epi32( 0xffff );
+        u = _mm256_and_si256( uv, mask );
+        u = _mm256_or_si256( u, _mm256_slli_epi32( u, 16 ) );
+        v = _mm256_srli_epi32( uv, 16 );
+        v = _mm256_or_si256( v, _mm256_slli_epi32( v, 16 ) );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void loadYuv( I420, const uint8_t* y, const uint8_t* u,
+                                              const uint8_t* v, unsigned x,
+                                              __m256i& Y, __m256i& U, __m256i& V )
+    {
+        Y = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + x ) ) );
+        U = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( u + x / 2 ) ) );
+        U = _mm256_or_si256( U, _mm256_slli_epi32( U, 16 ) );
+        V = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( v + x / 2 ) ) );
+        V = _mm256_or_si256( V, _mm256_slli_epi32( V, 16 ) );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void loadYuv( NV12, const uint8_t* y, const uint8_t* uv,
+                                              const uint8_t*, unsigned x,
+                                              __m256i& Y, __m256i& U, __m256i& V )
+    {
+        Y = _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( y + x ) ) );
+        splitChroma( _mm256_cvtepu8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( uv + x ) ) ), U, V );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static void loadYuv( P010, const uint8_t* y, const uint8_t* uv,
+                                              const uint8_t*, unsigned x,
+                                              __m256i& Y, __m256i& U, __m256i& V )
+    {
+        Y = _mm256_srli_epi16( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( y + x * 2 ) ), 6 );
+        splitChroma( _mm256_srli_epi16( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( uv + x * 2 ) ), 6 ), U, V );
+    }
+
+    LIBVLCPP_TARGET_AVX2 static __m128i packus( __m256i v )
+    {
+        return _mm_packus_epi16( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+    }
+
+    template <typename Out>
+    LIBVLCPP_TARGET_AVX2 static void storeRgb( Out, uint8_t* dst, unsigned x,
+                                               __m128i r, __m128i g, __m128i b )
+    {
+        if ( Out::Bpp == 4 )
+        {
+            Sse2::storeRgb( Out{}, dst, x, r, g, b );
+            Sse2::storeRgb( Out{}, dst, x + 8, _mm_srli_si128( r, 8 ),
+                            _mm_srli_si128( g, 8 ), _mm_srli_si128( b, 8 ) );
+            return;
+        }
+        // Interleave as RGBX, then drop the X bytes
+        auto alpha = _mm_setzero_si128();
+        auto rg0 = _mm_unpacklo_epi8( r, g );
+        auto rg1 = _mm_unpackhi_epi8( r, g );
+        auto bx0 = _mm_unpacklo_epi8( b, alpha );
+        auto bx1 = _mm_unpackhi_epi8( b, alpha );
+        const __m128i px[4] = {
+            _mm_unpacklo_epi16( rg0, bx0 ), _mm_unpackhi_epi16( rg0, bx0 ),
+            _mm_unpacklo_epi16( rg1, bx1 ), _mm_unpackhi_epi16( rg1, bx1 ),
+        };
+        auto shuffle = _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+        auto p = dst + x * 3;
+        for ( auto i = 0u; i < 4; ++i )
+        {
+            auto packed = _mm_shuffle_epi8( px[i], shuffle );
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( p + i * 12 ), packed );
+            auto last = _mm_cvtsi128_si32( _mm_srli_si128( packed, 8 ) );
+            memcpy( p + i * 12 + 8, &last, 4 );
+        }
+    }
+
+    template <typename In, typename Out>
+    LIBVLCPP_TARGET_AVX2 static void yuvToRgb( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                               uint8_t* dst, unsigned width, const YuvToRgbCoefs& c )
+    {
+        auto yOff = _mm256_set1_epi16( c.yOff );
+        auto cOff = _mm256_set1_epi16( c.cOff );
+        auto yv = _mm256_broadcastsi128_si256( Sse2::pair( c.yMul, c.vr ) );
+        auto yu = _mm256_broadcastsi128_si256( Sse2::pair( c.yMul, c.ub ) );
+        auto yug = _mm256_broadcastsi128_si256( Sse2::pair( c.yMul, -c.ug ) );
+        auto round = _mm256_broadcastsi128_si256( Sse2::pair( 0, c.round ) );
+        auto vgRound = _mm256_broadcastsi128_si256( Sse2::pair( -c.vg, c.round ) );
+        auto shift = _mm_cvtsi32_si128( c.shift );
+        auto zero = _mm256_setzero_si256();
+        auto x = 0u;
+        for ( ; x + 16 <= width; x += 16 )
+        {
+            __m256i Y, U, V;
+            loadYuv( In{}, y, u, v, x, Y, U, V );
+            Y = _mm256_sub_epi16( Y, yOff );
+            U = _mm256_sub_epi16( U, cOff );
+            V = _mm256_sub_epi16( V, cOff );
+            auto r = packus( dot( Y, V, yv, zero, round, shift ) );
+            auto g = packus( dot( Y, U, yug, V, vgRound, shift ) );
+            auto b = packus( dot( Y, U, yu, zero, round, shift ) );
+            storeRgb( Out{}, dst, x, r, g, b );
+        }
+        Sse2::YuvToRgbConstants k( c );
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            __m128i Y, U, V, r, g, b;
+            Sse2::loadYuv( In{}, y, u, v, x, Y, U, V );
+            Sse2::yuvToRgb8( Y, U, V, k, r, g, b );
+            Sse2::storeRgb( Out{}, dst, x, r, g, b );
+        }
+        Scalar::yuvToRgbTail<In, Out>( y, u, v, dst, x, width, c );
+    }
+
+    template <typename In, typename Out>
+    static void rgbToYuv( const uint8_t* rgb0, const uint8_t* rgb1, uint8_t* y0, uint8_t* y1,
+                          uint8_t* u, uint8_t* v, unsigned width, const RgbToYuvCoefs& c )
+    {
+        Sse2::rgbToYuv<In, Out>( rgb0, rgb1, y0, y1, u, v, width, c );
+    }
+};
+
+inline bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid( info, 0 );
+    if ( info[0] < 7 )
+        return false;
+    __cpuid( info, 1 );
+    // OSXSAVE & AVX
+    if ( ( info[2] & ( 1 << 27 ) ) == 0 || ( info[2] & ( 1 << 28 ) ) == 0 )
+        return false;
+    // The OS must save the YMM registers
+    if ( ( _xgetbv( 0 ) & 6 ) != 6 )
+        return false;
+    __cpuidex( info, 7, 0 );
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "avx2" ) != 0;
+#endif
+}
+
+#endif // LIBVLCPP_CHROMA_X86
+
+#if defined(LIBVLCPP_CHROMA_NEON)
+
+///
+/// NEON kernels: 16 pixels per iteration for YUV -> RGB, 8 for RGB -> YUV.
+/// Widening multiply-accumulates compute the same 32 bits values as the
+/// scalar code.
+///
+struct Neon
+{
+    static uint8x16_t dupChroma( uint8x8_t c )
+    {
+        auto z = vzip_u8( c, c );
+        return vcombine_u8( z.val[0], z.val[1] );
+    }
+
+    static int16x8_t widen( uint8x8_t v )
+    {
+        return vreinterpretq_s16_u16( vmovl_u8( v ) );
+    }
+
+    // Loads 16 pixels, as two halves of 8
+    static void loadYuv( I420, const uint8_t* y, const uint8_t* u, const uint8_t* v, unsigned x,
+                         int16x8_t Y[2], int16x8_t U[2], int16x8_t V[2] )
+    {
+        auto y8 = vld1q_u8( y + x );
+        auto u8 = dupChroma( vld1_u8( u + x / 2 ) );
+        auto v8 = dupChroma( vld1_u8( v + x / 2 ) );
+        Y[0] = widen( vget_low_u8( y8 ) );
+        Y[1] = widen( vget_high_u8( y8 ) );
+        U[0] = widen( vget_low_u8( u8 ) );
+        U[1] = widen( vget_high_u8( u8 ) );
+        V[0] = widen( vget_low_u8( v8 ) );
+        V[1] = widen( vget_high_u8( v8 ) );
+    }
+
+    static void loadYuv( NV12, const uint8_t* y, const uint8_t* uv, const uint8_t*, unsigned x,
+                         int16x8_t Y[2], int16x8_t U[2], int16x8_t V[2] )
+    {
+        auto y8 = vld1q_u8( y + x );
+        auto c = vld2_u8( uv + x );
+        auto u8 = dupChroma( c.val[0] );
+        auto v8 = dupChroma( c.val[1] );
+        Y[0] = widen( vget_low_u8( y8 ) );
+        Y[1] = widen( vget_high_u8( y8 ) );
+        U[0] = widen( vget_low_u8( u8 ) );
+        U[1] = widen( vget_high_u8( u8 ) );
+        V[0] = widen( vget_low_u8( v8 ) );
+        V[1] = widen( vget_high_u8( v8 ) );
+    }
+
+    static void loadYuv( P010, const uint8_t* y, const uint8_t* uv, const uint8_t*, unsigned x,
+                         int16x8_t Y[2], int16x8_t U[2], int16x8_t V[2] )
+    {
+        auto y16 = reinterpret_cast<const uint16_t*>( y ) + x;
+        Y[0] = vreinterpretq_s16_u16( vshrq_n_u16( vld1q_u16( y16 ), 6 ) );
+        Y[1] = vreinterpretq_s16_u16( vshrq_n_u16( vld1q_u16( y16 + 8 ), 6 ) );
+        auto c = vld2q_u16( reinterpret_cast<const uint16_t*>( uv ) + x );
+        auto u = vshrq_n_u16( c.val[0], 6 );
+        auto v = vshrq_n_u16( c.val[1], 6 );
+        auto uz = vzipq_u16( u, u );
+        auto vz = vzipq_u16( v, v );
+        U[0] = vreinterpretq_s16_u16( uz.val[0] );
+        U[1] = vreinterpretq_s16_u16( uz.val[1] );
+        V[0] = vreinterpretq_s16_u16( vz.val[0] );
+        V[1] = vreinterpretq_s16_u16( vz.val[1] );
+    }
+
+    // ( a * ka + b * kb + c * kc + round ) >> shift, saturated to 16 bits
+    static int16x8_t dot( int16x8_t a, int16_t ka, int16x8_t b, int16_t kb, int16x8_t c, int16_t kc,
+                          int32x4_t round, int32x4_t shift )
+    {
+        auto lo = vmull_n_s16( vget_low_s16( a ), ka );
+        lo = vmlal_n_s16( lo, vget_low_s16( b ), kb );
+        lo = vmlal_n_s16( lo, vget_low_s16( c ), kc );
+        auto hi = vmull_n_s16( vget_high_s16( a ), ka );
+        hi = vmlal_n_s16( hi, vget_high_s16( b ), kb );
+        hi = vmlal_n_s16( hi, vget_high_s16( c ), kc );
+        lo = vshlq_s32( vaddq_s32( lo, round ), shift );
+        hi = vshlq_s32( vaddq_s32( hi, round ), shift );
+        return vcombine_s16( vqmovn_s32( lo ), vqmovn_s32( hi ) );
+    }
+
+    template <typename Out>
+    static void storeRgb( Out, uint8_t* dst, unsigned x, uint8x16_t r, uint8x16_t g, uint8x16_t b )
+    {
+        if ( Out::Bpp == 4 )
+        {
+            uint8x16x4_t px;
+            px.val[Out::R] = r;
+            px.val[Out::G] = g;
+            px.val[Out::B] = b;
+            px.val[3] = vdupq_n_u8( 0xff );
+            vst4q_u8( dst + x * 4, px );
+        }
+        else
+        {
+            uint8x16x3_t px;
+            px.val[Out::R % 3] = r;
+            px.val[Out::G % 3] = g;
+            px.val[Out::B % 3] = b;
+            vst3q_u8( dst + x * 3, px );
+        }
+    }
+
+    template <typename In, typename Out>
+    static void yuvToRgb( const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                          uint8_t* dst, unsigned width, const YuvToRgbCoefs& c )
+    {
+        auto yOff = vdupq_n_s16( c.yOff );
+        auto cOff = vdupq_n_s16( c.cOff );
+        auto round = vdupq_n_s32( c.round );
+        auto shift = vdupq_n_s32( -c.shift );
+        auto zero = vdupq_n_s16( 0 );
+        auto x = 0u;
+        for ( ; x + 16 <= width; x += 16 )
+        {
+            int16x8_t Y[2], U[2], V[2];
+            loadYuv( In{}, y, u, v, x, Y, U, V );
+            uint8x8_t r[2], g[2], b[2];
+            for ( auto i = 0u; i < 2; ++i )
+            {
+                auto ys = vsubq_s16( Y[i], yOff );
+                auto us = vsubq_s16( U[i], cOff );
+                auto vs = vsubq_s16( V[i], cOff );
+                r[i] = vqmovun_s16( dot( ys, c.yMul, vs, c.vr, zero, 0, round, shift ) );
+                g[i] = vqmovun_s16( dot( ys, c.yMul, us, -c.ug, vs, -c.vg, round, shift ) );
+                b[i] = vqmovun_s16( dot( ys, c.yMul, us, c.ub, zero, 0, round, shift ) );
+            }
+            storeRgb( Out{}, dst, x, vcombine_u8( r[0], r[1] ), vcombine_u8( g[0], g[1] ),
+                      vcombine_u8( b[0], b[1] ) );
+        }
+        Scalar::yuvToRgbTail<In, Out>( y, u, v, dst, x, width, c );
+    }
+
+    // Loads 8 pixels as 16 bits components
+    template <typename In>
+    static void loadRgb( In, const uint8_t* p, unsigned x, int16x8_t& r, int16x8_t& g, int16x8_t& b )
+    {
+        if ( In::Bpp == 4 )
+        {
+            auto px = vld4_u8( p + x * 4 );
+            r = widen( px.val[In::R] );
+            g = widen( px.val[In::G] );
+            b = widen( px.val[In::B] );
+        }
+        else
+        {
+            auto px = vld3_u8( p + x * 3 );
+            r = widen( px.val[In::R % 3] );
+            g = widen( px.val[In::G % 3] );
+            b = widen( px.val[In::B % 3] );
+        }
+    }
+
+    static void storeY( I420, uint8_t* y, unsigned x, int16x8_t Y, int16x8_t )
+    {
+        vst1_u8( y + x, vqmovun_s16( Y ) );
+    }
+
+    static void storeY( NV12, uint8_t* y, unsigned x, int16x8_t Y, int16x8_t )
+    {
+        vst1_u8( y + x, vqmovun_s16( Y ) );
+    }
+
+    static void storeY( P010, uint8_t* y, unsigned x, int16x8_t Y, int16x8_t max )
+    {
+        auto v = vminq_s16( vmaxq_s16( Y, vdupq_n_s16( 0 ) ), max );
+        vst1q_u16( reinterpret_cast<uint16_t*>( y ) + x, vshlq_n_u16( vreinterpretq_u16_s16( v ), 6 ) );
+    }
+
+    // Stores 4 chroma samples
+    static void storeC( I420, uint8_t* u, uint8_t* v, unsigned cx, int16x4_t U, int16x4_t V, int16x8_t )
+    {
+        uint8_t tmp[8];
+        vst1_u8( tmp, vqmovun_s16( vcombine_s16( U, V ) ) );
+        memcpy( u + cx, tmp, 4 );
+        memcpy( v + cx, tmp + 4, 4 );
+    }
+
+    static void storeC( NV12, uint8_t* uv, uint8_t*, unsigned cx, int16x4_t U, int16x4_t V, int16x8_t )
+    {
+        auto z = vzip_s16( U, V );
+        vst1_u8( uv + cx * 2, vqmovun_s16( vcombine_s16( z.val[0], z.val[1] ) ) );
+    }
+
+    static void storeC( P010, uint8_t* uv, uint8_t*, unsigned cx, int16x4_t U, int16x4_t V, int16x8_t max )
+    {
+        auto z = vzip_s16( U, V );
+        auto c = vminq_s16( vmaxq_s16( vcombine_s16( z.val[0], z.val[1] ), vdupq_n_s16( 0 ) ), max );
+        vst1q_u16( reinterpret_cast<uint16_t*>( uv ) + cx * 2, vshlq_n_u16( vreinterpretq_u16_s16( c ), 6 ) );
+    }
+
+    static int16x4_t dot4( int16x4_t a, int16_t ka, int16x4_t b, int16_t kb, int16x4_t c, int16_t kc,
+                           int32x4_t round, int32x4_t shift, int32x4_t offset )
+    {
+        auto s = vmull_n_s16( a, ka );
+        s = vmlal_n_s16( s, b, kb );
+        s = vmlal_n_s16( s, c, kc );
+        s = vaddq_s32( vshlq_s32( vaddq_s32( s, round ), shift ), offset );
+        return vqmovn_s32( s );
+    }
+
+    static int16x4_t pairSums( int16x8_t v )
+    {
+        return vpadd_s16( vget_low_s16( v ), vget_high_s16( v ) );
+    }
+
+    template <typename In, typename Out>
+    static void rgbToYuv( const uint8_t* rgb0, const uint8_t* rgb1, uint8_t* y0, uint8_t* y1,
+                          uint8_t* u, uint8_t* v, unsigned width, const RgbToYuvCoefs& c )
+    {
+        auto yRound = vdupq_n_s32( c.yRound );
+        auto cRound = vdupq_n_s32( c.cRound );
+        auto yShift = vdupq_n_s32( -c.yShift );
+        auto cShift = vdupq_n_s32( -c.cShift );
+        auto yOff = vdupq_n_s16( c.yOff );
+        auto cOff = vdupq_n_s32( c.cOff );
+        auto noOff = vdupq_n_s32( 0 );
+        auto max = vdupq_n_s16( c.maxValue );
+        auto x = 0u;
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            int16x8_t r[2], g[2], b[2];
+            loadRgb( In{}, rgb0, x, r[0], g[0], b[0] );
+            loadRgb( In{}, rgb1, x, r[1], g[1], b[1] );
+            for ( auto i = 0u; i < 2; ++i )
+            {
+                auto dst = i == 0 ? y0 : y1;
+                if ( dst == nullptr )
+                    continue;
+                auto lo = dot4( vget_low_s16( r[i] ), c.yr, vget_low_s16( g[i] ), c.yg,
+                                vget_low_s16( b[i] ), c.yb, yRound, yShift, noOff );
+                auto hi = dot4( vget_high_s16( r[i] ), c.yr, vget_high_s16( g[i] ), c.yg,
+                                vget_high_s16( b[i] ), c.yb, yRound, yShift, noOff );
+                storeY( Out{}, dst, x, vaddq_s16( vcombine_s16( lo, hi ), yOff ), max );
+            }
+            auto rs = pairSums( vaddq_s16( r[0], r[1] ) );
+            auto gs = pairSums( vaddq_s16( g[0], g[1] ) );
+            auto bs = pairSums( vaddq_s16( b[0], b[1] ) );
+            auto U = dot4( rs, c.ur, gs, c.ug, bs, c.ub, cRound, cShift, cOff );
+            auto V = dot4( rs, c.vr, gs, c.vg, bs, c.vb, cRound, cShift, cOff );
+            storeC( Out{}, u, v, x / 2, U, V, max );
+        }
+        Scalar::rgbToYuvTail<In, Out>( rgb0, rgb1, y0, y1, u, v, x, width, c );
+    }
+};
+
+#endif // LIBVLCPP_CHROMA_NEON
+
+} // namespace chroma
+} // namespace detail
+
+///
+/// \brief The ChromaConverter class converts pictures between the YUV 4:2:0
+///        chromas libvlc decodes to (I420, NV12, P010), and packed RGB.
+///
+/// The conversion kernels are selected at construction time, from the best
+/// instruction set the CPU supports: AVX2 or SSE2 on x86, NEON on ARM. All
+/// of them produce the exact same output as the portable implementation.
+///
+/// When converting to YUV, the chroma of each 2x2 block is computed from
+/// the average of its pixels.
+///
+class ChromaConverter
+{
+public:
+    enum class Format
+    {
+        I420,
+        NV12,
+        P010,
+        /// Packed RGB, with the components in this order in memory
+        RGBA,
+        BGRA,
+        RGB24,
+    };
+
+    enum class Matrix
+    {
+        BT601,
+        BT709,
+    };
+
+    enum class Range
+    {
+        /// Luma in [16, 235], chroma in [16, 240] (scaled for 10 bits)
+        Limited,
+        Full,
+    };
+
+    enum class Isa
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    ///
+    /// \brief The Image struct points to the planes of a picture.
+    ///
+    /// Packed RGB pictures only use the first plane, NV12 & P010 use two,
+    /// I420 uses three.
+    ///
+    struct Image
+    {
+        uint8_t* planes[3];
+        size_t pitches[3];
+    };
+
+    ///
+    /// \brief ChromaConverter Prepares a conversion, using the best available
+    ///        instruction set
+    /// \throws std::invalid_argument if the conversion isn't supported
+    ///
+    ChromaConverter( Format from, Format to, Matrix matrix = Matrix::BT709,
+                     Range range = Range::Limited )
+        : ChromaConverter( from, to, matrix, range, bestIsa() )
+    {
+    }
+
+    ///
+    /// \brief ChromaConverter Prepares a conversion, using the provided
+    ///        instruction set
+    /// \throws std::invalid_argument if the conversion or the instruction set
+    ///         isn't supported
+    ///
+    ChromaConverter( Format from, Format to, Matrix matrix, Range range, Isa isa )
+        : m_from( from )
+        , m_to( to )
+        , m_isa( isa )
+        , m_yuvToRgb( nullptr )
+        , m_rgbToYuv( nullptr )
+    {
+        if ( isSupported( isa ) == false )
+            throw std::invalid_argument( "Unsupported instruction set" );
+        if ( isYuv( from ) == isYuv( to ) )
+            throw std::invalid_argument( "Only YUV <-> RGB conversions are supported" );
+        double kr = matrix == Matrix::BT601 ? 0.299 : 0.2126;
+        double kb = matrix == Matrix::BT601 ? 0.114 : 0.0722;
+        if ( isYuv( from ) )
+        {
+            m_yuvCoefs = yuvToRgbCoefs( kr, kb, range, depth( from ) );
+            m_yuvToRgb = selectYuvToRgb( isa );
+        }
+        else
+        {
+            m_rgbCoefs = rgbToYuvCoefs( kr, kb, range, depth( to ) );
+            m_rgbToYuv = selectRgbToYuv( isa );
+        }
+    }
+
+    ///
+    /// \brief convert Converts a width x height picture
+    ///
+    /// Odd dimensions are supported; the chroma planes must then have
+    /// ( width + 1 ) / 2 samples per line, and ( height + 1 ) / 2 lines.
+    ///
+    void convert( const Image& src, const Image& dst, unsigned width, unsigned height ) const
+    {
+        if ( m_yuvToRgb != nullptr )
+        {
+            for ( auto row = 0u; row < height; ++row )
+            {
+                auto crow = row / 2;
+                m_yuvToRgb( src.planes[0] + row * src.pitches[0],
+                            src.planes[1] + crow * src.pitches[1],
+                            m_from == Format::I420 ? src.planes[2] + crow * src.pitches[2] : nullptr,
+                            dst.planes[0] + row * dst.pitches[0], width, m_yuvCoefs );
+            }
+            return;
+        }
+        for ( auto row = 0u; row < height; row += 2 )
+        {
+            auto last = row + 1 == height;
+            auto rgb0 = src.planes[0] + row * src.pitches[0];
+            auto y0 = dst.planes[0] + row * dst.pitches[0];
+            m_rgbToYuv( rgb0, last ? rgb0 : rgb0 + src.pitches[0],
+                        y0, last ? nullptr : y0 + dst.pitches[0],
+                        dst.planes[1] + row / 2 * dst.pitches[1],
+                        m_to == Format::I420 ? dst.planes[2] + row / 2 * dst.pitches[2] : nullptr,
+                        width, m_rgbCoefs );
+        }
+    }
+
+    Isa isa() const
+    {
+        return m_isa;
+    }
+
+    static bool isYuv( Format f )
+    {
+        return f == Format::I420 || f == Format::NV12 || f == Format::P010;
+    }
+
+    ///
+    /// \brief isSupported Returns true if the CPU & the build support the
+    ///                    provided instruction set
+    ///
+    static bool isSupported( Isa isa )
+    {
+        switch ( isa )
+        {
+        case Isa::Scalar:
+            return true;
+#if defined(LIBVLCPP_CHROMA_X86)
+        case Isa::SSE2:
+            return true;
+        case Isa::AVX2:
+        {
+            static const bool avx2 = detail::chroma::cpuHasAvx2();
+            return avx2;
+        }
+#elif defined(LIBVLCPP_CHROMA_NEON)
+        case Isa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    static Isa bestIsa()
+    {
+        for ( auto isa : { Isa::AVX2, Isa::NEON, Isa::SSE2 } )
+        {
+            if ( isSupported( isa ) )
+                return isa;
+        }
+        return Isa::Scalar;
+    }
+
+    static const char* isaName( Isa isa )
+    {
+        switch ( isa )
+        {
+        case Isa::SSE2:
+            return "SSE2";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+        }
+    }
+
+    ///
+    /// \brief fromFourcc Maps a libvlc fourcc to a format
+    /// \return false if the fourcc isn't supported
+    ///
+    static bool fromFourcc( const char* fourcc, Format& format )
+    {
+        static const struct
+        {
+            char fourcc[5];
+            Format format;
+        } formats[] = {
+            { "I420", Format::I420 },
+            { "J420", Format::I420 },
+            { "NV12", Format::NV12 },
+            { "P010", Format::P010 },
+            { "RGBA", Format::RGBA },
+            { "BGRA", Format::BGRA },
+        };
+        for ( const auto& f : formats )
+        {
+            if ( memcmp( f.fourcc, fourcc, 4 ) == 0 )
+            {
+                format = f.format;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static unsigned depth( Format f )
+    {
+        return f == Format::P010 ? 10 : 8;
+    }
+
+    static int16_t fixed( double v )
+    {
+        return static_cast<int16_t>( std::lround( v * 8192 ) );
+    }
+
+    static detail::chroma::YuvToRgbCoefs yuvToRgbCoefs( double kr, double kb, Range range, unsigned depth )
+    {
+        auto kg = 1. - kr - kb;
+        auto ys = range == Range::Limited ? 255. / 219. : 1.;
+        auto cs = range == Range::Limited ? 255. / 224. : 1.;
+        detail::chroma::YuvToRgbCoefs c;
+        c.yOff = static_cast<int16_t>( range == Range::Limited ? 16 << ( depth - 8 ) : 0 );
+        c.cOff = static_cast<int16_t>( 128 << ( depth - 8 ) );
+        c.yMul = fixed( ys );
+        c.vr = fixed( 2. * ( 1. - kr ) * cs );
+        c.ug = fixed( 2. * kb * ( 1. - kb ) / kg * cs );
+        c.vg = fixed( 2. * kr * ( 1. - kr ) / kg * cs );
+        c.ub = fixed( 2. * ( 1. - kb ) * cs );
+        c.shift = 13 + static_cast<int>( depth - 8 );
+        c.round = 1 << ( c.shift - 1 );
+        return c;
+    }
+
+    static detail::chroma::RgbToYuvCoefs rgbToYuvCoefs( double kr, double kb, Range range, unsigned depth )
+    {
+        auto ys = range == Range::Limited ? 219. / 255. : 1.;
+        auto cs = range == Range::Limited ? 224. / 255. : 1.;
+        detail::chroma::RgbToYuvCoefs c;
+        // Make sure grey pixels map to a neutral chroma, and white to the
+        // maximum luma, despite the rounding
+        c.yr = fixed( kr * ys );
+        c.yb = fixed( kb * ys );
+        c.yg = static_cast<int16_t>( fixed( ys ) - c.yr - c.yb );
+        c.ur = fixed( -kr / ( 2. * ( 1. - kb ) ) * cs );
+        c.ub = fixed( 0.5 * cs );
+        c.ug = static_cast<int16_t>( -c.ur - c.ub );
+        c.vr = fixed( 0.5 * cs );
+        c.vb = fixed( -kb / ( 2. * ( 1. - kr ) ) * cs );
+        c.vg = static_cast<int16_t>( -c.vr - c.vb );
+        c.yShift = 13 - static_cast<int>( depth - 8 );
+        // The chroma is computed from the sum of 4 pixels
+        c.cShift = c.yShift + 2;
+        c.yRound = static_cast<int16_t>( 1 << ( c.yShift - 1 ) );
+        c.cRound = static_cast<int16_t>( 1 << ( c.cShift - 1 ) );
+        c.yOff = static_cast<int16_t>( range == Range::Limited ? 16 << ( depth - 8 ) : 0 );
+        c.cOff = static_cast<int16_t>( 128 << ( depth - 8 ) );
+        c.maxValue = static_cast<int16_t>( ( 1 << depth ) - 1 );
+        return c;
+    }
+
+    template <typename K, typename In>
+    detail::chroma::YuvToRgbRow selectRgbOutput() const
+    {
+        namespace dc = detail::chroma;
+        switch ( m_to )
+        {
+        case Format::RGBA:
+            return &K::template yuvToRgb<In, dc::RGBA>;
+        case Format::BGRA:
+            return &K::template yuvToRgb<In, dc::BGRA>;
+        default:
+            return &K::template yuvToRgb<In, dc::RGB24>;
+        }
+    }
+
+    template <typename K>
+    detail::chroma::YuvToRgbRow selectYuvToRgb() const
+    {
+        namespace dc = detail::chroma;
+        switch ( m_from )
+        {
+        case Format::I420:
+            return selectRgbOutput<K, dc::I420>();
+        case Format::NV12:
+            return selectRgbOutput<K, dc::NV12>();
+        default:
+            return selectRgbOutput<K, dc::P010>();
+        }
+    }
+
+    template <typename K, typename In>
+    detail::chroma::RgbToYuvRows selectYuvOutput() const
+    {
+        namespace dc = detail::chroma;
+        switch ( m_to )
+        {
+        case Format::I420:
+            return &K::template rgbToYuv<In, dc::I420>;
+        case Format::NV12:
+            return &K::template rgbToYuv<In, dc::NV12>;
+        default:
+            return &K::template rgbToYuv<In, dc::P010>;
+        }
+    }
+
+    template <typename K>
+    detail::chroma::RgbToYuvRows selectRgbToYuv() const
+    {
+        namespace dc = detail::chroma;
+        switch ( m_from )
+        {
+        case Format::RGBA:
+            return selectYuvOutput<K, dc::RGBA>();
+        case Format::BGRA:
+            return selectYuvOutput<K, dc::BGRA>();
+        default:
+            return selectYuvOutput<K, dc::RGB24>();
+        }
+    }
+
+    detail::chroma::YuvToRgbRow selectYuvToRgb( Isa isa ) const
+    {
+        switch ( isa )
+        {
+#if defined(LIBVLCPP_CHROMA_X86)
+        case Isa::AVX2:
+            return selectYuvToRgb<detail::chroma::Avx2>();
+        case Isa::SSE2:
+            return selectYuvToRgb<detail::chroma::Sse2>();
+#elif defined(LIBVLCPP_CHROMA_NEON)
+        case Isa::NEON:
+            return selectYuvToRgb<detail::chroma::Neon>();
+#endif
+        default:
+            return selectYuvToRgb<detail::chroma::Scalar>();
+        }
+    }
+
+    detail::chroma::RgbToYuvRows selectRgbToYuv( Isa isa ) const
+    {
+        switch ( isa )
+        {
+#if defined(LIBVLCPP_CHROMA_X86)
+        case Isa::AVX2:
+            return selectRgbToYuv<detail::chroma::Avx2>();
+        case Isa::SSE2:
+            return selectRgbToYuv<detail::chroma::Sse2>();
+#elif defined(LIBVLCPP_CHROMA_NEON)
+        case Isa::NEON:
+            return selectRgbToYuv<detail::chroma::Neon>();
+#endif
+        default:
+            return selectRgbToYuv<detail::chroma::Scalar>();
+        }
+    }
+
+private:
+    Format m_from;
+    Format m_to;
+    Isa m_isa;
+    detail::chroma::YuvToRgbCoefs m_yuvCoefs;
+    detail::chroma::RgbToYuvCoefs m_rgbCoefs;
+    detail::chroma::YuvToRgbRow m_yuvToRgb;
+    detail::chroma::RgbToYuvRows m_rgbToYuv;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_CHROMACONVERTER_H
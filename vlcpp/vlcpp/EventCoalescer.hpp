@@ -0,0 +1,238 @@
+/*****************************************************************************
+ * EventCoalescer.hpp: Rate limited delivery of high frequency events
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_EVENTCOALESCER_H
+#define LIBVLC_CXX_EVENTCOALESCER_H
+
+#include "SpinLock.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace VLC
+{
+
+namespace detail
+{
+    // Deduces the parameter list of a (non generic) callable type
+    template <typename T>
+    struct CallableSignature : CallableSignature<decltype(&T::operator())> {};
+
+    template <typename Ret, typename... Args>
+    struct CallableSignature<Ret(*)(Args...)>
+    {
+        using type = void(Args...);
+    };
+
+    template <typename C, typename Ret, typename... Args>
+    struct CallableSignature<Ret(C::*)(Args...)>
+    {
+        using type = void(Args...);
+    };
+
+    template <typename C, typename Ret, typename... Args>
+    struct CallableSignature<Ret(C::*)(Args...) const>
+    {
+        using type = void(Args...);
+    };
+
+    template <size_t... Idx>
+    struct IndexSequence {};
+
+    template <size_t N, size_t... Idx>
+    struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Idx...> {};
+
+    template <size_t... Idx>
+    struct MakeIndexSequence<0, Idx...>
+    {
+        using type = IndexSequence<Idx...>;
+    };
+
+    /// Tags the callables which need to be flushed upon state transitions.
+    /// See EventHandlerStore
+    struct CoalescingTag {};
+}
+
+template <typename Func, typename Clock = std::chrono::steady_clock,
+          typename Signature = typename detail::CallableSignature<Func>::type>
+class EventCoalescer;
+
+///
+/// \brief The EventCoalescer class rate limits the invocations of a callback.
+///
+/// The first invocation is forwarded right away. Invocations occurring less
+/// than `interval` after the last forwarded one are merged: only the latest
+/// set of parameters is kept, and will be forwarded by the next invocation
+/// occurring after the interval elapsed, or by a call to flush().
+///
+/// There is no timer: if the events stop arriving, the pending value waits
+/// for the next event or flush. For instance, a progress display fed with
+/// the time changes of a player can lag behind by the last update until the
+/// player changes state, which flushes it. A consumer which needs the
+/// trailing value sooner can call flush(), or EventManager::flush(),
+/// periodically from its own timer.
+///
+/// When given to an EventManager, a coalescer is automatically flushed before
+/// the state transition events of this manager (for instance, before a media
+/// player reports being paused or stopped), so that the last value is always
+/// delivered.
+///
+/// Invocations & flushes are thread safe. The callback is invoked without the
+/// coalescer's lock held, so it may run concurrently when events are raised
+/// from several threads, as any other event handler.
+///
+template <typename Func, typename Clock, typename... Args>
+class EventCoalescer<Func, Clock, void(Args...)> : public detail::CoalescingTag
+{
+public:
+    using Duration = typename Clock::duration;
+
+    template <typename FuncFwd>
+    EventCoalescer( Duration interval, FuncFwd&& f )
+        : m_func( std::forward<FuncFwd>( f ) )
+        , m_interval( interval )
+        , m_hasDelivered( false )
+        , m_pending( false )
+    {
+    }
+
+    // The lock isn't copied; the source mustn't be in use
+    EventCoalescer( const EventCoalescer& other )
+        : m_func( other.m_func )
+        , m_interval( other.m_interval )
+        , m_lastDelivery( other.m_lastDelivery )
+        , m_latest( other.m_latest )
+        , m_hasDelivered( other.m_hasDelivered )
+        , m_pending( other.m_pending )
+    {
+    }
+
+    EventCoalescer( EventCoalescer&& other )
+        : m_func( std::move( other.m_func ) )
+        , m_interval( other.m_interval )
+        , m_lastDelivery( other.m_lastDelivery )
+        , m_latest( std::move( other.m_latest ) )
+        , m_hasDelivered( other.m_hasDelivered )
+        , m_pending( other.m_pending )
+    {
+    }
+
+    EventCoalescer& operator=( const EventCoalescer& ) = delete;
+
+    void operator()( Args... args )
+    {
+        std::unique_lock<detail::SpinLock> lock( m_lock );
+        auto now = Clock::now();
+        if ( m_hasDelivered == false || now - m_lastDelivery >= m_interval )
+        {
+            // A more recent value supersedes the pending one
+            m_pending = false;
+            delivering( now );
+            lock.unlock();
+            m_func( std::forward<Args>( args )... );
+            return;
+        }
+        m_latest = std::make_tuple( std::forward<Args>( args )... );
+        m_pending = true;
+    }
+
+    ///
+    /// \brief flush Forwards the latest merged invocation, if any
+    ///
+    void flush()
+    {
+        std::unique_lock<detail::SpinLock> lock( m_lock );
+        if ( m_pending == false )
+            return;
+        m_pending = false;
+        delivering( Clock::now() );
+        auto latest = std::move( m_latest );
+        lock.unlock();
+        deliver( latest, typename detail::MakeIndexSequence<sizeof...(Args)>::type{} );
+    }
+
+    ///
+    /// \brief hasPending returns true if an invocation is waiting to be forwarded
+    ///
+    bool hasPending() const
+    {
+        std::lock_guard<detail::SpinLock> lock( m_lock );
+        return m_pending;
+    }
+
+    Duration interval() const
+    {
+        return m_interval;
+    }
+
+private:
+    template <typename Tuple, size_t... Idx>
+    void deliver( Tuple& latest, detail::IndexSequence<Idx...> )
+    {
+        m_func( std::move( std::get<Idx>( latest ) )... );
+    }
+
+    // Called with the lock held, before the callback gets invoked
+    void delivering( typename Clock::time_point now )
+    {
+        m_lastDelivery = now;
+        m_hasDelivered = true;
+    }
+
+private:
+    mutable detail::SpinLock m_lock;
+    Func m_func;
+    Duration m_interval;
+    typename Clock::time_point m_lastDelivery;
+    std::tuple<typename std::decay<Args>::type...> m_latest;
+    bool m_hasDelivered;
+    bool m_pending;
+};
+
+///
+/// \brief coalesce Wraps a callback so that it gets invoked at most once per interval
+///
+/// Typical usage:
+/// \code
+/// mp.eventManager().onTimeChanged( VLC::coalesce( std::chrono::milliseconds( 250 ),
+///     []( libvlc_time_t t ) { updateUI( t ); } ) );
+/// \endcode
+///
+/// \param interval The minimum delay between 2 invocations of f
+/// \param f        The user callback. It can't be a generic lambda, as the
+///                 parameters need to be deduced to be stored.
+/// \sa EventCoalescer
+///
+template <typename Clock = std::chrono::steady_clock, typename Rep, typename Period, typename Func>
+EventCoalescer<typename std::decay<Func>::type, Clock>
+coalesce( std::chrono::duration<Rep, Period> interval, Func&& f )
+{
+    return EventCoalescer<typename std::decay<Func>::type, Clock>(
+                std::chrono::duration_cast<typename Clock::duration>( interval ),
+                std::forward<Func>( f ) );
+}
+
+}
+
+#endif // LIBVLC_CXX_EVENTCOALESCER_H
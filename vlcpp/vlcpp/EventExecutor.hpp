@@ -0,0 +1,755 @@
+/*****************************************************************************
+ * EventExecutor.hpp: Runs event handlers outside of libvlc's event thread
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_EVENTEXECUTOR_H
+#define LIBVLC_CXX_EVENTEXECUTOR_H
+
+#include "EventCoalescer.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+///
+/// How an event parameter is kept until its handler runs on the executor.
+/// Values are copied as they are.
+///
+template <typename T>
+struct QueuedArg
+{
+    using type = T;
+
+    static T&& get( type& v )
+    {
+        return std::move( v );
+    }
+};
+
+///
+/// Objects given by pointer are only valid during the event, such as the
+/// thumbnail given by onThumbnailGenerated(). They are copied as well, and the
+/// handler gets a pointer to the copy, or nullptr.
+///
+template <typename T>
+struct QueuedArg<T*>
+{
+    static_assert( std::is_class<T>::value == true,
+                   "Only objects & strings can be given by pointer to an asynchronous "
+                   "handler, as they must be copied" );
+
+    struct type
+    {
+        type( T* p )
+            : copy( p != nullptr ? new typename std::remove_cv<T>::type( *p ) : nullptr )
+        {
+        }
+
+        std::unique_ptr<typename std::remove_cv<T>::type> copy;
+    };
+
+    static T* get( type& v )
+    {
+        return v.copy.get();
+    }
+};
+
+/// Strings given by pointer are copied as well
+template <>
+struct QueuedArg<const char*>
+{
+    struct type
+    {
+        type( const char* s )
+            : isNull( s == nullptr )
+            , copy( s != nullptr ? s : "" )
+        {
+        }
+
+        bool isNull;
+        std::string copy;
+    };
+
+    static const char* get( type& v )
+    {
+        return v.isNull == true ? nullptr : v.copy.c_str();
+    }
+};
+
+///
+/// \brief The ExecutorQueue class is a bounded, lock free, multiple producers
+///        single consumer queue of type erased tasks.
+///
+/// It is based on Dmitry Vyukov's bounded queue: each cell carries a sequence
+/// number telling whether it's ready to be written or read, so producers
+/// only contend on the enqueue position.
+/// Tasks are constructed in place in their cell, and only fall back to the
+/// heap when they don't fit.
+/// The consumer can sleep while the queue is empty. Producers only touch the
+/// mutex when the consumer is actually sleeping. Conversely, producers can
+/// sleep until the consumer makes some room.
+///
+class ExecutorQueue
+{
+public:
+    static constexpr size_t InlineSize = 12 * sizeof(void*);
+
+    explicit ExecutorQueue( size_t capacity )
+        : m_enqueuePos( 0 )
+        , m_dequeuePos( 0 )
+        , m_processed( 0 )
+        , m_dropped( 0 )
+        , m_sleeping( false )
+        , m_blocked( 0 )
+    {
+        size_t size = 2;
+        while ( size < capacity )
+            size *= 2;
+        m_mask = size - 1;
+        m_cells.reset( new Cell[size] );
+        for ( auto i = 0u; i < size; ++i )
+        {
+            m_cells[i].sequence.store( i, std::memory_order_relaxed );
+            m_cells[i].run = nullptr;
+            m_cells[i].destroy = nullptr;
+        }
+    }
+
+    ~ExecutorQueue()
+    {
+        discard();
+    }
+
+    ExecutorQueue( const ExecutorQueue& ) = delete;
+    ExecutorQueue& operator=( const ExecutorQueue& ) = delete;
+
+    ///
+    /// \brief push Constructs a T in the queue, from the provided arguments
+    /// \return false if the queue is full.
+    ///
+    /// If constructing the task throws, the task is dropped, which is
+    /// reported as a success, as retrying wouldn't help.
+    /// This can be called from any thread.
+    ///
+    template <typename T, typename... Args>
+    bool push( Args&&... args )
+    {
+        Cell* cell;
+        auto pos = m_enqueuePos.load( std::memory_order_relaxed );
+        while ( true )
+        {
+            cell = &m_cells[pos & m_mask];
+            auto seq = cell->sequence.load( std::memory_order_acquire );
+            auto diff = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos );
+            if ( diff == 0 )
+            {
+                if ( m_enqueuePos.compare_exchange_weak( pos, pos + 1,
+                                                         std::memory_order_relaxed ) )
+                    break;
+            }
+            else if ( diff < 0 )
+                return false;
+            else
+                pos = m_enqueuePos.load( std::memory_order_relaxed );
+        }
+        try
+        {
+            construct<T>( *cell, std::integral_constant<bool, fitsInline<T>()>{},
+                          std::forward<Args>( args )... );
+        }
+        catch ( ... )
+        {
+            cell->run = nullptr;
+            cell->destroy = nullptr;
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+        }
+        cell->sequence.store( pos + 1, std::memory_order_release );
+        // Pairs with the fence in wait(): either the consumer sees our task,
+        // or we see it sleeping.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( m_sleeping.load( std::memory_order_relaxed ) == true )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_cond.notify_one();
+        }
+        return true;
+    }
+
+    ///
+    /// \brief runOne Runs & destroys the oldest task, if any.
+    /// \return false if the queue was empty
+    ///
+    /// This must only be called by the consumer.
+    ///
+    bool runOne()
+    {
+        auto pos = m_dequeuePos.load( std::memory_order_relaxed );
+        auto& cell = m_cells[pos & m_mask];
+        if ( cell.sequence.load( std::memory_order_acquire ) != pos + 1 )
+            return false;
+        if ( cell.run != nullptr )
+        {
+            // Ensure the cell is recycled, even if the task throws
+            struct Release
+            {
+                ~Release()
+                {
+                    c.destroy( c );
+                    q.m_processed.fetch_add( 1, std::memory_order_relaxed );
+                    q.release( c, p );
+                }
+                ExecutorQueue& q;
+                Cell& c;
+                size_t p;
+            } release{ *this, cell, pos };
+            cell.run( cell );
+        }
+        else
+            release( cell, pos );
+        return true;
+    }
+
+    ///
+    /// \brief wait Waits for a task to be available, or for the queue to be woken up
+    ///
+    /// This must only be called by the consumer.
+    ///
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_sleeping.store( true, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( empty() == true && m_woken == false )
+            m_cond.wait( lock );
+        m_woken = false;
+        m_sleeping.store( false, std::memory_order_relaxed );
+    }
+
+    ///
+    /// \brief wake Interrupts the current or next call to wait(), and the
+    ///             current calls to waitForRoom()
+    ///
+    void wake()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_woken = true;
+        m_cond.notify_one();
+        m_roomCond.notify_all();
+    }
+
+    ///
+    /// \brief waitForRoom Waits for the consumer to release a cell, at most
+    ///                    for the given duration
+    ///
+    /// This can be called by any producer.
+    ///
+    void waitForRoom( std::chrono::milliseconds timeout )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_blocked.fetch_add( 1, std::memory_order_relaxed );
+        // Pairs with the fence in release(): either we see the room it made,
+        // or it sees us waiting.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( full() == true )
+            m_roomCond.wait_for( lock, timeout );
+        m_blocked.fetch_sub( 1, std::memory_order_relaxed );
+    }
+
+    ///
+    /// \brief discard Destroys the pending tasks without running them
+    ///
+    /// This must only be called by the consumer.
+    ///
+    void discard()
+    {
+        while ( true )
+        {
+            auto pos = m_dequeuePos.load( std::memory_order_relaxed );
+            auto& cell = m_cells[pos & m_mask];
+            if ( cell.sequence.load( std::memory_order_acquire ) != pos + 1 )
+                return;
+            if ( cell.destroy != nullptr )
+            {
+                cell.destroy( cell );
+                m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            }
+            release( cell, pos );
+        }
+    }
+
+    bool full() const
+    {
+        auto pos = m_enqueuePos.load( std::memory_order_relaxed );
+        auto seq = m_cells[pos & m_mask].sequence.load( std::memory_order_acquire );
+        return static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos ) < 0;
+    }
+
+    bool empty() const
+    {
+        auto pos = m_dequeuePos.load( std::memory_order_relaxed );
+        return m_cells[pos & m_mask].sequence.load( std::memory_order_acquire ) != pos + 1;
+    }
+
+    /// Approximate number of queued tasks
+    size_t depth() const
+    {
+        auto deq = m_dequeuePos.load( std::memory_order_relaxed );
+        auto enq = m_enqueuePos.load( std::memory_order_relaxed );
+        return enq > deq ? enq - deq : 0;
+    }
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    uint64_t processed() const
+    {
+        return m_processed.load( std::memory_order_relaxed );
+    }
+
+    uint64_t dropped() const
+    {
+        return m_dropped.load( std::memory_order_relaxed );
+    }
+
+    void countDrop()
+    {
+        m_dropped.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type storage;
+        // Points to the inline storage, or to a heap allocated task
+        void* task;
+        // Both are nullptr when the task was dropped
+        void (*run)(Cell&);
+        void (*destroy)(Cell&);
+    };
+
+    template <typename T>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(T) <= InlineSize && alignof(T) <= alignof(std::max_align_t);
+    }
+
+    template <typename T, typename... Args>
+    static void construct( Cell& c, std::true_type, Args&&... args )
+    {
+        c.task = new (&c.storage) T( std::forward<Args>( args )... );
+        c.run = [](Cell& c) { (*static_cast<T*>( c.task ))(); };
+        c.destroy = [](Cell& c) { static_cast<T*>( c.task )->~T(); };
+    }
+
+    template <typename T, typename... Args>
+    static void construct( Cell& c, std::false_type, Args&&... args )
+    {
+        c.task = new T( std::forward<Args>( args )... );
+        c.run = [](Cell& c) { (*static_cast<T*>( c.task ))(); };
+        c.destroy = [](Cell& c) { delete static_cast<T*>( c.task ); };
+    }
+
+    void release( Cell& cell, size_t pos )
+    {
+        m_dequeuePos.store( pos + 1, std::memory_order_relaxed );
+        cell.sequence.store( pos + m_mask + 1, std::memory_order_release );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( m_blocked.load( std::memory_order_relaxed ) > 0 )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_roomCond.notify_all();
+        }
+    }
+
+private:
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    // Keep the producers' and consumer's positions on separate cache lines
+    char m_pad0[64];
+    std::atomic<size_t> m_enqueuePos;
+    char m_pad1[64];
+    std::atomic<size_t> m_dequeuePos;
+    std::atomic<uint64_t> m_processed;
+    std::atomic<uint64_t> m_dropped;
+    char m_pad2[64];
+    std::atomic<bool> m_sleeping;
+    bool m_woken = false;
+    // Number of producers waiting for room
+    std::atomic<unsigned int> m_blocked;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_roomCond;
+};
+
+} // namespace detail
+
+template <typename Func, typename Signature = typename detail::CallableSignature<Func>::type>
+class AsyncHandler;
+
+///
+/// \brief The EventExecutor class runs event handlers away from libvlc's event thread.
+///
+/// Handlers wrapped with EventExecutor::wrap() don't run when libvlc raises the
+/// event. Instead, the event parameters are copied in a bounded queue, which
+/// gets drained by a pool of worker threads, or by a loop owned by the caller
+/// when the executor has no worker (see poll() & run()):
+/// \code
+/// VLC::EventExecutor executor( 1 );
+/// mp.eventManager().onPlaying( executor.wrap( []{ slowOperation(); } ) );
+/// \endcode
+///
+/// Each handler is bound to a single queue, and so to a single worker:
+/// a handler always receives its events in order, and never runs
+/// concurrently with itself. Different handlers may run in parallel.
+///
+/// When a queue is full, the event is either dropped or the libvlc thread
+/// sleeps until the worker makes some room, depending on the overflow policy.
+///
+/// The parameters of the events are copied, including the objects given by
+/// pointer, which only live as long as the event.
+///
+/// The executor must outlive the handlers it wrapped, or at least the libvlc
+/// objects raising their events. Events raised after the executor is stopped
+/// are dropped. Unregistering a handler doesn't wait for it to complete if
+/// it's running, but prevents its pending events from being delivered.
+///
+/// This can be combined with VLC::coalesce(), in which case the coalescer
+/// must wrap the asynchronous handler, so that it runs on libvlc's thread:
+/// \code
+/// em.onTimeChanged( VLC::coalesce( std::chrono::milliseconds( 250 ),
+///                                  executor.wrap( []( libvlc_time_t t ) { ... } ) ) );
+/// \endcode
+///
+class EventExecutor
+{
+public:
+    enum class Overflow
+    {
+        /// Drop the new event. This never blocks libvlc.
+        Drop,
+        /// Wait for the queue to have some room. libvlc's thread sleeps until
+        /// the worker runs a handler, or the executor is stopped.
+        Block,
+    };
+
+    struct Stats
+    {
+        /// Number of events waiting to be processed
+        size_t depth;
+        /// Number of events which were processed
+        uint64_t processed;
+        /// Number of events dropped, because of an overflow or because the
+        /// executor was stopped.
+        uint64_t dropped;
+    };
+
+    ///
+    /// \brief EventExecutor Creates an executor
+    /// \param nbWorkers    The number of threads running the handlers. If 0, the
+    ///                     handlers are run by poll() or run(), on the caller thread.
+    /// \param capacity     The maximum number of pending events, per worker
+    /// \param policy       The behavior when a worker's queue is full
+    ///
+    explicit EventExecutor( size_t nbWorkers, size_t capacity = 1024,
+                            Overflow policy = Overflow::Drop )
+        : m_state( std::make_shared<State>( nbWorkers > 0 ? nbWorkers : 1,
+                                            capacity, policy ) )
+    {
+        for ( auto i = 0u; i < nbWorkers; ++i )
+        {
+            auto& queue = *m_state->queues[i];
+            auto& stopped = m_state->stopped;
+            m_workers.emplace_back( [&queue, &stopped]() {
+                while ( stopped.load( std::memory_order_acquire ) == false )
+                {
+                    if ( queue.runOne() == false )
+                        queue.wait();
+                }
+            });
+        }
+    }
+
+    ///
+    /// Stops the executor, joining the workers. Pending events are dropped.
+    ///
+    ~EventExecutor()
+    {
+        stop();
+        for ( auto& w : m_workers )
+            w.join();
+        // No consumer is running anymore, as we own the caller's loop
+        for ( auto& q : m_state->queues )
+            q->discard();
+    }
+
+    EventExecutor( const EventExecutor& ) = delete;
+    EventExecutor& operator=( const EventExecutor& ) = delete;
+
+    ///
+    /// \brief wrap Returns a handler running f on this executor
+    ///
+    /// The returned handler is meant to be given to an EventManager.
+    /// f can't be a generic lambda, as its parameters need to be deduced to
+    /// be copied in the queue.
+    ///
+    template <typename Func>
+    AsyncHandler<typename std::decay<Func>::type> wrap( Func&& f )
+    {
+        auto idx = m_state->nextQueue.fetch_add( 1, std::memory_order_relaxed ) %
+                m_state->queues.size();
+        return AsyncHandler<typename std::decay<Func>::type>( m_state, idx,
+                                                              std::forward<Func>( f ) );
+    }
+
+    ///
+    /// \brief poll Runs the pending events, and returns without waiting for more
+    /// \return The number of events processed
+    ///
+    /// This is only meant for executors without worker. It must not be called
+    /// from multiple threads at once.
+    ///
+    size_t poll()
+    {
+        assert( m_workers.empty() == true );
+        auto& queue = *m_state->queues[0];
+        auto nbProcessed = 0u;
+        while ( m_state->stopped.load( std::memory_order_acquire ) == false &&
+                queue.runOne() == true )
+            ++nbProcessed;
+        return nbProcessed;
+    }
+
+    ///
+    /// \brief run Runs the events as they come, until stop() gets called.
+    ///
+    /// This is only meant for executors without worker. It must not be called
+    /// from multiple threads at once.
+    ///
+    void run()
+    {
+        assert( m_workers.empty() == true );
+        auto& queue = *m_state->queues[0];
+        while ( m_state->stopped.load( std::memory_order_acquire ) == false )
+        {
+            if ( queue.runOne() == false )
+                queue.wait();
+        }
+    }
+
+    ///
+    /// \brief stop Stops processing events.
+    ///
+    /// This can be called from any thread, including from a handler. Events
+    /// raised afterward are dropped.
+    ///
+    void stop()
+    {
+        m_state->stopped.store( true, std::memory_order_release );
+        for ( auto& q : m_state->queues )
+            q->wake();
+    }
+
+    Stats stats() const
+    {
+        Stats s{ 0, 0, 0 };
+        for ( const auto& q : m_state->queues )
+        {
+            s.depth += q->depth();
+            s.processed += q->processed();
+            s.dropped += q->dropped();
+        }
+        return s;
+    }
+
+    /// Number of events waiting to be processed
+    size_t depth() const
+    {
+        return stats().depth;
+    }
+
+    /// Number of events dropped so far
+    uint64_t dropped() const
+    {
+        return stats().dropped;
+    }
+
+private:
+    struct State
+    {
+        State( size_t nbQueues, size_t capacity, Overflow p )
+            : policy( p )
+            , stopped( false )
+            , nextQueue( 0 )
+        {
+            for ( auto i = 0u; i < nbQueues; ++i )
+                queues.emplace_back( new detail::ExecutorQueue( capacity ) );
+        }
+
+        template <typename T, typename... Args>
+        void push( size_t idx, Args&&... args )
+        {
+            auto& queue = *queues[idx];
+            while ( stopped.load( std::memory_order_acquire ) == false )
+            {
+                if ( queue.push<T>( std::forward<Args>( args )... ) == true )
+                    return;
+                if ( policy == Overflow::Drop )
+                    break;
+                // The timeout only bounds how long a stop() can go unnoticed
+                queue.waitForRoom( std::chrono::milliseconds( 10 ) );
+            }
+            queue.countDrop();
+        }
+
+        std::vector<std::unique_ptr<detail::ExecutorQueue>> queues;
+        const Overflow policy;
+        std::atomic<bool> stopped;
+        std::atomic<size_t> nextQueue;
+    };
+
+    std::shared_ptr<State> m_state;
+    std::vector<std::thread> m_workers;
+
+    template <typename, typename>
+    friend class AsyncHandler;
+};
+
+///
+/// \brief The AsyncHandler class forwards its invocations to an EventExecutor.
+///
+/// This is returned by EventExecutor::wrap(). The wrapped callback is shared
+/// between the copies of an AsyncHandler, and the queued events.
+/// Once all the copies are destroyed (ie. when the handler gets unregistered),
+/// the pending events are discarded.
+///
+template <typename Func, typename... Args>
+class AsyncHandler<Func, void(Args...)>
+{
+public:
+    AsyncHandler( const AsyncHandler& other )
+        : m_state( other.m_state )
+        , m_sub( other.m_sub )
+    {
+        if ( m_sub != nullptr )
+            m_sub->owners.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    AsyncHandler( AsyncHandler&& other )
+        : m_state( std::move( other.m_state ) )
+        , m_sub( std::move( other.m_sub ) )
+    {
+    }
+
+    AsyncHandler& operator=( const AsyncHandler& ) = delete;
+
+    ~AsyncHandler()
+    {
+        if ( m_sub != nullptr &&
+             m_sub->owners.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+            m_sub->active.store( false, std::memory_order_release );
+    }
+
+    void operator()( Args... args )
+    {
+        m_state->template push<Event>( m_sub->queue, m_sub,
+                                       std::forward<Args>( args )... );
+    }
+
+private:
+    struct Subscription
+    {
+        template <typename FuncFwd>
+        Subscription( size_t q, FuncFwd&& f )
+            : func( std::forward<FuncFwd>( f ) )
+            , owners( 1 )
+            , active( true )
+            , queue( q )
+        {
+        }
+
+        Func func;
+        std::atomic<unsigned int> owners;
+        std::atomic<bool> active;
+        const size_t queue;
+    };
+
+    // A queued event: the parameters, and the handler to invoke
+    struct Event
+    {
+        template <typename... EventArgs>
+        Event( const std::shared_ptr<Subscription>& s, EventArgs&&... a )
+            : sub( s )
+            , args( std::forward<EventArgs>( a )... )
+        {
+        }
+
+        void operator()()
+        {
+            if ( sub->active.load( std::memory_order_acquire ) == true )
+                invoke( typename detail::MakeIndexSequence<sizeof...(Args)>::type{} );
+        }
+
+        template <size_t... Idx>
+        void invoke( detail::IndexSequence<Idx...> )
+        {
+            sub->func( detail::QueuedArg<typename std::decay<Args>::type>::get(
+                           std::get<Idx>( args ) )... );
+        }
+
+        std::shared_ptr<Subscription> sub;
+        std::tuple<typename detail::QueuedArg<typename std::decay<Args>::type>::type...> args;
+    };
+
+    template <typename FuncFwd>
+    AsyncHandler( std::shared_ptr<EventExecutor::State> state, size_t queue, FuncFwd&& f )
+        : m_state( std::move( state ) )
+        , m_sub( std::make_shared<Subscription>( queue, std::forward<FuncFwd>( f ) ) )
+    {
+    }
+
+    std::shared_ptr<EventExecutor::State> m_state;
+    std::shared_ptr<Subscription> m_sub;
+
+    friend class EventExecutor;
+};
+
+}
+
+#endif // LIBVLC_CXX_EVENTEXECUTOR_H
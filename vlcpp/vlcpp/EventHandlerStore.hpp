@@ -0,0 +1,761 @@
+/*****************************************************************************
+ * EventHandlerStore.hpp: Slab storage for registered event handlers
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_EVENTHANDLERSTORE_H
+#define LIBVLC_CXX_EVENTHANDLERSTORE_H
+
+#include <vlc/vlc.h>
+
+#include "EventCoalescer.hpp"
+#include "EventTracer.hpp"
+#include "SpinLock.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+///
+/// \brief The EventHandlerStore class owns the user callbacks registered
+///        through an EventManager.
+///
+/// Handlers live in fixed size slots, allocated by chunks which are never
+/// released before the store itself. This gives every callback a stable
+/// address, which the libvlc trampolines rely on.
+/// Released slots are kept in a free list and recycled by the next
+/// registration, so once the store has grown to its working size, a
+/// register/unregister cycle doesn't touch the heap anymore.
+/// Callbacks which don't fit in a slot (or are over-aligned) are still
+/// supported, but are allocated on the heap.
+///
+/// Slots are addressed by an index & generation pair. The generation is bumped
+/// each time a slot is released, which lets us detect stale handles in O(1)
+/// instead of searching for the handler.
+///
+/// The store attaches to libvlc only once per event type. Each event type
+/// gets a channel, holding a compact array of subscribers which the channel
+/// trampoline iterates when libvlc raises the event. A channel stays attached
+/// until the store is cleared, so registering a handler for an event type which
+/// was already used doesn't involve libvlc at all.
+/// The delivery order between the subscribers of a single event is unspecified.
+///
+/// Callbacks wrapped in an EventCoalescer are flushed before the "flush
+/// events" given upon construction are dispatched. Those usually are the
+/// state transitions of the object emitting the events, so that a rate
+/// limited subscriber always gets the last value before the object stops.
+/// The flush events are only attached once a coalescing callback is stored.
+///
+/// When LIBVLCPP_EVENT_TRACING is defined, each handler invocation is
+/// reported to the EventTracer.
+///
+/// All operations are thread safe. libvlc is never called with our lock held,
+/// as libvlc holds its own lock while invoking our trampolines. Handlers
+/// aren't invoked with our lock held either: a dispatch collects the
+/// subscribers under the lock, then runs them once it is released, so events
+/// raised by different libvlc threads don't wait for each other.
+/// Handlers may register or unregister handlers from within a callback. A
+/// handler unregistered while a dispatch is in progress, on any thread, isn't
+/// invoked by this dispatch anymore, and its destruction is deferred until no
+/// dispatch is in progress. If it is running on another thread, remove()
+/// waits for it to return, as libvlc_event_detach() would, so that the caller
+/// can then release what the handler uses. It doesn't wait for the calling
+/// thread's own invocations, nor when called while the store is locked, from
+/// the destructor of a callback.
+///
+class EventHandlerStore
+{
+public:
+    using Wrapper = void(*)(const libvlc_event_t*, void*);
+
+    /// Size of the inline storage of a slot. This is enough for a std::function
+    /// or a lambda capturing a handful of pointers.
+    static constexpr size_t InlineSize = 6 * sizeof(void*);
+    /// Number of slots allocated at once when the store needs to grow.
+    static constexpr uint32_t ChunkSize = 32;
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+    /// Maximum number of flush events
+    static constexpr size_t MaxFlushEvents = 8;
+
+    struct Handle
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    ///
+    /// \param em              The libvlc event manager to attach to
+    /// \param flushEvents     The events which flush the coalescing callbacks
+    ///                        before being dispatched. Can be nullptr.
+    /// \param nbFlushEvents   The number of elements in flushEvents
+    ///
+    explicit EventHandlerStore( libvlc_event_manager_t* em,
+                                const libvlc_event_e* flushEvents = nullptr,
+                                size_t nbFlushEvents = 0 )
+        : m_em( em )
+        , m_flushEvents( flushEvents )
+        , m_nbFlushEvents( nbFlushEvents )
+        , m_freeHead( InvalidIndex )
+        , m_size( 0 )
+        , m_nbCoalescing( 0 )
+        , m_dispatchDepth( 0 )
+        , m_hasZombies( false )
+        , m_waiters( 0 )
+        , m_removals( 0 )
+    {
+        assert( nbFlushEvents <= MaxFlushEvents );
+    }
+
+    ~EventHandlerStore()
+    {
+        clear();
+    }
+
+    EventHandlerStore( const EventHandlerStore& ) = delete;
+    EventHandlerStore& operator=( const EventHandlerStore& ) = delete;
+
+    ///
+    /// \brief add Stores a callback and subscribes it to an event
+    /// \param eventType The libvlc event to listen to
+    /// \param f         The user callback. It will be moved or copied in the store
+    /// \param wrapper   The function decoding the libvlc event. It will be given
+    ///                  a pointer to the stored callback as its opaque parameter.
+    /// \throw std::bad_alloc if the event couldn't be attached
+    ///
+    template <typename Func>
+    Handle add( libvlc_event_e eventType, Func&& f, Wrapper wrapper )
+    {
+        using Callback = typename std::decay<Func>::type;
+        using IsCoalescing = std::is_base_of<CoalescingTag, Callback>;
+        Handle h;
+        // The subscriber's channel, and the flush channels if needed
+        Channel* toAttach[MaxFlushEvents + 1];
+        size_t nbToAttach = 0;
+        {
+            std::lock_guard<SpinLock> lock( m_lock );
+            auto idx = acquire();
+            auto& s = slot( idx );
+            Channel* c;
+            try
+            {
+                c = &channel( eventType );
+                if ( IsCoalescing::value == true )
+                {
+                    for ( auto i = 0u; i < m_nbFlushEvents; ++i )
+                        channel( m_flushEvents[i] );
+                }
+                // Ensure subscribe() won't throw once the callback is constructed
+                c->subscribers.reserve( c->subscribers.size() + 1 );
+                construct<Callback>( s, std::forward<Func>( f ),
+                                     std::integral_constant<bool, fitsInline<Callback>()>{} );
+            }
+            catch ( ... )
+            {
+                release( idx );
+                throw;
+            }
+            setFlush<Callback>( s, IsCoalescing{} );
+            subscribe( *c, idx, wrapper );
+            s.state = SlotState::Live;
+            ++m_size;
+            h = Handle{ idx, s.generation };
+            if ( c->attached == false )
+                toAttach[nbToAttach++] = c;
+            if ( IsCoalescing::value == true )
+            {
+                for ( auto i = 0u; i < m_nbFlushEvents; ++i )
+                {
+                    auto& fc = channel( m_flushEvents[i] );
+                    if ( fc.attached == false && &fc != c )
+                        toAttach[nbToAttach++] = &fc;
+                }
+            }
+            for ( auto i = 0u; i < nbToAttach; ++i )
+                toAttach[i]->attached = true;
+        }
+        for ( auto i = 0u; i < nbToAttach; ++i )
+        {
+            auto c = toAttach[i];
+            if ( libvlc_event_attach( m_em, c->eventType, &EventHandlerStore::dispatch, c ) != 0 )
+            {
+                {
+                    std::lock_guard<SpinLock> lock( m_lock );
+                    for ( auto j = i; j < nbToAttach; ++j )
+                        toAttach[j]->attached = false;
+                }
+                remove( h );
+                throw std::bad_alloc();
+            }
+        }
+        return h;
+    }
+
+    ///
+    /// \brief flush Flushes all the coalescing callbacks
+    ///
+    void flush()
+    {
+        Snapshot snapshot;
+        std::unique_lock<SpinLock> lock( m_lock );
+        DispatchScope scope( *this );
+        collectFlushes( snapshot );
+        auto removals = m_removals.load( std::memory_order_relaxed );
+        lock.unlock();
+        run( snapshot, removals, nullptr, nullptr );
+    }
+
+    ///
+    /// \brief remove Unsubscribes and destroys the callback designated by h
+    ///
+    /// If the callback is running on another thread, this waits for it to
+    /// return.
+    ///
+    /// \return false if the handle was stale or didn't belong to this store
+    ///
+    bool remove( Handle h )
+    {
+        std::unique_lock<SpinLock> lock( m_lock );
+        if ( isLive( h ) == false )
+            return false;
+        auto& s = slot( h.index );
+        --m_size;
+        // Pairs with the running count of the dispatches: either they see the
+        // removal, or we see them running
+        m_removals.fetch_add( 1, std::memory_order_seq_cst );
+        if ( m_dispatchDepth == 0 )
+        {
+            destroy( h.index );
+            return true;
+        }
+        // We might be removing a handler being run, or one which is yet to be
+        // visited by a dispatch loop, on any thread. Neutralize it, and defer
+        // the actual cleanup.
+        s.channel->subscribers[s.position].wrapper = nullptr;
+        s.state = SlotState::Zombie;
+        // Make any outstanding handle stale right away
+        bumpGeneration( s );
+        m_hasZombies = true;
+        // An outer caller holding the lock could prevent the handler from
+        // returning
+        if ( m_lock.depth() > 1 )
+            return true;
+        auto own = runningOnThisThread( h.index );
+        if ( s.running.load( std::memory_order_seq_cst ) <= own )
+            return true;
+        // The slot isn't recycled while we wait for it
+        ++m_waiters;
+        lock.unlock();
+        unsigned int spins = 0;
+        while ( s.running.load( std::memory_order_acquire ) > own )
+            backoff( spins );
+        lock.lock();
+        if ( --m_waiters == 0 && m_dispatchDepth == 0 && m_hasZombies == true )
+            purgeZombies();
+        return true;
+    }
+
+    bool isRegistered( Handle h ) const
+    {
+        std::lock_guard<SpinLock> lock( m_lock );
+        return isLive( h );
+    }
+
+    ///
+    /// \brief clear Detaches from libvlc and destroys all the stored callbacks.
+    ///
+    /// Allocated chunks are kept around to be reused by later registrations.
+    /// This must not be called from within an event handler.
+    ///
+    void clear()
+    {
+        std::vector<Channel*> toDetach;
+        {
+            std::lock_guard<SpinLock> lock( m_lock );
+            for ( auto& c : m_channels )
+            {
+                if ( c->attached == false )
+                    continue;
+                c->attached = false;
+                toDetach.push_back( c.get() );
+            }
+        }
+        // Once detached, libvlc guarantees that our trampoline isn't running
+        // anymore for this channel.
+        for ( auto c : toDetach )
+            libvlc_event_detach( m_em, c->eventType, &EventHandlerStore::dispatch, c );
+
+        std::lock_guard<SpinLock> lock( m_lock );
+        for ( auto i = 0u; i < capacity(); ++i )
+        {
+            if ( slot( i ).state != SlotState::Free )
+                destroy( i );
+        }
+        m_size = 0;
+        m_hasZombies = false;
+        m_removals.fetch_add( 1, std::memory_order_release );
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<SpinLock> lock( m_lock );
+        return m_size;
+    }
+
+    size_t capacity() const
+    {
+        return m_chunks.size() * ChunkSize;
+    }
+
+private:
+    enum class SlotState : uint8_t
+    {
+        Free,
+        Live,
+        // Unregistered during a dispatch, waiting for the dispatch to complete
+        Zombie,
+    };
+
+    struct Subscriber
+    {
+        // nullptr when the subscriber has been removed during a dispatch
+        Wrapper wrapper;
+        void* callback;
+        uint32_t slot;
+    };
+
+    struct Channel
+    {
+        EventHandlerStore* store;
+        libvlc_event_e eventType;
+        bool attached;
+        // Coalescing callbacks must be flushed before this event is dispatched
+        bool flushes;
+        std::vector<Subscriber> subscribers;
+    };
+
+    struct Slot
+    {
+        typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type storage;
+        // Points to the inline storage, or to a heap allocated callback
+        void* callback;
+        void (*destroy)(Slot&);
+        // Non null for coalescing callbacks
+        void (*flush)(void*);
+        Channel* channel;
+        // Position of this slot's subscriber in the channel
+        uint32_t position;
+        uint32_t generation;
+        uint32_t nextFree;
+        SlotState state;
+        // Number of invocations of the callback in progress, on all threads
+        std::atomic<uint32_t> running;
+    };
+
+    // Keeps the slots alive while their callbacks are being run. It must be
+    // created with the lock held, and takes it again upon destruction.
+    struct DispatchScope
+    {
+        explicit DispatchScope( EventHandlerStore& s ) : store( s ) { ++store.m_dispatchDepth; }
+        ~DispatchScope()
+        {
+            std::lock_guard<SpinLock> lock( store.m_lock );
+            if ( --store.m_dispatchDepth == 0 && store.m_hasZombies == true &&
+                 store.m_waiters == 0 )
+                store.purgeZombies();
+        }
+        EventHandlerStore& store;
+    };
+
+    // A callback collected by a dispatch, to be run once the lock is released
+    struct Invocation
+    {
+        // The subscriber's wrapper, or nullptr for a coalescing flush
+        Wrapper wrapper;
+        void (*flush)(void*);
+        void* callback;
+        Handle handle;
+        Slot* slot;
+    };
+
+    // A callback being run by the current thread. They are linked from the
+    // innermost one, so that remove() can tell the invocations of the calling
+    // thread from the others.
+    struct Running
+    {
+        Running( const EventHandlerStore& s, uint32_t idx )
+            : store( &s )
+            , slot( idx )
+            , next( top() )
+        {
+            top() = this;
+        }
+
+        ~Running()
+        {
+            top() = next;
+        }
+
+        static Running*& top()
+        {
+            static thread_local Running* running = nullptr;
+            return running;
+        }
+
+        const EventHandlerStore* store;
+        uint32_t slot;
+        Running* next;
+    };
+
+    // The callbacks to run. Most events only have a handful of subscribers,
+    // which don't need the heap.
+    class Snapshot
+    {
+    public:
+        Snapshot() : m_size( 0 ) {}
+
+        void push( const Invocation& i )
+        {
+            if ( m_size < InlineCount )
+                m_inline[m_size] = i;
+            else
+                m_overflow.push_back( i );
+            ++m_size;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        const Invocation& operator[]( size_t i ) const
+        {
+            return i < InlineCount ? m_inline[i] : m_overflow[i - InlineCount];
+        }
+
+    private:
+        static constexpr size_t InlineCount = 16;
+        Invocation m_inline[InlineCount];
+        std::vector<Invocation> m_overflow;
+        size_t m_size;
+    };
+
+    static void dispatch( const libvlc_event_t* e, void* data )
+    {
+        auto c = static_cast<Channel*>( data );
+        auto& store = *c->store;
+        DispatchTrace trace( c->eventType );
+        Snapshot snapshot;
+        std::unique_lock<SpinLock> lock( store.m_lock );
+        DispatchScope scope( store );
+        // The pending values are delivered before the flush event itself
+        if ( c->flushes == true && store.m_nbCoalescing > 0 )
+            store.collectFlushes( snapshot );
+        // Handlers registered during this dispatch will only receive the
+        // next events.
+        for ( const auto& sub : c->subscribers )
+        {
+            if ( sub.wrapper == nullptr )
+                continue;
+            auto& s = store.slot( sub.slot );
+            snapshot.push( Invocation{ sub.wrapper, nullptr, sub.callback,
+                                       Handle{ sub.slot, s.generation }, &s } );
+        }
+        auto removals = store.m_removals.load( std::memory_order_relaxed );
+        lock.unlock();
+        store.run( snapshot, removals, e, &trace );
+    }
+
+    // Runs the collected callbacks, without the lock, skipping the ones which
+    // were removed in the meantime. The DispatchScope keeps them alive.
+    void run( const Snapshot& snapshot, uint32_t removals, const libvlc_event_t* e,
+              DispatchTrace* trace )
+    {
+        for ( auto i = 0u; i < snapshot.size(); ++i )
+        {
+            const auto& inv = snapshot[i];
+            // Count the invocation before checking for removals, so that a
+            // concurrent remove() either gets seen here or waits for us
+            inv.slot->running.fetch_add( 1, std::memory_order_seq_cst );
+            // Only check the slot if something was removed since the snapshot
+            if ( m_removals.load( std::memory_order_seq_cst ) != removals )
+            {
+                std::lock_guard<SpinLock> lock( m_lock );
+                if ( isLive( inv.handle ) == false )
+                {
+                    inv.slot->running.fetch_sub( 1, std::memory_order_release );
+                    continue;
+                }
+            }
+            {
+                Running running( *this, inv.handle.index );
+                if ( inv.wrapper == nullptr )
+                    inv.flush( inv.callback );
+                else
+                {
+                    trace->beginHandler();
+                    inv.wrapper( e, inv.callback );
+                    trace->endHandler();
+                }
+            }
+            inv.slot->running.fetch_sub( 1, std::memory_order_release );
+        }
+    }
+
+    // The number of invocations of the slot the calling thread is running
+    uint32_t runningOnThisThread( uint32_t idx ) const
+    {
+        uint32_t count = 0;
+        for ( auto r = Running::top(); r != nullptr; r = r->next )
+        {
+            if ( r->store == this && r->slot == idx )
+                ++count;
+        }
+        return count;
+    }
+
+    template <typename Callback>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(Callback) <= InlineSize &&
+                alignof(Callback) <= alignof(std::max_align_t);
+    }
+
+    template <typename Callback, typename Func>
+    static void construct( Slot& s, Func&& f, std::true_type )
+    {
+        s.callback = new (&s.storage) Callback( std::forward<Func>( f ) );
+        s.destroy = [](Slot& s) {
+            static_cast<Callback*>( s.callback )->~Callback();
+        };
+    }
+
+    template <typename Callback, typename Func>
+    static void construct( Slot& s, Func&& f, std::false_type )
+    {
+        s.callback = new Callback( std::forward<Func>( f ) );
+        s.destroy = [](Slot& s) {
+            delete static_cast<Callback*>( s.callback );
+        };
+    }
+
+    template <typename Callback>
+    static void setFlush( Slot& s, std::true_type )
+    {
+        s.flush = [](void* callback) {
+            static_cast<Callback*>( callback )->flush();
+        };
+    }
+
+    template <typename Callback>
+    static void setFlush( Slot& s, std::false_type )
+    {
+        s.flush = nullptr;
+    }
+
+    void collectFlushes( Snapshot& snapshot )
+    {
+        // Flush events are state transitions, which are rare enough for a
+        // scan of the slots not to matter.
+        for ( auto i = 0u; i < capacity(); ++i )
+        {
+            auto& s = slot( i );
+            if ( s.state == SlotState::Live && s.flush != nullptr )
+                snapshot.push( Invocation{ nullptr, s.flush, s.callback,
+                                           Handle{ i, s.generation }, &s } );
+        }
+    }
+
+    bool isFlushEvent( libvlc_event_e eventType ) const
+    {
+        for ( auto i = 0u; i < m_nbFlushEvents; ++i )
+        {
+            if ( m_flushEvents[i] == eventType )
+                return true;
+        }
+        return false;
+    }
+
+    Channel& channel( libvlc_event_e eventType )
+    {
+        // There are only a few event types per manager, a linear lookup is
+        // good enough.
+        for ( auto& c : m_channels )
+        {
+            if ( c->eventType == eventType )
+                return *c;
+        }
+        std::unique_ptr<Channel> c( new Channel{ this, eventType, false,
+                                            isFlushEvent( eventType ), {} } );
+        m_channels.push_back( std::move( c ) );
+        return *m_channels.back();
+    }
+
+    void subscribe( Channel& c, uint32_t idx, Wrapper wrapper )
+    {
+        auto& s = slot( idx );
+        s.channel = &c;
+        if ( s.flush != nullptr )
+            ++m_nbCoalescing;
+        s.position = static_cast<uint32_t>( c.subscribers.size() );
+        c.subscribers.push_back( Subscriber{ wrapper, s.callback, idx } );
+    }
+
+    void unsubscribe( Slot& s )
+    {
+        auto& subs = s.channel->subscribers;
+        auto& last = subs.back();
+        if ( last.slot != subs[s.position].slot )
+        {
+            subs[s.position] = last;
+            slot( last.slot ).position = s.position;
+        }
+        subs.pop_back();
+        s.channel = nullptr;
+        if ( s.flush != nullptr )
+            --m_nbCoalescing;
+    }
+
+    bool isLive( Handle h ) const
+    {
+        if ( h.index >= capacity() )
+            return false;
+        const auto& s = slot( h.index );
+        return s.state == SlotState::Live && s.generation == h.generation;
+    }
+
+    // Unsubscribes, destroys the callback and releases the slot
+    void destroy( uint32_t idx )
+    {
+        auto& s = slot( idx );
+        unsubscribe( s );
+        s.destroy( s );
+        s.destroy = nullptr;
+        s.flush = nullptr;
+        if ( s.state == SlotState::Live )
+            bumpGeneration( s );
+        release( idx );
+    }
+
+    void purgeZombies()
+    {
+        m_hasZombies = false;
+        for ( auto i = 0u; i < capacity(); ++i )
+        {
+            if ( slot( i ).state == SlotState::Zombie )
+                destroy( i );
+        }
+    }
+
+    Slot& slot( uint32_t idx )
+    {
+        return m_chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    const Slot& slot( uint32_t idx ) const
+    {
+        return m_chunks[idx / ChunkSize][idx % ChunkSize];
+    }
+
+    uint32_t acquire()
+    {
+        if ( m_freeHead == InvalidIndex )
+            grow();
+        auto idx = m_freeHead;
+        m_freeHead = slot( idx ).nextFree;
+        return idx;
+    }
+
+    static void bumpGeneration( Slot& s )
+    {
+        // Invalidate any outstanding handle to this slot. 0 is never used as a
+        // valid generation, so that a zero-initialized handle is always stale.
+        if ( ++s.generation == 0 )
+            s.generation = 1;
+    }
+
+    void release( uint32_t idx )
+    {
+        auto& s = slot( idx );
+        s.state = SlotState::Free;
+        s.nextFree = m_freeHead;
+        m_freeHead = idx;
+    }
+
+    void grow()
+    {
+        auto first = static_cast<uint32_t>( capacity() );
+        std::unique_ptr<Slot[]> chunk( new Slot[ChunkSize] );
+        for ( auto i = 0u; i < ChunkSize; ++i )
+        {
+            chunk[i].callback = nullptr;
+            chunk[i].destroy = nullptr;
+            chunk[i].flush = nullptr;
+            chunk[i].channel = nullptr;
+            chunk[i].position = 0;
+            chunk[i].generation = 1;
+            chunk[i].nextFree = i + 1 < ChunkSize ? first + i + 1 : m_freeHead;
+            chunk[i].state = SlotState::Free;
+            chunk[i].running.store( 0, std::memory_order_relaxed );
+        }
+        m_chunks.push_back( std::move( chunk ) );
+        m_freeHead = first;
+    }
+
+private:
+    libvlc_event_manager_t* m_em;
+    const libvlc_event_e* m_flushEvents;
+    size_t m_nbFlushEvents;
+    // Recursive, as callbacks may unregister handlers when destroyed. Not a
+    // std::mutex, which MinGW's win32 thread model lacks.
+    mutable SpinLock m_lock;
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    // Channels are never released before the store, as libvlc might hold
+    // a pointer to them until they get detached.
+    std::vector<std::unique_ptr<Channel>> m_channels;
+    uint32_t m_freeHead;
+    size_t m_size;
+    // Number of subscribed coalescing callbacks
+    size_t m_nbCoalescing;
+    // Number of dispatches in progress, on all threads
+    unsigned int m_dispatchDepth;
+    bool m_hasZombies;
+    // Number of remove() calls waiting for a handler to return
+    unsigned int m_waiters;
+    // Bumped by each removal, so that dispatches only check the liveness of
+    // the handlers they run when needed
+    std::atomic<uint32_t> m_removals;
+};
+
+} // namespace detail
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_EVENTHANDLERSTORE_H
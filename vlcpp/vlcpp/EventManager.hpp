@@ -26,10 +26,10 @@
 #include <string>
 
 #include "common.hpp"
+#include "EventHandlerStore.hpp"
 #include "Internal.hpp"
 #include "Media.hpp"
 
-#include <algorithm>
 #include <functional>
 #include <vector>
 #include <memory>
@@ -52,66 +52,74 @@ protected:
     template <typename T>
     using DecayPtr = typename std::add_pointer<typename std::decay<T>::type>::type;
 
-private:
-    // Polymorphic base to hold a templated implementation
-    struct EventHandlerBase
+    using Wrapper = detail::EventHandlerStore::Wrapper;
+
+public:
+    /**
+     * @brief The RegisteredEvent class is a lightweight handle to a registered event handler.
+     *
+     * It can be freely copied, and remains safe to use after the handler it
+     * refers to has been unregistered: unregistering a stale handle is a no-op.
+     * It is assumed that the EventManager which returned this handle outlives it.
+     */
+    class RegisteredEvent
     {
-        using Wrapper = std::add_pointer<void(const libvlc_event_t*, void*)>::type;
-        virtual ~EventHandlerBase() = default;
+    public:
+        RegisteredEvent()
+            : m_store( nullptr )
+            , m_handle{ detail::EventHandlerStore::InvalidIndex, 0 }
+        {
+        }
+
         /**
          * @brief unregister Unregister this event handler.
          *
-         * Calling this method makes the instance invalid.
+         * Calling this method more than once, or on a handle for which the
+         * handler was already unregistered, has no effect.
          */
-        virtual void unregister() = 0;
-    };
+        void unregister() const
+        {
+            if ( m_store != nullptr )
+                m_store->remove( m_handle );
+        }
 
-    template <typename Func>
-    class EventHandler : public EventHandlerBase
-    {
-    public:
-        // We have to re-declare a template type, otherwise userCallback wouldn't be a forwarding reference
-        // Not doing so works since EventHandler is instantiated with a perfect forwarded type, so Func type
-        // will be a reference-less type if the callback was an lvalue, and an lvalue if the callback was an lvalue
-        // As described here: http://stackoverflow.com/questions/24497311/is-this-a-universal-reference-does-stdforward-make-sense-here
-        // this would still make sense, in a perverted kind of way.
-        template <typename FuncTpl>
-        EventHandler(EventManager& em, libvlc_event_e eventType, FuncTpl&& userCallback, Wrapper wrapper)
-            : m_userCallback( std::forward<Func>(userCallback) )
-            , m_eventManager(&em)
-            , m_wrapper(wrapper)
-            , m_eventType( eventType )
+        /**
+         * @brief isRegistered returns true if the handler is still registered
+         */
+        bool isRegistered() const
         {
-            static_assert(std::is_same<typename std::decay<Func>::type,
-                                        typename std::decay<FuncTpl>::type>::value, "");
-            if (libvlc_event_attach( *m_eventManager, m_eventType, m_wrapper, &m_userCallback ) != 0)
-                throw std::bad_alloc();
+            return m_store != nullptr && m_store->isRegistered( m_handle );
         }
 
-        ~EventHandler()
+        // Allows the historical pointer-like syntax: handler->unregister()
+        const RegisteredEvent* operator->() const
         {
-            // We unregister only when the object actually goes out of scope, IE. when it is
-            // removed from EventManager's event handler vector
-            libvlc_event_detach( *m_eventManager, m_eventType, m_wrapper, &m_userCallback );
+            return this;
         }
 
-        virtual void unregister() override
+        bool operator==( const RegisteredEvent& other ) const
         {
-            m_eventManager->unregister(this);
+            return m_store == other.m_store &&
+                    m_handle.index == other.m_handle.index &&
+                    m_handle.generation == other.m_handle.generation;
         }
 
-        EventHandler(const EventHandler&) = delete;
-        EventHandler& operator=( const EventHandler& ) = delete;
+        bool operator!=( const RegisteredEvent& other ) const
+        {
+            return !( *this == other );
+        }
 
     private:
-        // Deduced type is Func& in case of lvalue; Func in case of rvalue.
-        // We decay the type to ensure we either copy or take ownership.
-        // Taking a reference would quite likely lead to unexpected behavior
-        typename std::decay<Func>::type m_userCallback;
-        // EventManager always outlive EventHandler, no need for smart pointer
-        EventManager* m_eventManager;
-        Wrapper m_wrapper;
-        libvlc_event_e m_eventType;
+        RegisteredEvent( detail::EventHandlerStore* store, detail::EventHandlerStore::Handle handle )
+            : m_store( store )
+            , m_handle( handle )
+        {
+        }
+
+        detail::EventHandlerStore* m_store;
+        detail::EventHandlerStore::Handle m_handle;
+
+        friend class EventManager;
     };
 
 private:
@@ -122,15 +130,11 @@ public:
     template <typename T, typename... Args>
     void unregister(const T e, const Args... args)
     {
-        static_assert(std::is_convertible<decltype(e), const EventHandlerBase*>::value, "Expected const RegisteredEvent");
+        static_assert(std::is_convertible<decltype(e), const RegisteredEvent&>::value, "Expected const RegisteredEvent");
 
-        {
-            auto it = std::find_if(begin(m_lambdas), end(m_lambdas), [&e](typename decltype(m_lambdas)::value_type &value) {
-                return e == value.get();
-            });
-            if (it != end(m_lambdas))
-                m_lambdas.erase( it );
-        }
+        // Only unregister handlers which were registered through this instance
+        if ( m_handlers != nullptr && e.m_store == m_handlers.get() )
+            m_handlers->remove( e.m_handle );
 
         unregister(args...);
     }
@@ -138,6 +142,22 @@ public:
 protected:
     EventManager(InternalPtr ptr)
         : Internal{ ptr, [](InternalPtr){ /* No-op; EventManager's are handled by their respective objects */ } }
+        , m_flushEvents( nullptr )
+        , m_nbFlushEvents( 0 )
+    {
+    }
+
+    /**
+     * @brief EventManager Wraps an event manager which flushes coalesced events
+     * @param flushEvents   The events before which the handlers wrapped with
+     *                      VLC::coalesce() get flushed. The array must have a
+     *                      static storage duration.
+     * @param nbFlushEvents The number of elements in flushEvents
+     */
+    EventManager(InternalPtr ptr, const libvlc_event_e* flushEvents, size_t nbFlushEvents)
+        : Internal{ ptr, [](InternalPtr){ /* No-op; EventManager's are handled by their respective objects */ } }
+        , m_flushEvents( flushEvents )
+        , m_nbFlushEvents( nbFlushEvents )
     {
     }
 
@@ -152,6 +172,8 @@ public:
      */
     EventManager(const EventManager& em)
         : Internal( em )
+        , m_flushEvents( em.m_flushEvents )
+        , m_nbFlushEvents( em.m_nbFlushEvents )
     {
         // Don't rely on the default implementation, as we don't want to copy the
         // current list of events.
@@ -171,6 +193,8 @@ public:
         if (this == &em)
             return *this;
         Internal::operator=(em);
+        m_flushEvents = em.m_flushEvents;
+        m_nbFlushEvents = em.m_nbFlushEvents;
         return *this;
     }
 
@@ -180,7 +204,9 @@ public:
 #else
     EventManager(EventManager&& em)
         : Internal( std::move( em ) )
-        , m_lambdas(std::move( em.m_lambdas ) )
+        , m_handlers(std::move( em.m_handlers ) )
+        , m_flushEvents( em.m_flushEvents )
+        , m_nbFlushEvents( em.m_nbFlushEvents )
     {
     }
 
@@ -189,12 +215,12 @@ public:
         if ( this == &em )
             return *this;
         Internal::operator=( std::move( em ) );
-        m_lambdas = std::move( em.m_lambdas );
+        m_handlers = std::move( em.m_handlers );
+        m_flushEvents = em.m_flushEvents;
+        m_nbFlushEvents = em.m_nbFlushEvents;
     }
 #endif
 
-    using RegisteredEvent = EventHandlerBase*;
-
 protected:
 
     /**
@@ -205,20 +231,19 @@ protected:
      * @param wrapper       Our implementation defined wrapper around the user's callback. It is expected to be able
      *                      able to decay to a regular C-style function pointer. It is currently implemented as a
      *                      captureless lambda (§5.1.2)
-     * @return              A pointer to an abstract EventHandler type. It is assumed that the EventManager will
-     *                      outlive this reference. When EventManager::~EventManager is called, it will destroy all
-     *                      the registered event handler, this making this reference a dangling reference, which is
-     *                      undefined behavior.
-     *                      When calling unregister() on this object, the pointer should immediatly be considered invalid.
+     * @return              A handle to the registered event handler. It is assumed that the EventManager will
+     *                      outlive this handle. When EventManager::~EventManager is called, it will destroy all
+     *                      the registered event handler, and using the handle afterward is undefined behavior.
+     *                      Once the handler has been unregistered, the handle becomes stale, and any further
+     *                      attempt to unregister it is ignored.
      */
     template <typename Func>
-    RegisteredEvent handle(libvlc_event_e eventType, Func&& f, EventHandlerBase::Wrapper wrapper)
+    RegisteredEvent handle(libvlc_event_e eventType, Func&& f, Wrapper wrapper)
     {
-        auto ptr = std::unique_ptr<EventHandlerBase>( new EventHandler<Func>(
-                                *this, eventType, std::forward<Func>( f ), wrapper ) );
-        auto raw = ptr.get();
-        m_lambdas.push_back( std::move( ptr ) );
-        return raw;
+        if ( m_handlers == nullptr )
+            m_handlers.reset( new detail::EventHandlerStore( *this, m_flushEvents, m_nbFlushEvents ) );
+        auto h = m_handlers->add( eventType, std::forward<Func>( f ), wrapper );
+        return RegisteredEvent{ m_handlers.get(), h };
     }
 
     template <typename Func>
@@ -232,10 +257,40 @@ protected:
         });
     }
 
+public:
+    /**
+     * @brief flush Delivers the pending value of all the handlers wrapped with
+     *              VLC::coalesce(), registered through this instance.
+     *
+     * This is done automatically before the state transitions of the object
+     * emitting the events are dispatched.
+     */
+    void flush()
+    {
+        if ( m_handlers != nullptr )
+            m_handlers->flush();
+    }
+
+protected:
+    /**
+     * @brief clearHandlers Unregisters all the handlers registered through this instance
+     */
+    void clearHandlers()
+    {
+        if ( m_handlers != nullptr )
+            m_handlers->clear();
+    }
+
 protected:
-    // We store the EventHandlerBase's as unique_ptr in order for the function stored within
-    // EventHandler<T> not to move to another memory location
-    std::vector<std::unique_ptr<EventHandlerBase>> m_lambdas;
+    // The store is only allocated once an event gets registered, so that
+    // copying an EventManager for a punctual task stays cheap.
+    // It is held by pointer, as the handlers must not move to another memory
+    // location when this instance is moved.
+    std::unique_ptr<detail::EventHandlerStore> m_handlers;
+
+private:
+    const libvlc_event_e* m_flushEvents;
+    size_t m_nbFlushEvents;
 };
 
 /**
@@ -260,7 +315,7 @@ class MediaEventManager : public EventManager
         ~MediaEventManager()
         {
             // Clear the events as long as the underlying VLC object is alive
-            m_lambdas.clear();
+            clearHandlers();
         }
 
         /**
@@ -444,15 +499,39 @@ class MediaPlayerEventManager : public EventManager
 {
     private:
         MediaPlayer m_mp;
+
+        static constexpr size_t NbFlushEvents = 5;
+
+        // The state transitions before which coalesced handlers get flushed
+        static const libvlc_event_e* flushEvents()
+        {
+            static const libvlc_event_e events[] = {
+                libvlc_MediaPlayerMediaChanged,
+                libvlc_MediaPlayerPaused,
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+                libvlc_MediaPlayerStopping,
+#else
+                libvlc_MediaPlayerEndReached,
+#endif
+                libvlc_MediaPlayerStopped,
+                libvlc_MediaPlayerEncounteredError,
+            };
+            static_assert( sizeof(events) / sizeof(events[0]) == NbFlushEvents,
+                           "Invalid number of flush events" );
+            static_assert( NbFlushEvents <= detail::EventHandlerStore::MaxFlushEvents,
+                           "Too many flush events" );
+            return events;
+        }
+
     public:
         MediaPlayerEventManager(InternalPtr ptr, MediaPlayer mp)
-            : EventManager( ptr )
+            : EventManager( ptr, flushEvents(), NbFlushEvents )
             , m_mp( std::move( mp ) )
         {
         }
         ~MediaPlayerEventManager()
         {
-            m_lambdas.clear();
+            clearHandlers();
         }
 
         /**
@@ -992,7 +1071,7 @@ class MediaListEventManager : public EventManager
         }
         ~MediaListEventManager()
         {
-            m_lambdas.clear();
+            clearHandlers();
         }
 
         /**
@@ -1088,15 +1167,30 @@ class MediaListPlayerEventManager : public EventManager
 {
     private:
         MediaListPlayer m_mlp;
+
+        static constexpr size_t NbFlushEvents = 2;
+
+        // The state transitions before which coalesced handlers get flushed
+        static const libvlc_event_e* flushEvents()
+        {
+            static const libvlc_event_e events[] = {
+                libvlc_MediaListPlayerNextItemSet,
+                libvlc_MediaListPlayerStopped,
+            };
+            static_assert( sizeof(events) / sizeof(events[0]) == NbFlushEvents,
+                           "Invalid number of flush events" );
+            return events;
+        }
+
     public:
         MediaListPlayerEventManager(InternalPtr ptr, MediaListPlayer mlp)
-            : EventManager( ptr )
+            : EventManager( ptr, flushEvents(), NbFlushEvents )
             , m_mlp( std::move( mlp ) )
         {
         }
         ~MediaListPlayerEventManager()
         {
-            m_lambdas.clear();
+            clearHandlers();
         }
 
         template <typename Func>
@@ -1173,7 +1267,7 @@ public:
     }
     ~RendererDiscovererEventManager()
     {
-        m_lambdas.clear();
+        clearHandlers();
     }
 
     template <typename Func>
@@ -0,0 +1,383 @@
+/*****************************************************************************
+ * EventTracer.hpp: Event dispatch timings tracing
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_EVENTTRACER_H
+#define LIBVLC_CXX_EVENTTRACER_H
+
+#include <vlc/vlc.h>
+
+/*
+ * Event tracing is disabled by default. Define LIBVLCPP_EVENT_TRACING before
+ * including any libvlcpp header to enable it. When disabled, the tracing
+ * hooks are empty and no tracing state exists.
+ */
+#if defined(LIBVLCPP_EVENT_TRACING)
+
+#include "LatencyHistogram.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The EventTracer class collects the dispatch timings of all the events
+///        going through the EventManagers of the process.
+///
+/// For each event type, it keeps histograms of:
+/// - the dispatch overhead: the delay between libvlc invoking our trampoline
+///   and a handler being invoked. This includes waiting for the handlers lock,
+///   and for the previous subscribers of the same event.
+/// - the handler duration.
+/// The last events are also kept in a ring buffer, with their timestamps.
+///
+/// This isn't the end to end latency of the events: libvlc doesn't timestamp
+/// them, so the time between the event being raised and libvlc invoking the
+/// trampoline isn't measured. This gap includes libvlc's own event lock and
+/// the listeners it invokes before ours, usually a few microseconds, and
+/// whatever delayed the raising thread itself.
+///
+/// Tracing is only available when LIBVLCPP_EVENT_TRACING is defined.
+///
+class EventTracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Number of records kept in the ring buffer
+    static constexpr size_t RingSize = 4096;
+
+    struct Record
+    {
+        libvlc_event_e eventType;
+        /// Time at which the handler was invoked, since the tracer creation
+        uint64_t timestamp;
+        /// Time from the trampoline entry to the handler invocation
+        uint64_t overhead;
+        uint64_t duration;
+    };
+
+    struct EventStats
+    {
+        libvlc_event_e eventType;
+        LatencyHistogram overhead;
+        LatencyHistogram duration;
+    };
+
+    enum class Format
+    {
+        Text,
+        Json,
+    };
+
+    static EventTracer& instance()
+    {
+        static EventTracer tracer;
+        return tracer;
+    }
+
+    EventTracer( const EventTracer& ) = delete;
+    EventTracer& operator=( const EventTracer& ) = delete;
+
+    ~EventTracer()
+    {
+        for ( auto& s : m_stats )
+            delete s.load( std::memory_order_relaxed );
+    }
+
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    Clock::now() - m_epoch ).count() );
+    }
+
+    ///
+    /// \brief record Records a handler invocation
+    /// \param eventType    The dispatched event
+    /// \param entered      The time at which libvlc invoked the trampoline
+    /// \param start        The time at which the handler was invoked
+    /// \param end          The time at which the handler returned
+    ///
+    void record( libvlc_event_e eventType, uint64_t entered, uint64_t start, uint64_t end )
+    {
+        auto s = stats( eventType );
+        if ( s != nullptr )
+        {
+            s->overhead.record( start - entered );
+            s->duration.record( end - start );
+        }
+        // Seqlock-like protocol: odd sequence numbers denote a record being written
+        auto pos = m_ringPos.fetch_add( 1, std::memory_order_relaxed );
+        auto& r = m_ring[pos % RingSize];
+        r.sequence.store( pos * 2 + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        r.eventType.store( eventType, std::memory_order_relaxed );
+        r.timestamp.store( start, std::memory_order_relaxed );
+        r.overhead.store( start - entered, std::memory_order_relaxed );
+        r.duration.store( end - start, std::memory_order_relaxed );
+        r.sequence.store( pos * 2 + 2, std::memory_order_release );
+    }
+
+    ///
+    /// \brief recentEvents Returns the last recorded events, oldest first
+    ///
+    /// Records being written concurrently are skipped.
+    ///
+    std::vector<Record> recentEvents() const
+    {
+        std::vector<Record> res;
+        auto end = m_ringPos.load( std::memory_order_acquire );
+        auto begin = end > RingSize ? end - RingSize : 0;
+        res.reserve( end - begin );
+        for ( auto pos = begin; pos < end; ++pos )
+        {
+            const auto& r = m_ring[pos % RingSize];
+            auto seq = r.sequence.load( std::memory_order_acquire );
+            if ( seq != pos * 2 + 2 )
+                continue;
+            Record rec{ static_cast<libvlc_event_e>( r.eventType.load( std::memory_order_relaxed ) ),
+                        r.timestamp.load( std::memory_order_relaxed ),
+                        r.overhead.load( std::memory_order_relaxed ),
+                        r.duration.load( std::memory_order_relaxed ) };
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( r.sequence.load( std::memory_order_relaxed ) != seq )
+                continue;
+            res.push_back( rec );
+        }
+        return res;
+    }
+
+    ///
+    /// \brief eventStats Returns the statistics for the given event type, or
+    ///                   nullptr if this event was never dispatched.
+    ///
+    const EventStats* eventStats( libvlc_event_e eventType ) const
+    {
+        auto idx = index( eventType );
+        if ( idx >= NbEventTypes )
+            return nullptr;
+        return m_stats[idx].load( std::memory_order_acquire );
+    }
+
+    ///
+    /// \brief reset Clears the histograms and the ring buffer
+    ///
+    /// Events recorded concurrently may be partially accounted for.
+    ///
+    void reset()
+    {
+        for ( auto& s : m_stats )
+        {
+            auto p = s.load( std::memory_order_acquire );
+            if ( p == nullptr )
+                continue;
+            p->overhead.reset();
+            p->duration.reset();
+        }
+        for ( auto& r : m_ring )
+            r.sequence.store( 0, std::memory_order_relaxed );
+        m_ringPos.store( 0, std::memory_order_release );
+    }
+
+    ///
+    /// \brief dump Writes the statistics of each traced event type
+    ///
+    /// Durations are expressed in nanoseconds.
+    ///
+    void dump( std::ostream& os, Format format = Format::Text ) const
+    {
+        static const double Percentiles[] = { 50., 90., 99., 99.9 };
+        static const char* PercentileNames[] = { "p50", "p90", "p99", "p999" };
+
+        auto writeHistogram = [&os, format]( const char* name, const LatencyHistogram& h ) {
+            if ( format == Format::Json )
+            {
+                os << '"' << name << "\":{\"count\":" << h.count()
+                   << ",\"mean\":" << static_cast<uint64_t>( h.mean() );
+                for ( auto i = 0u; i < 4; ++i )
+                    os << ",\"" << PercentileNames[i] << "\":" << h.percentile( Percentiles[i] );
+                os << ",\"max\":" << h.max() << '}';
+            }
+            else
+            {
+                os << "  " << std::left << std::setw( 10 ) << name << std::right
+                   << " count " << h.count() << " mean " << static_cast<uint64_t>( h.mean() );
+                for ( auto i = 0u; i < 4; ++i )
+                    os << ' ' << PercentileNames[i] << ' ' << h.percentile( Percentiles[i] );
+                os << " max " << h.max() << '\n';
+            }
+        };
+
+        if ( format == Format::Json )
+            os << "{\"events\":[";
+        auto first = true;
+        for ( const auto& slot : m_stats )
+        {
+            auto s = slot.load( std::memory_order_acquire );
+            if ( s == nullptr )
+                continue;
+            if ( format == Format::Json )
+            {
+                if ( first == false )
+                    os << ',';
+                os << "{\"type\":" << static_cast<int>( s->eventType ) << ',';
+                writeHistogram( "overhead", s->overhead );
+                os << ',';
+                writeHistogram( "duration", s->duration );
+                os << '}';
+            }
+            else
+            {
+                os << "event 0x" << std::hex << static_cast<int>( s->eventType )
+                   << std::dec << " (ns)\n";
+                writeHistogram( "overhead", s->overhead );
+                writeHistogram( "duration", s->duration );
+            }
+            first = false;
+        }
+        if ( format == Format::Json )
+            os << "]}\n";
+    }
+
+private:
+    // libvlc event types are grouped by object type, with a 0x100 stride
+    static constexpr size_t NbGroups = 8;
+    static constexpr size_t GroupSize = 64;
+    static constexpr size_t NbEventTypes = NbGroups * GroupSize;
+
+    struct RingRecord
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<int> eventType;
+        std::atomic<uint64_t> timestamp;
+        std::atomic<uint64_t> overhead;
+        std::atomic<uint64_t> duration;
+    };
+
+    EventTracer()
+        : m_epoch( Clock::now() )
+        , m_ringPos( 0 )
+    {
+        for ( auto& s : m_stats )
+            s.store( nullptr, std::memory_order_relaxed );
+        for ( auto& r : m_ring )
+            r.sequence.store( 0, std::memory_order_relaxed );
+    }
+
+    static size_t index( libvlc_event_e eventType )
+    {
+        auto group = static_cast<size_t>( eventType ) >> 8;
+        auto idx = static_cast<size_t>( eventType ) & 0xff;
+        if ( group >= NbGroups || idx >= GroupSize )
+            return NbEventTypes;
+        return group * GroupSize + idx;
+    }
+
+    EventStats* stats( libvlc_event_e eventType )
+    {
+        auto idx = index( eventType );
+        if ( idx >= NbEventTypes )
+            return nullptr;
+        auto s = m_stats[idx].load( std::memory_order_acquire );
+        if ( s != nullptr )
+            return s;
+        // First occurrence of this event type. Another thread may be racing
+        // with us, in which case we use its instance.
+        auto newStats = new EventStats;
+        newStats->eventType = eventType;
+        if ( m_stats[idx].compare_exchange_strong( s, newStats, std::memory_order_acq_rel ) == false )
+        {
+            delete newStats;
+            return s;
+        }
+        return newStats;
+    }
+
+private:
+    const Clock::time_point m_epoch;
+    std::atomic<EventStats*> m_stats[NbEventTypes];
+    std::atomic<uint64_t> m_ringPos;
+    RingRecord m_ring[RingSize];
+};
+
+namespace detail
+{
+
+// Measures a single dispatch of an event to its subscribers. Create it first
+// thing in the trampoline, as the overhead is counted from there.
+class DispatchTrace
+{
+public:
+    explicit DispatchTrace( libvlc_event_e eventType )
+        : m_tracer( EventTracer::instance() )
+        , m_eventType( eventType )
+        , m_entered( m_tracer.now() )
+        , m_start( 0 )
+    {
+    }
+
+    void beginHandler()
+    {
+        m_start = m_tracer.now();
+    }
+
+    void endHandler()
+    {
+        m_tracer.record( m_eventType, m_entered, m_start, m_tracer.now() );
+    }
+
+private:
+    EventTracer& m_tracer;
+    libvlc_event_e m_eventType;
+    uint64_t m_entered;
+    uint64_t m_start;
+};
+
+} // namespace detail
+
+} // namespace VLC
+
+#else
+
+namespace VLC
+{
+namespace detail
+{
+
+class DispatchTrace
+{
+public:
+    explicit DispatchTrace( libvlc_event_e ) {}
+    void beginHandler() {}
+    void endHandler() {}
+};
+
+} // namespace detail
+} // namespace VLC
+
+#endif // LIBVLCPP_EVENT_TRACING
+
+#endif // LIBVLC_CXX_EVENTTRACER_H
@@ -0,0 +1,821 @@
+/*****************************************************************************
+ * FrameFanout.hpp: Multi resolution outputs from a single video decode
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_FRAMEFANOUT_H
+#define LIBVLC_CXX_FRAMEFANOUT_H
+
+#include "ChromaConverter.hpp"
+#include "FramePool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+namespace scale
+{
+
+///
+/// \brief The PlaneView struct points to a plane of 8 bits samples.
+///        The width is in pixels, each made of a number of components.
+///
+struct PlaneView
+{
+    uint8_t* data;
+    size_t pitch;
+    unsigned width;
+    unsigned height;
+
+    uint8_t* row( unsigned y ) const
+    {
+        return data + y * pitch;
+    }
+};
+
+/// A bilinear tap, with a weight in 1/128th
+struct Tap
+{
+    unsigned i0;
+    unsigned i1;
+    unsigned w;
+};
+
+inline std::vector<Tap> computeTaps( unsigned srcSize, unsigned dstSize )
+{
+    std::vector<Tap> taps( dstSize );
+    for ( auto i = 0u; i < dstSize; ++i )
+    {
+        // Align the pixels centers: ( i + 0.5 ) * src / dst - 0.5
+        auto pos = static_cast<int64_t>( ( 2 * i + 1 ) * uint64_t{ srcSize } * 128 / ( 2 * dstSize ) ) - 64;
+        if ( pos < 0 )
+            pos = 0;
+        auto& t = taps[i];
+        t.i0 = static_cast<unsigned>( pos >> 7 );
+        t.w = static_cast<unsigned>( pos & 127 );
+        if ( t.i0 >= srcSize - 1 )
+        {
+            t.i0 = srcSize - 1;
+            t.w = 0;
+        }
+        t.i1 = t.w != 0 ? t.i0 + 1 : t.i0;
+    }
+    return taps;
+}
+
+struct Scalar
+{
+    /// Averages 2x2 blocks of pixels of r0 & r1. The last column is
+    /// duplicated when the source width is odd.
+    template <unsigned C>
+    static void halveRowTail( const uint8_t* r0, const uint8_t* r1, uint8_t* dst,
+                              unsigned start, unsigned dstWidth, unsigned srcWidth )
+    {
+        for ( auto x = start; x < dstWidth; ++x )
+        {
+            auto x0 = 2 * x * C;
+            auto x1 = std::min( 2 * x + 1, srcWidth - 1 ) * C;
+            for ( auto k = 0u; k < C; ++k )
+                dst[x * C + k] = static_cast<uint8_t>(
+                        ( r0[x0 + k] + r0[x1 + k] + r1[x0 + k] + r1[x1 + k] + 2 ) >> 2 );
+        }
+    }
+
+    template <unsigned C>
+    static void halveRow( const uint8_t* r0, const uint8_t* r1, uint8_t* dst,
+                          unsigned dstWidth, unsigned srcWidth )
+    {
+        halveRowTail<C>( r0, r1, dst, 0, dstWidth, srcWidth );
+    }
+
+    static void blendRowsTail( const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                               unsigned start, unsigned nbBytes, unsigned w )
+    {
+        for ( auto i = start; i < nbBytes; ++i )
+            dst[i] = static_cast<uint8_t>( ( a[i] * ( 128 - w ) + b[i] * w + 64 ) >> 7 );
+    }
+
+    /// dst = a * ( 128 - w ) / 128 + b * w / 128, rounded
+    static void blendRows( const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                           unsigned nbBytes, unsigned w )
+    {
+        blendRowsTail( a, b, dst, 0, nbBytes, w );
+    }
+};
+
+#if defined(LIBVLCPP_CHROMA_X86)
+
+struct Sse2
+{
+    // Sums the even & odd pixels of a & b, which hold 16 bits components.
+    // The result holds the pixels of a then the ones of b.
+    LIBVLCPP_TARGET_SSE2 static __m128i pairSums( std::integral_constant<unsigned, 1>, __m128i a, __m128i b )
+    {
+        auto one = _mm_set1_epi16( 1 );
+        return _mm_packs_epi32( _mm_madd_epi16( a, one ), _mm_madd_epi16( b, one ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static __m128i pairSums( std::integral_constant<unsigned, 2>, __m128i a, __m128i b )
+    {
+        // ( p0 p2 p1 p3 ): the even pixels in the low half, the odd ones in the high half
+        auto sa = _mm_shuffle_epi32( a, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+        auto sb = _mm_shuffle_epi32( b, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+        return _mm_add_epi16( _mm_unpacklo_epi64( sa, sb ), _mm_unpackhi_epi64( sa, sb ) );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static __m128i pairSums( std::integral_constant<unsigned, 4>, __m128i a, __m128i b )
+    {
+        return _mm_add_epi16( _mm_unpacklo_epi64( a, b ), _mm_unpackhi_epi64( a, b ) );
+    }
+
+    template <unsigned C>
+    LIBVLCPP_TARGET_SSE2 static void halveRow( const uint8_t* r0, const uint8_t* r1, uint8_t* dst,
+                                               unsigned dstWidth, unsigned srcWidth )
+    {
+        // 16 source bytes give 8 destination bytes
+        const auto step = 8 / C;
+        auto zero = _mm_setzero_si128();
+        auto two = _mm_set1_epi16( 2 );
+        auto x = 0u;
+        for ( ; x + step <= dstWidth && 2 * ( x + step ) <= srcWidth; x += step )
+        {
+            auto a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( r0 + 2 * x * C ) );
+            auto b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( r1 + 2 * x * C ) );
+            auto lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+            auto hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+            auto s = _mm_srli_epi16( _mm_add_epi16( pairSums( std::integral_constant<unsigned, C>{}, lo, hi ), two ), 2 );
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + x * C ), _mm_packus_epi16( s, s ) );
+        }
+        Scalar::halveRowTail<C>( r0, r1, dst, x, dstWidth, srcWidth );
+    }
+
+    LIBVLCPP_TARGET_SSE2 static void blendRows( const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                                                unsigned nbBytes, unsigned w )
+    {
+        auto zero = _mm_setzero_si128();
+        auto wa = _mm_set1_epi16( static_cast<short>( 128 - w ) );
+        auto wb = _mm_set1_epi16( static_cast<short>( w ) );
+        auto round = _mm_set1_epi16( 64 );
+        auto i = 0u;
+        for ( ; i + 16 <= nbBytes; i += 16 )
+        {
+            auto va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + i ) );
+            auto vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + i ) );
+            auto lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( va, zero ), wa ),
+                                     _mm_mullo_epi16( _mm_unpacklo_epi8( vb, zero ), wb ) );
+            auto hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( va, zero ), wa ),
+                                     _mm_mullo_epi16( _mm_unpackhi_epi8( vb, zero ), wb ) );
+            lo = _mm_srli_epi16( _mm_add_epi16( lo, round ), 7 );
+            hi = _mm_srli_epi16( _mm_add_epi16( hi, round ), 7 );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packus_epi16( lo, hi ) );
+        }
+        Scalar::blendRowsTail( a, b, dst, i, nbBytes, w );
+    }
+};
+
+using Simd = Sse2;
+
+#elif defined(LIBVLCPP_CHROMA_NEON)
+
+struct Neon
+{
+    static uint16x8_t pairSums( std::integral_constant<unsigned, 1>, uint16x8_t a, uint16x8_t b )
+    {
+        auto p = vuzpq_u16( a, b );
+        return vaddq_u16( p.val[0], p.val[1] );
+    }
+
+    static uint16x8_t pairSums( std::integral_constant<unsigned, 2>, uint16x8_t a, uint16x8_t b )
+    {
+        auto p = vuzpq_u32( vreinterpretq_u32_u16( a ), vreinterpretq_u32_u16( b ) );
+        return vaddq_u16( vreinterpretq_u16_u32( p.val[0] ), vreinterpretq_u16_u32( p.val[1] ) );
+    }
+
+    static uint16x8_t pairSums( std::integral_constant<unsigned, 4>, uint16x8_t a, uint16x8_t b )
+    {
+        return vaddq_u16( vcombine_u16( vget_low_u16( a ), vget_low_u16( b ) ),
+                          vcombine_u16( vget_high_u16( a ), vget_high_u16( b ) ) );
+    }
+
+    template <unsigned C>
+    static void halveRow( const uint8_t* r0, const uint8_t* r1, uint8_t* dst,
+                          unsigned dstWidth, unsigned srcWidth )
+    {
+        const auto step = 8 / C;
+        auto x = 0u;
+        for ( ; x + step <= dstWidth && 2 * ( x + step ) <= srcWidth; x += step )
+        {
+            auto a = vld1q_u8( r0 + 2 * x * C );
+            auto b = vld1q_u8( r1 + 2 * x * C );
+            auto lo = vaddl_u8( vget_low_u8( a ), vget_low_u8( b ) );
+            auto hi = vaddl_u8( vget_high_u8( a ), vget_high_u8( b ) );
+            auto s = pairSums( std::integral_constant<unsigned, C>{}, lo, hi );
+            // ( s + 2 ) >> 2
+            vst1_u8( dst + x * C, vrshrn_n_u16( s, 2 ) );
+        }
+        Scalar::halveRowTail<C>( r0, r1, dst, x, dstWidth, srcWidth );
+    }
+
+    static void blendRows( const uint8_t* a, const uint8_t* b, uint8_t* dst,
+                           unsigned nbBytes, unsigned w )
+    {
+        auto wa = vdup_n_u8( static_cast<uint8_t>( 128 - w ) );
+        auto wb = vdup_n_u8( static_cast<uint8_t>( w ) );
+        auto i = 0u;
+        for ( ; i + 16 <= nbBytes; i += 16 )
+        {
+            auto va = vld1q_u8( a + i );
+            auto vb = vld1q_u8( b + i );
+            auto lo = vmlal_u8( vmull_u8( vget_low_u8( va ), wa ), vget_low_u8( vb ), wb );
+            auto hi = vmlal_u8( vmull_u8( vget_high_u8( va ), wa ), vget_high_u8( vb ), wb );
+            // ( x + 64 ) >> 7
+            vst1q_u8( dst + i, vcombine_u8( vrshrn_n_u16( lo, 7 ), vrshrn_n_u16( hi, 7 ) ) );
+        }
+        Scalar::blendRowsTail( a, b, dst, i, nbBytes, w );
+    }
+};
+
+using Simd = Neon;
+
+#else
+
+using Simd = Scalar;
+
+#endif
+
+///
+/// \brief halvePlane Downscales a plane by 2 in both directions, averaging
+///                   2x2 blocks. dst must be ( src + 1 ) / 2 in both
+///                   dimensions.
+///
+template <typename K>
+void halvePlane( const PlaneView& src, const PlaneView& dst, unsigned components )
+{
+    for ( auto y = 0u; y < dst.height; ++y )
+    {
+        auto r0 = src.row( 2 * y );
+        auto r1 = src.row( std::min( 2 * y + 1, src.height - 1 ) );
+        switch ( components )
+        {
+        case 1:
+            K::template halveRow<1>( r0, r1, dst.row( y ), dst.width, src.width );
+            break;
+        case 2:
+            K::template halveRow<2>( r0, r1, dst.row( y ), dst.width, src.width );
+            break;
+        default:
+            K::template halveRow<4>( r0, r1, dst.row( y ), dst.width, src.width );
+            break;
+        }
+    }
+}
+
+///
+/// \brief The Resampler class scales a plane to an arbitrary size, with a
+///        bilinear filter.
+///
+/// Each destination line is first blended from two source lines, with the
+/// SIMD kernels, then resampled horizontally through precomputed taps.
+///
+class Resampler
+{
+public:
+    Resampler( unsigned srcWidth, unsigned srcHeight, unsigned dstWidth,
+               unsigned dstHeight, unsigned components )
+        : m_components( components )
+        , m_hTaps( computeTaps( srcWidth, dstWidth ) )
+        , m_vTaps( computeTaps( srcHeight, dstHeight ) )
+        , m_line( srcWidth * components )
+    {
+    }
+
+    template <typename K>
+    void resample( const PlaneView& src, const PlaneView& dst )
+    {
+        auto lineSize = src.width * m_components;
+        for ( auto y = 0u; y < dst.height; ++y )
+        {
+            const auto& v = m_vTaps[y];
+            const uint8_t* line = src.row( v.i0 );
+            if ( v.w != 0 )
+            {
+                K::blendRows( src.row( v.i0 ), src.row( v.i1 ), m_line.data(), lineSize, v.w );
+                line = m_line.data();
+            }
+            auto out = dst.row( y );
+            for ( auto x = 0u; x < dst.width; ++x )
+            {
+                const auto& h = m_hTaps[x];
+                auto p0 = line + h.i0 * m_components;
+                auto p1 = line + h.i1 * m_components;
+                for ( auto k = 0u; k < m_components; ++k )
+                    *out++ = static_cast<uint8_t>( ( p0[k] * ( 128 - h.w ) + p1[k] * h.w + 64 ) >> 7 );
+            }
+        }
+    }
+
+private:
+    unsigned m_components;
+    std::vector<Tap> m_hTaps;
+    std::vector<Tap> m_vTaps;
+    std::vector<uint8_t> m_line;
+};
+
+inline void copyPlane( const PlaneView& src, const PlaneView& dst, unsigned components )
+{
+    for ( auto y = 0u; y < dst.height; ++y )
+        memcpy( dst.row( y ), src.row( y ), dst.width * components );
+}
+
+/// The planes of the chromas which can be scaled
+struct ChromaDesc
+{
+    struct Plane
+    {
+        uint8_t components;
+        uint8_t wDiv;
+        uint8_t hDiv;
+    };
+    char fourcc[5];
+    unsigned nbPlanes;
+    Plane planes[PictureLayout::MaxPlanes];
+};
+
+inline const ChromaDesc* describe( const char* fourcc )
+{
+    static const ChromaDesc chromas[] = {
+        { "RV32", 1, { { 4, 1, 1 } } },
+        { "RGBA", 1, { { 4, 1, 1 } } },
+        { "BGRA", 1, { { 4, 1, 1 } } },
+        { "ARGB", 1, { { 4, 1, 1 } } },
+        { "GREY", 1, { { 1, 1, 1 } } },
+        { "I420", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+        { "J420", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+        { "YV12", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+        { "I422", 3, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+        { "J422", 3, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+        { "I444", 3, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+        { "J444", 3, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+        { "NV12", 2, { { 1, 1, 1 }, { 2, 2, 2 } } },
+        { "NV21", 2, { { 1, 1, 1 }, { 2, 2, 2 } } },
+    };
+    for ( const auto& c : chromas )
+    {
+        if ( memcmp( c.fourcc, fourcc, 4 ) == 0 )
+            return &c;
+    }
+    return nullptr;
+}
+
+///
+/// \brief The Picture struct is a set of planes, with the dimensions of the
+///        picture as a whole
+///
+struct Picture
+{
+    unsigned width;
+    unsigned height;
+    PlaneView planes[PictureLayout::MaxPlanes];
+};
+
+} // namespace scale
+} // namespace detail
+
+///
+/// \brief The FrameFanout class decodes a stream once, and delivers it at
+///        several resolutions, each to its own frame pool & consumer.
+///
+/// The outputs are built as a pyramid: each output is computed from the
+/// smallest picture already available that is at least as large, either the
+/// decoded frame or a larger output. It is halved with a 2x2 box filter
+/// while possible, and the remaining factor is applied with a bilinear
+/// filter. Both steps use SIMD kernels (SSE2 or NEON).
+///
+/// The decoding cost doesn't depend on the number of outputs; each output
+/// only adds the cost of its downscaling, which runs on libvlc's display
+/// thread.
+/// Only 8 bits chromas can be scaled: RGB32 variants, GREY, and the planar
+/// and semi planar YUV ones.
+///
+class FrameFanout
+{
+public:
+    struct Output
+    {
+        Output()
+            : width( 0 )
+            , height( 0 )
+            , nbBuffers( 4 )
+        {
+        }
+
+        /// The output dimensions. When only one is set, the other one is
+        /// computed from the source aspect ratio.
+        unsigned width;
+        unsigned height;
+        /// The number of buffers of this output's pool
+        unsigned nbBuffers;
+        /// Invoked from libvlc's thread with each scaled frame
+        std::function<void(FramePool::Frame)> onFrame;
+    };
+
+    struct Configuration
+    {
+        /// The decoded frames pool. Its chroma & native chromas must be
+        /// scalable ones.
+        FramePool::Configuration source;
+        /// Invoked with the full resolution frames, after the outputs were
+        /// produced. Can be left empty.
+        std::function<void(FramePool::Frame)> onFrame;
+        std::vector<Output> outputs;
+    };
+
+private:
+    struct Stage
+    {
+        explicit Stage( unsigned idx )
+            : output( idx )
+            , base( 0 )
+            , picture()
+            , handle( nullptr )
+        {
+        }
+
+        /// The output index, in the configuration order
+        unsigned output;
+        /// Index of the picture to scale from: 0 for the source, i + 1 for
+        /// the i-th stage
+        unsigned base;
+        /// The intermediate halved pictures
+        std::vector<detail::scale::Picture> levels;
+        std::vector<std::vector<uint8_t>> levelBuffers;
+        std::vector<detail::scale::Resampler> resamplers;
+        detail::scale::Picture picture;
+        void* handle;
+    };
+
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_source( m_config.source )
+            , m_chroma( nullptr )
+        {
+            if ( m_config.outputs.empty() )
+                throw std::invalid_argument( "FrameFanout needs at least one output" );
+            if ( detail::scale::describe( m_config.source.chroma.c_str() ) == nullptr )
+                throw std::invalid_argument( "FrameFanout source chroma can't be scaled" );
+            for ( const auto& c : m_config.source.nativeChromas )
+            {
+                if ( c.size() != 4 || detail::scale::describe( c.c_str() ) == nullptr )
+                    throw std::invalid_argument( "FrameFanout native chromas must be scalable" );
+            }
+            m_outputs.reserve( m_config.outputs.size() );
+            for ( const auto& o : m_config.outputs )
+            {
+                if ( o.width == 0 && o.height == 0 )
+                    throw std::invalid_argument( "FrameFanout outputs need a width or a height" );
+                FramePool::Configuration c;
+                c.chroma = m_config.source.chroma;
+                c.nativeChromas = m_config.source.nativeChromas;
+                c.width = o.width;
+                c.height = o.height;
+                c.nbBuffers = o.nbBuffers;
+                m_outputs.emplace_back( std::move( c ) );
+                m_outputs.back().setFrameCallback( o.onFrame );
+            }
+            m_source.setFrameCallback( [this]( FramePool::Frame f ) { process( std::move( f ) ); } );
+        }
+
+        uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                        uint32_t* pitches, uint32_t* lines )
+        {
+            auto nb = m_source.setup( chroma, width, height, pitches, lines );
+            if ( nb == 0 )
+                return 0;
+            m_chroma = detail::scale::describe( chroma );
+            m_width = *width;
+            m_height = *height;
+            m_stages.clear();
+            for ( auto i = 0u; i < m_outputs.size(); ++i )
+            {
+                Stage s( i );
+                char outChroma[5];
+                memcpy( outChroma, chroma, 5 );
+                uint32_t w = m_width, h = m_height;
+                uint32_t outPitches[PictureLayout::MaxPlanes], outLines[PictureLayout::MaxPlanes];
+                // The output pools are driven just like libvlc would
+                if ( m_outputs[i].setup( outChroma, &w, &h, outPitches, outLines ) == 0 )
+                    return 0;
+                s.picture.width = w;
+                s.picture.height = h;
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    s.picture.planes[p].pitch = outPitches[p];
+                m_stages.push_back( std::move( s ) );
+            }
+            // Largest outputs first, so that they can be used as the base of
+            // the smaller ones
+            std::stable_sort( begin( m_stages ), end( m_stages ), []( const Stage& a, const Stage& b ) {
+                return uint64_t{ a.picture.width } * a.picture.height >
+                        uint64_t{ b.picture.width } * b.picture.height;
+            });
+            for ( auto i = 0u; i < m_stages.size(); ++i )
+                plan( i );
+            return nb;
+        }
+
+        void cleanup()
+        {
+            m_source.cleanup();
+            for ( auto& o : m_outputs )
+                o.cleanup();
+        }
+
+        void* lock( void** planes )
+        {
+            return m_source.lock( planes );
+        }
+
+        void unlock( void* picture, void* const* planes )
+        {
+            m_source.unlock( picture, planes );
+        }
+
+        void display( void* picture )
+        {
+            m_source.display( picture );
+        }
+
+        FramePool::Stats sourceStats() const
+        {
+            return m_source.stats();
+        }
+
+        FramePool::Stats outputStats( unsigned idx ) const
+        {
+            return m_outputs.at( idx ).stats();
+        }
+
+    private:
+        unsigned planeWidth( unsigned width, unsigned p ) const
+        {
+            return ( width + m_chroma->planes[p].wDiv - 1 ) / m_chroma->planes[p].wDiv;
+        }
+
+        unsigned planeHeight( unsigned height, unsigned p ) const
+        {
+            return ( height + m_chroma->planes[p].hDiv - 1 ) / m_chroma->planes[p].hDiv;
+        }
+
+        void setDimensions( detail::scale::Picture& pic, unsigned width, unsigned height ) const
+        {
+            pic.width = width;
+            pic.height = height;
+            for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+            {
+                pic.planes[p].width = planeWidth( width, p );
+                pic.planes[p].height = planeHeight( height, p );
+            }
+        }
+
+        void plan( unsigned idx )
+        {
+            auto& s = m_stages[idx];
+            setDimensions( s.picture, s.picture.width, s.picture.height );
+            auto w = s.picture.width;
+            auto h = s.picture.height;
+            // The smallest picture at least as large as this output
+            s.base = 0;
+            unsigned baseW = m_width, baseH = m_height;
+            for ( auto i = 0u; i < idx; ++i )
+            {
+                const auto& other = m_stages[i].picture;
+                if ( other.width >= w && other.height >= h &&
+                     uint64_t{ other.width } * other.height < uint64_t{ baseW } * baseH )
+                {
+                    s.base = i + 1;
+                    baseW = other.width;
+                    baseH = other.height;
+                }
+            }
+            // Halve while the output is at most half as large. The last step
+            // writes directly to the output when it lands on its size.
+            while ( w <= ( baseW + 1 ) / 2 && h <= ( baseH + 1 ) / 2 )
+            {
+                baseW = ( baseW + 1 ) / 2;
+                baseH = ( baseH + 1 ) / 2;
+                if ( baseW == w && baseH == h )
+                {
+                    s.levels.push_back( s.picture );
+                    break;
+                }
+                detail::scale::Picture level;
+                setDimensions( level, baseW, baseH );
+                size_t size = 0;
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                {
+                    level.planes[p].pitch = level.planes[p].width * m_chroma->planes[p].components;
+                    size += level.planes[p].pitch * level.planes[p].height;
+                }
+                s.levelBuffers.emplace_back( size );
+                s.levels.push_back( level );
+            }
+            if ( baseW != w || baseH != h )
+            {
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                {
+                    s.resamplers.emplace_back( planeWidth( baseW, p ), planeHeight( baseH, p ),
+                                               s.picture.planes[p].width, s.picture.planes[p].height,
+                                               m_chroma->planes[p].components );
+                }
+            }
+        }
+
+        void process( FramePool::Frame frame )
+        {
+            using namespace detail::scale;
+            Picture source;
+            source.width = frame.width();
+            source.height = frame.height();
+            for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+            {
+                source.planes[p].data = frame.plane( p );
+                source.planes[p].pitch = frame.pitch( p );
+                source.planes[p].width = planeWidth( source.width, p );
+                source.planes[p].height = planeHeight( source.height, p );
+            }
+            for ( auto& s : m_stages )
+            {
+                void* planes[PictureLayout::MaxPlanes];
+                s.handle = m_outputs[s.output].lock( planes );
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    s.picture.planes[p].data = static_cast<uint8_t*>( planes[p] );
+            }
+            for ( auto& s : m_stages )
+                scale( s, s.base == 0 ? source : m_stages[s.base - 1].picture );
+            // All outputs are complete: hand them to their consumers
+            for ( auto& s : m_stages )
+            {
+                auto& out = m_outputs[s.output];
+                void* planes[PictureLayout::MaxPlanes];
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    planes[p] = s.picture.planes[p].data;
+                // Displaying first releases the picture on unlock, whichever
+                // libvlc version the pool was built for
+                out.display( s.handle );
+                out.unlock( s.handle, planes );
+            }
+            if ( m_config.onFrame )
+                m_config.onFrame( std::move( frame ) );
+        }
+
+        void scale( Stage& s, const detail::scale::Picture& base )
+        {
+            using namespace detail::scale;
+            const Picture* cur = &base;
+            for ( auto l = 0u; l < s.levels.size(); ++l )
+            {
+                auto& level = l < s.levelBuffers.size() ? s.levels[l] : s.picture;
+                if ( l < s.levelBuffers.size() )
+                {
+                    auto data = s.levelBuffers[l].data();
+                    for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    {
+                        level.planes[p].data = data;
+                        data += level.planes[p].pitch * level.planes[p].height;
+                    }
+                }
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    halvePlane<Simd>( cur->planes[p], level.planes[p], m_chroma->planes[p].components );
+                cur = &level;
+            }
+            if ( s.resamplers.empty() == false )
+            {
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    s.resamplers[p].resample<Simd>( cur->planes[p], s.picture.planes[p] );
+            }
+            else if ( cur == &base )
+            {
+                for ( auto p = 0u; p < m_chroma->nbPlanes; ++p )
+                    copyPlane( cur->planes[p], s.picture.planes[p], m_chroma->planes[p].components );
+            }
+        }
+
+    private:
+        Configuration m_config;
+        FramePool m_source;
+        std::vector<FramePool> m_outputs;
+        std::vector<Stage> m_stages;
+        const detail::scale::ChromaDesc* m_chroma;
+        unsigned m_width;
+        unsigned m_height;
+    };
+
+public:
+    ///
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit FrameFanout( Configuration config )
+        : m_state( std::make_shared<State>( std::move( config ) ) )
+    {
+    }
+
+    ///
+    /// \brief attach Sets the video format & video callbacks of the provided
+    ///               player, so that it decodes to this fan-out.
+    ///
+    /// This must be called before the playback starts.
+    ///
+    void attach( MediaPlayer& mp )
+    {
+        auto state = m_state;
+        mp.setVideoFormatCallbacks(
+            [state]( char* chroma, uint32_t* width, uint32_t* height,
+                     uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return state->setup( chroma, width, height, pitches, lines );
+            },
+            [state]() { state->cleanup(); } );
+        mp.setVideoCallbacks(
+            [state]( void** planes ) -> void* { return state->lock( planes ); },
+            [state]( void* picture, void* const* planes ) { state->unlock( picture, planes ); },
+            [state]( void* picture ) { state->display( picture ); } );
+    }
+
+    FramePool::Stats sourceStats() const
+    {
+        return m_state->sourceStats();
+    }
+
+    ///
+    /// \brief outputStats Returns the stats of an output pool, in the
+    ///                    configuration order
+    ///
+    FramePool::Stats outputStats( unsigned idx ) const
+    {
+        return m_state->outputStats( idx );
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setVideoFormatCallbacks
+    /// and MediaPlayer::setVideoCallbacks prototypes, for callers which need
+    /// to wrap them.
+    ///
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        return m_state->setup( chroma, width, height, pitches, lines );
+    }
+
+    void cleanup()
+    {
+        m_state->cleanup();
+    }
+
+    void* lock( void** planes )
+    {
+        return m_state->lock( planes );
+    }
+
+    void unlock( void* picture, void* const* planes )
+    {
+        m_state->unlock( picture, planes );
+    }
+
+    void display( void* picture )
+    {
+        m_state->display( picture );
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_FRAMEFANOUT_H
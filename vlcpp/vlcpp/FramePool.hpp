@@ -0,0 +1,1162 @@
+/*****************************************************************************
+ * FramePool.hpp: Recycling video frame buffers for MediaPlayer callbacks
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_FRAMEPOOL_H
+#define LIBVLC_CXX_FRAMEPOOL_H
+
+#include "MediaPlayer.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+# include <malloc.h>
+#elif defined(__linux__)
+# include <sys/mman.h>
+#endif
+
+namespace VLC
+{
+
+///
+/// \brief The PictureLayout struct describes how a picture of a given chroma
+///        and size is laid out in memory.
+///
+/// Every line starts on a PictureLayout::Alignment boundary, and so does
+/// every plane.
+///
+struct PictureLayout
+{
+    static constexpr unsigned MaxPlanes = 3;
+    static constexpr size_t Alignment = 64;
+
+    char chroma[5];
+    unsigned width;
+    unsigned height;
+    unsigned nbPlanes;
+    unsigned pitches[MaxPlanes];
+    unsigned lines[MaxPlanes];
+    size_t offsets[MaxPlanes];
+    /// The size of a picture, rounded up to a multiple of Alignment
+    size_t size;
+
+    ///
+    /// \brief compute Fills the layout for the provided chroma & dimensions
+    /// \param chroma A fourcc, as understood by libvlc (ie. "RV32", "I420", ...)
+    /// \return false if the chroma is unknown or the dimensions are invalid
+    ///
+    bool compute( const char* fourcc, unsigned w, unsigned h )
+    {
+        // Bytes per sample, horizontal & vertical subsampling, per plane
+        struct Plane
+        {
+            uint8_t pixelSize;
+            uint8_t wDiv;
+            uint8_t hDiv;
+        };
+        struct Chroma
+        {
+            char fourcc[5];
+            unsigned nbPlanes;
+            Plane planes[MaxPlanes];
+        };
+        static const Chroma chromas[] = {
+            { "RV32", 1, { { 4, 1, 1 } } },
+            { "RGBA", 1, { { 4, 1, 1 } } },
+            { "BGRA", 1, { { 4, 1, 1 } } },
+            { "ARGB", 1, { { 4, 1, 1 } } },
+            { "RV24", 1, { { 3, 1, 1 } } },
+            { "RV16", 1, { { 2, 1, 1 } } },
+            { "RV15", 1, { { 2, 1, 1 } } },
+            { "GREY", 1, { { 1, 1, 1 } } },
+            { "YUY2", 1, { { 2, 1, 1 } } },
+            { "UYVY", 1, { { 2, 1, 1 } } },
+            { "I420", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "J420", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "YV12", 3, { { 1, 1, 1 }, { 1, 2, 2 }, { 1, 2, 2 } } },
+            { "I422", 3, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+            { "J422", 3, { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 2, 1 } } },
+            { "I444", 3, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+            { "J444", 3, { { 1, 1, 1 }, { 1, 1, 1 }, { 1, 1, 1 } } },
+            { "NV12", 2, { { 1, 1, 1 }, { 2, 2, 2 } } },
+            { "NV21", 2, { { 1, 1, 1 }, { 2, 2, 2 } } },
+            { "P010", 2, { { 2, 1, 1 }, { 4, 2, 2 } } },
+        };
+        if ( fourcc == nullptr || w == 0 || h == 0 )
+            return false;
+        const Chroma* desc = nullptr;
+        for ( const auto& c : chromas )
+        {
+            if ( memcmp( c.fourcc, fourcc, 4 ) == 0 )
+            {
+                desc = &c;
+                break;
+            }
+        }
+        if ( desc == nullptr )
+            return false;
+        memcpy( chroma, desc->fourcc, sizeof( chroma ) );
+        width = w;
+        height = h;
+        nbPlanes = desc->nbPlanes;
+        size = 0;
+        for ( auto i = 0u; i < MaxPlanes; ++i )
+        {
+            if ( i >= nbPlanes )
+            {
+                pitches[i] = lines[i] = 0;
+                offsets[i] = size;
+                continue;
+            }
+            const auto& p = desc->planes[i];
+            auto samples = ( w + p.wDiv - 1 ) / p.wDiv;
+            pitches[i] = static_cast<unsigned>( align( samples * p.pixelSize ) );
+            lines[i] = ( h + p.hDiv - 1 ) / p.hDiv;
+            offsets[i] = size;
+            size += align( static_cast<size_t>( pitches[i] ) * lines[i] );
+        }
+        return true;
+    }
+
+    bool operator==( const PictureLayout& other ) const
+    {
+        return memcmp( chroma, other.chroma, 4 ) == 0 && width == other.width &&
+                height == other.height && size == other.size;
+    }
+
+    bool operator!=( const PictureLayout& other ) const
+    {
+        return !( *this == other );
+    }
+
+    static size_t align( size_t s )
+    {
+        return ( s + Alignment - 1 ) & ~( Alignment - 1 );
+    }
+};
+
+namespace detail
+{
+
+///
+/// \brief The PictureMemory class owns a block of memory suitable for
+///        pictures: aligned to PictureLayout::Alignment, and optionally backed
+///        by huge pages.
+///
+class PictureMemory
+{
+public:
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    PictureMemory( size_t size, bool hugePages )
+        : m_size( size )
+        , m_hugePages( false )
+        , m_mapped( false )
+    {
+        m_memory = allocate( hugePages );
+        if ( m_memory == nullptr )
+            throw std::bad_alloc();
+    }
+
+    ~PictureMemory()
+    {
+#if defined(__linux__)
+        if ( m_mapped == true )
+        {
+            munmap( m_memory, m_size );
+            return;
+        }
+#endif
+#if defined(_WIN32)
+        _aligned_free( m_memory );
+#else
+        free( m_memory );
+#endif
+    }
+
+    PictureMemory( const PictureMemory& ) = delete;
+    PictureMemory& operator=( const PictureMemory& ) = delete;
+
+    uint8_t* data() const
+    {
+        return m_memory;
+    }
+
+    ///
+    /// \brief hugePages Returns true if the memory is backed by reserved huge
+    ///                  pages
+    ///
+    bool hugePages() const
+    {
+        return m_hugePages;
+    }
+
+private:
+    uint8_t* allocate( bool hugePages )
+    {
+#if defined(__linux__)
+        if ( hugePages == true )
+        {
+            m_size = ( m_size + HugePageSize - 1 ) & ~( HugePageSize - 1 );
+            auto ptr = mmap( nullptr, m_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+            if ( ptr != MAP_FAILED )
+                m_hugePages = true;
+            else
+            {
+                // No reserved huge pages, fall back to transparent ones
+                ptr = mmap( nullptr, m_size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+                if ( ptr == MAP_FAILED )
+                    return nullptr;
+# if defined(MADV_HUGEPAGE)
+                madvise( ptr, m_size, MADV_HUGEPAGE );
+# endif
+            }
+            m_mapped = true;
+            return static_cast<uint8_t*>( ptr );
+        }
+#else
+        (void)hugePages;
+#endif
+#if defined(_WIN32)
+        return static_cast<uint8_t*>( _aligned_malloc( m_size, PictureLayout::Alignment ) );
+#else
+        void* ptr;
+        if ( posix_memalign( &ptr, PictureLayout::Alignment, m_size ) != 0 )
+            return nullptr;
+        return static_cast<uint8_t*>( ptr );
+#endif
+    }
+
+private:
+    size_t m_size;
+    bool m_hugePages;
+    bool m_mapped;
+    uint8_t* m_memory;
+};
+
+///
+/// \brief negotiateSize Computes the dimensions of the pictures to decode to
+///
+/// \param width   The requested width, or 0
+/// \param height  The requested height, or 0
+/// \param srcWidth, srcHeight The source dimensions, which are replaced
+///                            with the negotiated ones
+///
+/// When only one dimension is requested, the other one is computed from the
+/// source aspect ratio, and rounded to an even value.
+///
+inline void negotiateSize( unsigned width, unsigned height, uint32_t* srcWidth, uint32_t* srcHeight )
+{
+    if ( width == 0 && height != 0 && *srcHeight != 0 )
+        width = static_cast<unsigned>( ( uint64_t{ *srcWidth } * height / *srcHeight + 1 ) & ~uint64_t{ 1 } );
+    else if ( height == 0 && width != 0 && *srcWidth != 0 )
+        height = static_cast<unsigned>( ( uint64_t{ *srcHeight } * width / *srcWidth + 1 ) & ~uint64_t{ 1 } );
+    else if ( width == 0 && height == 0 )
+    {
+        width = *srcWidth;
+        height = *srcHeight;
+    }
+    *srcWidth = width;
+    *srcHeight = height;
+}
+
+///
+/// \brief applyLayout Reports a negotiated layout through the format
+///                    callback parameters
+///
+inline void applyLayout( const PictureLayout& layout, char* chroma, uint32_t* width,
+                         uint32_t* height, uint32_t* pitches, uint32_t* lines )
+{
+    memcpy( chroma, layout.chroma, 4 );
+    *width = layout.width;
+    *height = layout.height;
+    for ( auto i = 0u; i < layout.nbPlanes; ++i )
+    {
+        pitches[i] = layout.pitches[i];
+        lines[i] = layout.lines[i];
+    }
+}
+
+///
+/// \brief The FrameArena class owns the memory of a fixed set of pictures,
+///        all sharing the same layout.
+///
+/// Free buffers are tracked in a bitmask, so that taking or returning one is
+/// a single atomic operation.
+/// When every buffer is in use, the decoder can carry on with scratch
+/// buffers. Those are allocated upon first use, and are never handed to two
+/// pictures at once, as the decoder may still be reading a picture it
+/// decoded before. libvlc never holds more pictures than the pool has
+/// buffers, so there are as many scratch buffers as regular ones.
+/// Should a scratch buffer fail to be allocated, the decoder is given the
+/// sink: a buffer allocated along the regular ones, which can be handed to
+/// several pictures at once, as their content is discarded.
+///
+class FrameArena
+{
+public:
+    static constexpr unsigned MaxBuffers = 64;
+
+    struct Slot
+    {
+        /// The state of libvlc's reference to the picture
+        enum Flags : unsigned
+        {
+            /// libvlc still holds its reference
+            Held = 1,
+            Unlocked = 2,
+            Displayed = 4,
+        };
+
+        std::atomic<unsigned> refs;
+        std::atomic<unsigned> flags;
+        unsigned index;
+        uint64_t sequence;
+        uint8_t* buffer;
+    };
+
+    FrameArena( const PictureLayout& layout, unsigned nbBuffers, bool hugePages )
+        : m_layout( layout )
+        , m_nbBuffers( nbBuffers )
+        , m_free( mask( nbBuffers ) )
+        , m_scratchFree( mask( nbBuffers ) )
+        , m_cursor( 0 )
+        , m_nbWaiters( 0 )
+        , m_memory( layout.size * ( nbBuffers + 1 ), hugePages )
+        , m_scratch( new std::unique_ptr<PictureMemory>[nbBuffers] )
+        , m_slots( new Slot[nbBuffers * 2 + 1] )
+    {
+        assert( nbBuffers > 0 && nbBuffers <= MaxBuffers );
+        for ( auto i = 0u; i < nbBuffers * 2 + 1; ++i )
+        {
+            m_slots[i].refs.store( 0, std::memory_order_relaxed );
+            m_slots[i].flags.store( 0, std::memory_order_relaxed );
+            m_slots[i].index = i;
+            m_slots[i].sequence = 0;
+            m_slots[i].buffer = nullptr;
+        }
+        for ( auto i = 0u; i < nbBuffers; ++i )
+            m_slots[i].buffer = m_memory.data() + i * layout.size;
+        m_slots[nbBuffers * 2].buffer = m_memory.data() + nbBuffers * layout.size;
+    }
+
+    FrameArena( const FrameArena& ) = delete;
+    FrameArena& operator=( const FrameArena& ) = delete;
+
+    ///
+    /// \brief acquire Takes a free buffer, waiting up to timeout for one to
+    ///                be released
+    /// \return The buffer slot, or nullptr if none became available.
+    ///
+    Slot* acquire( std::chrono::milliseconds timeout )
+    {
+        auto slot = tryAcquire();
+        if ( slot != nullptr || timeout.count() <= 0 )
+            return slot;
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_nbWaiters.fetch_add( 1, std::memory_order_relaxed );
+        // Pairs with the fence in release(): either we see the freed buffer
+        // or the releaser sees us waiting.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        m_cond.wait_for( lock, timeout, [this, &slot]() {
+            slot = tryAcquire();
+            return slot != nullptr;
+        });
+        m_nbWaiters.fetch_sub( 1, std::memory_order_relaxed );
+        return slot;
+    }
+
+    ///
+    /// \brief acquireScratch Takes a free scratch buffer, allocating it if
+    ///                       needed
+    /// \return The buffer slot, or nullptr if none is free or the allocation
+    ///         failed.
+    ///
+    Slot* acquireScratch()
+    {
+        // Only the acquisitions clear bits, and they are serialized
+        std::lock_guard<std::mutex> lock( m_mutex );
+        auto free = m_scratchFree.load( std::memory_order_acquire );
+        if ( free == 0 )
+            return nullptr;
+        auto idx = 0u;
+        while ( ( free & ( uint64_t{ 1 } << idx ) ) == 0 )
+            ++idx;
+        auto& memory = m_scratch[idx];
+        if ( memory == nullptr )
+        {
+            try
+            {
+                memory.reset( new PictureMemory( m_layout.size, false ) );
+            }
+            catch ( const std::bad_alloc& )
+            {
+                return nullptr;
+            }
+            m_slots[m_nbBuffers + idx].buffer = memory->data();
+        }
+        m_scratchFree.fetch_and( ~( uint64_t{ 1 } << idx ), std::memory_order_relaxed );
+        return &m_slots[m_nbBuffers + idx];
+    }
+
+    ///
+    /// \brief release Drops a reference to the provided slot, and recycles the
+    ///                buffer when it was the last one
+    ///
+    /// This can be called from any thread.
+    ///
+    void release( Slot* slot )
+    {
+        if ( slot->refs.fetch_sub( 1, std::memory_order_acq_rel ) != 1 )
+            return;
+        if ( isScratch( slot ) == true )
+        {
+            m_scratchFree.fetch_or( uint64_t{ 1 } << ( slot->index - m_nbBuffers ),
+                                    std::memory_order_release );
+            return;
+        }
+        m_free.fetch_or( uint64_t{ 1 } << slot->index, std::memory_order_release );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if ( m_nbWaiters.load( std::memory_order_relaxed ) > 0 )
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_cond.notify_all();
+        }
+    }
+
+    ///
+    /// \brief retain Adds a reference to a buffer, unless it was already
+    ///               recycled
+    ///
+    bool retain( Slot* slot )
+    {
+        auto refs = slot->refs.load( std::memory_order_relaxed );
+        while ( refs != 0 )
+        {
+            if ( slot->refs.compare_exchange_weak( refs, refs + 1, std::memory_order_acquire,
+                                                   std::memory_order_relaxed ) )
+                return true;
+        }
+        return false;
+    }
+
+    ///
+    /// \brief sink Returns the buffer to decode to when no other one is
+    ///             available. It isn't reference counted.
+    ///
+    Slot* sink() const
+    {
+        return &m_slots[m_nbBuffers * 2];
+    }
+
+    bool isScratch( const Slot* slot ) const
+    {
+        return slot->index >= m_nbBuffers && slot->index < m_nbBuffers * 2;
+    }
+
+    bool isSink( const Slot* slot ) const
+    {
+        return slot == sink();
+    }
+
+    bool owns( const Slot* slot ) const
+    {
+        return slot >= &m_slots[0] && slot <= sink();
+    }
+
+    ///
+    /// \brief slot Returns a slot by index, scratch ones coming after the
+    ///             regular ones. The sink isn't counted.
+    ///
+    Slot* slot( unsigned idx ) const
+    {
+        return &m_slots[idx];
+    }
+
+    unsigned nbSlots() const
+    {
+        return m_nbBuffers * 2;
+    }
+
+    const PictureLayout& layout() const
+    {
+        return m_layout;
+    }
+
+    unsigned nbBuffers() const
+    {
+        return m_nbBuffers;
+    }
+
+    unsigned nbFree() const
+    {
+        auto mask = m_free.load( std::memory_order_relaxed );
+        auto n = 0u;
+        for ( ; mask != 0; mask &= mask - 1 )
+            ++n;
+        return n;
+    }
+
+    bool hugePages() const
+    {
+        return m_memory.hugePages();
+    }
+
+private:
+    static uint64_t mask( unsigned nbBuffers )
+    {
+        return nbBuffers == 64 ? ~uint64_t{ 0 } : ( uint64_t{ 1 } << nbBuffers ) - 1;
+    }
+
+    Slot* tryAcquire()
+    {
+        // Start looking after the last buffer we handed out, so buffers are
+        // reused in a round robin fashion, giving consumers as much time as
+        // possible before a buffer gets reused.
+        auto mask = m_free.load( std::memory_order_relaxed );
+        while ( mask != 0 )
+        {
+            auto cursor = m_cursor.load( std::memory_order_relaxed );
+            auto candidates = mask & ~( ( uint64_t{ 1 } << cursor ) - 1 );
+            if ( candidates == 0 )
+                candidates = mask;
+            auto bit = candidates & ( ~candidates + 1 );
+            if ( m_free.compare_exchange_weak( mask, mask & ~bit, std::memory_order_acquire,
+                                               std::memory_order_relaxed ) )
+            {
+                auto idx = 0u;
+                while ( ( bit >> idx ) != 1 )
+                    ++idx;
+                m_cursor.store( idx + 1 == m_nbBuffers ? 0 : idx + 1,
+                                std::memory_order_relaxed );
+                return &m_slots[idx];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    PictureLayout m_layout;
+    unsigned m_nbBuffers;
+    std::atomic<uint64_t> m_free;
+    std::atomic<uint64_t> m_scratchFree;
+    std::atomic<unsigned> m_cursor;
+    std::atomic<unsigned> m_nbWaiters;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    PictureMemory m_memory;
+    std::unique_ptr<std::unique_ptr<PictureMemory>[]> m_scratch;
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+} // namespace detail
+
+///
+/// \brief The FormatNegotiator class picks the format of the pictures to
+///        decode to, from the one libvlc proposes.
+///
+/// When invoking the format callback, libvlc fills the chroma & dimensions
+/// with the decoder's output format. If the consumer can handle that chroma
+/// natively, keeping it spares a conversion filter, and a full pass over
+/// every frame. Otherwise, the fallback chroma is requested, and libvlc
+/// converts to it.
+///
+class FormatNegotiator
+{
+public:
+    struct Result
+    {
+        /// The negotiated format, with correctly strided planes
+        PictureLayout layout;
+        /// The chroma & dimensions libvlc proposed
+        char proposed[5];
+        unsigned sourceWidth;
+        unsigned sourceHeight;
+        /// True if the decoder's format was kept as is, so that libvlc
+        /// doesn't need to convert nor scale the pictures
+        bool passthrough;
+    };
+
+    ///
+    /// \brief FormatNegotiator
+    /// \param fallback  The fourcc to use when the proposed one isn't supported
+    /// \param natives   The fourccs the consumer supports, beside the fallback
+    /// \param width     The requested width, or 0. See FramePool::Configuration
+    /// \param height    The requested height, or 0
+    /// \throws std::invalid_argument if one of the chromas isn't a fourcc
+    ///
+    FormatNegotiator( std::string fallback, std::vector<std::string> natives,
+                      unsigned width, unsigned height )
+        : m_fallback( std::move( fallback ) )
+        , m_natives( std::move( natives ) )
+        , m_width( width )
+        , m_height( height )
+    {
+        if ( m_fallback.size() != 4 )
+            throw std::invalid_argument( "The fallback chroma must be a fourcc" );
+        for ( const auto& c : m_natives )
+        {
+            if ( c.size() != 4 )
+                throw std::invalid_argument( "The native chromas must be fourccs" );
+        }
+    }
+
+    ///
+    /// \brief negotiate Implements the MediaPlayer::setVideoFormatCallbacks
+    ///                  setup callback, and reports the outcome in result.
+    /// \return false if no usable format could be computed
+    ///
+    bool negotiate( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines, Result& result ) const
+    {
+        memcpy( result.proposed, chroma, 4 );
+        result.proposed[4] = 0;
+        result.sourceWidth = *width;
+        result.sourceHeight = *height;
+        detail::negotiateSize( m_width, m_height, width, height );
+        // A native chroma is only kept if its layout is known, since the
+        // buffers have to be allocated accordingly
+        auto native = isNative( chroma ) &&
+                result.layout.compute( result.proposed, *width, *height );
+        if ( native == false &&
+             result.layout.compute( m_fallback.c_str(), *width, *height ) == false )
+            return false;
+        result.passthrough = native && *width == result.sourceWidth &&
+                *height == result.sourceHeight;
+        detail::applyLayout( result.layout, chroma, width, height, pitches, lines );
+        return true;
+    }
+
+    bool isNative( const char* chroma ) const
+    {
+        for ( const auto& c : m_natives )
+        {
+            if ( memcmp( c.c_str(), chroma, 4 ) == 0 )
+                return true;
+        }
+        return memcmp( m_fallback.c_str(), chroma, 4 ) == 0;
+    }
+
+private:
+    std::string m_fallback;
+    std::vector<std::string> m_natives;
+    unsigned m_width;
+    unsigned m_height;
+};
+
+///
+/// \brief The FramePool class provides the buffers libvlc decodes video into,
+///        and hands the decoded frames to a consumer.
+///
+/// The geometry is negotiated through MediaPlayer::setVideoFormatCallbacks:
+/// the decoder's chroma is kept if it is one of the configured native
+/// chromas, otherwise the configured chroma is used. The dimensions are the
+/// configured ones, or the source ones when left to 0.
+/// Buffers come from a fixed set allocated at negotiation time, are 64 bytes
+/// aligned, and can be backed by huge pages.
+/// A buffer is only recycled once both libvlc and the consumers released it,
+/// so the decoder never writes to a buffer which is still being read, nor to
+/// a picture waiting to be displayed. libvlc releases a picture once it was
+/// both unlocked and displayed, when libvlc 3 returns it to its pool without
+/// displaying it, or upon cleanup.
+/// When all buffers are held, the pool is starving: it can wait for a buffer
+/// to be released, and will otherwise decode into a scratch buffer of its
+/// own, whose frame is then dropped. libvlc's thread is never blocked for
+/// longer: if no scratch buffer can be allocated either, the frame goes to a
+/// preallocated sink buffer after a short wait, and is dropped as well.
+///
+/// The pool state is shared with the player callbacks, and with the frames
+/// it handed out, so it can be destroyed at any time.
+///
+class FramePool
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : chroma( "RV32" )
+            , width( 0 )
+            , height( 0 )
+            , nbBuffers( 4 )
+            , hugePages( false )
+            , starvationTimeout( 0 )
+        {
+        }
+
+        /// The fourcc of the pictures to decode to
+        std::string chroma;
+        /// The fourccs the consumer can also handle. When the decoder outputs
+        /// one of them, it is used as is, and libvlc doesn't convert the
+        /// frames. Check Frame::chroma() to know which one was picked.
+        std::vector<std::string> nativeChromas;
+        /// The pictures dimensions. When only one is set, the other one is
+        /// computed from the source aspect ratio. When both are 0, the source
+        /// dimensions are used.
+        unsigned width;
+        unsigned height;
+        /// The number of buffers, between 1 and 64
+        unsigned nbBuffers;
+        /// Try to back the buffers with huge pages (Linux only)
+        bool hugePages;
+        /// How long libvlc's decoding thread can be blocked waiting for a
+        /// buffer to be released. After that, the frame is decoded to a
+        /// scratch buffer, and dropped.
+        std::chrono::milliseconds starvationTimeout;
+        /// Invoked from libvlc's thread when no buffer was available
+        std::function<void()> onStarvation;
+    };
+
+    struct Stats
+    {
+        /// Number of frames handed to the consumer
+        uint64_t delivered;
+        /// Number of frames libvlc decoded but didn't display
+        uint64_t dropped;
+        /// Number of times no buffer was available
+        uint64_t starved;
+        /// Number of buffers currently held by libvlc or by consumers
+        unsigned inUse;
+        unsigned nbBuffers;
+        /// True if the buffers are backed by reserved huge pages
+        bool hugePages;
+        /// True if the current format is the decoder's one, so that libvlc
+        /// doesn't convert the frames
+        bool passthrough;
+    };
+
+    class Frame;
+
+private:
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_negotiator( m_config.chroma, m_config.nativeChromas,
+                            m_config.width, m_config.height )
+            , m_sequence( 0 )
+            , m_delivered( 0 )
+            , m_dropped( 0 )
+            , m_starved( 0 )
+            , m_passthrough( false )
+        {
+            if ( m_config.nbBuffers == 0 || m_config.nbBuffers > detail::FrameArena::MaxBuffers )
+                throw std::invalid_argument( "FramePool buffer count must be between 1 and 64" );
+        }
+
+        uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                        uint32_t* pitches, uint32_t* lines )
+        {
+            FormatNegotiator::Result format;
+            if ( m_negotiator.negotiate( chroma, width, height, pitches, lines, format ) == false )
+                return 0;
+            m_passthrough.store( format.passthrough, std::memory_order_relaxed );
+            const auto& layout = format.layout;
+            if ( m_arena == nullptr || m_arena->layout() != layout )
+            {
+                // Frames from the previous arena keep it alive as long as needed
+                try
+                {
+                    std::atomic_store( &m_arena, std::make_shared<detail::FrameArena>(
+                                           layout, m_config.nbBuffers, m_config.hugePages ) );
+                }
+                catch ( const std::bad_alloc& )
+                {
+                    std::atomic_store( &m_arena, std::shared_ptr<detail::FrameArena>{} );
+                    return 0;
+                }
+            }
+            return m_config.nbBuffers;
+        }
+
+        void cleanup()
+        {
+            // libvlc is done with all its pictures
+            if ( m_arena == nullptr )
+                return;
+            for ( auto i = 0u; i < m_arena->nbSlots(); ++i )
+                dropReference( m_arena->slot( i ) );
+        }
+
+        void* lock( void** planes )
+        {
+            auto slot = m_arena->acquire( m_config.starvationTimeout );
+            if ( slot == nullptr )
+            {
+                m_starved.fetch_add( 1, std::memory_order_relaxed );
+                if ( m_config.onStarvation )
+                    m_config.onStarvation();
+                slot = m_arena->acquireScratch();
+                // There is a scratch buffer for each picture libvlc can hold,
+                // so this only waits if one couldn't be allocated
+                if ( slot == nullptr )
+                    slot = m_arena->acquire( std::chrono::milliseconds( 100 ) );
+                if ( slot == nullptr )
+                {
+                    // The sink is shared, so its frame is dropped right away,
+                    // and libvlc's callbacks ignore it
+                    m_dropped.fetch_add( 1, std::memory_order_relaxed );
+                    slot = m_arena->sink();
+                    const auto& layout = m_arena->layout();
+                    for ( auto i = 0u; i < layout.nbPlanes; ++i )
+                        planes[i] = slot->buffer + layout.offsets[i];
+                    return slot;
+                }
+            }
+            if ( m_arena->isScratch( slot ) == false )
+                slot->sequence = m_sequence++;
+            slot->refs.store( 1, std::memory_order_relaxed );
+            slot->flags.store( Slot::Held, std::memory_order_release );
+            const auto& layout = m_arena->layout();
+            for ( auto i = 0u; i < layout.nbPlanes; ++i )
+                planes[i] = slot->buffer + layout.offsets[i];
+            return slot;
+        }
+
+        void unlock( void* picture, void* const* )
+        {
+            auto slot = static_cast<Slot*>( picture );
+            if ( m_arena->isSink( slot ) == true )
+                return;
+            auto flags = slot->flags.fetch_or( Slot::Unlocked, std::memory_order_acq_rel );
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+            // The picture is yet to be displayed
+            if ( ( flags & Slot::Displayed ) == 0 )
+                return;
+#else
+            // libvlc 3 unlocks the pictures when they go back to its pool,
+            // after they were displayed, or dropped
+            (void)flags;
+#endif
+            dropReference( slot );
+        }
+
+        void display( void* picture );
+
+        Stats stats() const
+        {
+            Stats s;
+            s.delivered = m_delivered.load( std::memory_order_relaxed );
+            s.dropped = m_dropped.load( std::memory_order_relaxed );
+            s.starved = m_starved.load( std::memory_order_relaxed );
+            auto arena = std::atomic_load( &m_arena );
+            s.nbBuffers = m_config.nbBuffers;
+            s.inUse = arena != nullptr ? arena->nbBuffers() - arena->nbFree() : 0;
+            s.hugePages = arena != nullptr && arena->hugePages();
+            s.passthrough = m_passthrough.load( std::memory_order_relaxed );
+            return s;
+        }
+
+        std::function<void(Frame)> onFrame;
+
+    private:
+        using Slot = detail::FrameArena::Slot;
+
+        // Drops libvlc's reference to a picture, unless it already was
+        void dropReference( Slot* slot )
+        {
+            auto flags = slot->flags.load( std::memory_order_acquire );
+            do
+            {
+                if ( ( flags & Slot::Held ) == 0 )
+                    return;
+            } while ( slot->flags.compare_exchange_weak( flags, flags & ~Slot::Held,
+                                                         std::memory_order_acq_rel,
+                                                         std::memory_order_acquire ) == false );
+            if ( ( flags & Slot::Displayed ) == 0 )
+                m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            m_arena->release( slot );
+        }
+
+    private:
+        Configuration m_config;
+        FormatNegotiator m_negotiator;
+        std::shared_ptr<detail::FrameArena> m_arena;
+        uint64_t m_sequence;
+        std::atomic<uint64_t> m_delivered;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_starved;
+        std::atomic<bool> m_passthrough;
+    };
+
+public:
+    ///
+    /// \brief The Frame class is a reference to a decoded picture.
+    ///
+    /// The buffer goes back to the pool when the frame is destroyed or
+    /// released. Frames can be moved to, and released from, any thread.
+    ///
+    class Frame
+    {
+    public:
+        Frame() noexcept : m_slot( nullptr ) {}
+
+        Frame( Frame&& other ) noexcept
+            : m_arena( std::move( other.m_arena ) )
+            , m_slot( other.m_slot )
+        {
+            other.m_slot = nullptr;
+        }
+
+        Frame& operator=( Frame&& other ) noexcept
+        {
+            if ( this != &other )
+            {
+                release();
+                m_arena = std::move( other.m_arena );
+                m_slot = other.m_slot;
+                other.m_slot = nullptr;
+            }
+            return *this;
+        }
+
+        Frame( const Frame& ) = delete;
+        Frame& operator=( const Frame& ) = delete;
+
+        ~Frame()
+        {
+            release();
+        }
+
+        ///
+        /// \brief release Gives the buffer back to the pool
+        ///
+        void release()
+        {
+            if ( m_slot == nullptr )
+                return;
+            m_arena->release( m_slot );
+            m_slot = nullptr;
+            m_arena.reset();
+        }
+
+        explicit operator bool() const
+        {
+            return m_slot != nullptr;
+        }
+
+        uint8_t* plane( unsigned idx ) const
+        {
+            return m_slot->buffer + m_arena->layout().offsets[idx];
+        }
+
+        unsigned pitch( unsigned idx ) const
+        {
+            return m_arena->layout().pitches[idx];
+        }
+
+        unsigned lines( unsigned idx ) const
+        {
+            return m_arena->layout().lines[idx];
+        }
+
+        unsigned nbPlanes() const
+        {
+            return m_arena->layout().nbPlanes;
+        }
+
+        unsigned width() const
+        {
+            return m_arena->layout().width;
+        }
+
+        unsigned height() const
+        {
+            return m_arena->layout().height;
+        }
+
+        ///
+        /// \brief chroma Returns the frame fourcc, as a null terminated string
+        ///
+        const char* chroma() const
+        {
+            return m_arena->layout().chroma;
+        }
+
+        const PictureLayout& layout() const
+        {
+            return m_arena->layout();
+        }
+
+        ///
+        /// \brief sequence Returns the frame number, in decoding order
+        ///
+        uint64_t sequence() const
+        {
+            return m_slot->sequence;
+        }
+
+        ///
+        /// \brief index Returns the index of the underlying buffer in the pool
+        ///
+        unsigned index() const
+        {
+            return m_slot->index;
+        }
+
+    private:
+        Frame( std::shared_ptr<detail::FrameArena> arena, detail::FrameArena::Slot* slot ) noexcept
+            : m_arena( std::move( arena ) )
+            , m_slot( slot )
+        {
+        }
+
+    private:
+        std::shared_ptr<detail::FrameArena> m_arena;
+        detail::FrameArena::Slot* m_slot;
+
+        friend class FramePool::State;
+    };
+
+    explicit FramePool( Configuration config = Configuration() )
+        : m_state( std::make_shared<State>( std::move( config ) ) )
+    {
+    }
+
+    ///
+    /// \brief attach Sets the video format & video callbacks of the provided
+    ///               player, so that it decodes to this pool.
+    ///
+    /// \param onFrame Invoked from libvlc's thread when a frame is to be
+    ///                displayed. Expected prototype is void(FramePool::Frame).
+    ///                The frame can be kept as long as needed, but while it's
+    ///                alive its buffer can't be reused.
+    ///
+    /// This must be called before the playback starts.
+    ///
+    template <typename FrameCb>
+    void attach( MediaPlayer& mp, FrameCb&& onFrame )
+    {
+        setFrameCallback( std::forward<FrameCb>( onFrame ) );
+        auto state = m_state;
+        mp.setVideoFormatCallbacks(
+            [state]( char* chroma, uint32_t* width, uint32_t* height,
+                     uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return state->setup( chroma, width, height, pitches, lines );
+            },
+            [state]() { state->cleanup(); } );
+        mp.setVideoCallbacks(
+            [state]( void** planes ) -> void* { return state->lock( planes ); },
+            [state]( void* picture, void* const* planes ) { state->unlock( picture, planes ); },
+            [state]( void* picture ) { state->display( picture ); } );
+    }
+
+    ///
+    /// \brief setFrameCallback Sets the frame consumer, when using the raw
+    ///                         callbacks instead of attach()
+    ///
+    /// This must not be called while the pool is in use.
+    ///
+    template <typename FrameCb>
+    void setFrameCallback( FrameCb&& onFrame )
+    {
+        m_state->onFrame = std::forward<FrameCb>( onFrame );
+    }
+
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setVideoFormatCallbacks
+    /// and MediaPlayer::setVideoCallbacks prototypes, for callers which need
+    /// to wrap them.
+    ///
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        return m_state->setup( chroma, width, height, pitches, lines );
+    }
+
+    void cleanup()
+    {
+        m_state->cleanup();
+    }
+
+    void* lock( void** planes )
+    {
+        return m_state->lock( planes );
+    }
+
+    void unlock( void* picture, void* const* planes )
+    {
+        m_state->unlock( picture, planes );
+    }
+
+    void display( void* picture )
+    {
+        m_state->display( picture );
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+inline void FramePool::State::display( void* picture )
+{
+    auto slot = static_cast<Slot*>( picture );
+    if ( m_arena->isSink( slot ) == true )
+        return;
+    // The frame gets its own reference, as libvlc may still be using the
+    // picture
+    auto scratch = m_arena->isScratch( slot );
+    if ( scratch == false && m_arena->retain( slot ) == false )
+        return;
+    auto flags = slot->flags.fetch_or( Slot::Displayed, std::memory_order_acq_rel );
+    if ( ( flags & Slot::Held ) == 0 )
+    {
+        // libvlc already released this picture
+        if ( scratch == false )
+            m_arena->release( slot );
+        return;
+    }
+    if ( ( flags & Slot::Unlocked ) != 0 )
+        dropReference( slot );
+    if ( scratch == true )
+    {
+        m_dropped.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+    m_delivered.fetch_add( 1, std::memory_order_relaxed );
+    Frame frame( m_arena, slot );
+    if ( onFrame )
+        onFrame( std::move( frame ) );
+}
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_FRAMEPOOL_H
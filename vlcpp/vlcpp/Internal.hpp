@@ -25,13 +25,172 @@
 
 #include <cassert>
 #include <stdlib.h>
-#include <vlc/libvlc.h>
+#include <vlc/vlc.h>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace VLC
 {
 
+namespace detail
+{
+
+///
+/// Describes how a libvlc type can be reference counted.
+/// Types exposing a retain/release pair are wrapped in an IntrusivePtr,
+/// which relies on libvlc's own reference counter. Other types use a
+/// std::shared_ptr with a custom releaser.
+///
+template <typename T>
+struct RefcountTraits
+{
+    static constexpr bool Intrusive = false;
+};
+
+template <>
+struct RefcountTraits<libvlc_instance_t>
+{
+    static constexpr bool Intrusive = true;
+    static void retain( libvlc_instance_t* p ) { libvlc_retain( p ); }
+    static void release( libvlc_instance_t* p ) { libvlc_release( p ); }
+    static bool isRelease( void (*f)( libvlc_instance_t* ) ) { return f == &libvlc_release; }
+};
+
+template <>
+struct RefcountTraits<libvlc_media_t>
+{
+    static constexpr bool Intrusive = true;
+    static void retain( libvlc_media_t* p ) { libvlc_media_retain( p ); }
+    static void release( libvlc_media_t* p ) { libvlc_media_release( p ); }
+    static bool isRelease( void (*f)( libvlc_media_t* ) ) { return f == &libvlc_media_release; }
+};
+
+template <>
+struct RefcountTraits<libvlc_media_player_t>
+{
+    static constexpr bool Intrusive = true;
+    static void retain( libvlc_media_player_t* p ) { libvlc_media_player_retain( p ); }
+    static void release( libvlc_media_player_t* p ) { libvlc_media_player_release( p ); }
+    static bool isRelease( void (*f)( libvlc_media_player_t* ) ) { return f == &libvlc_media_player_release; }
+};
+
+template <>
+struct RefcountTraits<libvlc_media_list_t>
+{
+    static constexpr bool Intrusive = true;
+    static void retain( libvlc_media_list_t* p ) { libvlc_media_list_retain( p ); }
+    static void release( libvlc_media_list_t* p ) { libvlc_media_list_release( p ); }
+    static bool isRelease( void (*f)( libvlc_media_list_t* ) ) { return f == &libvlc_media_list_release; }
+};
+
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(3, 0, 0, 0)
+template <>
+struct RefcountTraits<libvlc_media_list_player_t>
+{
+    static constexpr bool Intrusive = true;
+    static void retain( libvlc_media_list_player_t* p ) { libvlc_media_list_player_retain( p ); }
+    static void release( libvlc_media_list_player_t* p ) { libvlc_media_list_player_release( p ); }
+    static bool isRelease( void (*f)( libvlc_media_list_player_t* ) ) { return f == &libvlc_media_list_player_release; }
+};
+#endif
+
+///
+/// A smart pointer sharing a libvlc object through its own reference counter.
+///
+/// Copying it retains the object, destroying it releases it. Unlike a
+/// std::shared_ptr, there is no control block to allocate, and copies only
+/// cost libvlc's atomic increment.
+/// It mimics the subset of the std::shared_ptr interface Internal relies on.
+///
+template <typename T>
+class IntrusivePtr
+{
+public:
+    using Traits = RefcountTraits<T>;
+
+    IntrusivePtr() noexcept : m_ptr( nullptr ) {}
+
+    // The releaser must be the libvlc release function, which Traits knows about
+    template <typename Releaser>
+    IntrusivePtr( std::nullptr_t, Releaser releaser ) noexcept
+        : m_ptr( nullptr )
+    {
+        assert( Traits::isRelease( releaser ) == true );
+        (void)releaser;
+    }
+
+    IntrusivePtr( const IntrusivePtr& other ) noexcept
+        : m_ptr( other.m_ptr )
+    {
+        if ( m_ptr != nullptr )
+            Traits::retain( m_ptr );
+    }
+
+    IntrusivePtr( IntrusivePtr&& other ) noexcept
+        : m_ptr( other.m_ptr )
+    {
+        other.m_ptr = nullptr;
+    }
+
+    ~IntrusivePtr()
+    {
+        if ( m_ptr != nullptr )
+            Traits::release( m_ptr );
+    }
+
+    IntrusivePtr& operator=( const IntrusivePtr& other ) noexcept
+    {
+        IntrusivePtr( other ).swap( *this );
+        return *this;
+    }
+
+    IntrusivePtr& operator=( IntrusivePtr&& other ) noexcept
+    {
+        IntrusivePtr( std::move( other ) ).swap( *this );
+        return *this;
+    }
+
+    ///
+    /// \brief reset Adopts a reference to ptr, which the caller already owns
+    ///
+    /// The reference is always released with the libvlc release function,
+    /// which releaser must be.
+    ///
+    template <typename Releaser>
+    void reset( T* ptr, Releaser releaser )
+    {
+        assert( Traits::isRelease( releaser ) == true );
+        (void)releaser;
+        IntrusivePtr tmp;
+        tmp.m_ptr = ptr;
+        tmp.swap( *this );
+    }
+
+    void reset() noexcept
+    {
+        IntrusivePtr().swap( *this );
+    }
+
+    void swap( IntrusivePtr& other ) noexcept
+    {
+        std::swap( m_ptr, other.m_ptr );
+    }
+
+    T* get() const noexcept { return m_ptr; }
+    T* operator->() const noexcept { return m_ptr; }
+    explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+    bool operator==( const IntrusivePtr& other ) const noexcept { return m_ptr == other.m_ptr; }
+    bool operator!=( const IntrusivePtr& other ) const noexcept { return m_ptr != other.m_ptr; }
+
+private:
+    T* m_ptr;
+};
+
+} // namespace detail
+
 ///
 /// @brief The Internal class is a helper to wrap a raw libvlc type in a common
 ///         C++ type.
@@ -42,7 +201,14 @@ class Internal
     public:
         using InternalType  = T;
         using InternalPtr   = T*;
-        using Pointer       = std::shared_ptr<T>;
+        // Objects which libvlc can retain are shared through libvlc's own
+        // reference counter. A custom Releaser implies a custom ownership,
+        // which only a shared_ptr can express.
+        using Pointer       = typename std::conditional<
+                                detail::RefcountTraits<T>::Intrusive &&
+                                    std::is_same<Releaser, void(*)(T*)>::value,
+                                detail::IntrusivePtr<T>,
+                                std::shared_ptr<T>>::type;
 
         ///
         /// \brief get returns the underlying libvlc type, or nullptr if this
@@ -65,6 +231,10 @@ class Internal
         Internal() = default;
 
 
+        ///
+        /// Takes ownership of one reference to obj. When libvlc's reference
+        /// counter is used, releaser must be the libvlc release function for T.
+        ///
         Internal( InternalPtr obj, Releaser releaser )
         {
             if ( obj == nullptr )
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ * LatencyHistogram.hpp: Lock free duration histogram
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_LATENCYHISTOGRAM_H
+#define LIBVLC_CXX_LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace VLC
+{
+
+///
+/// \brief The LatencyHistogram class records durations with a bounded relative error
+///
+/// Values are bucketed HDR-style: values below 16ns get their own bucket,
+/// then each power of 2 is split in 16 linear sub buckets, which bounds the
+/// relative error to 1/16th. Values above 2^40ns (about 18 minutes) are
+/// clamped in the last bucket.
+/// Recording is lock free and wait free. When a histogram has a single
+/// writing thread, recordExclusive() avoids the atomic read-modify-writes.
+///
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned int SubBucketBits = 4;
+    static constexpr uint64_t SubBuckets = 1 << SubBucketBits;
+    static constexpr unsigned int MaxShift = 40 - SubBucketBits;
+    static constexpr size_t NbBuckets = SubBuckets + ( MaxShift + 1 ) * SubBuckets;
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record( uint64_t ns )
+    {
+        m_buckets[bucketIndex( ns )].fetch_add( 1, std::memory_order_relaxed );
+        m_count.fetch_add( 1, std::memory_order_relaxed );
+        m_sum.fetch_add( ns, std::memory_order_relaxed );
+        auto max = m_max.load( std::memory_order_relaxed );
+        while ( ns > max &&
+                m_max.compare_exchange_weak( max, ns, std::memory_order_relaxed ) == false )
+            ;
+    }
+
+    ///
+    /// \brief recordExclusive Records a value without atomic read-modify-write
+    ///        operations, which is only correct if no other thread records
+    ///        to this histogram. Readers can still query it concurrently.
+    ///
+    void recordExclusive( uint64_t ns )
+    {
+        auto& b = m_buckets[bucketIndex( ns )];
+        b.store( b.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        m_count.store( m_count.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        m_sum.store( m_sum.load( std::memory_order_relaxed ) + ns, std::memory_order_relaxed );
+        if ( ns > m_max.load( std::memory_order_relaxed ) )
+            m_max.store( ns, std::memory_order_relaxed );
+    }
+
+    uint64_t count() const
+    {
+        return m_count.load( std::memory_order_relaxed );
+    }
+
+    uint64_t max() const
+    {
+        return m_max.load( std::memory_order_relaxed );
+    }
+
+    uint64_t sum() const
+    {
+        return m_sum.load( std::memory_order_relaxed );
+    }
+
+    ///
+    /// \brief bucketCount Returns the number of values recorded in a bucket
+    /// \param idx A bucket index, below NbBuckets
+    ///
+    uint64_t bucketCount( size_t idx ) const
+    {
+        return m_buckets[idx].load( std::memory_order_relaxed );
+    }
+
+    double mean() const
+    {
+        auto c = count();
+        return c == 0 ? 0. : static_cast<double>( m_sum.load( std::memory_order_relaxed ) ) / c;
+    }
+
+    ///
+    /// \brief percentile Returns the highest value equivalent to the given percentile
+    /// \param p A percentile, between 0 and 100
+    ///
+    uint64_t percentile( double p ) const
+    {
+        auto total = count();
+        if ( total == 0 )
+            return 0;
+        auto target = static_cast<uint64_t>( p / 100. * total + .5 );
+        if ( target == 0 )
+            target = 1;
+        uint64_t acc = 0;
+        for ( auto i = 0u; i < NbBuckets; ++i )
+        {
+            acc += m_buckets[i].load( std::memory_order_relaxed );
+            if ( acc >= target )
+            {
+                auto v = highestEquivalentValue( i );
+                // Don't report more than what was actually recorded
+                return v < max() ? v : max();
+            }
+        }
+        return max();
+    }
+
+    void reset()
+    {
+        for ( auto& b : m_buckets )
+            b.store( 0, std::memory_order_relaxed );
+        m_count.store( 0, std::memory_order_relaxed );
+        m_sum.store( 0, std::memory_order_relaxed );
+        m_max.store( 0, std::memory_order_relaxed );
+    }
+
+    static size_t bucketIndex( uint64_t ns )
+    {
+        if ( ns < SubBuckets )
+            return static_cast<size_t>( ns );
+        auto shift = msb( ns ) - SubBucketBits;
+        if ( shift > MaxShift )
+            return NbBuckets - 1;
+        auto sub = ( ns >> shift ) - SubBuckets;
+        return static_cast<size_t>( SubBuckets + shift * SubBuckets + sub );
+    }
+
+    static uint64_t highestEquivalentValue( size_t idx )
+    {
+        if ( idx < SubBuckets )
+            return idx;
+        auto shift = ( idx - SubBuckets ) / SubBuckets;
+        auto sub = ( idx - SubBuckets ) % SubBuckets;
+        return ( ( SubBuckets + sub + 1 ) << shift ) - 1;
+    }
+
+private:
+    static unsigned int msb( uint64_t v )
+    {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll( v );
+#else
+        unsigned int r = 0;
+        while ( v >>= 1 )
+            ++r;
+        return r;
+#endif
+    }
+
+private:
+    std::atomic<uint64_t> m_buckets[NbBuckets];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_LATENCYHISTOGRAM_H
@@ -0,0 +1,408 @@
+/*****************************************************************************
+ * LatestFrame.hpp: Triple buffered latest video frame handoff
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_LATESTFRAME_H
+#define LIBVLC_CXX_LATESTFRAME_H
+
+#include "FramePool.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+///
+/// \brief The TripleBufferIndex class implements the index exchange of a
+///        single producer, single consumer triple buffer.
+///
+/// The producer owns the back buffer, the consumer owns the front one, and
+/// the middle one is exchanged between them through a single atomic byte,
+/// which also carries a flag telling whether it holds an unread value.
+/// Neither side ever waits for the other.
+///
+class TripleBufferIndex
+{
+public:
+    static constexpr uint8_t Fresh = 0x4;
+    static constexpr uint8_t IndexMask = 0x3;
+
+    TripleBufferIndex()
+        : m_back( 0 )
+        , m_middle( 1 )
+        , m_front( 2 )
+    {
+    }
+
+    ///
+    /// \brief back Returns the index of the buffer the producer can write to
+    ///
+    unsigned back() const
+    {
+        return m_back;
+    }
+
+    ///
+    /// \brief publish Makes the back buffer available to the consumer
+    /// \return true if the previously published buffer was never read
+    ///
+    bool publish()
+    {
+        auto prev = m_middle.exchange( static_cast<uint8_t>( m_back | Fresh ),
+                                       std::memory_order_acq_rel );
+        m_back = prev & IndexMask;
+        return ( prev & Fresh ) != 0;
+    }
+
+    ///
+    /// \brief acquire Takes the most recently published buffer, if any
+    /// \return true if the front buffer changed
+    ///
+    bool acquire()
+    {
+        if ( ( m_middle.load( std::memory_order_relaxed ) & Fresh ) == 0 )
+            return false;
+        auto prev = m_middle.exchange( static_cast<uint8_t>( m_front ), std::memory_order_acq_rel );
+        m_front = prev & IndexMask;
+        return true;
+    }
+
+    ///
+    /// \brief front Returns the index of the buffer the consumer can read
+    ///
+    unsigned front() const
+    {
+        return m_front;
+    }
+
+private:
+    // Only accessed by the producer
+    unsigned m_back;
+    std::atomic<uint8_t> m_middle;
+    // Only accessed by the consumer
+    unsigned m_front;
+};
+
+} // namespace detail
+
+///
+/// \brief The LatestFrame class lets a reader thread access the most recent
+///        decoded frame, without ever blocking libvlc's decoding.
+///
+/// The frames are decoded into one of three buffers. When libvlc displays a
+/// frame, it is published for the reader, and replaces the previously
+/// published one if the reader didn't pick it up. The reader always gets the
+/// newest complete frame, which the decoder won't touch until the reader
+/// moves on to a newer one.
+/// Publishing and acquiring a frame each cost a single atomic exchange.
+///
+/// There must be a single reader thread.
+///
+class LatestFrame
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : chroma( "RV32" )
+            , width( 0 )
+            , height( 0 )
+            , hugePages( false )
+        {
+        }
+
+        /// The fourcc of the pictures to decode to
+        std::string chroma;
+        /// The fourccs the reader can also handle. See FramePool::Configuration
+        std::vector<std::string> nativeChromas;
+        /// The pictures dimensions. See FramePool::Configuration
+        unsigned width;
+        unsigned height;
+        /// Try to back the buffers with huge pages (Linux only)
+        bool hugePages;
+    };
+
+    struct Stats
+    {
+        /// Number of frames made available to the reader
+        uint64_t published;
+        /// Number of published frames which were replaced before being read
+        uint64_t overwritten;
+        /// Number of frames the reader picked up
+        uint64_t acquired;
+        /// True if the current format is the decoder's one
+        bool passthrough;
+    };
+
+    ///
+    /// \brief The Frame struct describes the frame currently owned by the
+    ///        reader. It remains valid until the next call to acquire().
+    ///
+    struct Frame
+    {
+        const uint8_t* plane( unsigned idx ) const
+        {
+            return buffer + layout->offsets[idx];
+        }
+
+        unsigned pitch( unsigned idx ) const
+        {
+            return layout->pitches[idx];
+        }
+
+        unsigned lines( unsigned idx ) const
+        {
+            return layout->lines[idx];
+        }
+
+        unsigned width() const
+        {
+            return layout->width;
+        }
+
+        unsigned height() const
+        {
+            return layout->height;
+        }
+
+        const char* chroma() const
+        {
+            return layout->chroma;
+        }
+
+        /// The frame number, in decoding order
+        uint64_t sequence;
+        const uint8_t* buffer;
+        const PictureLayout* layout;
+    };
+
+private:
+    // The buffers allocated for a given format. Frames keep the generation
+    // they were decoded to alive, so the reader can still use its frame
+    // after a format change.
+    struct Generation
+    {
+        Generation( const PictureLayout& l, bool hugePages )
+            : layout( l )
+            , memory( l.size * 3, hugePages )
+        {
+        }
+
+        PictureLayout layout;
+        detail::PictureMemory memory;
+    };
+
+    struct Slot
+    {
+        std::shared_ptr<Generation> generation;
+        uint8_t* buffer;
+        uint64_t sequence;
+    };
+
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_negotiator( m_config.chroma, m_config.nativeChromas,
+                            m_config.width, m_config.height )
+            , m_sequence( 0 )
+            , m_published( 0 )
+            , m_overwritten( 0 )
+            , m_passthrough( false )
+            , m_acquired( 0 )
+            , m_hasFrame( false )
+        {
+        }
+
+        uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                        uint32_t* pitches, uint32_t* lines )
+        {
+            FormatNegotiator::Result format;
+            if ( m_negotiator.negotiate( chroma, width, height, pitches, lines, format ) == false )
+                return 0;
+            m_passthrough.store( format.passthrough, std::memory_order_relaxed );
+            const auto& layout = format.layout;
+            if ( m_current == nullptr || m_current->layout != layout )
+            {
+                try
+                {
+                    m_current = std::make_shared<Generation>( layout, m_config.hugePages );
+                }
+                catch ( const std::bad_alloc& )
+                {
+                    m_current.reset();
+                    return 0;
+                }
+            }
+            // A single picture: libvlc won't lock a new one before the
+            // previous one was displayed or dropped.
+            return 1;
+        }
+
+        void* lock( void** planes )
+        {
+            auto idx = m_index.back();
+            auto& slot = m_slots[idx];
+            // The back buffer belongs to the decoder, so it can be moved to
+            // the current generation without synchronization.
+            if ( slot.generation != m_current )
+            {
+                slot.generation = m_current;
+                slot.buffer = m_current->memory.data() + idx * m_current->layout.size;
+            }
+            const auto& layout = m_current->layout;
+            for ( auto i = 0u; i < layout.nbPlanes; ++i )
+                planes[i] = slot.buffer + layout.offsets[i];
+            return &slot;
+        }
+
+        void display( void* picture )
+        {
+            auto& slot = m_slots[m_index.back()];
+            if ( picture != &slot )
+                return;
+            slot.sequence = m_sequence++;
+            if ( m_index.publish() == true )
+                m_overwritten.fetch_add( 1, std::memory_order_relaxed );
+            m_published.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        const Frame* acquire()
+        {
+            if ( m_index.acquire() == true )
+            {
+                const auto& slot = m_slots[m_index.front()];
+                m_frame.sequence = slot.sequence;
+                m_frame.buffer = slot.buffer;
+                m_frame.layout = &slot.generation->layout;
+                m_hasFrame = true;
+                m_acquired.fetch_add( 1, std::memory_order_relaxed );
+            }
+            return m_hasFrame ? &m_frame : nullptr;
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            s.published = m_published.load( std::memory_order_relaxed );
+            s.overwritten = m_overwritten.load( std::memory_order_relaxed );
+            s.acquired = m_acquired.load( std::memory_order_relaxed );
+            s.passthrough = m_passthrough.load( std::memory_order_relaxed );
+            return s;
+        }
+
+    private:
+        Configuration m_config;
+        FormatNegotiator m_negotiator;
+        detail::TripleBufferIndex m_index;
+        std::array<Slot, 3> m_slots;
+        // Decoder side
+        std::shared_ptr<Generation> m_current;
+        uint64_t m_sequence;
+        std::atomic<uint64_t> m_published;
+        std::atomic<uint64_t> m_overwritten;
+        std::atomic<bool> m_passthrough;
+        // Reader side
+        std::atomic<uint64_t> m_acquired;
+        Frame m_frame;
+        bool m_hasFrame;
+    };
+
+public:
+    explicit LatestFrame( Configuration config = Configuration() )
+        : m_state( std::make_shared<State>( std::move( config ) ) )
+    {
+    }
+
+    ///
+    /// \brief attach Sets the video format & video callbacks of the provided
+    ///               player, so that it decodes to this object.
+    ///
+    /// This must be called before the playback starts.
+    ///
+    void attach( MediaPlayer& mp )
+    {
+        auto state = m_state;
+        mp.setVideoFormatCallbacks(
+            [state]( char* chroma, uint32_t* width, uint32_t* height,
+                     uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return state->setup( chroma, width, height, pitches, lines );
+            }, nullptr );
+        mp.setVideoCallbacks(
+            [state]( void** planes ) -> void* { return state->lock( planes ); },
+            nullptr,
+            [state]( void* picture ) { state->display( picture ); } );
+    }
+
+    ///
+    /// \brief acquire Returns the most recent frame
+    ///
+    /// If no new frame was published since the last call, the same frame is
+    /// returned again; its sequence number tells whether it changed.
+    /// The previously returned frame must not be used anymore.
+    ///
+    /// \return The frame, or nullptr if no frame was published yet.
+    ///
+    const Frame* acquire()
+    {
+        return m_state->acquire();
+    }
+
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setVideoFormatCallbacks
+    /// and MediaPlayer::setVideoCallbacks prototypes, for callers which need
+    /// to wrap them.
+    ///
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        return m_state->setup( chroma, width, height, pitches, lines );
+    }
+
+    void* lock( void** planes )
+    {
+        return m_state->lock( planes );
+    }
+
+    void display( void* picture )
+    {
+        m_state->display( picture );
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_LATESTFRAME_H
@@ -781,7 +781,7 @@ public:
     {
         static_assert(signature_match_or_nullptr<VolumeCb, void(float, bool)>::value, "Mismatched set volume callback");
         libvlc_audio_set_volume_callback(*this,
-            CallbackWrapper<(unsigned int)CallbackIdx::AudioVolume, libvlc_audio_set_volume_cb>::wrap( this, std::forward<VolumeCb>( func ) ) );
+            CallbackWrapper<(unsigned int)CallbackIdx::AudioVolume, libvlc_audio_set_volume_cb>::wrap( *m_callbacks, std::forward<VolumeCb>( func ) ) );
     }
 
     /**
@@ -804,8 +804,8 @@ public:
         static_assert(signature_match_or_nullptr<CleanupCb, void()>::value, "Mismatched cleanup callback");
 
         libvlc_audio_set_format_callbacks(*this,
-            CallbackWrapper<(unsigned int)CallbackIdx::AudioSetup, libvlc_audio_setup_cb>::wrap( this, std::forward<SetupCb>( setup ) ),
-            CallbackWrapper<(unsigned int)CallbackIdx::AudioCleanup, libvlc_audio_cleanup_cb>::wrap( this, std::forward<CleanupCb>( cleanup ) ) );
+            CallbackWrapper<(unsigned int)CallbackIdx::AudioSetup, libvlc_audio_setup_cb>::wrap( *m_callbacks, std::forward<SetupCb>( setup ) ),
+            CallbackWrapper<(unsigned int)CallbackIdx::AudioCleanup, libvlc_audio_cleanup_cb>::wrap( *m_callbacks, std::forward<CleanupCb>( cleanup ) ) );
     }
 
     /**
@@ -1192,6 +1192,8 @@ public:
      *                                              unsigned *pitches, // Must be filled with the required pitch for each plane
      *                                              unsigned *lines);  // Must be filled with the required number of lines for each plane
      *              The return value reprensent the amount of pictures to create in a pool. 0 to indicate an error
+     *              On input, chroma, width & height hold the decoder's output format. Keeping them
+     *              avoids a conversion; VLC::FormatNegotiator implements this negotiation.
      *
      * \param cleanup  callback to release any allocated resources (or nullptr)
      *                 Expected prototype is void()
@@ -0,0 +1,135 @@
+/*****************************************************************************
+ * MediaSource.hpp: Media backed by a custom byte source
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_MEDIASOURCE_H
+#define LIBVLC_CXX_MEDIASOURCE_H
+
+#include "Instance.hpp"
+#include "Media.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace VLC
+{
+
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(3, 0, 0, 0)
+
+namespace detail
+{
+
+namespace source
+{
+
+// The callbacks of a media reading from a Source. The open callback creates
+// a stream for each player, which becomes the opaque of the other ones.
+template <typename Source>
+struct Callbacks
+{
+    using Stream = typename Source::Stream;
+
+    struct Open
+    {
+        int operator()( void*, void** datap, uint64_t* sizep ) const
+        {
+            std::unique_ptr<Stream> stream;
+            // An exception can't unwind through libvlc, it fails the opening
+            try
+            {
+                stream = source.open();
+            }
+            catch ( ... )
+            {
+                return -1;
+            }
+            if ( stream == nullptr )
+                return -1;
+            *sizep = stream->size();
+            *datap = stream.release();
+            return 0;
+        }
+
+        Source source;
+    };
+
+    static ptrdiff_t read( void* opaque, unsigned char* buf, size_t len )
+    {
+        return static_cast<Stream*>( opaque )->read( buf, len );
+    }
+
+    static int seek( void* opaque, uint64_t offset )
+    {
+        return static_cast<Stream*>( opaque )->seek( offset );
+    }
+
+    static void close( void* opaque )
+    {
+        delete static_cast<Stream*>( opaque );
+    }
+};
+
+} // namespace source
+
+} // namespace detail
+
+///
+/// \brief mediaFromSource Creates a media which reads from the provided source
+///
+/// A source is a copyable type which provides:
+/// - a Stream type, with the following members:
+///   - ptrdiff_t read( unsigned char* buf, size_t len ), matching
+///     Media::ExpectedMediaReadCb
+///   - int seek( uint64_t offset ), matching Media::ExpectedMediaSeekCb
+///   - uint64_t size() const, which returns 0 if the size is unknown
+/// - std::unique_ptr<Stream> open() const, which returns nullptr on failure.
+///   An exception thrown by open() fails the opening as well.
+///
+/// The media keeps a copy of the source, and opens a stream each time a
+/// player opens the media. Several players can use the same media, so
+/// open() must be reentrant, while each stream is only used by one player
+/// at a time.
+///
+/// \throw std::runtime_error if the media creation fails
+///
+#if LIBVLC_VERSION_INT >= LIBVLC_VERSION(4, 0, 0, 0)
+template <typename Source>
+Media mediaFromSource( Source source )
+{
+    using Callbacks = detail::source::Callbacks<Source>;
+    return Media( typename Callbacks::Open{ std::move( source ) }, &Callbacks::read,
+                  &Callbacks::seek, &Callbacks::close );
+}
+#else
+template <typename Source>
+Media mediaFromSource( const Instance& instance, Source source )
+{
+    using Callbacks = detail::source::Callbacks<Source>;
+    return Media( instance, typename Callbacks::Open{ std::move( source ) }, &Callbacks::read,
+                  &Callbacks::seek, &Callbacks::close );
+}
+#endif
+
+#endif
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_MEDIASOURCE_H
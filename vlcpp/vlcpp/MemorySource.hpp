@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * MemorySource.hpp: Media source reading from an immutable memory buffer
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_MEMORYSOURCE_H
+#define LIBVLC_CXX_MEMORYSOURCE_H
+
+#include "MediaSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace VLC
+{
+
+///
+/// \brief The MemorySource class serves a media from bytes already held in
+///        memory, for use with mediaFromSource().
+///
+/// The bytes are never copied, besides the copy to the buffer libvlc
+/// provides to each read. They must remain immutable while the source, or
+/// any of its streams, exists: the source shares the ownership of the bytes
+/// through a reference counted owner, so that many players can read the
+/// same buffer, each at its own position, and the last one to close its
+/// stream releases it.
+///
+/// \code
+/// auto blob = std::make_shared<const std::vector<uint8_t>>( load() );
+/// auto media = VLC::mediaFromSource( instance, VLC::MemorySource( blob ) );
+/// \endcode
+///
+class MemorySource
+{
+public:
+    class Stream
+    {
+    public:
+        Stream( std::shared_ptr<const void> owner, const uint8_t* data, size_t size )
+            : m_owner( std::move( owner ) )
+            , m_data( data )
+            , m_size( size )
+            , m_position( 0 )
+        {
+        }
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            auto n = m_size - m_position;
+            if ( len < n )
+                n = len;
+            if ( n > 0 )
+            {
+                memcpy( buf, m_data + m_position, n );
+                m_position += n;
+            }
+            return static_cast<ptrdiff_t>( n );
+        }
+
+        int seek( uint64_t offset )
+        {
+            if ( offset > m_size )
+                return -1;
+            m_position = static_cast<size_t>( offset );
+            return 0;
+        }
+
+        uint64_t size() const
+        {
+            return m_size;
+        }
+
+        uint64_t position() const
+        {
+            return m_position;
+        }
+
+    private:
+        std::shared_ptr<const void> m_owner;
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_position;
+    };
+
+    ///
+    /// \brief MemorySource Serves the bytes of a contiguous container, such
+    ///                     as a std::vector<uint8_t> or a std::string.
+    ///
+    template <typename Container>
+    explicit MemorySource( std::shared_ptr<const Container> buffer )
+        : m_data( buffer != nullptr ? reinterpret_cast<const uint8_t*>( buffer->data() ) : nullptr )
+        , m_size( buffer != nullptr ? buffer->size() * sizeof( *buffer->data() ) : 0 )
+        , m_owner( std::move( buffer ) )
+    {
+        if ( m_owner == nullptr )
+            throw std::invalid_argument( "The buffer can't be null" );
+    }
+
+    template <typename Container>
+    explicit MemorySource( std::shared_ptr<Container> buffer )
+        : MemorySource( std::shared_ptr<const Container>( std::move( buffer ) ) )
+    {
+    }
+
+    ///
+    /// \brief MemorySource Serves size bytes from data, which owner keeps
+    ///                     alive. The owner can be null if the bytes outlive
+    ///                     all the players, such as static data.
+    ///
+    MemorySource( const void* data, size_t size, std::shared_ptr<const void> owner )
+        : m_data( static_cast<const uint8_t*>( data ) )
+        , m_size( size )
+        , m_owner( std::move( owner ) )
+    {
+        if ( data == nullptr && size > 0 )
+            throw std::invalid_argument( "The buffer can't be null" );
+    }
+
+    std::unique_ptr<Stream> open() const
+    {
+        return std::unique_ptr<Stream>( new Stream( m_owner, m_data, m_size ) );
+    }
+
+    const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    std::shared_ptr<const void> m_owner;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_MEMORYSOURCE_H
@@ -0,0 +1,232 @@
+/*****************************************************************************
+ * MmapSource.hpp: Media source reading from a memory mapped file
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_MMAPSOURCE_H
+#define LIBVLC_CXX_MMAPSOURCE_H
+
+#if defined(_WIN32)
+# error "The memory mapped file source is only available on POSIX systems"
+#endif
+
+#include "MediaSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace VLC
+{
+
+///
+/// \brief The MmapSource class serves a media from a memory mapped file, for
+///        use with mediaFromSource().
+///
+/// Each stream maps the whole file, and serves the reads with a copy from the
+/// mapping, so that a read doesn't cost a system call once the pages are
+/// resident. As the position moves forward, the stream asks the kernel to
+/// read ahead of it with MADV_WILLNEED, and releases the pages it left far
+/// behind with MADV_DONTNEED, which keeps the resident size of long files
+/// bounded. The pages remain in the page cache, so another stream of the same
+/// file, or a backward seek, only costs minor faults.
+///
+/// The file must not be truncated while it's mapped: reading the missing pages
+/// would raise SIGBUS. On 32 bits systems, the file must fit in the address
+/// space.
+///
+class MmapSource
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : readahead( 8 * 1024 * 1024 )
+            , keepBehind( 2 * 1024 * 1024 )
+            , dropBehind( true )
+        {
+        }
+
+        /// How far ahead of the position the kernel is asked to read. The
+        /// hint is renewed when half of it was consumed.
+        size_t readahead;
+        /// How much is kept mapped behind the position, before being
+        /// released, for the small backward seeks demuxers do.
+        size_t keepBehind;
+        /// Whether the pages behind the position are released
+        bool dropBehind;
+    };
+
+    class Stream
+    {
+    public:
+        Stream( uint8_t* map, size_t size, const Configuration& config )
+            : m_map( map )
+            , m_size( size )
+            , m_config( config )
+            , m_page( static_cast<size_t>( sysconf( _SC_PAGESIZE ) ) )
+            , m_position( 0 )
+            , m_nextAdvice( 0 )
+            , m_dropped( 0 )
+        {
+        }
+
+        ~Stream()
+        {
+            if ( m_map != nullptr )
+                munmap( m_map, m_size );
+        }
+
+        Stream( const Stream& ) = delete;
+        Stream& operator=( const Stream& ) = delete;
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            auto n = m_size - m_position;
+            if ( len < n )
+                n = len;
+            if ( n == 0 )
+                return 0;
+            if ( m_position + n > m_nextAdvice )
+                advise();
+            memcpy( buf, m_map + m_position, n );
+            m_position += n;
+            return static_cast<ptrdiff_t>( n );
+        }
+
+        int seek( uint64_t offset )
+        {
+            if ( offset > m_size )
+                return -1;
+            m_position = static_cast<size_t>( offset );
+            // Renew the hints from the new position
+            m_nextAdvice = 0;
+            if ( m_position < m_dropped )
+                m_dropped = m_position & ~( m_page - 1 );
+            return 0;
+        }
+
+        uint64_t size() const
+        {
+            return m_size;
+        }
+
+        uint64_t position() const
+        {
+            return m_position;
+        }
+
+    private:
+        void advise()
+        {
+            auto start = m_position & ~( m_page - 1 );
+            auto end = m_size - start > m_config.readahead ? start + m_config.readahead : m_size;
+            madvise( m_map + start, end - start, MADV_WILLNEED );
+            m_nextAdvice = end == m_size ? m_size : start + m_config.readahead / 2;
+            if ( m_config.dropBehind == false || start < m_config.keepBehind )
+                return;
+            auto drop = ( start - m_config.keepBehind ) & ~( m_page - 1 );
+            if ( drop > m_dropped )
+            {
+                madvise( m_map + m_dropped, drop - m_dropped, MADV_DONTNEED );
+                m_dropped = drop;
+            }
+        }
+
+    private:
+        uint8_t* m_map;
+        size_t m_size;
+        const Configuration m_config;
+        const size_t m_page;
+        size_t m_position;
+        // The position from which the readahead hint must be renewed
+        size_t m_nextAdvice;
+        // Everything before this offset was released
+        size_t m_dropped;
+    };
+
+    ///
+    /// \brief MmapSource Creates a source for the provided file
+    ///
+    /// The file is only opened by each stream, so a missing file makes the
+    /// player fail to open the media.
+    ///
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit MmapSource( std::string path, Configuration config = Configuration() )
+        : m_path( std::move( path ) )
+        , m_config( std::move( config ) )
+    {
+        if ( m_config.readahead == 0 )
+            throw std::invalid_argument( "The readahead window can't be empty" );
+    }
+
+    std::unique_ptr<Stream> open() const
+    {
+        auto fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC );
+        if ( fd < 0 )
+            return nullptr;
+        struct stat st;
+        if ( fstat( fd, &st ) != 0 || S_ISREG( st.st_mode ) == false ||
+             static_cast<uint64_t>( st.st_size ) > std::numeric_limits<size_t>::max() )
+        {
+            close( fd );
+            return nullptr;
+        }
+        auto size = static_cast<size_t>( st.st_size );
+        uint8_t* map = nullptr;
+        // An empty file can't be mapped, and doesn't need to
+        if ( size > 0 )
+        {
+            auto m = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( m == MAP_FAILED )
+            {
+                close( fd );
+                return nullptr;
+            }
+            map = static_cast<uint8_t*>( m );
+            madvise( map, size, MADV_SEQUENTIAL );
+        }
+        // The mapping keeps the file referenced
+        close( fd );
+        return std::unique_ptr<Stream>( new Stream( map, size, m_config ) );
+    }
+
+    const std::string& path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+    Configuration m_config;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_MMAPSOURCE_H
@@ -0,0 +1,438 @@
+/*****************************************************************************
+ * PrefetchSource.hpp: Asynchronous read-ahead for Media sources
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_PREFETCHSOURCE_H
+#define LIBVLC_CXX_PREFETCHSOURCE_H
+
+#include "MediaSource.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace prefetch
+{
+
+// Outside of the PrefetchSource template, so that they don't depend on the
+// wrapped source type
+struct Configuration
+{
+    Configuration()
+        : chunkSize( 256 * 1024 )
+        , nbChunks( 16 )
+    {
+    }
+
+    /// The size of each read of the wrapped stream
+    size_t chunkSize;
+    /// The number of chunks in the ring, which sets how far ahead of the
+    /// position the prefetching goes.
+    size_t nbChunks;
+};
+
+struct Stats
+{
+    /// Number of reads, which were served without waiting (hits) or had
+    /// to wait for the wrapped stream (misses)
+    uint64_t reads;
+    uint64_t hits;
+    uint64_t misses;
+    /// The time spent waiting by the misses
+    std::chrono::nanoseconds stallTime;
+    /// Number of seeks, and of those which reprimed the ring
+    uint64_t seeks;
+    uint64_t reprimes;
+    /// Bytes read from the wrapped streams, and discarded by reprimes
+    uint64_t prefetched;
+    uint64_t discarded;
+};
+
+} // namespace prefetch
+
+} // namespace detail
+
+///
+/// \brief The PrefetchSource class reads another source ahead of the
+///        player, from a background thread, for use with mediaFromSource().
+///
+/// libvlc calls the read callback from its input thread, so any latency of
+/// the storage directly stalls the demuxer. Each stream of a PrefetchSource
+/// runs the wrapped stream on its own thread, which keeps a ring of chunks
+/// filled ahead of the read position. Reads are then served from memory, and
+/// only wait when the ring is empty.
+///
+/// A seek within the prefetched data only skips it. Any other seek cancels
+/// the prefetching: the chunk being read is discarded once the wrapped read
+/// returns, and the ring is primed again from the new position. The wrapped
+/// stream is only ever used from the background thread, so a failed seek of
+/// the wrapped stream is reported by the next read.
+///
+/// Destroying a stream waits for the wrapped read in progress, if any.
+///
+template <typename Source>
+class PrefetchSource
+{
+public:
+    using Configuration = detail::prefetch::Configuration;
+    using Stats = detail::prefetch::Stats;
+
+private:
+    // Shared by all the streams of a source
+    struct Counters
+    {
+        Counters()
+            : reads( 0 ), hits( 0 ), misses( 0 ), stallTime( 0 )
+            , seeks( 0 ), reprimes( 0 ), prefetched( 0 ), discarded( 0 )
+        {
+        }
+
+        std::atomic<uint64_t> reads;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> stallTime;
+        std::atomic<uint64_t> seeks;
+        std::atomic<uint64_t> reprimes;
+        std::atomic<uint64_t> prefetched;
+        std::atomic<uint64_t> discarded;
+    };
+
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.fetch_add( v, std::memory_order_relaxed );
+    }
+
+public:
+    class Stream
+    {
+    public:
+        Stream( std::unique_ptr<typename Source::Stream> inner, const Configuration& config,
+                std::shared_ptr<Counters> counters )
+            : m_inner( std::move( inner ) )
+            , m_size( m_inner->size() )
+            , m_chunkSize( config.chunkSize )
+            , m_counters( std::move( counters ) )
+            , m_chunks( config.nbChunks )
+            , m_head( 0 )
+            , m_count( 0 )
+            , m_position( 0 )
+            , m_generation( 0 )
+            , m_target( 0 )
+            , m_eof( false )
+            , m_error( false )
+            , m_stop( false )
+        {
+            for ( auto& c : m_chunks )
+            {
+                c.data.reset( new uint8_t[m_chunkSize] );
+                c.size = c.consumed = 0;
+            }
+            m_worker = std::thread( &Stream::prefetch, this );
+        }
+
+        ~Stream()
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_lock );
+                m_stop = true;
+            }
+            m_spaceCond.notify_one();
+            m_worker.join();
+        }
+
+        Stream( const Stream& ) = delete;
+        Stream& operator=( const Stream& ) = delete;
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            if ( len == 0 )
+                return 0;
+            std::unique_lock<std::mutex> lock( m_lock );
+            add( m_counters->reads, 1 );
+            if ( m_count == 0 && m_eof == false && m_error == false )
+            {
+                auto start = std::chrono::steady_clock::now();
+                m_dataCond.wait( lock, [this]() {
+                    return m_count > 0 || m_eof == true || m_error == true;
+                } );
+                auto stall = std::chrono::steady_clock::now() - start;
+                add( m_counters->misses, 1 );
+                add( m_counters->stallTime, static_cast<uint64_t>(
+                         std::chrono::duration_cast<std::chrono::nanoseconds>( stall ).count() ) );
+            }
+            else
+                add( m_counters->hits, 1 );
+            if ( m_count == 0 )
+                return m_error == true ? -1 : 0;
+            size_t done = 0;
+            bool freed = false;
+            while ( done < len && m_count > 0 )
+            {
+                auto& c = m_chunks[m_head];
+                auto n = c.size - c.consumed;
+                if ( len - done < n )
+                    n = len - done;
+                memcpy( buf + done, c.data.get() + c.consumed, n );
+                c.consumed += n;
+                done += n;
+                if ( c.consumed == c.size )
+                {
+                    pop();
+                    freed = true;
+                }
+            }
+            m_position += done;
+            lock.unlock();
+            if ( freed == true )
+                m_spaceCond.notify_one();
+            return static_cast<ptrdiff_t>( done );
+        }
+
+        int seek( uint64_t offset )
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+            if ( m_size != 0 && offset > m_size )
+                return -1;
+            add( m_counters->seeks, 1 );
+            if ( offset >= m_position && offset - m_position <= buffered() )
+            {
+                // Skip what the ring already holds
+                auto skip = offset - m_position;
+                bool freed = false;
+                while ( skip > 0 )
+                {
+                    auto& c = m_chunks[m_head];
+                    auto n = c.size - c.consumed;
+                    if ( skip < n )
+                        n = static_cast<size_t>( skip );
+                    c.consumed += n;
+                    skip -= n;
+                    if ( c.consumed == c.size )
+                    {
+                        pop();
+                        freed = true;
+                    }
+                }
+                m_position = offset;
+                lock.unlock();
+                if ( freed == true )
+                    m_spaceCond.notify_one();
+                return 0;
+            }
+            add( m_counters->reprimes, 1 );
+            add( m_counters->discarded, buffered() );
+            ++m_generation;
+            m_target = offset;
+            m_position = offset;
+            m_count = 0;
+            m_eof = m_error = false;
+            lock.unlock();
+            m_spaceCond.notify_one();
+            return 0;
+        }
+
+        uint64_t size() const
+        {
+            return m_size;
+        }
+
+        uint64_t position() const
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            return m_position;
+        }
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<uint8_t[]> data;
+            size_t size;
+            size_t consumed;
+        };
+
+        // Releases the head chunk. Called with the lock held.
+        void pop()
+        {
+            m_head = ( m_head + 1 ) % m_chunks.size();
+            --m_count;
+        }
+
+        // The number of bytes the ring holds. Called with the lock held.
+        uint64_t buffered() const
+        {
+            uint64_t n = 0;
+            for ( auto i = 0u; i < m_count; ++i )
+            {
+                const auto& c = m_chunks[( m_head + i ) % m_chunks.size()];
+                n += c.size - c.consumed;
+            }
+            return n;
+        }
+
+        void prefetch()
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+            // The wrapped stream starts at 0, even if a seek happened before
+            // this thread started.
+            uint64_t generation = 0;
+            bool seek = false;
+            while ( true )
+            {
+                m_spaceCond.wait( lock, [this, generation]() {
+                    return m_stop == true || m_generation != generation ||
+                           ( m_count < m_chunks.size() && m_eof == false && m_error == false );
+                } );
+                if ( m_stop == true )
+                    return;
+                if ( m_generation != generation )
+                {
+                    generation = m_generation;
+                    seek = true;
+                    continue;
+                }
+                auto& c = m_chunks[( m_head + m_count ) % m_chunks.size()];
+                auto target = m_target;
+                lock.unlock();
+
+                // The wrapped stream is only used from this thread, without
+                // the lock, so that reads & seeks don't wait for it.
+                ptrdiff_t n = -1;
+                if ( seek == false || m_inner->seek( target ) == 0 )
+                    n = m_inner->read( c.data.get(), m_chunkSize );
+
+                lock.lock();
+                if ( m_generation != generation )
+                {
+                    // Cancelled by a seek
+                    if ( n > 0 )
+                        add( m_counters->discarded, static_cast<uint64_t>( n ) );
+                    continue;
+                }
+                seek = false;
+                if ( n < 0 )
+                    m_error = true;
+                else if ( n == 0 )
+                    m_eof = true;
+                else
+                {
+                    add( m_counters->prefetched, static_cast<uint64_t>( n ) );
+                    c.size = static_cast<size_t>( n );
+                    c.consumed = 0;
+                    ++m_count;
+                }
+                m_dataCond.notify_one();
+            }
+        }
+
+    private:
+        const std::unique_ptr<typename Source::Stream> m_inner;
+        const uint64_t m_size;
+        const size_t m_chunkSize;
+        const std::shared_ptr<Counters> m_counters;
+        mutable std::mutex m_lock;
+        std::condition_variable m_dataCond;
+        std::condition_variable m_spaceCond;
+        std::vector<Chunk> m_chunks;
+        size_t m_head;
+        size_t m_count;
+        uint64_t m_position;
+        // Incremented by each seek which cancels the prefetching, which then
+        // resumes from m_target
+        uint64_t m_generation;
+        uint64_t m_target;
+        bool m_eof;
+        bool m_error;
+        bool m_stop;
+        std::thread m_worker;
+    };
+
+    ///
+    /// \brief PrefetchSource Wraps the provided source
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit PrefetchSource( Source source, Configuration config = Configuration() )
+        : m_source( std::move( source ) )
+        , m_config( std::move( config ) )
+        , m_counters( std::make_shared<Counters>() )
+    {
+        if ( m_config.chunkSize == 0 || m_config.nbChunks == 0 )
+            throw std::invalid_argument( "The prefetch ring can't be empty" );
+    }
+
+    std::unique_ptr<Stream> open() const
+    {
+        auto inner = m_source.open();
+        if ( inner == nullptr )
+            return nullptr;
+        return std::unique_ptr<Stream>( new Stream( std::move( inner ), m_config, m_counters ) );
+    }
+
+    ///
+    /// \brief stats Returns the statistics of all the streams of this source,
+    ///              and of its copies
+    ///
+    Stats stats() const
+    {
+        Stats s;
+        s.reads = m_counters->reads.load( std::memory_order_relaxed );
+        s.hits = m_counters->hits.load( std::memory_order_relaxed );
+        s.misses = m_counters->misses.load( std::memory_order_relaxed );
+        s.stallTime = std::chrono::nanoseconds(
+                    m_counters->stallTime.load( std::memory_order_relaxed ) );
+        s.seeks = m_counters->seeks.load( std::memory_order_relaxed );
+        s.reprimes = m_counters->reprimes.load( std::memory_order_relaxed );
+        s.prefetched = m_counters->prefetched.load( std::memory_order_relaxed );
+        s.discarded = m_counters->discarded.load( std::memory_order_relaxed );
+        return s;
+    }
+
+private:
+    Source m_source;
+    Configuration m_config;
+    std::shared_ptr<Counters> m_counters;
+};
+
+///
+/// \brief prefetch Wraps a source with a PrefetchSource
+///
+template <typename Source>
+PrefetchSource<Source> prefetch( Source source, detail::prefetch::Configuration config =
+                                     detail::prefetch::Configuration() )
+{
+    return PrefetchSource<Source>( std::move( source ), std::move( config ) );
+}
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_PREFETCHSOURCE_H
@@ -0,0 +1,390 @@
+/*****************************************************************************
+ * SharedFramePublisher.hpp: Exports decoded frames through shared memory
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_SHAREDFRAMEPUBLISHER_H
+#define LIBVLC_CXX_SHAREDFRAMEPUBLISHER_H
+
+#include "FramePool.hpp"
+#include "SharedFrameReader.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace VLC
+{
+
+///
+/// \brief The SharedFramePublisher class lets libvlc decode straight into a
+///        ring of shared memory slots, which other processes map with a
+///        SharedFrameReader.
+///
+/// The ring is created with a fixed slot size, either from a named POSIX
+/// shared memory object, or from an anonymous memfd whose descriptor is then
+/// handed to the readers. Each slot carries a small header with the frame
+/// sequence, timestamps, geometry & chroma, so the format can change during
+/// playback as long as the pictures fit in a slot.
+///
+/// libvlc decodes into the oldest slot, and a displayed frame is published by
+/// bumping the ring's frame counter and waking the readers through a futex.
+/// The publisher never waits for the readers: the slot sequence numbers let
+/// them detect frames which were overwritten. Readers which need a frame for
+/// longer than the ring covers must copy it.
+///
+/// The ring is unlinked & marked as closed once the publisher and the player
+/// callbacks are gone. Readers keep their mapping until they destroy their
+/// SharedFrameReader.
+///
+class SharedFramePublisher
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : chroma( "RV32" )
+            , width( 0 )
+            , height( 0 )
+            , nbSlots( 8 )
+            , slotSize( 0 )
+        {
+        }
+
+        /// The POSIX shared memory name, ie. "/vlc-frames". When empty, an
+        /// anonymous memfd is used; see SharedFramePublisher::fd()
+        std::string name;
+        /// The fourcc of the pictures to decode to
+        std::string chroma;
+        /// The fourccs the readers can also handle. See FramePool::Configuration
+        std::vector<std::string> nativeChromas;
+        /// The pictures dimensions. See FramePool::Configuration
+        unsigned width;
+        unsigned height;
+        /// The number of slots, between 2 and 64
+        unsigned nbSlots;
+        /// The size of a slot, in bytes. When 0, it is computed from the
+        /// chroma & dimensions, which must then both be set. Formats which
+        /// don't fit in a slot are refused, which disables the video.
+        size_t slotSize;
+        /// Returns the pts of the frame being displayed, in microseconds.
+        /// libvlc's video callbacks don't carry timestamps, so this defaults
+        /// to the publication date.
+        std::function<int64_t()> clock;
+    };
+
+    struct Stats
+    {
+        /// Number of frames made available to the readers
+        uint64_t published;
+        /// Number of frames libvlc decoded but didn't display
+        uint64_t dropped;
+        /// Number of formats refused because they didn't fit in a slot
+        uint64_t oversized;
+        /// True if the current format is the decoder's one
+        bool passthrough;
+    };
+
+private:
+    class State
+    {
+    public:
+        explicit State( Configuration config )
+            : m_config( std::move( config ) )
+            , m_negotiator( m_config.chroma, m_config.nativeChromas,
+                            m_config.width, m_config.height )
+            , m_fd( -1 )
+            , m_base( nullptr )
+            , m_size( 0 )
+            , m_header( nullptr )
+            , m_cursor( 0 )
+            , m_locked( -1 )
+            , m_sequence( 0 )
+            , m_dropped( 0 )
+            , m_oversized( 0 )
+            , m_passthrough( false )
+        {
+            namespace shm = detail::shm;
+            m_layout.nbPlanes = 0;
+            if ( m_config.nbSlots < 2 || m_config.nbSlots > shm::MaxSlots )
+                throw std::invalid_argument( "SharedFramePublisher slot count must be between 2 and 64" );
+            auto slotSize = m_config.slotSize;
+            if ( slotSize == 0 )
+            {
+                PictureLayout layout;
+                if ( layout.compute( m_config.chroma.c_str(), m_config.width, m_config.height ) == false )
+                    throw std::invalid_argument( "SharedFramePublisher needs either a slot size or "
+                                                 "the pictures chroma & dimensions" );
+                slotSize = layout.size;
+            }
+            slotSize = shm::roundToPage( slotSize );
+            auto dataOffset = shm::dataOffset( m_config.nbSlots );
+            m_size = dataOffset + slotSize * m_config.nbSlots;
+
+            if ( m_config.name.empty() == true )
+                m_fd = static_cast<int>( syscall( SYS_memfd_create, "vlcpp-frames", MFD_CLOEXEC ) );
+            else
+                m_fd = shm_open( m_config.name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600 );
+            if ( m_fd < 0 )
+                throw std::runtime_error( "Failed to create the shared frame ring" );
+            if ( ftruncate( m_fd, static_cast<off_t>( m_size ) ) != 0 ||
+                 ( m_base = static_cast<uint8_t*>( mmap( nullptr, m_size, PROT_READ | PROT_WRITE,
+                                                         MAP_SHARED, m_fd, 0 ) ) ) == MAP_FAILED )
+            {
+                m_base = nullptr;
+                release();
+                throw std::runtime_error( "Failed to map the shared frame ring" );
+            }
+
+            m_header = new ( m_base ) shm::RingHeader;
+            m_header->version = shm::Version;
+            m_header->nbSlots = m_config.nbSlots;
+            m_header->closed.store( 0, std::memory_order_relaxed );
+            m_header->slotSize = slotSize;
+            m_header->dataOffset = dataOffset;
+            m_header->totalSize = m_size;
+            m_header->published.store( 0, std::memory_order_relaxed );
+            m_header->futex.store( 0, std::memory_order_relaxed );
+            for ( auto i = 0u; i < m_config.nbSlots; ++i )
+            {
+                auto s = new ( &slot( i ) ) shm::SlotHeader;
+                s->sequence.store( shm::Writing, std::memory_order_relaxed );
+                new ( &index()[i] ) std::atomic<uint32_t>( shm::MaxSlots );
+            }
+            // Readers opening a named ring early see it as invalid until here
+            std::atomic_thread_fence( std::memory_order_release );
+            m_header->magic = shm::Magic;
+        }
+
+        ~State()
+        {
+            m_header->closed.store( 1, std::memory_order_release );
+            m_header->futex.fetch_add( 1, std::memory_order_release );
+            detail::shm::futexWake( &m_header->futex );
+            release();
+        }
+
+        State( const State& ) = delete;
+        State& operator=( const State& ) = delete;
+
+        uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                        uint32_t* pitches, uint32_t* lines )
+        {
+            FormatNegotiator::Result format;
+            if ( m_negotiator.negotiate( chroma, width, height, pitches, lines, format ) == false )
+                return 0;
+            if ( format.layout.size > m_header->slotSize )
+            {
+                m_oversized.fetch_add( 1, std::memory_order_relaxed );
+                return 0;
+            }
+            m_passthrough.store( format.passthrough, std::memory_order_relaxed );
+            m_layout = format.layout;
+            // A single picture: libvlc won't lock a new one before the
+            // previous one was displayed or dropped, so the oldest slot can
+            // always be reused.
+            return 1;
+        }
+
+        void* lock( void** planes )
+        {
+            if ( m_locked >= 0 )
+                m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            auto idx = m_cursor;
+            m_cursor = ( m_cursor + 1 ) % m_config.nbSlots;
+            auto& s = slot( idx );
+            // Readers of the frame this slot used to hold can now tell it's gone
+            s.sequence.store( detail::shm::Writing, std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_release );
+            auto data = this->data( idx );
+            for ( auto i = 0u; i < m_layout.nbPlanes; ++i )
+                planes[i] = data + m_layout.offsets[i];
+            m_locked = static_cast<int>( idx );
+            return &s;
+        }
+
+        void display( void* picture )
+        {
+            if ( m_locked < 0 || picture != &slot( static_cast<unsigned>( m_locked ) ) )
+                return;
+            auto idx = static_cast<unsigned>( m_locked );
+            m_locked = -1;
+            auto& s = slot( idx );
+            s.date = detail::shm::now();
+            s.pts = m_config.clock ? m_config.clock() : s.date;
+            s.width = m_layout.width;
+            s.height = m_layout.height;
+            memcpy( s.chroma, m_layout.chroma, 4 );
+            s.nbPlanes = m_layout.nbPlanes;
+            for ( auto i = 0u; i < detail::shm::MaxPlanes; ++i )
+            {
+                s.pitches[i] = m_layout.pitches[i];
+                s.lines[i] = m_layout.lines[i];
+                s.offsets[i] = m_layout.offsets[i];
+            }
+            auto sequence = m_sequence++;
+            index()[sequence % m_config.nbSlots].store( idx, std::memory_order_relaxed );
+            s.sequence.store( sequence, std::memory_order_release );
+            m_header->published.store( sequence + 1, std::memory_order_release );
+            m_header->futex.fetch_add( 1, std::memory_order_release );
+            // Readers don't write to the ring, so there is no waiter count to
+            // check: the wake is a cheap syscall when nobody waits.
+            detail::shm::futexWake( &m_header->futex );
+        }
+
+        int fd() const
+        {
+            return m_fd;
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            s.published = m_header->published.load( std::memory_order_relaxed );
+            s.dropped = m_dropped.load( std::memory_order_relaxed );
+            s.oversized = m_oversized.load( std::memory_order_relaxed );
+            s.passthrough = m_passthrough.load( std::memory_order_relaxed );
+            return s;
+        }
+
+    private:
+        detail::shm::SlotHeader& slot( unsigned idx )
+        {
+            return reinterpret_cast<detail::shm::SlotHeader*>(
+                        m_base + detail::shm::slotsOffset() )[idx];
+        }
+
+        std::atomic<uint32_t>* index()
+        {
+            return reinterpret_cast<std::atomic<uint32_t>*>(
+                        m_base + detail::shm::indexOffset( m_config.nbSlots ) );
+        }
+
+        uint8_t* data( unsigned idx )
+        {
+            return m_base + m_header->dataOffset + idx * m_header->slotSize;
+        }
+
+        void release()
+        {
+            if ( m_base != nullptr )
+                munmap( m_base, m_size );
+            if ( m_fd >= 0 )
+                ::close( m_fd );
+            if ( m_config.name.empty() == false )
+                shm_unlink( m_config.name.c_str() );
+        }
+
+    private:
+        Configuration m_config;
+        FormatNegotiator m_negotiator;
+        int m_fd;
+        uint8_t* m_base;
+        size_t m_size;
+        detail::shm::RingHeader* m_header;
+        // Decoder side
+        PictureLayout m_layout;
+        unsigned m_cursor;
+        int m_locked;
+        uint64_t m_sequence;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_oversized;
+        std::atomic<bool> m_passthrough;
+    };
+
+public:
+    ///
+    /// \brief SharedFramePublisher Creates the shared memory ring
+    /// \throws std::invalid_argument if the configuration is invalid
+    /// \throws std::runtime_error if the ring can't be created, ie. because
+    ///         the name is already in use
+    ///
+    explicit SharedFramePublisher( Configuration config )
+        : m_state( std::make_shared<State>( std::move( config ) ) )
+    {
+    }
+
+    ///
+    /// \brief attach Sets the video format & video callbacks of the provided
+    ///               player, so that it decodes to the ring.
+    ///
+    /// This must be called before the playback starts.
+    ///
+    void attach( MediaPlayer& mp )
+    {
+        auto state = m_state;
+        mp.setVideoFormatCallbacks(
+            [state]( char* chroma, uint32_t* width, uint32_t* height,
+                     uint32_t* pitches, uint32_t* lines ) -> uint32_t {
+                return state->setup( chroma, width, height, pitches, lines );
+            }, nullptr );
+        mp.setVideoCallbacks(
+            [state]( void** planes ) -> void* { return state->lock( planes ); },
+            nullptr,
+            [state]( void* picture ) { state->display( picture ); } );
+    }
+
+    ///
+    /// \brief fd Returns the ring's file descriptor, which is close on exec.
+    ///
+    /// This is the way to share an anonymous ring: pass it over a unix socket,
+    /// or dup2() it in a child process, and give it to SharedFrameReader.
+    ///
+    int fd() const
+    {
+        return m_state->fd();
+    }
+
+    Stats stats() const
+    {
+        return m_state->stats();
+    }
+
+    ///
+    /// The raw callbacks, matching the MediaPlayer::setVideoFormatCallbacks
+    /// and MediaPlayer::setVideoCallbacks prototypes, for callers which need
+    /// to wrap them.
+    ///
+    uint32_t setup( char* chroma, uint32_t* width, uint32_t* height,
+                    uint32_t* pitches, uint32_t* lines )
+    {
+        return m_state->setup( chroma, width, height, pitches, lines );
+    }
+
+    void* lock( void** planes )
+    {
+        return m_state->lock( planes );
+    }
+
+    void display( void* picture )
+    {
+        m_state->display( picture );
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_SHAREDFRAMEPUBLISHER_H
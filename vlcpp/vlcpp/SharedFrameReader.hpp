@@ -0,0 +1,478 @@
+/*****************************************************************************
+ * SharedFrameReader.hpp: Out of process access to a shared memory frame ring
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_SHAREDFRAMEREADER_H
+#define LIBVLC_CXX_SHAREDFRAMEREADER_H
+
+#if !defined(__linux__)
+# error "The shared memory frame ring is only available on Linux"
+#endif
+
+// This header doesn't depend on libvlc, so that the reading processes don't
+// need to link with it.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace shm
+{
+
+static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+               "The frame ring needs address free atomics" );
+
+static constexpr uint32_t Magic = 0x464c4356; // "VLCF"
+static constexpr uint32_t Version = 1;
+static constexpr uint32_t MaxPlanes = 3;
+static constexpr uint32_t MaxSlots = 64;
+/// The sequence of a slot which is being written to
+static constexpr uint64_t Writing = ~uint64_t{ 0 };
+
+///
+/// The ring layout, shared between processes. It starts with a RingHeader,
+/// followed by nbSlots SlotHeaders, the index array, and the slots data,
+/// which starts on a page boundary. All fields have fixed sizes, so that
+/// the layout doesn't depend on the compiler.
+///
+struct alignas( 64 ) RingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nbSlots;
+    /// Set once the publisher is gone
+    std::atomic<uint32_t> closed;
+    uint64_t slotSize;
+    uint64_t dataOffset;
+    uint64_t totalSize;
+    /// The number of published frames. Frame n lives in the slot at
+    /// index[n % nbSlots], as long as that slot's sequence is still n.
+    std::atomic<uint64_t> published;
+    /// Incremented on every publication, and on close; readers wait on it
+    std::atomic<uint32_t> futex;
+};
+
+struct alignas( 64 ) SlotHeader
+{
+    /// The sequence of the frame held by this slot, or Writing. It acts as
+    /// a sequence lock for the rest of the slot.
+    std::atomic<uint64_t> sequence;
+    int64_t pts;
+    int64_t date;
+    uint32_t width;
+    uint32_t height;
+    char chroma[4];
+    uint32_t nbPlanes;
+    uint32_t pitches[MaxPlanes];
+    uint32_t lines[MaxPlanes];
+    uint64_t offsets[MaxPlanes];
+};
+
+static_assert( sizeof( RingHeader ) == 64 && sizeof( SlotHeader ) == 128,
+               "Unexpected shared ring layout" );
+
+inline size_t slotsOffset()
+{
+    return sizeof( RingHeader );
+}
+
+inline size_t indexOffset( uint32_t nbSlots )
+{
+    return slotsOffset() + nbSlots * sizeof( SlotHeader );
+}
+
+inline size_t pageSize()
+{
+    auto s = sysconf( _SC_PAGESIZE );
+    return s > 0 ? static_cast<size_t>( s ) : 4096;
+}
+
+inline size_t roundToPage( size_t s )
+{
+    auto p = pageSize();
+    return ( s + p - 1 ) / p * p;
+}
+
+inline size_t dataOffset( uint32_t nbSlots )
+{
+    return roundToPage( indexOffset( nbSlots ) + nbSlots * sizeof( uint32_t ) );
+}
+
+/// The CLOCK_MONOTONIC date, in microseconds. This clock is shared by all
+/// the processes, so it can be used to measure the delivery latency.
+inline int64_t now()
+{
+    timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return static_cast<int64_t>( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+}
+
+inline void futexWake( std::atomic<uint32_t>* word )
+{
+    syscall( SYS_futex, reinterpret_cast<uint32_t*>( word ), FUTEX_WAKE, INT32_MAX,
+             nullptr, nullptr, 0 );
+}
+
+inline void futexWait( const std::atomic<uint32_t>* word, uint32_t expected,
+                       std::chrono::microseconds timeout )
+{
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>( timeout.count() / 1000000 );
+    ts.tv_nsec = static_cast<long>( timeout.count() % 1000000 * 1000 );
+    // Not a private futex: the word lives in memory shared between processes
+    syscall( SYS_futex, reinterpret_cast<const uint32_t*>( word ), FUTEX_WAIT, expected,
+             &ts, nullptr, 0 );
+}
+
+} // namespace shm
+
+} // namespace detail
+
+///
+/// \brief The SharedFrameReader class maps a frame ring exported by a
+///        SharedFramePublisher, possibly from another process.
+///
+/// The frames are read in place, from a read only mapping: nothing is copied,
+/// and the publisher never waits for its readers, whatever their number.
+/// The flip side is that a slot gets overwritten once the publisher went
+/// around the ring: a reader which falls behind skips frames, and a frame
+/// can be overwritten while it is being processed. Call valid() once done
+/// with a frame to know whether what was read can be trusted.
+///
+/// A reader must only be used by one thread at a time.
+///
+class SharedFrameReader
+{
+public:
+    struct Frame
+    {
+        const uint8_t* plane( unsigned idx ) const
+        {
+            return data + offsets[idx];
+        }
+
+        unsigned pitch( unsigned idx ) const
+        {
+            return pitches[idx];
+        }
+
+        unsigned nbLines( unsigned idx ) const
+        {
+            return lines[idx];
+        }
+
+        /// The frame number, in display order
+        uint64_t sequence;
+        /// The presentation timestamp, in microseconds. See
+        /// SharedFramePublisher::Configuration::clock
+        int64_t pts;
+        /// The publication date, in microseconds. See SharedFrameReader::now()
+        int64_t date;
+        unsigned width;
+        unsigned height;
+        /// The fourcc, nul terminated
+        char chroma[5];
+        unsigned nbPlanes;
+        unsigned pitches[detail::shm::MaxPlanes];
+        unsigned lines[detail::shm::MaxPlanes];
+        size_t offsets[detail::shm::MaxPlanes];
+        const uint8_t* data;
+        unsigned slot;
+    };
+
+    struct Stats
+    {
+        /// Number of frames returned by next() or latest()
+        uint64_t received;
+        /// Number of frames which were overwritten before being read, or
+        /// which latest() skipped
+        uint64_t skipped;
+        /// Number of frames valid() reported as overwritten
+        uint64_t torn;
+    };
+
+    ///
+    /// \brief SharedFrameReader Maps the ring published under the provided name
+    /// \param name The SharedFramePublisher::Configuration::name
+    /// \throws std::runtime_error if the ring can't be opened or is invalid
+    ///
+    explicit SharedFrameReader( const std::string& name )
+        : SharedFrameReader()
+    {
+        auto fd = shm_open( name.c_str(), O_RDONLY | O_CLOEXEC, 0 );
+        if ( fd < 0 )
+            throw std::runtime_error( "Failed to open the shared frame ring " + name );
+        try
+        {
+            map( fd );
+        }
+        catch ( ... )
+        {
+            ::close( fd );
+            throw;
+        }
+        ::close( fd );
+    }
+
+    ///
+    /// \brief SharedFrameReader Maps the ring referred to by a file descriptor,
+    ///        ie. SharedFramePublisher::fd(), as inherited or passed over a
+    ///        unix socket. The descriptor can be closed once constructed.
+    /// \throws std::runtime_error if the ring is invalid
+    ///
+    explicit SharedFrameReader( int fd )
+        : SharedFrameReader()
+    {
+        map( fd );
+    }
+
+    ~SharedFrameReader()
+    {
+        if ( m_base != nullptr )
+            munmap( const_cast<uint8_t*>( m_base ), m_size );
+    }
+
+    SharedFrameReader( const SharedFrameReader& ) = delete;
+    SharedFrameReader& operator=( const SharedFrameReader& ) = delete;
+
+    ///
+    /// \brief wait Waits for a frame newer than the last one read
+    /// \return true if one is available, false on timeout or if the publisher
+    ///         is gone
+    ///
+    bool wait( std::chrono::microseconds timeout )
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while ( true )
+        {
+            // Load the futex word first, so that a publication happening
+            // after the check makes the wait return immediately
+            auto word = m_header->futex.load( std::memory_order_acquire );
+            if ( m_header->published.load( std::memory_order_acquire ) > m_next )
+                return true;
+            if ( closed() == true )
+                return false;
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                        deadline - std::chrono::steady_clock::now() );
+            if ( remaining.count() <= 0 )
+                return false;
+            detail::shm::futexWait( &m_header->futex, word, remaining );
+        }
+    }
+
+    ///
+    /// \brief next Returns the oldest unread frame which is still available
+    /// \return false if no new frame was published
+    ///
+    bool next( Frame& frame )
+    {
+        auto published = m_header->published.load( std::memory_order_acquire );
+        if ( published > m_next + m_header->nbSlots )
+        {
+            m_skipped += published - m_header->nbSlots - m_next;
+            m_next = published - m_header->nbSlots;
+        }
+        for ( ; m_next < published; ++m_next )
+        {
+            if ( read( m_next, frame ) == true )
+            {
+                ++m_next;
+                ++m_received;
+                return true;
+            }
+            ++m_skipped;
+        }
+        return false;
+    }
+
+    ///
+    /// \brief latest Returns the most recent frame, skipping the older unread ones
+    /// \return false if no new frame was published
+    ///
+    bool latest( Frame& frame )
+    {
+        auto published = m_header->published.load( std::memory_order_acquire );
+        if ( published <= m_next )
+            return false;
+        m_skipped += published - 1 - m_next;
+        m_next = published - 1;
+        return next( frame );
+    }
+
+    ///
+    /// \brief valid Checks that the frame wasn't overwritten since it was
+    ///        returned. Call it once done reading the frame.
+    ///
+    bool valid( const Frame& frame )
+    {
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( slot( frame.slot ).sequence.load( std::memory_order_relaxed ) == frame.sequence )
+            return true;
+        ++m_torn;
+        return false;
+    }
+
+    ///
+    /// \brief closed Returns true once the publisher was destroyed
+    ///
+    bool closed() const
+    {
+        return m_header->closed.load( std::memory_order_acquire ) != 0;
+    }
+
+    unsigned nbSlots() const
+    {
+        return m_header->nbSlots;
+    }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.received = m_received;
+        s.skipped = m_skipped;
+        s.torn = m_torn;
+        return s;
+    }
+
+    ///
+    /// \brief now Returns the date publishers use for Frame::date
+    ///
+    static int64_t now()
+    {
+        return detail::shm::now();
+    }
+
+private:
+    SharedFrameReader()
+        : m_base( nullptr )
+        , m_size( 0 )
+        , m_header( nullptr )
+        , m_next( 0 )
+        , m_received( 0 )
+        , m_skipped( 0 )
+        , m_torn( 0 )
+    {
+    }
+
+    void map( int fd )
+    {
+        namespace shm = detail::shm;
+        struct stat st;
+        if ( fstat( fd, &st ) != 0 || static_cast<size_t>( st.st_size ) < sizeof( shm::RingHeader ) )
+            throw std::runtime_error( "Invalid shared frame ring" );
+        m_size = static_cast<size_t>( st.st_size );
+        auto ptr = mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+        if ( ptr == MAP_FAILED )
+            throw std::runtime_error( "Failed to map the shared frame ring" );
+        m_base = static_cast<const uint8_t*>( ptr );
+        m_header = reinterpret_cast<const shm::RingHeader*>( m_base );
+        if ( m_header->magic != shm::Magic || m_header->version != shm::Version ||
+             m_header->nbSlots == 0 || m_header->nbSlots > shm::MaxSlots ||
+             m_header->totalSize != m_size ||
+             m_header->dataOffset != shm::dataOffset( m_header->nbSlots ) ||
+             m_header->slotSize > ( m_size - m_header->dataOffset ) / m_header->nbSlots )
+        {
+            munmap( ptr, m_size );
+            m_base = nullptr;
+            throw std::runtime_error( "Invalid shared frame ring" );
+        }
+        // Start with the frames published from now on
+        m_next = m_header->published.load( std::memory_order_acquire );
+    }
+
+    const detail::shm::SlotHeader& slot( unsigned idx ) const
+    {
+        return reinterpret_cast<const detail::shm::SlotHeader*>(
+                    m_base + detail::shm::slotsOffset() )[idx];
+    }
+
+    // Copies the frame metadata, using the slot sequence as a sequence lock
+    bool read( uint64_t sequence, Frame& frame ) const
+    {
+        namespace shm = detail::shm;
+        auto index = reinterpret_cast<const std::atomic<uint32_t>*>(
+                    m_base + shm::indexOffset( m_header->nbSlots ) );
+        auto idx = index[sequence % m_header->nbSlots].load( std::memory_order_acquire );
+        if ( idx >= m_header->nbSlots )
+            return false;
+        const auto& s = slot( idx );
+        if ( s.sequence.load( std::memory_order_acquire ) != sequence )
+            return false;
+        frame.sequence = sequence;
+        frame.pts = s.pts;
+        frame.date = s.date;
+        frame.width = s.width;
+        frame.height = s.height;
+        memcpy( frame.chroma, s.chroma, 4 );
+        frame.chroma[4] = 0;
+        frame.nbPlanes = s.nbPlanes;
+        for ( auto i = 0u; i < shm::MaxPlanes; ++i )
+        {
+            frame.pitches[i] = s.pitches[i];
+            frame.lines[i] = s.lines[i];
+            frame.offsets[i] = s.offsets[i];
+        }
+        frame.data = m_base + m_header->dataOffset + idx * m_header->slotSize;
+        frame.slot = idx;
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( s.sequence.load( std::memory_order_relaxed ) != sequence )
+            return false;
+        // Never hand out planes pointing outside of the slot
+        if ( frame.nbPlanes > shm::MaxPlanes )
+            return false;
+        for ( auto i = 0u; i < frame.nbPlanes; ++i )
+        {
+            if ( frame.offsets[i] > m_header->slotSize ||
+                 static_cast<uint64_t>( frame.pitches[i] ) * frame.lines[i] >
+                    m_header->slotSize - frame.offsets[i] )
+                return false;
+        }
+        return true;
+    }
+
+    const uint8_t* m_base;
+    size_t m_size;
+    const detail::shm::RingHeader* m_header;
+    uint64_t m_next;
+    uint64_t m_received;
+    uint64_t m_skipped;
+    uint64_t m_torn;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_SHAREDFRAMEREADER_H
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ * SpinLock.hpp: A lock which doesn't depend on the C++ thread support
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_SPINLOCK_H
+#define LIBVLC_CXX_SPINLOCK_H
+
+#include <atomic>
+#include <cassert>
+
+#if defined(_WIN32)
+// Declared here rather than by including windows.h, which would leak its
+// min/max macros to everything including vlc.hpp
+extern "C" __declspec(dllimport) void __stdcall Sleep( unsigned long ms );
+#else
+# include <chrono>
+# include <thread>
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+
+///
+/// \brief backoff Waits a little before trying again, spinning at first, then
+///        giving the processor up
+/// \param spins The number of tries so far, incremented by each call
+///
+inline void backoff( unsigned int& spins )
+{
+    if ( spins++ < 64 )
+        return;
+#if defined(_WIN32)
+    Sleep( spins < 256 ? 0 : 1 );
+#else
+    if ( spins < 256 )
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for( std::chrono::microseconds( 500 ) );
+#endif
+}
+
+///
+/// \brief The SpinLock class is a recursive lock built on an atomic.
+///
+/// MinGW's win32 thread model, which the ActiveX plugin is built with, has
+/// neither std::mutex nor std::thread. The headers which vlc.hpp includes
+/// use this lock instead, for the short critical sections of the event
+/// handling. A thread which can't take it spins for a while, then yields.
+///
+/// It can be used with std::lock_guard and std::unique_lock.
+///
+class SpinLock
+{
+public:
+    SpinLock() : m_owner( nullptr ), m_depth( 0 ) {}
+
+    SpinLock( const SpinLock& ) = delete;
+    SpinLock& operator=( const SpinLock& ) = delete;
+
+    void lock()
+    {
+        auto self = currentThread();
+        if ( m_owner.load( std::memory_order_relaxed ) == self )
+        {
+            ++m_depth;
+            return;
+        }
+        unsigned int spins = 0;
+        const void* expected = nullptr;
+        while ( m_owner.compare_exchange_weak( expected, self, std::memory_order_acquire,
+                                               std::memory_order_relaxed ) == false )
+        {
+            expected = nullptr;
+            backoff( spins );
+        }
+        m_depth = 1;
+    }
+
+    bool try_lock()
+    {
+        auto self = currentThread();
+        if ( m_owner.load( std::memory_order_relaxed ) == self )
+        {
+            ++m_depth;
+            return true;
+        }
+        const void* expected = nullptr;
+        if ( m_owner.compare_exchange_strong( expected, self, std::memory_order_acquire,
+                                              std::memory_order_relaxed ) == false )
+            return false;
+        m_depth = 1;
+        return true;
+    }
+
+    void unlock()
+    {
+        assert( isHeld() == true );
+        if ( --m_depth == 0 )
+            m_owner.store( nullptr, std::memory_order_release );
+    }
+
+    ///
+    /// \brief isHeld returns true if the calling thread holds the lock
+    ///
+    bool isHeld() const
+    {
+        return m_owner.load( std::memory_order_relaxed ) == currentThread();
+    }
+
+    ///
+    /// \brief depth returns how many times the owner took the lock. Only
+    ///              meaningful for the thread holding it.
+    ///
+    unsigned int depth() const
+    {
+        return m_depth;
+    }
+
+private:
+    // Any address unique to the calling thread identifies it
+    static const void* currentThread()
+    {
+        static thread_local char tag;
+        return &tag;
+    }
+
+private:
+    std::atomic<const void*> m_owner;
+    unsigned int m_depth;
+};
+
+} // namespace detail
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_SPINLOCK_H
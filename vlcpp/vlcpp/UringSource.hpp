@@ -0,0 +1,901 @@
+/*****************************************************************************
+ * UringSource.hpp: Media source reading a file through io_uring
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_URINGSOURCE_H
+#define LIBVLC_CXX_URINGSOURCE_H
+
+#if !defined(__linux__)
+# error "The io_uring file source is only available on Linux"
+#endif
+
+#include "MediaSource.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace uring
+{
+
+// The alignment O_DIRECT requires for the buffers, offsets and sizes
+static constexpr size_t Alignment = 4096;
+
+// Signaled by the completion thread, under the lock of the stream
+struct Completion
+{
+    std::mutex* lock;
+    std::condition_variable* cond;
+    int32_t result;
+    bool done;
+};
+
+struct FreeDeleter
+{
+    void operator()( uint8_t* p ) const
+    {
+        free( p );
+    }
+};
+
+using Buffer = std::unique_ptr<uint8_t, FreeDeleter>;
+
+inline Buffer allocate( size_t size )
+{
+    void* p = nullptr;
+    if ( posix_memalign( &p, Alignment, size ) != 0 )
+        throw std::bad_alloc();
+    return Buffer( static_cast<uint8_t*>( p ) );
+}
+
+} // namespace uring
+
+} // namespace detail
+
+class UringSource;
+
+///
+/// \brief The IoUring class is an io_uring instance, shared by the streams
+///        of UringSource.
+///
+/// It is driven with the raw system calls, so that it doesn't depend on
+/// liburing. The submissions come from the threads reading the streams,
+/// while a single thread reaps the completions, and wakes up the stream
+/// which submitted each of them.
+///
+/// The instance also owns a pool of buffers, registered with the kernel when
+/// possible, which the streams borrow for their readahead chunks, so that
+/// the reads don't map the pages of the buffers each time.
+///
+/// When io_uring is unavailable, because of an old kernel or of a seccomp
+/// policy, the instance still works, and the streams use pread instead.
+///
+class IoUring
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : entries( 256 )
+            , chunkSize( 128 * 1024 )
+            , nbBuffers( 64 )
+            , forcePread( false )
+        {
+        }
+
+        /// The size of the submission queue
+        unsigned entries;
+        /// The size of each read, which must be a multiple of 4096, for
+        /// O_DIRECT
+        size_t chunkSize;
+        /// The number of buffers in the registered pool. The streams use
+        /// their own buffers once the pool is empty.
+        size_t nbBuffers;
+        /// Don't use io_uring at all, to compare with the fallback
+        bool forcePread;
+    };
+
+    struct Stats
+    {
+        /// The io_uring_enter calls which submitted reads, and the reads
+        uint64_t submissions;
+        uint64_t requests;
+        /// The reads of registered buffers
+        uint64_t fixedReads;
+        /// The reads done with pread
+        uint64_t preads;
+    };
+
+    ///
+    /// \brief IoUring Creates an instance, which falls back to pread if
+    ///                io_uring can't be used
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit IoUring( Configuration config = Configuration() )
+        : m_config( std::move( config ) )
+        , m_fd( -1 )
+        , m_params()
+        , m_sqRing( nullptr )
+        , m_cqRing( nullptr )
+        , m_sqes( nullptr )
+        , m_sqRingSize( 0 )
+        , m_cqRingSize( 0 )
+        , m_fixed( false )
+        , m_inflight( 0 )
+        , m_reaping( false )
+        , m_stopping( false )
+        , m_submissions( 0 )
+        , m_requests( 0 )
+        , m_fixedReads( 0 )
+        , m_preads( 0 )
+    {
+        if ( m_config.entries == 0 || m_config.chunkSize == 0 ||
+             m_config.chunkSize % detail::uring::Alignment != 0 )
+            throw std::invalid_argument( "Invalid io_uring configuration" );
+        if ( m_config.nbBuffers > 0 )
+        {
+            m_pool = detail::uring::allocate( m_config.nbBuffers * m_config.chunkSize );
+            for ( auto i = m_config.nbBuffers; i > 0; --i )
+                m_free.push_back( static_cast<int>( i - 1 ) );
+        }
+        if ( m_config.forcePread == false && setup() == true )
+        {
+            registerBuffers();
+            m_reaping = true;
+            m_reaper = std::thread( &IoUring::reap, this );
+        }
+    }
+
+    ~IoUring()
+    {
+        if ( m_reaper.joinable() == true )
+        {
+            // A NOP without user data stops the completion thread. It uses
+            // the rings until it returns, so it must be joined before they
+            // are unmapped: retry the submission until it gets through,
+            // unless the thread wakes up by itself to check the flag.
+            m_stopping.store( true, std::memory_order_release );
+            io_uring_sqe sqe;
+            memset( &sqe, 0, sizeof( sqe ) );
+            sqe.opcode = IORING_OP_NOP;
+            while ( m_reaping.load( std::memory_order_acquire ) == true &&
+                    submit( &sqe, 1 ) != 1 && timedWait() == false )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            m_reaper.join();
+        }
+        teardown();
+    }
+
+    IoUring( const IoUring& ) = delete;
+    IoUring& operator=( const IoUring& ) = delete;
+
+    ///
+    /// \brief shared Returns the instance shared by the whole process, with
+    ///               the default configuration
+    ///
+    static std::shared_ptr<IoUring> shared()
+    {
+        static std::shared_ptr<IoUring> ring = std::make_shared<IoUring>();
+        return ring;
+    }
+
+    ///
+    /// \brief available Returns true if the reads go through io_uring
+    ///
+    bool available() const
+    {
+        return m_fd >= 0;
+    }
+
+    ///
+    /// \brief fixedBuffers Returns true if the buffer pool is registered
+    ///
+    bool fixedBuffers() const
+    {
+        return m_fixed;
+    }
+
+    size_t chunkSize() const
+    {
+        return m_config.chunkSize;
+    }
+
+    Stats stats() const
+    {
+        Stats s;
+        s.submissions = m_submissions.load( std::memory_order_relaxed );
+        s.requests = m_requests.load( std::memory_order_relaxed );
+        s.fixedReads = m_fixedReads.load( std::memory_order_relaxed );
+        s.preads = m_preads.load( std::memory_order_relaxed );
+        return s;
+    }
+
+private:
+    static void add( std::atomic<uint64_t>& counter, uint64_t v )
+    {
+        counter.fetch_add( v, std::memory_order_relaxed );
+    }
+
+    bool setup()
+    {
+        io_uring_params params;
+        memset( &params, 0, sizeof( params ) );
+        auto fd = static_cast<int>( syscall( __NR_io_uring_setup, m_config.entries, &params ) );
+        if ( fd < 0 )
+            return false;
+        m_fd = fd;
+        m_params = params;
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+        if ( params.features & IORING_FEAT_SINGLE_MMAP )
+        {
+            if ( m_cqRingSize > m_sqRingSize )
+                m_sqRingSize = m_cqRingSize;
+            m_cqRingSize = 0;
+        }
+        auto sq = mmap( nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        m_fd, IORING_OFF_SQ_RING );
+        if ( sq == MAP_FAILED )
+            return teardown();
+        m_sqRing = static_cast<uint8_t*>( sq );
+        if ( m_cqRingSize == 0 )
+            m_cqRing = m_sqRing;
+        else
+        {
+            auto cq = mmap( nullptr, m_cqRingSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING );
+            if ( cq == MAP_FAILED )
+                return teardown();
+            m_cqRing = static_cast<uint8_t*>( cq );
+        }
+        auto sqes = mmap( nullptr, params.sq_entries * sizeof( io_uring_sqe ),
+                          PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                          IORING_OFF_SQES );
+        if ( sqes == MAP_FAILED )
+            return teardown();
+        m_sqes = static_cast<io_uring_sqe*>( sqes );
+        // The submission entries are used in order
+        auto array = sqField( params.sq_off.array );
+        for ( auto i = 0u; i < params.sq_entries; ++i )
+            array[i] = i;
+        return true;
+    }
+
+    bool teardown()
+    {
+        if ( m_sqes != nullptr )
+            munmap( m_sqes, m_params.sq_entries * sizeof( io_uring_sqe ) );
+        if ( m_cqRing != nullptr && m_cqRing != m_sqRing )
+            munmap( m_cqRing, m_cqRingSize );
+        if ( m_sqRing != nullptr )
+            munmap( m_sqRing, m_sqRingSize );
+        if ( m_fd >= 0 )
+            close( m_fd );
+        m_sqes = nullptr;
+        m_sqRing = m_cqRing = nullptr;
+        m_fd = -1;
+        return false;
+    }
+
+    void registerBuffers()
+    {
+        if ( m_pool == nullptr )
+            return;
+        std::vector<iovec> iovecs( m_config.nbBuffers );
+        for ( auto i = 0u; i < iovecs.size(); ++i )
+        {
+            iovecs[i].iov_base = m_pool.get() + i * m_config.chunkSize;
+            iovecs[i].iov_len = m_config.chunkSize;
+        }
+        // This fails if the buffers exceed RLIMIT_MEMLOCK, on kernels which
+        // still account them that way
+        m_fixed = syscall( __NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS,
+                           iovecs.data(), static_cast<unsigned>( iovecs.size() ) ) == 0;
+    }
+
+    unsigned* sqField( uint32_t offset ) const
+    {
+        return reinterpret_cast<unsigned*>( m_sqRing + offset );
+    }
+
+    unsigned* cqField( uint32_t offset ) const
+    {
+        return reinterpret_cast<unsigned*>( m_cqRing + offset );
+    }
+
+    // Queues the entries, and submits them with a single system call.
+    // Returns the number of entries the kernel accepted.
+    size_t submit( const io_uring_sqe* sqes, size_t count )
+    {
+        if ( m_fd < 0 || count == 0 )
+            return 0;
+        // Without SQPOLL, the kernel consumes the whole queue on each call,
+        // so it's empty here
+        if ( count > m_params.sq_entries )
+            count = m_params.sq_entries;
+        {
+            // Never have more requests in flight than the completion queue
+            // can hold
+            std::unique_lock<std::mutex> lock( m_inflightLock );
+            m_inflightCond.wait( lock, [this, count]() {
+                return m_inflight + count <= m_params.cq_entries;
+            } );
+            m_inflight += count;
+        }
+        std::lock_guard<std::mutex> lock( m_sqLock );
+        auto mask = *sqField( m_params.sq_off.ring_mask );
+        auto tailp = sqField( m_params.sq_off.tail );
+        auto tail = *tailp;
+        for ( auto i = 0u; i < count; ++i )
+            m_sqes[( tail + i ) & mask] = sqes[i];
+        __atomic_store_n( tailp, tail + static_cast<unsigned>( count ), __ATOMIC_RELEASE );
+        size_t submitted = 0;
+        while ( submitted < count )
+        {
+            auto res = syscall( __NR_io_uring_enter, m_fd,
+                                static_cast<unsigned>( count - submitted ), 0u, 0u, nullptr, 0 );
+            if ( res < 0 )
+            {
+                if ( errno == EINTR || errno == EAGAIN || errno == EBUSY )
+                    continue;
+                break;
+            }
+            submitted += static_cast<size_t>( res );
+        }
+        if ( submitted < count )
+        {
+            // Take back what the kernel didn't consume
+            __atomic_store_n( tailp, tail + static_cast<unsigned>( submitted ), __ATOMIC_RELEASE );
+            completed( count - submitted );
+        }
+        add( m_submissions, 1 );
+        add( m_requests, submitted );
+        return submitted;
+    }
+
+    void completed( size_t count )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_inflightLock );
+            m_inflight -= count;
+        }
+        m_inflightCond.notify_all();
+    }
+
+    // Whether the completion thread wakes up periodically, which needs a
+    // timeout for io_uring_enter (Linux 5.11)
+    bool timedWait() const
+    {
+#ifdef IORING_FEAT_EXT_ARG
+        return ( m_params.features & IORING_FEAT_EXT_ARG ) != 0;
+#else
+        return false;
+#endif
+    }
+
+    long waitCompletion()
+    {
+#ifdef IORING_FEAT_EXT_ARG
+        if ( timedWait() == true )
+        {
+            __kernel_timespec ts;
+            ts.tv_sec = 0;
+            ts.tv_nsec = 100 * 1000 * 1000;
+            io_uring_getevents_arg arg;
+            memset( &arg, 0, sizeof( arg ) );
+            arg.ts = reinterpret_cast<uint64_t>( &ts );
+            return syscall( __NR_io_uring_enter, m_fd, 0u, 1u,
+                            IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                            &arg, sizeof( arg ) );
+        }
+#endif
+        return syscall( __NR_io_uring_enter, m_fd, 0u, 1u, IORING_ENTER_GETEVENTS,
+                        nullptr, 0 );
+    }
+
+    void reap()
+    {
+        bool running = true;
+        while ( running == true )
+        {
+            auto res = waitCompletion();
+            if ( res < 0 && errno != EINTR && errno != ETIME )
+                break;
+            std::lock_guard<std::mutex> lock( m_cqLock );
+            running = dispatch() && m_stopping.load( std::memory_order_acquire ) == false;
+        }
+        m_reaping.store( false, std::memory_order_release );
+    }
+
+    // Called by the streams before they wait: the reads of cached pages
+    // complete during their submission, and don't need to wake the
+    // completion thread up.
+    void poll()
+    {
+        if ( m_fd < 0 )
+            return;
+        std::unique_lock<std::mutex> lock( m_cqLock, std::try_to_lock );
+        if ( lock.owns_lock() == true )
+            dispatch();
+    }
+
+    // Signals the available completions. Called with m_cqLock held.
+    // Returns false once the NOP of the destructor was reaped.
+    bool dispatch()
+    {
+        auto headp = cqField( m_params.cq_off.head );
+        auto mask = *cqField( m_params.cq_off.ring_mask );
+        auto cqes = reinterpret_cast<io_uring_cqe*>( m_cqRing + m_params.cq_off.cqes );
+        auto head = *headp;
+        auto tail = __atomic_load_n( cqField( m_params.cq_off.tail ), __ATOMIC_ACQUIRE );
+        if ( head == tail )
+            return true;
+        // The kernel orders the completions after the submissions, but not
+        // for the C++ memory model: this pairs with the release of the
+        // submission queue tail, to make the writes of the submitters
+        // visible.
+        __atomic_load_n( sqField( m_params.sq_off.tail ), __ATOMIC_ACQUIRE );
+        bool running = true;
+        size_t count = 0;
+        for ( ; head != tail; ++head, ++count )
+        {
+            const auto& cqe = cqes[head & mask];
+            if ( cqe.user_data == 0 )
+            {
+                running = false;
+                continue;
+            }
+            auto c = reinterpret_cast<detail::uring::Completion*>( cqe.user_data );
+            // Notify with the lock held: the stream may be destroyed as
+            // soon as it sees the completion
+            std::lock_guard<std::mutex> lock( *c->lock );
+            c->result = cqe.res;
+            c->done = true;
+            c->cond->notify_all();
+        }
+        __atomic_store_n( headp, head, __ATOMIC_RELEASE );
+        completed( count );
+        return running;
+    }
+
+    // Borrows a buffer from the pool, returns -1 if it's empty
+    int acquire()
+    {
+        std::lock_guard<std::mutex> lock( m_poolLock );
+        if ( m_free.empty() == true )
+            return -1;
+        auto i = m_free.back();
+        m_free.pop_back();
+        return i;
+    }
+
+    void release( int index )
+    {
+        std::lock_guard<std::mutex> lock( m_poolLock );
+        m_free.push_back( index );
+    }
+
+    uint8_t* buffer( int index ) const
+    {
+        return m_pool.get() + static_cast<size_t>( index ) * m_config.chunkSize;
+    }
+
+    friend class UringSource;
+
+private:
+    const Configuration m_config;
+    int m_fd;
+    io_uring_params m_params;
+    uint8_t* m_sqRing;
+    uint8_t* m_cqRing;
+    io_uring_sqe* m_sqes;
+    size_t m_sqRingSize;
+    size_t m_cqRingSize;
+    bool m_fixed;
+    std::mutex m_sqLock;
+    std::mutex m_cqLock;
+    std::mutex m_inflightLock;
+    std::condition_variable m_inflightCond;
+    size_t m_inflight;
+    std::thread m_reaper;
+    std::atomic<bool> m_reaping;
+    std::atomic<bool> m_stopping;
+    detail::uring::Buffer m_pool;
+    std::mutex m_poolLock;
+    std::vector<int> m_free;
+    std::atomic<uint64_t> m_submissions;
+    std::atomic<uint64_t> m_requests;
+    std::atomic<uint64_t> m_fixedReads;
+    std::atomic<uint64_t> m_preads;
+};
+
+///
+/// \brief The UringSource class serves a file through io_uring, for use with
+///        mediaFromSource().
+///
+/// Each stream keeps a window of chunks ahead of its position. When the
+/// position leaves a chunk, the reads of the chunks entering the window are
+/// submitted together, so that a player costs a single system call per
+/// batch, and the reads proceed while the demuxer works. Seeks are only
+/// recorded, and a seek out of the window drops it once its reads complete.
+///
+/// With O_DIRECT, the reads bypass the page cache, which avoids doubling
+/// the memory used by the files many players stream once. The source falls
+/// back to buffered reads if the file system doesn't support it.
+///
+class UringSource
+{
+public:
+    struct Configuration
+    {
+        Configuration()
+            : nbChunks( 8 )
+            , direct( false )
+        {
+        }
+
+        /// The number of chunks read ahead of the position
+        size_t nbChunks;
+        /// Whether the file is opened with O_DIRECT
+        bool direct;
+    };
+
+    class Stream
+    {
+    public:
+        Stream( int fd, uint64_t size, const Configuration& config,
+                std::shared_ptr<IoUring> ring )
+            : m_fd( fd )
+            , m_size( size )
+            , m_ring( std::move( ring ) )
+            , m_chunkSize( m_ring->chunkSize() )
+            , m_slots( config.nbChunks )
+            , m_batch( config.nbChunks )
+            , m_batchSlots( config.nbChunks )
+            , m_base( 0 )
+            , m_position( 0 )
+        {
+            for ( auto& s : m_slots )
+            {
+                s.buffer = m_ring->acquire();
+                if ( s.buffer >= 0 )
+                    s.data = m_ring->buffer( s.buffer );
+                else
+                {
+                    s.own = detail::uring::allocate( m_chunkSize );
+                    s.data = s.own.get();
+                }
+                s.iov.iov_base = s.data;
+                s.iov.iov_len = m_chunkSize;
+                s.chunk = 0;
+                s.pending = false;
+                s.completion = detail::uring::Completion{ &m_lock, &m_cond, 0, false };
+            }
+        }
+
+        ~Stream()
+        {
+            drain();
+            for ( auto& s : m_slots )
+                if ( s.buffer >= 0 )
+                    m_ring->release( s.buffer );
+            close( m_fd );
+        }
+
+        Stream( const Stream& ) = delete;
+        Stream& operator=( const Stream& ) = delete;
+
+        ptrdiff_t read( unsigned char* buf, size_t len )
+        {
+            if ( m_position >= m_size || len == 0 )
+                return 0;
+            auto chunk = m_position / m_chunkSize;
+            if ( chunk < m_base || chunk >= m_base + m_slots.size() )
+            {
+                drain();
+                m_base = chunk;
+            }
+            else
+            {
+                // Recycle the chunks left behind
+                for ( ; m_base < chunk; ++m_base )
+                {
+                    auto& s = slot( m_base );
+                    wait( s );
+                    s.pending = false;
+                }
+            }
+            fill( chunk );
+            auto& s = slot( chunk );
+            wait( s );
+            auto result = s.completion.result;
+            if ( result < 0 )
+            {
+                // Have the next read try again
+                s.pending = false;
+                return -1;
+            }
+            auto offset = static_cast<size_t>( m_position - chunk * m_chunkSize );
+            while ( offset >= static_cast<size_t>( result ) )
+            {
+                // libvlc takes 0 for the end of the stream: a read which
+                // stopped short of it is completed synchronously
+                if ( chunk * m_chunkSize + static_cast<uint64_t>( result ) >= m_size )
+                    return 0;
+                auto res = preadFrom( s, static_cast<size_t>( result ) );
+                if ( res < 0 )
+                {
+                    s.pending = false;
+                    return -1;
+                }
+                // The file was truncated
+                if ( res == 0 )
+                    return 0;
+                result += static_cast<int32_t>( res );
+                std::lock_guard<std::mutex> lock( m_lock );
+                s.completion.result = result;
+            }
+            auto n = static_cast<size_t>( result ) - offset;
+            if ( len < n )
+                n = len;
+            memcpy( buf, s.data + offset, n );
+            m_position += n;
+            return static_cast<ptrdiff_t>( n );
+        }
+
+        int seek( uint64_t offset )
+        {
+            if ( offset > m_size )
+                return -1;
+            m_position = offset;
+            return 0;
+        }
+
+        uint64_t size() const
+        {
+            return m_size;
+        }
+
+        uint64_t position() const
+        {
+            return m_position;
+        }
+
+    private:
+        struct Slot
+        {
+            // The index of the buffer in the pool, or -1 for an own buffer
+            int buffer;
+            detail::uring::Buffer own;
+            uint8_t* data;
+            iovec iov;
+            uint64_t chunk;
+            // Whether the slot holds, or will hold, the chunk
+            bool pending;
+            detail::uring::Completion completion;
+        };
+
+        Slot& slot( uint64_t chunk )
+        {
+            return m_slots[chunk % m_slots.size()];
+        }
+
+        // Submits the reads of the chunks of the window which aren't read yet,
+        // once they make half of the window, or if the current chunk is
+        // missing
+        void fill( uint64_t current )
+        {
+            size_t idle = 0;
+            for ( auto c = m_base; c < m_base + m_slots.size(); ++c )
+                if ( c * m_chunkSize < m_size && slot( c ).pending == false )
+                    ++idle;
+            if ( idle == 0 || ( slot( current ).pending == true &&
+                                idle < ( m_slots.size() + 1 ) / 2 ) )
+                return;
+            size_t count = 0;
+            for ( auto c = m_base; c < m_base + m_slots.size(); ++c )
+            {
+                if ( c * m_chunkSize >= m_size )
+                    break;
+                auto& s = slot( c );
+                if ( s.pending == true )
+                    continue;
+                s.chunk = c;
+                s.pending = true;
+                {
+                    std::lock_guard<std::mutex> lock( m_lock );
+                    s.completion.done = false;
+                }
+                if ( m_ring->available() == false )
+                {
+                    pread( s );
+                    continue;
+                }
+                auto& sqe = m_batch[count];
+                memset( &sqe, 0, sizeof( sqe ) );
+                sqe.fd = m_fd;
+                sqe.off = c * m_chunkSize;
+                sqe.user_data = reinterpret_cast<uint64_t>( &s.completion );
+                if ( s.buffer >= 0 && m_ring->fixedBuffers() == true )
+                {
+                    sqe.opcode = IORING_OP_READ_FIXED;
+                    sqe.addr = reinterpret_cast<uint64_t>( s.data );
+                    sqe.len = static_cast<uint32_t>( m_chunkSize );
+                    sqe.buf_index = static_cast<uint16_t>( s.buffer );
+                    IoUring::add( m_ring->m_fixedReads, 1 );
+                }
+                else
+                {
+                    sqe.opcode = IORING_OP_READV;
+                    sqe.addr = reinterpret_cast<uint64_t>( &s.iov );
+                    sqe.len = 1;
+                }
+                m_batchSlots[count++] = &s;
+            }
+            size_t submitted = 0;
+            while ( submitted < count )
+            {
+                auto n = m_ring->submit( m_batch.data() + submitted, count - submitted );
+                if ( n == 0 )
+                    break;
+                submitted += n;
+            }
+            // What the kernel refused is read synchronously
+            for ( auto i = submitted; i < count; ++i )
+                pread( *m_batchSlots[i] );
+        }
+
+        void pread( Slot& s )
+        {
+            auto res = preadFrom( s, 0 );
+            std::lock_guard<std::mutex> lock( m_lock );
+            s.completion.result = res < 0 ? -errno : static_cast<int32_t>( res );
+            s.completion.done = true;
+        }
+
+        // Reads the chunk of the slot from the given offset in the chunk
+        ssize_t preadFrom( Slot& s, size_t from )
+        {
+            ssize_t res;
+            do
+                res = ::pread( m_fd, s.data + from, m_chunkSize - from,
+                               static_cast<off_t>( s.chunk * m_chunkSize + from ) );
+            while ( res < 0 && errno == EINTR );
+            IoUring::add( m_ring->m_preads, 1 );
+            return res;
+        }
+
+        void wait( Slot& s )
+        {
+            if ( s.pending == false )
+                return;
+            std::unique_lock<std::mutex> lock( m_lock );
+            if ( s.completion.done == true )
+                return;
+            lock.unlock();
+            m_ring->poll();
+            lock.lock();
+            m_cond.wait( lock, [&s]() { return s.completion.done; } );
+        }
+
+        // Waits for all the reads in flight, and empties the window
+        void drain()
+        {
+            for ( auto& s : m_slots )
+            {
+                wait( s );
+                s.pending = false;
+            }
+        }
+
+    private:
+        const int m_fd;
+        const uint64_t m_size;
+        const std::shared_ptr<IoUring> m_ring;
+        const size_t m_chunkSize;
+        std::mutex m_lock;
+        std::condition_variable m_cond;
+        std::vector<Slot> m_slots;
+        // The reads submitted together by fill()
+        std::vector<io_uring_sqe> m_batch;
+        std::vector<Slot*> m_batchSlots;
+        // The first chunk of the window
+        uint64_t m_base;
+        uint64_t m_position;
+    };
+
+    ///
+    /// \brief UringSource Creates a source for the provided file
+    ///
+    /// \param ring The io_uring instance the streams use, which defaults to
+    ///             the one shared by the process
+    /// \throws std::invalid_argument if the configuration is invalid
+    ///
+    explicit UringSource( std::string path, Configuration config = Configuration(),
+                          std::shared_ptr<IoUring> ring = IoUring::shared() )
+        : m_path( std::move( path ) )
+        , m_config( std::move( config ) )
+        , m_ring( std::move( ring ) )
+    {
+        if ( m_config.nbChunks == 0 || m_ring == nullptr )
+            throw std::invalid_argument( "Invalid io_uring source configuration" );
+    }
+
+    std::unique_ptr<Stream> open() const
+    {
+        int fd = -1;
+        if ( m_config.direct == true )
+            fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT );
+        // Not all the file systems support O_DIRECT
+        if ( fd < 0 )
+            fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC );
+        if ( fd < 0 )
+            return nullptr;
+        struct stat st;
+        if ( fstat( fd, &st ) != 0 || S_ISREG( st.st_mode ) == false )
+        {
+            close( fd );
+            return nullptr;
+        }
+        if ( m_config.direct == false )
+            posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+        return std::unique_ptr<Stream>( new Stream( fd, static_cast<uint64_t>( st.st_size ),
+                                                    m_config, m_ring ) );
+    }
+
+    const std::string& path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+    Configuration m_config;
+    std::shared_ptr<IoUring> m_ring;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_URINGSOURCE_H
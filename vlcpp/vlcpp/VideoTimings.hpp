@@ -0,0 +1,509 @@
+/*****************************************************************************
+ * VideoTimings.hpp: Video callbacks timing instrumentation
+ *****************************************************************************
+ * Copyright © 2026 libvlcpp authors & VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CXX_VIDEOTIMINGS_H
+#define LIBVLC_CXX_VIDEOTIMINGS_H
+
+#include "LatencyHistogram.hpp"
+#include "Media.hpp"
+#include "MediaPlayer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+# define LIBVLCPP_TIMING_TSC 1
+# include <x86intrin.h>
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+# define LIBVLCPP_TIMING_TSC 1
+# include <intrin.h>
+#endif
+
+namespace VLC
+{
+
+namespace detail
+{
+
+namespace timing
+{
+
+// Invokes an optional user callback
+template <typename Cb, typename... Args>
+void call( Cb& cb, Args... args )
+{
+    cb( args... );
+}
+
+template <typename... Args>
+void call( std::nullptr_t&, Args... )
+{
+}
+
+inline int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+///
+/// Returns a monotonic tick count. On x86, this reads the time stamp counter,
+/// which costs about half as much as the steady clock; the ticks are then
+/// converted to nanoseconds using the steady clock as a reference. This
+/// relies on an invariant TSC, as found on all the CPUs of the last decade.
+/// Elsewhere, ticks are nanoseconds.
+///
+inline uint64_t ticks()
+{
+#if defined(LIBVLCPP_TIMING_TSC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>( now() );
+#endif
+}
+
+///
+/// \brief The LockDates class remembers when each picture was locked, until
+///        it gets unlocked. libvlc can lock & unlock pictures from different
+///        threads, so this is a small lock free open addressing table.
+///
+class LockDates
+{
+public:
+    static constexpr size_t Size = 32;
+
+    LockDates()
+    {
+        for ( auto& e : m_entries )
+        {
+            e.picture.store( nullptr, std::memory_order_relaxed );
+            e.date = 0;
+        }
+    }
+
+    /// \return false if the table is full
+    bool insert( void* picture, uint64_t date )
+    {
+        auto h = hash( picture );
+        for ( auto i = 0u; i < Size; ++i )
+        {
+            auto& e = m_entries[( h + i ) % Size];
+            void* expected = nullptr;
+            if ( e.picture.load( std::memory_order_relaxed ) == nullptr &&
+                 e.picture.compare_exchange_strong( expected, picture, std::memory_order_acquire ) )
+            {
+                // libvlc only unlocks a picture after its lock returned, which
+                // orders this write before the matching take()
+                e.date = date;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \return false if the picture wasn't tracked
+    bool take( void* picture, uint64_t& date )
+    {
+        auto h = hash( picture );
+        for ( auto i = 0u; i < Size; ++i )
+        {
+            auto& e = m_entries[( h + i ) % Size];
+            if ( e.picture.load( std::memory_order_relaxed ) == picture )
+            {
+                date = e.date;
+                // Orders the read above before the entry gets reused
+                e.picture.store( nullptr, std::memory_order_release );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \return The number of pictures currently tracked
+    size_t size() const
+    {
+        size_t n = 0;
+        for ( const auto& e : m_entries )
+            n += e.picture.load( std::memory_order_relaxed ) != nullptr;
+        return n;
+    }
+
+private:
+    static size_t hash( void* picture )
+    {
+        auto v = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( picture ) );
+        return static_cast<size_t>( ( v * 0x9e3779b97f4a7c15ull ) >> 59 );
+    }
+
+    struct Entry
+    {
+        std::atomic<void*> picture;
+        uint64_t date;
+    };
+    Entry m_entries[Size];
+};
+
+} // namespace timing
+
+} // namespace detail
+
+///
+/// \brief The VideoTimings class instruments the video callbacks of a player.
+///
+/// It decorates the callbacks given to MediaPlayer::setVideoCallbacks, and
+/// timestamps each of them to measure:
+/// - the hold time: how long the decoder keeps a picture between the lock and
+///   unlock callbacks,
+/// - the interval between two display callbacks,
+/// - the display jitter: the difference between two consecutive intervals.
+///   A smoothed estimate, as defined by RFC 3550, is also kept.
+/// It also counts the pictures which were locked but never displayed, which
+/// can be compared with the statistics libvlc reports for the media.
+///
+/// The histograms are cumulative; each snapshot() reports the distributions
+/// over the period since the previous one, so that periodic snapshots give
+/// rolling statistics.
+///
+/// The instrumentation reads a tick counter once per callback, and records
+/// to lock free histograms, so that it costs less than 100ns per frame. The
+/// ticks are converted to nanoseconds when taking a snapshot.
+///
+class VideoTimings
+{
+public:
+    struct Distribution
+    {
+        uint64_t count;
+        /// The durations, in nanoseconds. The percentiles & max are within
+        /// 1/16th of the actual values, see LatencyHistogram.
+        double mean;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t max;
+    };
+
+    struct Snapshot
+    {
+        /// The period covered by the distributions
+        std::chrono::nanoseconds period;
+        /// Time between the lock & unlock of a picture
+        Distribution hold;
+        /// Time between two display callbacks
+        Distribution displayInterval;
+        /// Absolute difference between two consecutive display intervals
+        Distribution jitter;
+        /// RFC 3550 smoothed jitter, in nanoseconds
+        double smoothedJitter;
+        /// Number of pictures locked, and displayed, since the decoration
+        uint64_t locked;
+        uint64_t displayed;
+        /// Number of pictures whose lock date couldn't be tracked, because
+        /// libvlc held too many at once
+        uint64_t untracked;
+        /// True if the following fields were filled from the media statistics
+        bool hasMediaStats;
+        /// What libvlc reports for the media, since its playback started
+        uint64_t mediaDecoded;
+        uint64_t mediaDisplayed;
+        uint64_t mediaLost;
+    };
+
+private:
+    class State
+    {
+    public:
+        State()
+            : m_holdBusy( false )
+            , m_displayed( 0 )
+            , m_untracked( 0 )
+            , m_smoothedJitter( 0 )
+            , m_lastDisplay( 0 )
+            , m_lastInterval( -1 )
+            , m_originTicks( detail::timing::ticks() )
+            , m_originDate( detail::timing::now() )
+            , m_previousDate( m_originDate )
+        {
+            m_previous[0] = m_previous[1] = m_previous[2] = Totals();
+        }
+
+        void locked( void* picture )
+        {
+            if ( picture == nullptr )
+                return;
+            if ( m_dates.insert( picture, detail::timing::ticks() ) == false )
+                m_untracked.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        void unlocked( void* picture )
+        {
+            uint64_t date;
+            if ( picture == nullptr || m_dates.take( picture, date ) == false )
+                return;
+            auto hold = detail::timing::ticks() - date;
+            // Pictures can be unlocked from several threads, but hardly ever
+            // concurrently: claim the histogram, which is cheaper than its
+            // atomic recording, and fall back to a second one on contention.
+            if ( m_holdBusy.exchange( true, std::memory_order_acquire ) == false )
+            {
+                m_hold.recordExclusive( hold );
+                m_holdBusy.store( false, std::memory_order_release );
+            }
+            else
+                m_holdContended.record( hold );
+        }
+
+        // libvlc only displays from the video output thread, so the display
+        // statistics have a single writer
+        void displayed()
+        {
+            auto date = detail::timing::ticks();
+            auto nbDisplayed = m_displayed.load( std::memory_order_relaxed );
+            m_displayed.store( nbDisplayed + 1, std::memory_order_relaxed );
+            if ( nbDisplayed > 0 )
+            {
+                auto interval = static_cast<int64_t>( date - m_lastDisplay );
+                m_interval.recordExclusive( static_cast<uint64_t>( interval ) );
+                if ( m_lastInterval >= 0 )
+                {
+                    auto d = std::llabs( interval - m_lastInterval );
+                    m_jitter.recordExclusive( static_cast<uint64_t>( d ) );
+                    // J += ( |D| - J ) / 16, in 1/16th of ticks
+                    auto j = m_smoothedJitter.load( std::memory_order_relaxed );
+                    m_smoothedJitter.store( j + d - ( j >> 4 ), std::memory_order_relaxed );
+                }
+                m_lastInterval = interval;
+            }
+            m_lastDisplay = date;
+        }
+
+        Snapshot snapshot()
+        {
+            std::lock_guard<std::mutex> lock( m_snapshotLock );
+            Snapshot s;
+            auto ticks = detail::timing::ticks();
+            auto date = detail::timing::now();
+            s.period = std::chrono::nanoseconds( date - m_previousDate );
+            m_previousDate = date;
+            // Nanoseconds per tick, measured over the whole lifetime
+            auto scale = 1.;
+            if ( ticks > m_originTicks && date > m_originDate )
+                scale = static_cast<double>( date - m_originDate ) /
+                        static_cast<double>( ticks - m_originTicks );
+            s.hold = distribution( { &m_hold, &m_holdContended }, m_previous[0], scale );
+            s.displayInterval = distribution( { &m_interval }, m_previous[1], scale );
+            s.jitter = distribution( { &m_jitter }, m_previous[2], scale );
+            s.smoothedJitter = static_cast<double>(
+                        m_smoothedJitter.load( std::memory_order_relaxed ) ) / 16. * scale;
+            s.displayed = m_displayed.load( std::memory_order_relaxed );
+            s.untracked = m_untracked.load( std::memory_order_relaxed );
+            // Counting the locks would cost an atomic increment per frame:
+            // each one was either unlocked, is still held, or wasn't tracked.
+            s.locked = m_hold.count() + m_holdContended.count() + m_dates.size() + s.untracked;
+            s.hasMediaStats = false;
+            s.mediaDecoded = s.mediaDisplayed = s.mediaLost = 0;
+            return s;
+        }
+
+    private:
+        // A copy of a histogram, as of the previous snapshot
+        struct Totals
+        {
+            uint64_t buckets[LatencyHistogram::NbBuckets];
+            uint64_t count;
+            uint64_t sum;
+        };
+
+        // Computes the distribution of the values recorded to the provided
+        // histograms since the previous snapshot
+        static Distribution distribution( std::initializer_list<const LatencyHistogram*> histograms,
+                                          Totals& previous, double scale )
+        {
+            Totals current = Totals();
+            uint64_t max = 0;
+            for ( auto h : histograms )
+            {
+                for ( auto i = 0u; i < LatencyHistogram::NbBuckets; ++i )
+                {
+                    auto n = h->bucketCount( i );
+                    current.buckets[i] += n;
+                    current.count += n;
+                }
+                current.sum += h->sum();
+                max = h->max() > max ? h->max() : max;
+            }
+
+            Distribution d;
+            d.count = current.count - previous.count;
+            d.mean = d.count == 0 ? 0. :
+                    static_cast<double>( current.sum - previous.sum ) * scale / d.count;
+            d.p50 = d.p90 = d.p99 = d.max = 0;
+            const double percentiles[] = { 50., 90., 99. };
+            uint64_t* results[] = { &d.p50, &d.p90, &d.p99 };
+            auto p = 0u;
+            uint64_t acc = 0;
+            for ( auto i = 0u; i < LatencyHistogram::NbBuckets && d.count > 0; ++i )
+            {
+                auto n = current.buckets[i] - previous.buckets[i];
+                if ( n == 0 )
+                    continue;
+                acc += n;
+                auto value = LatencyHistogram::highestEquivalentValue( i );
+                while ( p < 3 && acc >= static_cast<uint64_t>( percentiles[p] / 100. * d.count + .5 ) )
+                    *results[p++] = value;
+                d.max = value;
+            }
+            // Don't report more than what was actually recorded
+            for ( auto r : { &d.p50, &d.p90, &d.p99, &d.max } )
+                *r = static_cast<uint64_t>( static_cast<double>( *r < max ? *r : max ) * scale );
+            previous = current;
+            return d;
+        }
+
+    private:
+        detail::timing::LockDates m_dates;
+        std::atomic<bool> m_holdBusy;
+        LatencyHistogram m_hold;
+        LatencyHistogram m_holdContended;
+        LatencyHistogram m_interval;
+        LatencyHistogram m_jitter;
+        std::atomic<uint64_t> m_displayed;
+        std::atomic<uint64_t> m_untracked;
+        std::atomic<int64_t> m_smoothedJitter;
+        // Display thread
+        uint64_t m_lastDisplay;
+        int64_t m_lastInterval;
+        // Snapshot side
+        const uint64_t m_originTicks;
+        const int64_t m_originDate;
+        std::mutex m_snapshotLock;
+        Totals m_previous[3];
+        int64_t m_previousDate;
+    };
+
+public:
+    VideoTimings()
+        : m_state( std::make_shared<State>() )
+    {
+    }
+
+    ///
+    /// \brief The Callbacks struct holds decorated video callbacks, matching
+    ///        the MediaPlayer::setVideoCallbacks prototypes.
+    ///
+    struct Callbacks
+    {
+        std::function<void*(void**)> lock;
+        std::function<void(void*, void* const*)> unlock;
+        std::function<void(void*)> display;
+    };
+
+    ///
+    /// \brief decorate Wraps video callbacks with the instrumentation
+    ///
+    /// The parameters are the same as MediaPlayer::setVideoCallbacks ones.
+    ///
+    template <typename LockCb, typename UnlockCb, typename DisplayCb>
+    Callbacks decorate( LockCb&& lock, UnlockCb&& unlock, DisplayCb&& display )
+    {
+        static_assert(signature_match<LockCb, void*(void**)>::value, "Mismatched lock callback signature");
+        static_assert(signature_match_or_nullptr<UnlockCb, void(void*, void *const *)>::value, "Mismatched unlock callback signature");
+        static_assert(signature_match_or_nullptr<DisplayCb, void(void*)>::value, "Mismatched display callback signature");
+
+        auto state = m_state;
+        typename std::decay<LockCb>::type l( std::forward<LockCb>( lock ) );
+        typename std::decay<UnlockCb>::type u( std::forward<UnlockCb>( unlock ) );
+        typename std::decay<DisplayCb>::type d( std::forward<DisplayCb>( display ) );
+        Callbacks c;
+        c.lock = [state, l]( void** planes ) mutable -> void* {
+            auto picture = l( planes );
+            state->locked( picture );
+            return picture;
+        };
+        c.unlock = [state, u]( void* picture, void* const* planes ) mutable {
+            state->unlocked( picture );
+            detail::timing::call( u, picture, planes );
+        };
+        c.display = [state, d]( void* picture ) mutable {
+            state->displayed();
+            detail::timing::call( d, picture );
+        };
+        return c;
+    }
+
+    ///
+    /// \brief setVideoCallbacks Sets the player's video callbacks, decorated
+    ///                          with the instrumentation.
+    ///
+    /// To instrument a component which sets its own callbacks, such as
+    /// FramePool::attach, call this afterward with its raw callbacks.
+    ///
+    template <typename LockCb, typename UnlockCb, typename DisplayCb>
+    void setVideoCallbacks( MediaPlayer& mp, LockCb&& lock, UnlockCb&& unlock, DisplayCb&& display )
+    {
+        auto c = decorate( std::forward<LockCb>( lock ), std::forward<UnlockCb>( unlock ),
+                           std::forward<DisplayCb>( display ) );
+        mp.setVideoCallbacks( std::move( c.lock ), std::move( c.unlock ), std::move( c.display ) );
+    }
+
+    ///
+    /// \brief snapshot Returns the statistics since the previous snapshot
+    ///
+    /// This can be called from any thread.
+    ///
+    Snapshot snapshot()
+    {
+        return m_state->snapshot();
+    }
+
+    ///
+    /// \brief snapshot Returns the statistics since the previous snapshot,
+    ///                 along with what libvlc reports for the provided media
+    ///
+    Snapshot snapshot( Media& media )
+    {
+        auto s = m_state->snapshot();
+        libvlc_media_stats_t stats;
+        if ( media.stats( &stats ) == true )
+        {
+            s.hasMediaStats = true;
+            s.mediaDecoded = static_cast<uint64_t>( stats.i_decoded_video );
+            s.mediaDisplayed = static_cast<uint64_t>( stats.i_displayed_pictures );
+            s.mediaLost = static_cast<uint64_t>( stats.i_lost_pictures );
+        }
+        return s;
+    }
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace VLC
+
+#endif // LIBVLC_CXX_VIDEOTIMINGS_H
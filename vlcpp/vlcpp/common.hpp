@@ -31,8 +31,12 @@ using ssize_t = long int;
 #include <vlc/vlc.h>
 #include <vlc/libvlc_version.h>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 namespace VLC
 {
@@ -96,24 +100,120 @@ namespace VLC
     {
     };
 
-    struct CallbackHandlerBase
-    {
-        virtual ~CallbackHandlerBase() = default;
-    };
-
     template <typename Func>
-    struct CallbackHandler : public CallbackHandlerBase
+    struct CallbackHandler
     {
         template <typename FuncFwd>
         CallbackHandler(FuncFwd&& f) : func( std::forward<Func>( f ) ) {}
         Func func;
     };
 
+    ///
+    /// Type erased storage for a single user callback.
+    /// Callbacks which fit in the inline buffer are stored in place, so invoking
+    /// them only requires the address of the slot, which is known from the
+    /// opaque pointer libvlc gives back. Bigger or over-aligned callbacks
+    /// are allocated on the heap, as well as those which may throw when moved.
+    /// A callback is built before the one it replaces gets destroyed, so that
+    /// the slot keeps the old one if the construction throws.
+    /// The storage strategy is deduced from the callback type, so the trampoline
+    /// generated by CallbackWrapper doesn't need to check it at runtime.
+    ///
+    class CallbackSlot
+    {
+    public:
+        /// Enough for a std::function, or a lambda capturing a few pointers
+        static constexpr size_t InlineSize = 4 * sizeof(void*);
+
+        CallbackSlot() : m_heap( nullptr ), m_destroy( nullptr ) {}
+        ~CallbackSlot() { reset(); }
+
+        CallbackSlot( const CallbackSlot& ) = delete;
+        CallbackSlot& operator=( const CallbackSlot& ) = delete;
+
+        template <typename T>
+        static constexpr bool fitsInline()
+        {
+            return sizeof(T) <= InlineSize && alignof(T) <= alignof(std::max_align_t) &&
+                    std::is_nothrow_move_constructible<T>::value;
+        }
+
+        template <typename T, typename... Args>
+        void emplace( Args&&... args )
+        {
+            emplace<T>( std::integral_constant<bool, fitsInline<T>()>{},
+                        std::forward<Args>( args )... );
+        }
+
+        template <typename T>
+        T& get()
+        {
+            return get<T>( std::integral_constant<bool, fitsInline<T>()>{} );
+        }
+
+        void reset()
+        {
+            if ( m_destroy == nullptr )
+                return;
+            auto destroy = m_destroy;
+            m_destroy = nullptr;
+            destroy( *this );
+            m_heap = nullptr;
+        }
+
+        CallbackSlot& operator=( std::nullptr_t )
+        {
+            reset();
+            return *this;
+        }
+
+        bool operator==( std::nullptr_t ) const { return m_destroy == nullptr; }
+        bool operator!=( std::nullptr_t ) const { return m_destroy != nullptr; }
+
+    private:
+        template <typename T, typename... Args>
+        void emplace( std::true_type, Args&&... args )
+        {
+            T callback( std::forward<Args>( args )... );
+            reset();
+            new (&m_storage) T( std::move( callback ) );
+            m_destroy = [](CallbackSlot& s) { s.get<T>( std::true_type{} ).~T(); };
+        }
+
+        template <typename T, typename... Args>
+        void emplace( std::false_type, Args&&... args )
+        {
+            auto callback = new T( std::forward<Args>( args )... );
+            reset();
+            m_heap = callback;
+            m_destroy = [](CallbackSlot& s) { delete static_cast<T*>( s.m_heap ); };
+        }
+
+        template <typename T>
+        T& get( std::true_type )
+        {
+            return *reinterpret_cast<T*>( &m_storage );
+        }
+
+        template <typename T>
+        T& get( std::false_type )
+        {
+            return *static_cast<T*>( m_heap );
+        }
+
+    private:
+        typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type m_storage;
+        void* m_heap;
+        void (*m_destroy)(CallbackSlot&);
+    };
+
     template <size_t NbEvent>
-    using CallbackArray = std::array<std::unique_ptr<CallbackHandlerBase>, NbEvent>;
+    using CallbackArray = std::array<CallbackSlot, NbEvent>;
 
     ///
     /// Utility class that contains a shared pointer to a callback array.
+    /// The callbacks are stored inline in the array, which is the opaque pointer
+    /// given to libvlc, so invoking a callback only requires one pointer hop.
     /// We use a shared_ptr to allow multiple instances to share the same callback array
     /// This must be inherited before the Internal<T> type, to ensure it gets deleted
     /// after the wrapped libvlc object.
@@ -183,12 +283,12 @@ namespace VLC
         template <size_t NbEvents, typename Func>
         static Wrapped wrap(CallbackArray<NbEvents>& callbacks, Func&& func)
         {
-            callbacks[Idx] = std::unique_ptr<CallbackHandler<Func>>( new CallbackHandler<Func>( std::forward<Func>( func ) ) );
+            callbacks[Idx].template emplace<CallbackHandler<Func>>( std::forward<Func>( func ) );
             return [](Opaque opaque, Args... args) -> Ret {
                 auto& callbacks = FromOpaque<NbEvents, Opaque>::get( opaque );
                 assert(callbacks[Idx] != nullptr);
-                auto cbHandler = static_cast<CallbackHandler<Func>*>( callbacks[Idx].get() );
-                return cbHandler->func( detail::converterForNullToString<Args>(std::forward<Args>(args))... );
+                auto& cbHandler = callbacks[Idx].template get<CallbackHandler<Func>>();
+                return cbHandler.func( detail::converterForNullToString<Args>(std::forward<Args>(args))... );
             };
         }
 
@@ -243,6 +343,51 @@ namespace VLC
             void* userOpaque;
         };
 
+        // Segment based sources reopen their media constantly, so the boxes
+        // are recycled instead of being allocated by each open callback.
+        // Released boxes are parked in a few slots, which are claimed with an
+        // atomic exchange: the pool is lock-free, and unlike a linked
+        // freelist, it isn't subject to ABA. The boxes which don't fit are
+        // released to the heap.
+        template <int NbEvent>
+        struct OpaquePool
+        {
+            static constexpr size_t Size = 16;
+
+            static Opaque<NbEvent>* acquire()
+            {
+                for ( auto& slot : slots )
+                {
+                    if ( slot.load( std::memory_order_relaxed ) == nullptr )
+                        continue;
+                    auto box = slot.exchange( nullptr, std::memory_order_acquire );
+                    if ( box != nullptr )
+                        return box;
+                }
+                return new Opaque<NbEvent>;
+            }
+
+            static void release( Opaque<NbEvent>* box )
+            {
+                for ( auto& slot : slots )
+                {
+                    Opaque<NbEvent>* expected = nullptr;
+                    if ( slot.load( std::memory_order_relaxed ) == nullptr &&
+                         slot.compare_exchange_strong( expected, box, std::memory_order_release,
+                                                       std::memory_order_relaxed ) == true )
+                        return;
+                }
+                delete box;
+            }
+
+            // Constant initialized, and never destroyed, so that media closed
+            // by static destructors can still use it.
+            static std::atomic<Opaque<NbEvent>*> slots[Size];
+        };
+
+        template <int NbEvent>
+        std::atomic<Opaque<NbEvent>*> OpaquePool<NbEvent>::slots[OpaquePool<NbEvent>::Size];
+
         enum class BoxingStrategy
         {
             /// No boxing required.
@@ -251,7 +396,7 @@ namespace VLC
             Setup,
             /// Unbox CallbackArray/user callback pointers
             Unbox,
-            /// Releases the Opaque, created during Setup
+            /// Releases the Opaque, created during Setup, to the OpaquePool
             Cleanup,
         };
 
@@ -310,7 +455,7 @@ namespace VLC
             using Base = BoxOpaque<NbEvents, BoxingStrategy::Unbox>;
             template <typename... Args>
             BoxOpaque(void* ptr, void** userOpaque, Args...)
-                : Base( new Opaque<NbEvents> )
+                : Base( OpaquePool<NbEvents>::acquire() )
                 , m_userOpaque( userOpaque )
             {
                 Base::m_ptr->callbacks = reinterpret_cast<CallbackArray<NbEvents>*>( ptr );
@@ -337,7 +482,7 @@ namespace VLC
             using Base = BoxOpaque<NbEvents, BoxingStrategy::Unbox>;
             template <typename... Args>
             BoxOpaque(void* ptr, Args...) : BoxOpaque<NbEvents, BoxingStrategy::Unbox>( ptr ) {}
-            ~BoxOpaque() { delete Base::m_ptr; }
+            ~BoxOpaque() { OpaquePool<NbEvents>::release( Base::m_ptr ); }
         };
 
         // When no boxing is required, enfore the user provided callback as a nullptr.
@@ -380,12 +525,12 @@ namespace VLC
             template <BoxingStrategy Strategy, size_t NbEvents, typename Func>
             static Wrapped wrap(CallbackArray<NbEvents>& callbacks, Func&& func)
             {
-                callbacks[Idx] = std::unique_ptr<CallbackHandler<Func>>( new CallbackHandler<Func>( std::forward<Func>( func ) ) );
+                callbacks[Idx].template emplace<CallbackHandler<Func>>( std::forward<Func>( func ) );
                 return [](void* opaque, Args... args) -> Ret {
                     auto boxed = BoxOpaque<NbEvents, Strategy>( opaque, std::forward<Args>( args )... );
                     assert(boxed.callbacks()[Idx] != nullptr );
-                    auto cbHandler = static_cast<CallbackHandler<Func>*>( boxed.callbacks()[Idx].get() );
-                    return cbHandler->func( boxed, std::forward<Args>(args)... );
+                    auto& cbHandler = boxed.callbacks()[Idx].template get<CallbackHandler<Func>>();
+                    return cbHandler.func( boxed, std::forward<Args>(args)... );
                 };
             }
 